@@ -63,6 +63,7 @@
 
 #include <geogram/basic/command_line.h>
 #include <geogram/basic/command_line_args.h>
+#include <geogram/basic/profiler.h>
 
 namespace {
     using namespace GEO;
@@ -429,6 +430,7 @@ namespace {
         void smooth_point_set(
             index_t nb_iterations=2, index_t nb_neighbors=30
         ) {
+            geo_profile_scope("geobox:smooth_point_set");
             begin();
             if(nb_iterations != 0) {
                 Co3Ne_smooth(*mesh(), nb_neighbors, nb_iterations);
@@ -440,6 +442,7 @@ namespace {
             double radius=5.0,
             index_t nb_iterations=0, index_t nb_neighbors=30
         ) {
+            geo_profile_scope("geobox:reconstruct");
             hide_surface();
             begin();
             double R = bbox_diagonal(*mesh());
@@ -462,6 +465,7 @@ namespace {
             double max_degree3_dist = 0.0,
             bool remove_isect = false
         ) {
+            geo_profile_scope("geobox:repair_surface");
             begin();
 
             double bbox_diagonal = GEO::bbox_diagonal(*mesh());
@@ -505,6 +509,7 @@ namespace {
         void merge_vertices(
             double epsilon=1e-6
         ) {
+            geo_profile_scope("geobox:merge_vertices");
             begin();
             epsilon *= (0.01 * bbox_diagonal(*mesh()));
             mesh_repair(*mesh(), MESH_REPAIR_DEFAULT, epsilon);
@@ -522,6 +527,7 @@ namespace {
             index_t Newton_m = 7,
             index_t LFS_samples = 10000
         ) {
+            geo_profile_scope("geobox:remesh_smooth");
             if(mesh()->facets.nb() == 0) {
                 Logger::err("Remesh")
                     << "mesh has no facet" << std::endl;
@@ -587,6 +593,7 @@ namespace {
             bool keep_borders = true,
             bool repair = true
         ) {
+            geo_profile_scope("geobox:decimate");
             begin();
             MeshDecimateMode mode = MESH_DECIMATE_DUP_F;
             if(remove_deg3_vrtx) {
@@ -705,6 +712,7 @@ namespace {
             double quality=1.0,
             bool verbose=false
         ) {
+            geo_profile_scope("geobox:tet_meshing");
             if(verbose) {
                 show_console();
             }
@@ -8,6 +8,7 @@
 #include <geogram/basic/command_line_args.h>
 #include <geogram/basic/progress.h>
 #include <geogram/basic/stopwatch.h>
+#include <geogram/basic/profiler.h>
 #include <geogram/basic/process.h>
 #include <geogram/basic/file_system.h>
 #include <geogram/basic/geometry_nd.h>
@@ -64,6 +65,7 @@ namespace {
      * \param[in,out] M_in the input point set and the reconstructed mesh
      */
     void reconstruct(Mesh& M_in) {
+        geo_profile_scope("Reconstruct");
         Logger::div("reconstruction");
 
         Logger::out("Co3Ne") << "Preparing data" << std::endl;
@@ -568,6 +570,7 @@ namespace {
     int polyhedral_mesher(
         const std::string& input_filename, std::string output_filename
     ) {
+        geo_profile_scope("Polyhedral meshing");
         Mesh M_in;
         Mesh M_out;
 	Mesh M_points;
@@ -707,6 +710,7 @@ namespace {
     int tetrahedral_mesher(
         const std::string& input_filename, const std::string& output_filename
     ) {
+        geo_profile_scope("Tetrahedral meshing");
         MeshIOFlags flags;
         flags.set_element(MESH_CELLS);
 
@@ -801,6 +805,7 @@ int main(int argc, char** argv) {
 
         Logger::div("remeshing");
 	{
+            geo_profile_scope("Remeshing");
             double gradation = CmdLine::get_arg_double("remesh:gradation");
             if(gradation != 0.0) {
                 compute_sizing_field(
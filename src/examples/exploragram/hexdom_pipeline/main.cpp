@@ -79,7 +79,8 @@ namespace {
 	    Mesh input;
 	    load_mesh("input",input);
 	    HexdomPipeline::FrameField(
-		  &input, CmdLine::get_arg_bool("FrameField:smooth")
+		  &input, CmdLine::get_arg_bool("hexdom:FrameField:smooth"),
+		  CmdLine::get_arg_bool("hexdom:FrameField:gauss_seidel")
 	    );
 	    save_mesh(input, "FF");
 	} else if(stage == "Parameterization") {
@@ -229,6 +230,12 @@ QuadDominant,Hexahedrons,Cavity,HexDominant,all");
     CmdLine::declare_arg(
         "hexdom:FrameField:smooth", false, "smooth frame field"
     );
+
+    CmdLine::declare_arg(
+        "hexdom:FrameField:gauss_seidel", false,
+	"smooth frame field with parallel Gauss-Seidel instead of LBFGS "
+	"(experimental, slower than LBFGS)"
+    );
     
     CmdLine::declare_arg(
 	 "hexdom:Parameterization:algo", 0, "one of 0(PGP with corr.), 1(CubeCover), 2(PGP without corr.)"
@@ -41,6 +41,7 @@
 #include <exploragram/hexdom/frame.h>
 #include <exploragram/hexdom/basic.h>
 #include <exploragram/hexdom/extra_connectivity.h>
+#include <exploragram/hexdom/time_log.h>
 #include <geogram/NL/nl.h>
 #include <geogram/numerics/optimizer.h>
 
@@ -49,6 +50,113 @@
 #endif
 #include <queue>
 
+namespace {
+
+    using namespace GEO;
+
+    /**
+     * \brief Projects spherical harmonics coefficients onto a frame.
+     * \param[in] fv the spherical harmonics coefficients
+     * \param[in] oldB the previous frame
+     * \param[in] keep_z if set, the Z axis (and its size) of the previous
+     *  frame is kept (frames constrained by the boundary)
+     * \param[in] prev euler angles used to initialize the projection,
+     *  or NULL
+     * \return the projected frame
+     */
+    mat3 project_frame(
+        SphericalHarmonicL4& fv, const mat3& oldB, bool keep_z, vec3* prev
+    ) {
+        vec3 oldz = col(oldB, 2);
+        mat3 result = fv.project_mat3(1e-3, 1e-5, prev);
+        if (keep_z) {
+            AxisPermutation ap;
+            ap.make_col2_equal_to_z(result, normalize(oldz));
+            result = Frame(result).apply_permutation(ap);
+            FOR(d, 3) result(d, 2) = oldz[d];// restore size as well
+        }
+        return result;
+    }
+
+    /**
+     * \brief Projects spherical harmonics coefficients onto the frames
+     *  that share the Z axis of a given frame.
+     * \details Used for the frames constrained by the boundary: the
+     *  optimal rotation around Z is found in closed form, so that the
+     *  Z axis (and its size) is kept exactly.
+     * \param[in] fv the spherical harmonics coefficients
+     * \param[in,out] B the previous frame, replaced with the projected one
+     * \param[out] sh the spherical harmonics of the projected frame
+     */
+    void project_frame_around_z(
+        const SphericalHarmonicL4& fv, mat3& B, SphericalHarmonicL4& sh
+    ) {
+        mat3 R = normalize_columns(B);
+        vec3 xyz = mat3_to_euler(R);
+        SphericalHarmonicL4 sh0, sh4, sh8;
+        sh0[0] = std::sqrt(5. / 12.);
+        sh4[4] = std::sqrt(7. / 12.);
+        sh8[8] = std::sqrt(5. / 12.);
+        sh0.euler_rot(xyz);
+        sh4.euler_rot(xyz);
+        sh8.euler_rot(xyz);
+        // the coefficients of the frame rotated by alpha around Z are
+        // sh4 + cos(4 alpha) sh8 + sin(4 alpha) sh0
+        double a = fv * sh8;
+        double b = fv * sh0;
+        double r = std::sqrt(a * a + b * b);
+        if (r < 1e-10) {
+            sh = sh4 + sh8;
+            return;
+        }
+        mat3 result = R * rotz(std::atan2(b, a) / 4.);
+        FOR(d, 3) result(d, 2) = B(d, 2);
+        B = result;
+        sh = sh4 + sh8 * (a / r) + sh0 * (b / r);
+    }
+
+    /**
+     * \brief Replaces a batch of frames with the projection of the
+     *  average spherical harmonics of their neighbors.
+     * \details The projections start from the current frames and their
+     *  spherical harmonics, so that no conversion to Euler angles is
+     *  needed for the free frames, and they usually converge in a single
+     *  step.
+     * \param[in] nb number of frames in the batch
+     * \param[in] verts the nb vertices
+     * \param[in] avg the nb averages of the neighbors
+     * \param[in] num_ln_v the frames of the vertices below num_ln_v are
+     *  constrained by the boundary
+     * \param[in,out] B the frames
+     * \param[in,out] fv the spherical harmonics of the frames
+     * \param[out] change the norm of the change of the spherical harmonics
+     *  of each frame
+     */
+    void project_frames_batch(
+        index_t nb, const index_t* verts, const SphericalHarmonicL4* avg,
+        index_t num_ln_v, Attribute<mat3>& B,
+        vector<SphericalHarmonicL4>& fv, vector<double>& change
+    ) {
+        FOR(i, nb) {
+            index_t v = verts[i];
+            if (avg[i].norm() < 1e-10) {
+                change[v] = 0;
+                continue;
+            }
+            SphericalHarmonicL4 nfv = fv[v];
+            if (v < num_ln_v) {
+                project_frame_around_z(avg[i], B[v], nfv);
+            } else {
+                mat3 W = normalize_columns(B[v]);
+                avg[i].project_mat3(W, nfv, 1e-3, 1e-5);
+                B[v] = W;
+            }
+            change[v] = (nfv - fv[v]).norm();
+            fv[v] = nfv;
+        }
+    }
+}
+
 namespace GEO {
 
     FFopt::FFopt(Mesh* p_m) {
@@ -83,7 +191,7 @@ namespace GEO {
 
 		plop(num_l_v);
 		plop(num_ln_v);
-		plop("construct system");
+		logt.start_section("FF_init", "construct system");
         nlNewContext();
         nlSolverParameteri(NL_LEAST_SQUARES, NL_TRUE);
         nlSolverParameteri(NL_NB_VARIABLES, NLint(2 * (num_ln_v - num_l_v) + 9 * m->vertices.nb()));
@@ -136,9 +244,10 @@ namespace GEO {
 
         nlEnd(NL_MATRIX);
         nlEnd(NL_SYSTEM);
+        logt.add_step("solve");
         nlSolve();
 
-        plop("project SH");
+        logt.add_step("project SH");
         // convert spherical harmonic coefficients to a rotation
 #ifdef GEO_OPENMP	
 #pragma omp parallel
@@ -150,22 +259,16 @@ namespace GEO {
                 FOR(i, 9) fv[i] = nlGetVariable(v * 9 + i);
                 if (generate_sh) sh[v] = fv;
                 if (v >= num_l_v) {
-                    vec3 oldz = col(B[v], 2);
                     if (v > start) {
                         vec3  prev = mat3_to_euler(normalize_columns(B[v - 1]));
-                        B[v] = fv.project_mat3(1e-3, 1e-5, &prev);
+                        B[v] = project_frame(fv, B[v], v < num_ln_v, &prev);
                     } else 
-                        B[v] = fv.project_mat3(1e-3, 1e-5, NULL);
-                    if (v < num_ln_v) {
-                        AxisPermutation ap;
-                        ap.make_col2_equal_to_z(B[v], normalize(oldz));
-                        B[v] = Frame(B[v]).apply_permutation(ap);
-                        FOR(d, 3) B[v](d, 2) = oldz[d];// restore size as well
-                    }
+                        B[v] = project_frame(fv, B[v], v < num_ln_v, NULL);
                 }
             }
         }
         nlDeleteContext(nlGetCurrent());
+        logt.end_section();
 
     }
 
@@ -209,7 +312,7 @@ namespace {
         }
     }
 
-    void compute_gradient_cb2(unsigned int N, double* x, double& f, double* g) {
+    void compute_gradient_cb2(index_t N, double* x, double& f, double* g) {
         mat3 mEx = mat3_from_coeffs( 0, 0, 0, 0, 0, -1, 0, 1, 0 );
         mat3 mEy = mat3_from_coeffs(0, 0, 1, 0, 0, 0, -1, 0, 0 );
         mat3 mEz = mat3_from_coeffs(0, -1, 0, 1, 0, 0, 0, 0, 0 );
@@ -365,6 +468,95 @@ namespace GEO {
 
 
 
+    void FFopt::FF_smooth_GS(index_t max_iter) {
+        Attribute<mat3> B(m->vertices.attributes(), "B");
+        Attribute<SphericalHarmonicL4> sh(m->vertices.attributes(), "sh");
+        index_t nverts = m->vertices.nb();
+
+        // greedy coloring of the vertex graph: vertices with the same
+        // color are not neighbors and can be updated concurrently
+        logt.start_section("FF_smooth_GS", "graph coloring");
+        vector<index_t> color(nverts, NOT_AN_ID);
+        vector<bool> used;
+        index_t nb_colors = 0;
+        FOR(v, nverts) {
+            FOR(lv, nb_neigs(v)) {
+                index_t c = color[neig(v, lv)];
+                if (c != NOT_AN_ID) used[c] = true;
+            }
+            index_t c = 0;
+            while (c < nb_colors && used[c]) c++;
+            if (c == nb_colors) {
+                nb_colors++;
+                used.push_back(false);
+            }
+            color[v] = c;
+            FOR(lv, nb_neigs(v)) {
+                index_t c2 = color[neig(v, lv)];
+                if (c2 != NOT_AN_ID) used[c2] = false;
+            }
+        }
+
+        // free vertices sorted by color
+        vector<index_t> color_ptr(nb_colors + 1, 0);
+        for (index_t v = num_l_v; v < nverts; v++) color_ptr[color[v] + 1]++;
+        FOR(c, nb_colors) color_ptr[c + 1] += color_ptr[c];
+        vector<index_t> sorted(nverts - num_l_v);
+        {
+            vector<index_t> pos(color_ptr);
+            for (index_t v = num_l_v; v < nverts; v++) sorted[pos[color[v]]++] = v;
+        }
+        plop(nb_colors);
+
+        // spherical harmonics of the current frames
+        vector<SphericalHarmonicL4> fv(nverts);
+#ifdef GEO_OPENMP
+#pragma omp parallel
+#endif
+        {
+            get_thread_range(nverts, start, end);
+            for (index_t v = start; v < end; v++) {
+                fv[v] = SphericalHarmonicL4::rest_frame();
+                fv[v].euler_rot(mat3_to_euler(normalize_columns(B[v])));
+            }
+        }
+
+        // each vertex is replaced with the projection of the average
+        // of its neighbors (that minimizes the smoothing energy of FF_init)
+        logt.add_step("Gauss-Seidel");
+        vector<double> change(nverts, 0.);
+        index_t iter = 0;
+        for (; iter < max_iter; iter++) {
+            FOR(c, nb_colors) {
+                index_t b = color_ptr[c];
+                index_t nb = color_ptr[c + 1] - b;
+#ifdef GEO_OPENMP
+#pragma omp parallel
+#endif
+                {
+                    get_thread_range(nb, start, end);
+                    vector<SphericalHarmonicL4> avg(end - start);
+                    for (index_t i = start; i < end; i++) {
+                        index_t v = sorted[b + i];
+                        FOR(lv, nb_neigs(v)) avg[i - start] = avg[i - start] + fv[neig(v, lv)];
+                    }
+                    if (end > start) {
+                        project_frames_batch(end - start, &sorted[b + start], avg.data(), num_ln_v, B, fv, change);
+                    }
+                }
+            }
+            double max_change = 0;
+            for (index_t v = num_l_v; v < nverts; v++) max_change = std::max(max_change, change[v]);
+            if (max_change < 1e-3) break;
+        }
+        plop(iter);
+
+        FOR(v, nverts) sh[v] = fv[v];
+        logt.end_section();
+    }
+
+
+
     //   ___             _      ___            _   _       _
     //  | _ )_ _ _  _ __| |_   |_  )  ___ _ __| |_(_)_ __ (_)______
     //  | _ \ '_| || (_-< ' \   / /  / _ \ '_ \  _| | '  \| |_ / -_)
@@ -47,10 +47,53 @@
 
 #include <geogram/NL/nl.h>
 
+#ifdef GEO_OPENMP
+#include <omp.h>
+#endif
+
 #include <algorithm>
 #include <cmath>
 #include <queue>
 
+namespace {
+
+    using namespace GEO;
+
+    /**
+     * \brief Adds the contribution of a least squares row
+     *  to the normal equations.
+     * \details The coefficients of the non-locked variables are added to the
+     *  current OpenNL matrix with nlThreadAddIJCoefficient(), and the locked
+     *  variables are moved to the right hand side.
+     * \param[in] thread the index of the thread buffer
+     * \param[in] nb the number of coefficients in the row
+     * \param[in] var the indices of the variables
+     * \param[in] coeff the coefficients
+     * \param[in] locked the locked flag of all the variables
+     * \param[in] value the values of all the variables (used if locked)
+     * \param[in,out] rhs the right hand side of the thread
+     */
+    void add_row_to_normal_equations(
+        index_t thread, index_t nb, const index_t* var, const double* coeff,
+        const vector<bool>& locked, const vector<double>& value,
+        vector<double>& rhs
+    ) {
+        FOR(i, nb) {
+            if (locked[var[i]]) continue;
+            FOR(j, nb) {
+                if (locked[var[j]]) {
+                    rhs[var[i]] -= coeff[i] * coeff[j] * value[var[j]];
+                } else {
+                    nlThreadAddIJCoefficient(
+                        NLuint(thread), NLuint(var[i]), NLuint(var[j]),
+                        coeff[i] * coeff[j]
+                    );
+                }
+            }
+        }
+    }
+}
+
 namespace GEO {
 
 	PGPopt::PGPopt(Mesh* p_m) : m(p_m) {
@@ -196,15 +239,21 @@ namespace GEO {
 		}
 		cubcover(true);
 		// clamp the result: very naive way to avoid too large corrections. May be improved.
-		FOR(e, m->edges.nb()) {
-			//   BasisChg chg = edge_basis_change(e, false);
-			vec3 geom_form = wish_angle_edge_geom(e, false);
-			vec3 corr_form = wish_angle_corr(e, false);
-			double scale = 1.;
-			double cl = corr_form.length();
-			double gl = geom_form.length();
-			if (cl > max_corr_prop* gl)  scale = max_corr_prop* gl / cl;
-			FOR(d, 3) corr[e][d] = scale * corr[e][d];
+#ifdef GEO_OPENMP
+#pragma omp parallel
+#endif
+		{
+			get_thread_range(m->edges.nb(), start, end);
+			for (index_t e = start; e < end; e++) {
+				//   BasisChg chg = edge_basis_change(e, false);
+				vec3 geom_form = wish_angle_edge_geom(e, false);
+				vec3 corr_form = wish_angle_corr(e, false);
+				double scale = 1.;
+				double cl = corr_form.length();
+				double gl = geom_form.length();
+				if (cl > max_corr_prop* gl)  scale = max_corr_prop* gl / cl;
+				FOR(d, 3) corr[e][d] = scale * corr[e][d];
+			}
 		}
 	}
 
@@ -214,52 +263,58 @@ namespace GEO {
 		Attribute<vec3> UC(m->cell_corners.attributes(), "U");
 		Attribute<bool> has_param(m->cell_facets.attributes(), "has_param");
 
-		FOR(c, m->cells.nb()) {
+#ifdef GEO_OPENMP
+#pragma omp parallel
+#endif
+		{
+			get_thread_range(m->cells.nb(), start, end);
+			for (index_t c = start; c < end; c++) {
 
-			bool all_faces_have_param = true;
-			// flag has param
-			FOR(lf, 4) {
-				index_t f = m->cells.facet(c, lf);
-				has_param[f] = true;
-				if (triangle_is_frame_singular(m, B, c, lf))has_param[f] = false;
-				else if (is_PGP_singular(c, lf)) has_param[f] = false;
-				all_faces_have_param = all_faces_have_param && has_param[f];
-			}
+				bool all_faces_have_param = true;
+				// flag has param
+				FOR(lf, 4) {
+					index_t f = m->cells.facet(c, lf);
+					has_param[f] = true;
+					if (triangle_is_frame_singular(m, B, c, lf))has_param[f] = false;
+					else if (is_PGP_singular(c, lf)) has_param[f] = false;
+					all_faces_have_param = all_faces_have_param && has_param[f];
+				}
 
 
-			index_t org = 0;
+				index_t org = 0;
 
-			// find a seed that will properly reconstruct all valid triangle param
-			if (!all_faces_have_param) {
-				bool can_be_ref[4] = { true, true, true, true };
-				FOR(lf, 4) {
-					index_t f = m->cells.facet(c, lf);
-					if (has_param[f]) {
-						bool local_can_be_ref[4] = { false, false, false, false };
-						FOR(lv, 3) local_can_be_ref[m->cells.descriptor(c).facet_vertex[lf][lv]] = true;
-						FOR(i, 4) can_be_ref[i] = can_be_ref[i] && local_can_be_ref[i];
+				// find a seed that will properly reconstruct all valid triangle param
+				if (!all_faces_have_param) {
+					bool can_be_ref[4] = { true, true, true, true };
+					FOR(lf, 4) {
+						index_t f = m->cells.facet(c, lf);
+						if (has_param[f]) {
+							bool local_can_be_ref[4] = { false, false, false, false };
+							FOR(lv, 3) local_can_be_ref[m->cells.descriptor(c).facet_vertex[lf][lv]] = true;
+							FOR(i, 4) can_be_ref[i] = can_be_ref[i] && local_can_be_ref[i];
+						}
 					}
+					org = NOT_AN_ID;
+					FOR(i, 4) if (can_be_ref[i]) org = i;
 				}
-				org = NOT_AN_ID;
-				FOR(i, 4) if (can_be_ref[i]) org = i;
-			}
 
 
-			if (org != NOT_AN_ID)
-				FOR(i, 4) {
-				index_t corner = m->cells.corner(c, i);
-				UC[corner] = U[m->cells.vertex(c, i)];
-				if (i != org) {
-					AxisPermutation change = Rij(m, B, m->cells.vertex(c, org), m->cells.vertex(c, i));
-					UC[corner] = change.inverse()  * U[m->cells.vertex(c, i)];
-					bool inv;
-					index_t e = edge_from_vertices(m->cells.vertex(c, org), m->cells.vertex(c, i), inv);
-					geo_assert(e != NOT_AN_ID);
-					vec3i t2 = !inv ? tij[e] : -(change.inverse()*tij[e]);
-					UC[corner] += vec3(t2[0], t2[1], t2[2]);
+				if (org != NOT_AN_ID)
+					FOR(i, 4) {
+					index_t corner = m->cells.corner(c, i);
+					UC[corner] = U[m->cells.vertex(c, i)];
+					if (i != org) {
+						AxisPermutation change = Rij(m, B, m->cells.vertex(c, org), m->cells.vertex(c, i));
+						UC[corner] = change.inverse()  * U[m->cells.vertex(c, i)];
+						bool inv;
+						index_t e = edge_from_vertices(m->cells.vertex(c, org), m->cells.vertex(c, i), inv);
+						geo_assert(e != NOT_AN_ID);
+						vec3i t2 = !inv ? tij[e] : -(change.inverse()*tij[e]);
+						UC[corner] += vec3(t2[0], t2[1], t2[2]);
+					}
 				}
+				else geo_assert(!has_param[m->cells.facet(c, 0)] && !has_param[m->cells.facet(c, 1)] && !has_param[m->cells.facet(c, 2)] && !has_param[m->cells.facet(c, 3)]);
 			}
-			else geo_assert(!has_param[m->cells.facet(c, 0)] && !has_param[m->cells.facet(c, 1)] && !has_param[m->cells.facet(c, 2)] && !has_param[m->cells.facet(c, 3)]);
 		}
 
 		// TODO REMOVE THAT  !!!!! just to TEST
@@ -276,67 +331,137 @@ namespace GEO {
 
 	void PGPopt::optimize_PGP() {
 		Attribute<vec3> lockU(m->vertices.attributes(), "lockU");
-		// Create and initialize OpenNL context
-		nlNewContext();
-		nlSolverParameteri(NL_LEAST_SQUARES, NL_TRUE);
-		nlSolverParameteri(NL_NB_VARIABLES, NLint(6 * m->vertices.nb()));
-
-		nlBegin(NL_SYSTEM);
-		FOR(v, m->vertices.nb())FOR(d, 3) if (std::fabs(lockU[v][d]) > 0)FOR(c, 2) {
-			nlSetVariable(6 * v + 2 * d + c, 1 - c);
-			nlLockVariable(6 * v + 2 * d + c);
+		index_t nverts = m->vertices.nb();
+		index_t nvars = 6 * nverts;
+
+		// The least squares system is assembled as normal equations, so
+		// that each thread can add the rows of its edges to its own buffer.
+		// Locked variables are eliminated by hand (the parallel assembly
+		// of OpenNL does not support them).
+		logt.start_section("optimize_PGP", "assemble");
+		vector<bool> locked(nvars, false);
+		vector<double> value(nvars, 0.);
+		FOR(v, nverts)FOR(d, 3) if (std::fabs(lockU[v][d]) > 0)FOR(c, 2) {
+			locked[6 * v + 2 * d + c] = true;
+			value[6 * v + 2 * d + c] = double(1 - c);
 		}
 
+		index_t nb_threads = 1;
+#ifdef GEO_OPENMP
+		nb_threads = index_t(omp_get_max_threads());
+#endif
+		vector<vector<double> > thread_rhs(nb_threads);
+
+		NLContext context = nlNewContext();
+		nlSolverParameteri(NL_NB_VARIABLES, NLint(nvars));
+		nlSolverParameteri(NL_ASSEMBLY_THREADS, NLint(nb_threads));
+		// Note: the multigrid preconditioner (with 6 components) is much
+		// slower here, Jacobi-preconditioned CG converges in a few iterations
+		nlSolverParameteri(NL_SOLVER, NL_CG);
+		nlSolverParameteri(NL_PRECONDITIONER, NL_PRECOND_JACOBI);
+
+		nlBegin(NL_SYSTEM);
 		nlBegin(NL_MATRIX);
-		FOR(e, m->edges.nb()) {
-			AxisPermutation ap = Rij(m, B, m->edges.vertex(e, 0), m->edges.vertex(e, 1));
-
-			vec3 theta = wish_angle(e, false);
-			FOR(d, 3) {
-				double c = cos(theta[d]);
-				double s = sin(theta[d]);
-				index_t off0 = 6 * m->edges.vertex(e, 0) + 2 * d;
-
-				nlBegin(NL_ROW);
-				FOR(dd, 3)  if (ap.get_mat()(dd, d) != 0)
-					nlCoefficient(6 * m->edges.vertex(e, 1) + 2 * dd, -1.);
-				nlCoefficient(off0, c);
-				nlCoefficient(off0 + 1, s);
-				nlEnd(NL_ROW);
-				nlBegin(NL_ROW);
-				FOR(dd, 3)
-					nlCoefficient(6 * m->edges.vertex(e, 1) + 2 * dd + 1, -ap.get_mat()(dd, d));
-				nlCoefficient(off0, -s);
-				nlCoefficient(off0 + 1, c);
-				nlEnd(NL_ROW);
+		FOR(i, nvars) if (locked[i]) nlThreadAddIJCoefficient(0, NLuint(i), NLuint(i), 1.);
+
+#ifdef GEO_OPENMP
+#pragma omp parallel
+#endif
+		{
+			index_t thread = 0;
+#ifdef GEO_OPENMP
+			thread = index_t(omp_get_thread_num());
+#endif
+			// the current OpenNL context is thread-local
+			nlMakeCurrent(context);
+			vector<double>& rhs = thread_rhs[thread];
+			rhs.assign(nvars, 0.);
+			get_thread_range(m->edges.nb(), start, end);
+			for (index_t e = start; e < end; e++) {
+				AxisPermutation ap = Rij(m, B, m->edges.vertex(e, 0), m->edges.vertex(e, 1));
+
+				vec3 theta = wish_angle(e, false);
+				FOR(d, 3) {
+					double c = cos(theta[d]);
+					double s = sin(theta[d]);
+					index_t off0 = 6 * m->edges.vertex(e, 0) + 2 * d;
+					index_t var[3];
+					double coeff[3];
+
+					index_t nb = 0;
+					FOR(dd, 3)  if (ap.get_mat()(dd, d) != 0) {
+						var[nb] = 6 * m->edges.vertex(e, 1) + 2 * dd;
+						coeff[nb++] = -1.;
+					}
+					var[nb] = off0;		coeff[nb++] = c;
+					var[nb] = off0 + 1;	coeff[nb++] = s;
+					add_row_to_normal_equations(thread, nb, var, coeff, locked, value, rhs);
+
+					nb = 0;
+					FOR(dd, 3) if (ap.get_mat()(dd, d) != 0) {
+						var[nb] = 6 * m->edges.vertex(e, 1) + 2 * dd + 1;
+						coeff[nb++] = -ap.get_mat()(dd, d);
+					}
+					var[nb] = off0;		coeff[nb++] = -s;
+					var[nb] = off0 + 1;	coeff[nb++] = c;
+					add_row_to_normal_equations(thread, nb, var, coeff, locked, value, rhs);
+				}
 			}
+			// the context is deleted below, worker threads should not
+			// keep a dangling pointer to it
+			nlMakeCurrent(NULL);
+		}
+		nlMakeCurrent(context);
+
+		FOR(i, nvars) {
+			double b = locked[i] ? value[i] : 0.;
+			FOR(t, nb_threads) if (!thread_rhs[t].empty()) b += thread_rhs[t][i];
+			if (b != 0.) nlAddIRightHandSide(NLuint(i), b);
 		}
 
 		nlEnd(NL_MATRIX);
 		nlEnd(NL_SYSTEM);
 		// Solve and get solution
+		logt.add_step("solve");
 		nlSolve();
 
-		FOR(v, m->vertices.nb())  FOR(d, 3)
-			U[v][d] = (.5 / M_PI) *  atan2(nlGetVariable(6 * v + 2 * d + 1), nlGetVariable(6 * v + 2 * d));
+		logt.add_step("extract U");
+		vector<double> X(nvars);
+		FOR(i, nvars) X[i] = nlGetVariable(NLuint(i));
+		nlDeleteContext(context);
 
-		nlDeleteContext(nlGetCurrent());
+#ifdef GEO_OPENMP
+#pragma omp parallel
+#endif
+		{
+			get_thread_range(nverts, start, end);
+			for (index_t v = start; v < end; v++) FOR(d, 3)
+				U[v][d] = (.5 / M_PI) *  atan2(X[6 * v + 2 * d + 1], X[6 * v + 2 * d]);
+		}
 
 //		snap_U_to_round();
 
-		FOR(e, m->edges.nb()) {
-			index_t i = m->edges.vertex(e, 0);
-			index_t j = m->edges.vertex(e, 1);
-			AxisPermutation rij = Rij(m, B, i, j);
+#ifdef GEO_OPENMP
+#pragma omp parallel
+#endif
+		{
+			get_thread_range(m->edges.nb(), start, end);
+			for (index_t e = start; e < end; e++) {
+				index_t i = m->edges.vertex(e, 0);
+				index_t j = m->edges.vertex(e, 1);
+				AxisPermutation rij = Rij(m, B, i, j);
 
-			vec3 gij = wish_angle(e, false) / (2.*M_PI);
+				vec3 gij = wish_angle(e, false) / (2.*M_PI);
 
-			FOR(d, 3) {
-				tij[e][d] = int(round(-(rij.inverse().get_mat()*U[j])[d] - gij[d] + U[i][d]));
+				FOR(d, 3) {
+					tij[e][d] = int(round(-(rij.inverse().get_mat()*U[j])[d] - gij[d] + U[i][d]));
+				}
 			}
-
 		}
+
+		logt.add_step("move U to corners");
 		move_U_to_corner();
+		logt.end_section();
 	}
 
 
@@ -464,8 +589,20 @@ namespace GEO {
 	void PGPopt::grow_ball(Attribute<bool>& tet_in_ball) {
 
 		vector<bool> touched(m->vertices.nb(), false);
-		vector<bool> tet_is_singular(m->cells.nb(), false);
-		FOR(c, m->cells.nb()) FOR(lf, 4) tet_is_singular[c] = tet_is_singular[c] || triangle_is_frame_singular(m, B, c, lf);
+		// vector<bool> packs bits: threads that write neighboring tets would
+		// share words, thus one byte per tet, each written once by its thread
+		vector<Numeric::uint8> tet_is_singular(m->cells.nb(), 0);
+#ifdef GEO_OPENMP
+#pragma omp parallel
+#endif
+		{
+			get_thread_range(m->cells.nb(), start, end);
+			for (index_t c = start; c < end; c++) {
+				bool singular = false;
+				FOR(lf, 4) singular = singular || triangle_is_frame_singular(m, B, c, lf);
+				tet_is_singular[c] = singular ? 1 : 0;
+			}
+		}
 
 		FOR(c, m->cells.nb()) tet_in_ball[c] = false;
 		FOR(seed, m->cells.nb()) {
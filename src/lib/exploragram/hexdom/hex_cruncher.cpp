@@ -1629,7 +1629,7 @@ namespace GEO {
 					plop(poly.length());
 					plop(ave_edge_length);
 					index_t nb_seg = index_t(2.0 * nint(0.5*poly.length() / ave_edge_length));
-					nb_seg = geo_max(1u, nb_seg);
+					nb_seg = geo_max(index_t(1), nb_seg);
 					//FOR(s, nb_seg) l_pts.push_back(poly.interpolate(double(s + 1) / double(nb_seg) - .001));
 					
 					FOR(s, nb_seg - 1) plop(poly.interpolate(double(s + 1) / double(nb_seg) - .001));
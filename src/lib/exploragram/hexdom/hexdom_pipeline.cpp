@@ -82,11 +82,14 @@ namespace GEO {
 			return true;
 		}
 
-		void FrameField(Mesh*m, bool smooth) {
+		void FrameField(Mesh*m, bool smooth, bool gauss_seidel) {
 			GEO::FFopt ffopt(m);
 			STEP(ffopt.FF_init,(true));
-			if (smooth) 
+			if (smooth && gauss_seidel) {
+				STEP(ffopt.FF_smooth_GS,());
+			} else if (smooth) {
 				STEP(ffopt.FF_smooth,());
+			}
 			STEP(ffopt.compute_Bid_norm,());
 			//uncomment may ease debugging...  STEP(ffopt.brush_frame,());
 		}
@@ -51,7 +51,9 @@ namespace GEO {
         bool EXPLORAGRAM_API SetConstraints(Mesh*m, std::string& msg, bool hilbert_sort = true,
                 bool relaxed = false);
 	
-        void EXPLORAGRAM_API FrameField(Mesh*m, bool smooth);
+        // if gauss_seidel is set, smoothing uses parallel Gauss-Seidel iterations instead of LBFGS
+        // (slower than LBFGS, off by default)
+        void EXPLORAGRAM_API FrameField(Mesh*m, bool smooth, bool gauss_seidel = false);
 
         //{algo} = {0: CubeCover, 1 : PGP with correction, 2 PGP}
         void EXPLORAGRAM_API Parameterization(Mesh*m, int algo=0, double PGP_max_scale_corr =0.3);
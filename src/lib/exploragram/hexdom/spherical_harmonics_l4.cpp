@@ -124,11 +124,32 @@ namespace GEO {
     }
 
 
+    namespace {
+        /**
+         * \brief The initial guesses of the projection onto frames.
+         * \details They do not depend on the projected coefficients,
+         *  they are computed once for all.
+         */
+        struct ProjectionSeeds {
+            ProjectionSeeds() {
+                rot[0] = vec3(0, 0, 0);
+                rot[1] = vec3(M_PI / 4., 0, 0);
+                rot[2] = vec3(0, M_PI / 4., 0);
+                rot[3] = vec3(0, 0, M_PI / 4.);
+                rot[4] = vec3(M_PI / 4., 0, M_PI / 4.);
+                FOR(i,5) {
+                    harmonics[i] = SphericalHarmonicL4::rest_frame();
+                    harmonics[i].euler_rot(rot[i]);
+                }
+            }
+            vec3 rot[5];
+            SphericalHarmonicL4 harmonics[5];
+        };
+
+        const ProjectionSeeds seeds;
+    }
+
     mat3 SphericalHarmonicL4::project_mat3(double grad_threshold, double dot_threshold, vec3* euler_prev) {
-        SphericalHarmonicL4 init_harmonics[5] = { rest_frame(),rest_frame(),rest_frame(),rest_frame(),rest_frame() };
-        vec3 init_rot[5] = { vec3(0, 0, 0),vec3(M_PI / 4., 0, 0),vec3(0, M_PI / 4., 0),vec3(0, 0, M_PI / 4.),vec3(M_PI / 4., 0, M_PI / 4.)};
-        FOR(i,5) init_harmonics[i].euler_rot(init_rot[i]);
-        
         mat3 W;
         SphericalHarmonicL4 v;
         double dot = -1.;
@@ -138,7 +159,7 @@ namespace GEO {
 
 
         if (euler_prev) {
-            SphericalHarmonicL4 prev_seed = init_harmonics[0];
+            SphericalHarmonicL4 prev_seed = seeds.harmonics[0];
 
             prev_seed.euler_rot(*euler_prev);
             double tdot = prev_seed*query;
@@ -150,17 +171,42 @@ namespace GEO {
             }
         }
 
+        select_seed(query, W, v, dot);
+        descend(query, W, v, dot, grad_threshold, dot_threshold);
+        return W;
+    }
+
+    void SphericalHarmonicL4::project_mat3(
+        mat3& W, SphericalHarmonicL4& sh,
+        double grad_threshold, double dot_threshold
+    ) const {
+        SphericalHarmonicL4 query = *this;
+        query = query / query.norm();
+        double dot = sh*query;
+        select_seed(query, W, sh, dot);
+        descend(query, W, sh, dot, grad_threshold, dot_threshold);
+    }
 
+    void SphericalHarmonicL4::select_seed(
+        const SphericalHarmonicL4& query,
+        mat3& W, SphericalHarmonicL4& v, double& dot
+    ) {
         FOR(i,5) {
-            double tdot = init_harmonics[i] * query;
+            double tdot = seeds.harmonics[i] * query;
             if (tdot>dot) {
                 dot = tdot;
  
-                W = euler_to_mat3(init_rot[i]);
-                v = init_harmonics[i];
+                W = euler_to_mat3(seeds.rot[i]);
+                v = seeds.harmonics[i];
             }
         }
+    }
 
+    void SphericalHarmonicL4::descend(
+        const SphericalHarmonicL4& query,
+        mat3& W, SphericalHarmonicL4& v, double dot,
+        double grad_threshold, double dot_threshold
+    ) {
         int cnt = 0;
         double olddot = dot;
         while (cnt < 10000) {
@@ -177,9 +223,6 @@ namespace GEO {
             olddot = dot;
         }
         if (cnt == 10000) GEO::Logger::out("HexDom")  << "[error] SH projection infinite loop protection" <<  std::endl;
-  
-        return W;
     }
-
 }
 
@@ -137,6 +137,15 @@ namespace GEO {
 	    
         mat3 project_mat3(double grad_threshold = 1e-3, double dot_threshold = 1e-5, vec3* euler_prev = NULL);
 
+        // same as above, starting from the frame W (a rotation) with spherical
+        // harmonics sh, that are both replaced with the result. Used by iterative
+        // smoothers, that do not need to go through Euler angles.
+        void project_mat3(mat3& W, SphericalHarmonicL4& sh, double grad_threshold = 1e-3, double dot_threshold = 1e-5) const;
+
+    protected:
+        static void select_seed(const SphericalHarmonicL4& query, mat3& W, SphericalHarmonicL4& v, double& dot);
+        static void descend(const SphericalHarmonicL4& query, mat3& W, SphericalHarmonicL4& v, double dot, double grad_threshold, double dot_threshold);
+
     };
 
     inline std::istream& operator>> (std::istream& input, SphericalHarmonicL4 &gna) {
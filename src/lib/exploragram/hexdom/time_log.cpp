@@ -39,13 +39,14 @@
  */
 
 #include <exploragram/hexdom/time_log.h>
+#include <geogram/basic/profiler.h>
 
 LogTime logt ; 
 
 bool LogTime::is_start_section(unsigned int i)   { return check[i].right != i + 1; }
 bool LogTime::is_end_section(unsigned int i)             { return check[i].n == "end section"; }
 bool LogTime::is_final(unsigned int i)                   { return i + 1 == check.size(); }
-double LogTime::time(unsigned int i)                             { return double(check[check[i].right].t - check[i].t) / double(CLOCKS_PER_SEC); }
+double LogTime::time(unsigned int i)                             { return check[check[i].right].t - check[i].t; }
 
 
 unsigned int LogTime::dec(unsigned int i){
@@ -109,7 +110,7 @@ void LogTime::report(std::ostream &out, unsigned int timing_depth){
                         }
                 }
         
-                out << double(check[check.size() - 1].t - check[0].t) / double(CLOCKS_PER_SEC) << "\tTOTAL" << std::endl;
+                out << check[check.size() - 1].t - check[0].t << "\tTOTAL" << std::endl;
         }
         out << "\n***********************************************************" << std::endl;
         out << "                  OUPUT VALUES" << std::endl;
@@ -137,7 +138,7 @@ void LogTime::report_py(std::ostream &out, unsigned int timing_depth){
                         }
                 }
 
-                //out << "\ttest[\'TIME_TOTAL\'] = " << double(check[check.size() - 1].t - check[0].t) / double(CLOCKS_PER_SEC) << std::endl;
+                //out << "\ttest[\'TIME_TOTAL\'] = " << check[check.size() - 1].t - check[0].t << std::endl;
         }
         for (size_t i = 0; i < out_values.size(); i++)
             out << ", \"" << out_values[i].first << "\": " << out_values[i].second ;
@@ -157,6 +158,9 @@ void LogTime::report_py(std::ostream &out, unsigned int timing_depth){
 void LogTime::add_value(std::string str, double val) {
     GEO::Logger::out("HexDom")  << "log new value : " << str<< post_fix << " = " << val <<  std::endl;
     out_values.push_back(std::pair<std::string, double>(str+ post_fix, val));
+    if (GEO::Profiler::enabled()) {
+        GEO::Profiler::counter(GEO::Profiler::name_id(str + post_fix), val);
+    }
 }
 void LogTime::add_string(std::string str , std::string val) {
     GEO::Logger::out("HexDom")  << "log new string  : " << str << post_fix << " = " << val <<  std::endl;
@@ -173,6 +177,7 @@ void LogTime::add_step(const std::string& name){
                 check.back().right = (unsigned int)(check.size());
                 check.push_back(c);
         }
+        profile_step(check.back().n);
         const char *symbol = "#>=_-~..............";
         GEO::Logger::out("HexDom")  << std::endl << std::string(4 * lastdec(), ' ') << std::string(80 - 4 * lastdec(), symbol[dec()]) <<  std::endl;
         GEO::Logger::out("HexDom")  << std::string(4 * lastdec() + 4, ' ') << cur_stack() << std::endl <<  std::endl;
@@ -182,6 +187,8 @@ void LogTime::start_section(const std::string& secname, const std::string& name
         add_step(secname + post_fix);
         CheckPoint c(name + post_fix, (unsigned int)(check.size()) - 1);
         check.push_back(c);
+        profile_spans.push_back(false);
+        if (name != "begin section") profile_step(c.n);
 }
 void LogTime::end_section(){
         unsigned int u = check.back().up;
@@ -189,6 +196,24 @@ void LogTime::end_section(){
         check.back().right = (unsigned int)(check.size());
         CheckPoint c("end section", check[u].up);
         check.push_back(c);
+        if (!profile_spans.empty()) {
+                if (profile_spans.back()) GEO::Profiler::end_span();
+                profile_spans.pop_back();
+        }
+        if (!profile_spans.empty() && profile_spans.back()) {
+                GEO::Profiler::end_span();
+                profile_spans.back() = false;
+        }
+}
+
+void LogTime::profile_step(const std::string& name){
+        if (profile_spans.empty()) profile_spans.push_back(false);
+        if (profile_spans.back()) GEO::Profiler::end_span();
+        // "the end" is added by report(), it does not start a new step
+        profile_spans.back() = GEO::Profiler::enabled() && name != "the end" + post_fix;
+        if (profile_spans.back()) {
+                GEO::Profiler::begin_span(GEO::Profiler::name_id(name));
+        }
 }
 
 
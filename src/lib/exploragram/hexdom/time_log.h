@@ -41,17 +41,20 @@
 #define H_HEXDOM_ALGO_TIME_LOG_H
 
 #include <exploragram/basic/common.h>
+#include <geogram/basic/stopwatch.h>
 #include <string>
 #include <iostream>
 #include <vector>
-#include <time.h> 
 #include <fstream>
 
 /**
  * LogTime reports a hierarchical execution pipeline:
  *	A logger outputs the steps during execution
- *	It summarizes execution time in each step
+ *	It summarizes execution time in each step (wall clock time, so that
+ *	multithreaded steps are not accounted for the sum over all threads)
  *	It outputs important values (stats) at the end of the execution
+ *	Steps and sections are also recorded as spans, and values as counters,
+ *	by the geogram Profiler (see profile:xxx command line arguments)
  */
 
 struct EXPLORAGRAM_API LogTime {
@@ -109,9 +112,9 @@ struct EXPLORAGRAM_API LogTime {
      * "right" is the next item at the same level
      */
     struct CheckPoint{
-	CheckPoint(const std::string& p_n, unsigned int p_up){ n = p_n; up = p_up; t = clock(); right = (unsigned int)(-1); }
+	CheckPoint(const std::string& p_n, unsigned int p_up){ n = p_n; up = p_up; t = GEO::SystemStopwatch::now(); right = (unsigned int)(-1); }
 	std::string n;
-	clock_t t;
+	double t;
 	unsigned int right;
 	unsigned int up;
     };
@@ -126,10 +129,21 @@ struct EXPLORAGRAM_API LogTime {
     std::string cur_stack();
     void report(std::ostream &out, unsigned int timing_depth = 10000);
     void report_py(std::ostream &out, unsigned int timing_depth = 10000);
+
+    /**
+     * ends the span of the current step (if any) and starts a new one
+     * in the Profiler
+     */
+    void profile_step(const std::string& name);
 	
 private:
 	std::string post_fix;
     std::vector<CheckPoint> check;
+    /**
+     * for each opened section level, whether a Profiler span is opened
+     * for the current step
+     */
+    std::vector<bool> profile_spans;
     std::vector<std::pair<std::string, double> > out_values;
     std::vector<std::pair<std::string, std::string> > out_strings;
 };
@@ -62,6 +62,10 @@
 #include <geogram/basic/command_line.h>
 
 #include <geogram/NL/nl.h>
+#include <geogram/NL/nl_matrix.h>
+#include <geogram/NL/nl_preconditioners.h>
+#include <geogram/NL/nl_iterative_solvers.h>
+#include <geogram/basic/stopwatch.h>
 
 #include <geogram/bibliography/bibliography.h>
 
@@ -113,6 +117,7 @@ namespace GEO {
         total_mass_ = 0.0;
         current_call_iter_ = 0;
         epsilon_ = 0.01;
+        coarse_levels_epsilon_ = 0.0;
         level_ = 0;
         
         save_RVD_iter_ = false;
@@ -141,11 +146,24 @@ namespace GEO {
 	air_fraction_ = 0.0;
 
 	clip_by_balls_ = false;
+
+	Hessian_COO_ = nil;
+	Hessian_ = nil;
+	Hessian_nb_triplets_ = 0;
+	linsolve_x_ = nil;
+	power_diagram_time_ = 0.0;
+	RVD_time_ = 0.0;
+	Hessian_time_ = 0.0;
+	solve_time_ = 0.0;
     }
 
     OptimalTransportMap::~OptimalTransportMap() {
 	delete callback_;
 	callback_ = nil;
+	nlDeleteMatrix(Hessian_COO_);
+	Hessian_COO_ = nil;
+	nlDeleteMatrix(Hessian_);
+	Hessian_ = nil;
     }
     
     void OptimalTransportMap::set_points(
@@ -225,6 +243,11 @@ namespace GEO {
 	    }
             xk=weights_;
 
+	    power_diagram_time_ = 0.0;
+	    RVD_time_ = 0.0;
+	    Hessian_time_ = 0.0;
+	    solve_time_ = 0.0;
+	    
             new_linear_system(n,pk.data());
             eval_func_grad_Hessian(n,xk.data(),fk,gk.data());
             
@@ -327,6 +350,16 @@ namespace GEO {
 		first_inner_iter = 0;
 	    }
 	    
+	    if(verbose_) {
+		Logger::out("OTM")
+		    << "Newton iter " << k << " times (s):"
+		    << " power diagram=" << power_diagram_time_
+		    << " RVD=" << RVD_time_
+		    << " Hessian=" << Hessian_time_
+		    << " solve=" << solve_time_
+		    << std::endl;
+	    }
+	    
             newiteration();
             if(converged) {
                 break;
@@ -431,27 +464,26 @@ namespace GEO {
 	    
             NN->set_points(b, points_dimp1_.data(), dimp1_);
             index_t degree = 2; // CmdLine::get_arg_uint("fitting_degree");
+            LinearLeastSquares LLS(degree);
+
+            //   Number of samples of the previous levels used to estimate
+            // the weight of a new sample (the first level may have fewer
+            // samples than that).
+            const index_t nb_fit = 10 * degree;
+            const index_t nb = geo_min(nb_fit, b);
+            index_t neighbor[100];
+            double dist[100];
             
-            // If degree \notin {1,2}, use weight of nearest sample
-            if(degree < 1 || degree > 2) {
-                for(index_t i = b; i < e; ++i) {
-                    weights_[i] =
-                        weights_[
-                            NN->get_nearest_neighbor(&points_dimp1_[dimp1_ * i])
-                        ];
-                }
-            } else {
-                
-                //   If degree \in {1,2} use linear least squares to
-                // compute an estimate of the weight function.
-                LinearLeastSquares LLS(degree);
-                for(index_t i = b; i < e; ++i) {
-                    const index_t nb = 10 * degree;
-                    index_t neighbor[100];
-                    double dist[100];
-                    NN->get_nearest_neighbors(
-                        nb, &points_dimp1_[dimp1_ * i], neighbor, dist
-                    );
+            for(index_t i = b; i < e; ++i) {
+                const double* p = &points_dimp1_[dimp1_ * i];
+                NN->get_nearest_neighbors(nb, p, neighbor, dist);
+
+                // Weight of the nearest sample of the previous levels.
+                weights_[i] = weights_[neighbor[0]];
+
+                //   If there are enough samples, refine the estimate
+                // with a low-degree fit of the weight function.
+                if(nb == nb_fit) {
                     LLS.begin();
                     for(index_t jj = 0; jj < nb; ++jj) {
                         if(dist[jj] != 0.0) {
@@ -462,7 +494,7 @@ namespace GEO {
                         }
                     }
                     LLS.end();
-                    weights_[i] = LLS.eval(&points_dimp1_[dimp1_ * i]);
+                    weights_[i] = LLS.eval(p);
                 }
             }
         }
@@ -476,6 +508,9 @@ namespace GEO {
         constant_nu_ = total_mass_ / double(n);
 
         if(newton_) {
+            if(b != 0) {
+                make_cells_non_empty(n);
+            }
             optimize_full_Newton(max_iterations, n);
             return;
         }
@@ -504,6 +539,45 @@ namespace GEO {
         funcgrad(n, weights_.data(), dummy, nil);
     }
 
+    void OptimalTransportMap::make_cells_non_empty(index_t n) {
+        // With all weights set to zero, the Laguerre cells are the
+        // Voronoi cells, that are all non-empty. The weights are shrunk
+        // towards zero until there is no empty cell. Each try costs a
+        // full RVD traversal, hence the small number of halvings.
+        const index_t max_halvings = 3;
+        vector<double> g(n);
+        double f = 0.0;
+        vector<double> w0(weights_);
+        double s = 1.0;
+        for(index_t k=0; k<=max_halvings; ++k) {
+            w_did_not_change_ = false;
+            funcgrad(n, weights_.data(), f, g.data());
+            if(nbZ_ == 0) {
+                if(verbose_) {
+                    Logger::out("OTM") << "Non-empty cells after "
+                                       << k << " halving(s)" << std::endl;
+                }
+                break;
+            }
+            s *= 0.5;
+            for(index_t i=0; i<n; ++i) {
+                weights_[i] = s * w0[i];
+            }
+        }
+        if(nbZ_ != 0) {
+            // Still some empty cells after shrinking the weights:
+            // restart from the Voronoi diagram.
+            Logger::warn("OTM") 
+                << nbZ_ << " empty cell(s) remaining, resetting the weights"
+                << std::endl;
+            for(index_t i=0; i<n; ++i) {
+                weights_[i] = 0.0;
+            }
+            w_did_not_change_ = false;
+            funcgrad(n, weights_.data(), f, g.data());
+        }
+    }
+
     void OptimalTransportMap::optimize_levels(
         const vector<index_t>& levels, index_t max_iterations
     ) {
@@ -524,7 +598,14 @@ namespace GEO {
                 brio_levels.push_back(levels[i]);
             }
             RVD_->delaunay()->set_BRIO_levels(brio_levels);
+            // The intermediate levels only provide an initialization
+            // for the next ones, they can use a looser threshold.
+            double epsilon = epsilon_;
+            if(l + 2 < levels.size() && coarse_levels_epsilon_ != 0.0) {
+                epsilon_ = coarse_levels_epsilon_;
+            }
             optimize_level(b, e, max_iterations);
+            epsilon_ = epsilon;
         }
         if(save_RVD_last_iter_) {
             save_RVD(current_iter_);
@@ -611,7 +692,9 @@ namespace GEO {
 			Logger::out("OTM") << "In power diagram..." << std::endl;
 		    }
 		}
+		double start = SystemStopwatch::now();
                 delaunay_->set_vertices((n + nb_air_particles_), points_dimp1_.data());
+		power_diagram_time_ += SystemStopwatch::now() - start;
 		if(verbose_ && newton_) {
 		    delete SW;
 		}
@@ -651,7 +734,9 @@ namespace GEO {
 		W = new Stopwatch("RVD");
 		Logger::out("OTM") << "In RVD (funcgrad)..." << std::endl;
 	    }
+	    double start = SystemStopwatch::now();
 	    call_callback_on_RVD();
+	    RVD_time_ += SystemStopwatch::now() - start;
 	    if(verbose_ && newton_) {
 		delete W;
 	    }
@@ -816,68 +901,120 @@ namespace GEO {
     
     void OptimalTransportMap::update_sparsity_pattern() {
         // Does nothing for now,
-	// (we let OpenNL discover the sparsity pattern)
+	// (the sparsity pattern is discovered from the assembled
+	//  coefficients, and kept as long as it does not change,
+	//  see solve_linear_system())
 	// Tryed smarter things, but was not faster...
     }
 
     void OptimalTransportMap::new_linear_system(index_t n, double* x) {
-        nlNewContext();
-            
+	// The Hessian is accumulated in one buffer per thread, merged
+	// and sorted once the RVD is traversed by solve_linear_system().
+	NLuint nb_threads = NLuint(Process::maximum_concurrent_threads());
+	NLCOOMatrix* COO = (NLCOOMatrix*)Hessian_COO_;
+	if(COO == nil || COO->m != NLuint(n) || COO->nb_buffers < nb_threads) {
+	    nlDeleteMatrix(Hessian_COO_);
+	    Hessian_COO_ = nlCOOMatrixNew(NLuint(n), NLuint(n), nb_threads);
+	} else {
+	    nlCOOMatrixZero(COO);
+	}
+	rhs_.assign(n, 0.0);
+	linsolve_x_ = x;
+    }
+
+    void OptimalTransportMap::solve_linear_system() {
+	index_t n = rhs_.size();
+	
+	// Compress the Hessian, keeping the sparsity pattern of the
+	// previous Newton step if it contains the new one (only the
+	// coefficients are updated then). When the Laguerre diagram
+	// changes, the number of triplets changes as well in general,
+	// then the pattern is rebuilt directly, to avoid sorting the
+	// triplets twice.
+	double start = SystemStopwatch::now();
+	NLCOOMatrix* COO = (NLCOOMatrix*)Hessian_COO_;
+	NLuint nb_triplets = nlCOOMatrixNNZ(COO);
+	bool pattern_reused = (
+	    Hessian_ != nil && Hessian_->m == NLuint(n) &&
+	    nb_triplets == Hessian_nb_triplets_ &&
+	    nlCRSMatrixUpdateFromCOOMatrix((NLCRSMatrix*)Hessian_, COO)
+	);
+	if(!pattern_reused) {
+	    nlDeleteMatrix(Hessian_);
+	    Hessian_ = nlCRSMatrixNewFromCOOMatrix(COO);
+	}
+	Hessian_nb_triplets_ = nb_triplets;
+	Hessian_time_ += SystemStopwatch::now() - start;
+	if(verbose_) {
+	    std::cerr << "   Hessian: "
+		      << nlCRSMatrixNNZ((NLCRSMatrix*)Hessian_) << " nnz, "
+		      << (pattern_reused ? "pattern reused" : "new pattern")
+		      << std::endl;
+	}
+
+	start = SystemStopwatch::now();
         if(use_direct_solver_) {
-            use_direct_solver_ = (
-		use_direct_solver_ && (nlInitExtension("SUPERLU") == NL_TRUE)
+	    solve_linear_system_direct();
+	}
+	if(!use_direct_solver_) {
+	    NLMatrix P = nlNewJacobiPreconditioner(Hessian_);
+	    NLuint used_iters = nlSolveSystemIterative(
+		nlHostBlas(), Hessian_, P, rhs_.data(), linsolve_x_,
+		NL_CG, linsolve_epsilon_, NLuint(linsolve_maxiter_), 0
 	    );
-	    if(!use_direct_solver_) {
-		Logger::warn("OTM") << "Could not initialize SUPERLU OpenNL extension"
-				    << std::endl;
-		Logger::warn("OTM") << "Falling back to conjugate gradient"
-				    << std::endl;
+	    nlDeleteMatrix(P);
+	    if(verbose_) {
+		vector<double> r(n);
+		nlMultMatrixVector(Hessian_, linsolve_x_, r.data());
+		double rnorm = 0.0;
+		double bnorm = 0.0;
+		for(index_t i=0; i<n; ++i) {
+		    rnorm += geo_sqr(r[i] - rhs_[i]);
+		    bnorm += geo_sqr(rhs_[i]);
+		}
+		std::cerr << "   "
+			  << used_iters << " iters in "
+			  << (SystemStopwatch::now() - start) << " seconds "
+			  << "  ||Ax-b||/||b||="
+			  << ((bnorm == 0.0) ? 0.0 : ::sqrt(rnorm / bnorm))
+			  << std::endl;
 	    }
-        }
+	}
+	solve_time_ += SystemStopwatch::now() - start;
+    }
 
+    void OptimalTransportMap::solve_linear_system_direct() {
+	index_t n = rhs_.size();
+	NLContext context = nlNewContext();
+	use_direct_solver_ = (nlInitExtension("SUPERLU") == NL_TRUE);
+	if(!use_direct_solver_) {
+	    Logger::warn("OTM") << "Could not initialize SUPERLU OpenNL extension"
+				<< std::endl;
+	    Logger::warn("OTM") << "Falling back to conjugate gradient"
+				<< std::endl;
+	    nlDeleteContext(context);
+	    return;
+	}
 	if(verbose_) {
 	    nlEnable(NL_VERBOSE);
 	}
-	
         nlSolverParameteri(NL_NB_VARIABLES, NLint(n));
-        if(use_direct_solver_) {
-            nlSolverParameteri(NL_SOLVER, NL_PERM_SUPERLU_EXT);
-        } else {
-            nlSolverParameteri(NL_SOLVER, NL_CG);
-            nlSolverParameteri(NL_PRECONDITIONER, NL_PRECOND_JACOBI);
-            nlSolverParameteri(NL_SYMMETRIC, NL_TRUE);
-            nlSolverParameterd(NL_THRESHOLD, linsolve_epsilon_);
-            nlSolverParameteri(NL_MAX_ITERATIONS, NLint(linsolve_maxiter_));                
-        }
-
+	nlSolverParameteri(NL_SOLVER, NL_PERM_SUPERLU_EXT);
 	nlEnable(NL_VARIABLES_BUFFER);
         nlBegin(NL_SYSTEM);
-	nlBindBuffer(NL_VARIABLES_BUFFER, 0, x, NLuint(sizeof(double)));
+	nlBindBuffer(NL_VARIABLES_BUFFER, 0, linsolve_x_, NLuint(sizeof(double)));
         nlBegin(NL_MATRIX);
-    }
-
-    void OptimalTransportMap::solve_linear_system() {
+	const NLCRSMatrix* H = (const NLCRSMatrix*)Hessian_;
+	for(index_t i=0; i<n; ++i) {
+	    for(NLuint k=H->rowptr[i]; k<H->rowptr[i+1]; ++k) {
+		nlAddIJCoefficient(NLuint(i), H->colind[k], H->val[k]);
+	    }
+	    nlAddIRightHandSide(NLuint(i), rhs_[i]);
+	}
         nlEnd(NL_MATRIX);
         nlEnd(NL_SYSTEM);
         nlSolve();
-        if(verbose_) {
-            int used_iters;
-            double elapsed_time;
-            double gflops;
-            double error;
-            nlGetIntegerv(NL_USED_ITERATIONS, &used_iters);
-            nlGetDoublev(NL_ELAPSED_TIME, &elapsed_time);
-            nlGetDoublev(NL_GFLOPS, &gflops);
-            nlGetDoublev(NL_ERROR, &error);
-	    std::cerr << "   "
-		      << used_iters << " iters in "
-		      << elapsed_time << " seconds "
-		      << gflops << " GFlop/s"
-		      << "  ||Ax-b||/||b||="
-		      << error
-		      << std::endl;
-	}
-        nlDeleteContext(nlGetCurrent());
+        nlDeleteContext(context);
     }
     
     /**********************************************************************/
@@ -45,6 +45,8 @@
 #include <geogram/voronoi/RVD.h>
 #include <geogram/delaunay/delaunay.h>
 #include <geogram/NL/nl.h>
+#include <geogram/NL/nl_matrix.h>
+#include <geogram/basic/process.h>
 #include <geogram/third_party/HLBFGS/HLBFGS.h>
 
 /**
@@ -201,6 +203,19 @@ namespace GEO {
             epsilon_ = eps;
         }
 
+        /**
+         * \brief Sets the maximum error for the intermediate levels
+         *  of optimize_levels().
+         * \details The intermediate levels are only used to initialize
+         *  the next ones, and can be solved with a looser threshold.
+         * \param eps acceptable relative deviation for the measure of a
+         *   Laguerre cell in the intermediate levels, or 0 to use the
+         *   same value as in set_epsilon().
+         */
+        void set_coarse_levels_epsilon(double eps) {
+            coarse_levels_epsilon_ = eps;
+        }
+
 
 	/**
 	 * \brief Sets the tolerance for linear solve.
@@ -308,11 +323,28 @@ namespace GEO {
          */
         void optimize_level(index_t b, index_t e, index_t max_iterations);
 
+        /**
+         * \brief Makes sure that all the Laguerre cells are non-empty
+         *  before starting Newton's algorithm.
+         * \details The weights transferred from the previous levels may
+         *  result in empty cells, that Newton's algorithm cannot handle.
+         *  The weights are then shrunk towards zero (Voronoi diagram)
+         *  until all the cells are non-empty. If there are still empty
+         *  cells after three halvings, all the weights are reset to zero.
+         * \param[in] n number of weights to consider
+         */
+        void make_cells_non_empty(index_t n);
+
         /**
          * \brief Multi-level optimization.
          * \details The points specified by set_points() need to have
          *   a hierarchical structure. They can be constructed by
-         *   compute_hierarchical_sampling().
+         *   compute_hierarchical_sampling(). The weights of the samples
+         *   of each level are initialized from the previous levels (weight
+         *   of the nearest sample, refined by a least-squares fit), then
+         *   optimized. Each level rebuilds its Delaunay triangulation and,
+         *   with Newton, its linear systems: only the weights are
+         *   transferred from one level to the next.
          * \param[in] levels sample indices that correspond to level l are
          *   in the range levels[l] (included) ... levels[l+1] (excluded)
          * \param[in] max_iterations maximum number of iterations
@@ -456,20 +488,34 @@ namespace GEO {
 
         /**
          * \brief Adds a coefficient to the matrix of the system.
+	 * \details Each thread accumulates its coefficients in its
+	 *  own buffer, thus this function can be called concurrently by
+	 *  the threads that compute the RVD, without any lock.
          * \param[in] i , j the indices of the coefficient
          * \param[in] a the value to be added to the coefficient
          */
         void add_ij_coefficient(index_t i, index_t j, double a) {
-	    nlAddIJCoefficient(i,j,a);
+	    Thread* thread = Thread::current();
+	    index_t current_thread_id = (thread == nil) ? 0 : thread->id();
+	    geo_debug_assert(
+		current_thread_id < ((NLCOOMatrix*)Hessian_COO_)->nb_buffers
+	    );
+	    nlCOOMatrixAdd(
+		(NLCOOMatrix*)Hessian_COO_,
+		NLuint(current_thread_id), NLuint(i), NLuint(j), a
+	    );
 	}
 
         /**
          * \brief Adds a coefficient to the right hand side.
+	 * \details Concurrent calls with the same \p i need to be
+	 *  protected by a lock.
          * \param[in] i the index of the coefficient
          * \param[in] a the value to be added to the coefficient
          */
         void add_i_right_hand_side(index_t i, double a) {
-	    nlAddIRightHandSide(i,a);
+	    geo_debug_assert(i < rhs_.size());
+	    rhs_[i] += a;
 	}
         
         /**
@@ -479,6 +525,14 @@ namespace GEO {
          */
         void solve_linear_system();
 
+        /**
+         * \brief Solves the linear system with the SUPERLU OpenNL 
+	 *  extension.
+	 * \details If the extension cannot be initialized, then 
+	 *  use_direct_solver_ is reset and nothing is done.
+         */
+        void solve_linear_system_direct();
+
 	/**
 	 * \brief Sets the initial value of the weight associated
 	 *  with one of the points.
@@ -715,6 +769,8 @@ namespace GEO {
 	vector<double> nu_;  /**< \brief Value of all the Diracs. */
         double epsilon_;
         /**< \brief Acceptable relative deviation for the measure of a cell */
+        double coarse_levels_epsilon_;
+        /**< \brief Same as epsilon_, for the intermediate levels */
         index_t current_call_iter_;
 
 	Callback* callback_;
@@ -798,6 +854,35 @@ namespace GEO {
 	 *  air particles.
 	 */
 	bool clip_by_balls_;
+
+	/**
+	 * \brief The coefficients of the Hessian, in one buffer per
+	 *  thread, of type NL_MATRIX_COO.
+	 */
+	NLMatrix Hessian_COO_;
+
+	/**
+	 * \brief The Hessian, in compressed row storage.
+	 * \details It is kept from one Newton step to the next one, and
+	 *  only its coefficients are updated as long as its sparsity 
+	 *  pattern contains the one of the new Hessian.
+	 */
+	NLMatrix Hessian_;
+
+	/** \brief Number of triplets Hessian_ was assembled from */
+	NLuint Hessian_nb_triplets_;
+
+	/** \brief The right-hand side of the Newton step */
+	vector<double> rhs_;
+
+	/** \brief Where to store the solution of the Newton step */
+	double* linsolve_x_;
+
+	/** 
+	 * \brief Time spent in the different phases of the current Newton
+	 *  iteration, in seconds.
+	 */
+	double power_diagram_time_, RVD_time_, Hessian_time_, solve_time_;
     };
 
 }
@@ -365,19 +365,14 @@ namespace {
 
 		    // -hij because we maximize F <=> minimize -F
 		    if(hij != 0.0) {
-			if(spinlocks_ != nil) {
-			    spinlocks_->acquire_spinlock(i);
-			}
 			// Diagonal is positive, extra-diagonal
 			// coefficients are negative,
 			// this is a convex function.
+			// (no lock needed, each thread has its own buffer)
 			if(j < n_) {
 			    OTM_->add_ij_coefficient(i, j, -hij);
 			}
 			OTM_->add_ij_coefficient(i, i,  hij);
-			if(spinlocks_ != nil) {
-			    spinlocks_->release_spinlock(i);
-			}
 		    }
 		}
 	    }
@@ -119,8 +119,9 @@ namespace {
     // non-empty intersection (a common facet). The value of the coefficient
     // is the mass (area or weighted area) of the face divided by twice the
     // distance between vertex i and vertex j. They
-    // are computed by update_Hessian(), that calls OpenNL functions to
-    // construct the (sparse) Hessian. The right-hand side of the linear system
+    // are computed by update_Hessian(), that accumulates them in
+    // per-thread buffers, merged into a (sparse) CRS matrix before
+    // the Newton step is solved. The right-hand side of the linear system
     // (minus the gradient) is computed by the OptimalTransport class (that
     // copies it from the gradient).
     //
@@ -388,13 +389,10 @@ namespace {
 		const double* p1 = OTM_->point_ptr(v_adj);		
 		hij /= (2.0 * GEO::Geom::distance(p0,p1,3));		
 
-		if(spinlocks_ != nil) {
-		    spinlocks_->acquire_spinlock(v);
-		}
-		
 		// Diagonal is positive, extra-diagonal
 		// coefficients are negative,
 		// this is a convex function.
+		// (no lock needed, each thread has its own buffer)
 
 		if(v_adj < n_) {
 		    OTM_->add_ij_coefficient(
@@ -404,10 +402,6 @@ namespace {
 		OTM_->add_ij_coefficient(
 		    v, v, hij
                 );
-
-		if(spinlocks_ != nil) {
-		    spinlocks_->release_spinlock(v);
-		}
 	    }
 	}
 
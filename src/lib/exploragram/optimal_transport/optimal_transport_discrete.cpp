@@ -0,0 +1,525 @@
+
+/*
+ *  OGF/Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000-2009 INRIA - Project ALICE
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy - levy@loria.fr
+ *
+ *     Project ALICE
+ *     LORIA, INRIA Lorraine, 
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX 
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs. 
+ *
+ * As an exception to the GPL, Graphite can be linked with 
+ *     the following (non-GPL) libraries:
+ *     Qt, SuperLU, WildMagic and CGAL
+ */
+
+#include <exploragram/optimal_transport/optimal_transport_discrete.h>
+#include <geogram/points/nn_search.h>
+#include <geogram/basic/geometry_nd.h>
+#include <geogram/basic/process.h>
+#include <geogram/basic/logger.h>
+#include <geogram/basic/stopwatch.h>
+
+#include <algorithm>
+
+namespace {
+    using namespace GEO;
+
+    /**
+     * \brief Number of Sinkhorn iterations with each intermediate value
+     *  of epsilon.
+     */
+    const index_t nb_iterations_per_scale = 5;
+
+    /**
+     * \brief Number of Sinkhorn iterations after which the truncated
+     *  kernel is updated.
+     */
+    const index_t nb_iterations_per_kernel = 50;
+
+    /**
+     * \brief Functional object used to query the nearest neighbors
+     *  of a pointset in parallel.
+     */
+    class GetNearestNeighbors {
+    public:
+        /**
+         * \brief GetNearestNeighbors constructor.
+         * \param[in] NN the search data structure
+         * \param[in] points the query points
+         * \param[in] dim dimension of the points
+         * \param[in] nb number of neighbors of each query point
+         * \param[out] neighbors the nb neighbors of each query point
+         */
+        GetNearestNeighbors(
+            const NearestNeighborSearch* NN, const double* points,
+            coord_index_t dim, index_t nb, vector<index_t>& neighbors
+        ) :
+            NN_(NN), points_(points), dim_(dim), nb_(nb),
+            neighbors_(neighbors) {
+        }
+
+        /**
+         * \brief Queries the nearest neighbors of a point.
+         * \param[in] i index of the query point
+         */
+        void operator()(index_t i) const {
+            index_t* neighbors = neighbors_.data() + size_t(i) * nb_;
+            double* sq_dist = (double*)alloca(sizeof(double) * nb_);
+            NN_->get_nearest_neighbors(
+                nb_, points_ + size_t(i) * dim_, neighbors, sq_dist
+            );
+        }
+
+    private:
+        const NearestNeighborSearch* NN_;
+        const double* points_;
+        coord_index_t dim_;
+        index_t nb_;
+        vector<index_t>& neighbors_;
+    };
+
+    /**
+     * \brief Lifts a pointset in dimension + 1.
+     * \details The additional coordinate is \f$ \sqrt{P - p_i} \f$ where
+     *  \f$ P = \max_i p_i \f$, so that the squared distance between a
+     *  point \f$ (q,0) \f$ and a lifted point is \f$ \| q - x_i \|^2 -
+     *  p_i + P \f$.
+     * \param[in] nb number of points
+     * \param[in] points the coordinates of the points
+     * \param[in] dim dimension of the points
+     * \param[in] p the potentials of the points, or nil for a zero
+     *  additional coordinate
+     * \param[out] lifted the nb * (dim + 1) coordinates of the lifted
+     *  points
+     */
+    void lift_points(
+        index_t nb, const double* points, coord_index_t dim,
+        const double* p, vector<double>& lifted
+    ) {
+        double P = -Numeric::max_float64();
+        if(p != nil) {
+            for(index_t i=0; i<nb; ++i) {
+                P = geo_max(P, p[i]);
+            }
+        }
+        lifted.resize(size_t(nb) * (dim + 1));
+        for(index_t i=0; i<nb; ++i) {
+            for(coord_index_t c=0; c<dim; ++c) {
+                lifted[i*(dim+1)+c] = points[i*dim+c];
+            }
+            lifted[i*(dim+1)+dim] = (p == nil) ? 0.0 : ::sqrt(P - p[i]);
+        }
+    }
+
+    /**
+     * \brief Copies and normalizes the masses of a pointset.
+     * \param[in] nb_points number of points
+     * \param[in] mass the masses of the points, or nil for uniform masses
+     * \param[out] a the normalized masses
+     * \param[out] log_a the logarithms of the normalized masses
+     */
+    void normalize_masses(
+        index_t nb_points, const double* mass,
+        vector<double>& a, vector<double>& log_a
+    ) {
+        a.resize(nb_points);
+        log_a.resize(nb_points);
+        double total = 0.0;
+        for(index_t i=0; i<nb_points; ++i) {
+            a[i] = (mass == nil) ? 1.0 : mass[i];
+            geo_assert(a[i] > 0.0);
+            total += a[i];
+        }
+        for(index_t i=0; i<nb_points; ++i) {
+            a[i] /= total;
+            log_a[i] = ::log(a[i]);
+        }
+    }
+
+    /**
+     * \brief Computes the log of a sum of exponentials in a numerically
+     *  stable way.
+     * \details Computes \f$ \log \sum_k \exp(v_k) \f$ with
+     *  \f$ v_k = \log m_{j_k} + (p_{j_k} - c_k) / \epsilon \f$.
+     *  Both passes read the costs contiguously, and the potentials and
+     *  masses indirectly.
+     * \param[in] nb number of terms
+     * \param[in] j indices of the terms
+     * \param[in] c costs of the terms
+     * \param[in] log_m logarithms of the masses
+     * \param[in] p potentials
+     * \param[in] eps regularization
+     */
+    double log_sum_exp(
+        index_t nb, const index_t* j, const double* c,
+        const double* log_m, const double* p, double eps
+    ) {
+        double inv_eps = 1.0 / eps;
+        double vmax = -Numeric::max_float64();
+        for(index_t k=0; k<nb; ++k) {
+            double v = log_m[j[k]] + (p[j[k]] - c[k]) * inv_eps;
+            vmax = geo_max(vmax, v);
+        }
+        double s = 0.0;
+        for(index_t k=0; k<nb; ++k) {
+            double v = log_m[j[k]] + (p[j[k]] - c[k]) * inv_eps;
+            s += ::exp(v - vmax);
+        }
+        return vmax + ::log(s);
+    }
+}
+
+namespace GEO {
+
+    DiscreteOptimalTransport::DiscreteOptimalTransport(
+        coord_index_t dimension
+    ) :
+        dimension_(dimension),
+        eps_(0.0),
+        epsilon_(1e-3),
+        epsilon_scaling_(0.7),
+        nb_neighbors_(20),
+        marginal_epsilon_(1e-3),
+        marginal_error_(0.0),
+        max_iterations_(1000),
+        verbose_(false) {
+    }
+
+    void DiscreteOptimalTransport::set_source(
+        index_t nb_points, const double* points, const double* mass
+    ) {
+        x_.assign(points, points + size_t(nb_points) * dimension_);
+        normalize_masses(nb_points, mass, a_, log_a_);
+    }
+
+    void DiscreteOptimalTransport::set_target(
+        index_t nb_points, const double* points, const double* mass
+    ) {
+        y_.assign(points, points + size_t(nb_points) * dimension_);
+        normalize_masses(nb_points, mass, b_, log_b_);
+    }
+
+    void DiscreteOptimalTransport::compute_kernel_pattern() {
+        index_t n = nb_source_points();
+        index_t m = nb_target_points();
+        index_t k_xy = geo_min(nb_neighbors_, m);
+        index_t k_yx = geo_min(nb_neighbors_, n);
+
+        //   The largest coefficients of the kernel in row i are the
+        // ones that minimize |x_i - y_j|^2 - g_j, found by a nearest
+        // neighbor query in the pointset lifted by the potentials (and
+        // similarly for the columns). Thus the truncated kernel follows
+        // the transport plan when the points are moved far away.
+        coord_index_t dimp1 = coord_index_t(dimension_ + 1);
+        vector<double> query;
+        vector<double> lifted;
+        vector<index_t> nn_xy(n * k_xy);
+        vector<index_t> nn_yx(m * k_yx);
+        {
+            lift_points(n, x_.data(), dimension_, nil, query);
+            lift_points(m, y_.data(), dimension_, g_.data(), lifted);
+            NearestNeighborSearch_var NN =
+                NearestNeighborSearch::create(dimp1, "BNN");
+            NN->set_points(m, lifted.data());
+            parallel_for(
+                GetNearestNeighbors(NN, query.data(), dimp1, k_xy, nn_xy),
+                0, n
+            );
+        }
+        {
+            lift_points(m, y_.data(), dimension_, nil, query);
+            lift_points(n, x_.data(), dimension_, f_.data(), lifted);
+            NearestNeighborSearch_var NN =
+                NearestNeighborSearch::create(dimp1, "BNN");
+            NN->set_points(n, lifted.data());
+            parallel_for(
+                GetNearestNeighbors(NN, query.data(), dimp1, k_yx, nn_yx),
+                0, m
+            );
+        }
+
+        // Rows: union of both neighborhoods, sorted, without duplicates.
+        row_ptr_.assign(n+1, 0);
+        for(index_t i=0; i<n; ++i) {
+            row_ptr_[i+1] = k_xy;
+        }
+        for(index_t c=0; c<nn_yx.size(); ++c) {
+            ++row_ptr_[nn_yx[c]+1];
+        }
+        for(index_t i=0; i<n; ++i) {
+            row_ptr_[i+1] += row_ptr_[i];
+        }
+        col_.resize(row_ptr_[n]);
+        vector<index_t> pos(n);
+        for(index_t i=0; i<n; ++i) {
+            pos[i] = row_ptr_[i];
+            for(index_t k=0; k<k_xy; ++k) {
+                col_[pos[i]] = nn_xy[i*k_xy+k];
+                ++pos[i];
+            }
+        }
+        for(index_t j=0; j<m; ++j) {
+            for(index_t k=0; k<k_yx; ++k) {
+                index_t i = nn_yx[j*k_yx+k];
+                col_[pos[i]] = j;
+                ++pos[i];
+            }
+        }
+        index_t nb = 0;
+        for(index_t i=0; i<n; ++i) {
+            index_t* b = col_.data() + row_ptr_[i];
+            index_t* e = col_.data() + row_ptr_[i+1];
+            std::sort(b,e);
+            e = std::unique(b,e);
+            row_ptr_[i] = nb;
+            for(index_t* it=b; it!=e; ++it) {
+                col_[nb] = *it;
+                ++nb;
+            }
+        }
+        row_ptr_[n] = nb;
+        col_.resize(nb);
+
+        cost_.resize(nb);
+        for(index_t i=0; i<n; ++i) {
+            const double* p = x_.data() + size_t(i) * dimension_;
+            for(index_t c=row_ptr_[i]; c<row_ptr_[i+1]; ++c) {
+                const double* q = y_.data() + size_t(col_[c]) * dimension_;
+                cost_[c] = Geom::distance2(p, q, dimension_);
+            }
+        }
+
+        // Columns: transpose of the rows.
+        col_ptr_.assign(m+1, 0);
+        for(index_t c=0; c<nb; ++c) {
+            ++col_ptr_[col_[c]+1];
+        }
+        for(index_t j=0; j<m; ++j) {
+            col_ptr_[j+1] += col_ptr_[j];
+        }
+        row_.resize(nb);
+        cost_t_.resize(nb);
+        pos.resize(m);
+        for(index_t j=0; j<m; ++j) {
+            pos[j] = col_ptr_[j];
+        }
+        for(index_t i=0; i<n; ++i) {
+            for(index_t c=row_ptr_[i]; c<row_ptr_[i+1]; ++c) {
+                index_t j = col_[c];
+                row_[pos[j]] = i;
+                cost_t_[pos[j]] = cost_[c];
+                ++pos[j];
+            }
+        }
+    }
+
+    void DiscreteOptimalTransport::update_source_potential(index_t i) {
+        index_t b = row_ptr_[i];
+        double f = -eps_ * log_sum_exp(
+            row_ptr_[i+1] - b, col_.data() + b, cost_.data() + b,
+            log_b_.data(), g_.data(), eps_
+        );
+        // Before the update, the mass transported from i is
+        // a_i exp((f_i - f) / eps).
+        row_error_[i] = a_[i] * ::fabs(::exp((f_[i] - f) / eps_) - 1.0);
+        f_[i] = f;
+    }
+
+    void DiscreteOptimalTransport::update_target_potential(index_t j) {
+        index_t b = col_ptr_[j];
+        g_[j] = -eps_ * log_sum_exp(
+            col_ptr_[j+1] - b, row_.data() + b, cost_t_.data() + b,
+            log_a_.data(), f_.data(), eps_
+        );
+    }
+
+    double DiscreteOptimalTransport::iterate() {
+        index_t n = nb_source_points();
+        index_t m = nb_target_points();
+        parallel_for(
+            parallel_for_member_callback(
+                this, &DiscreteOptimalTransport::update_source_potential
+            ),
+            0, n
+        );
+        parallel_for(
+            parallel_for_member_callback(
+                this, &DiscreteOptimalTransport::update_target_potential
+            ),
+            0, m
+        );
+        // The column marginals are exact after the update of the target
+        // potentials, the error is measured on the rows.
+        double result = 0.0;
+        for(index_t i=0; i<n; ++i) {
+            result += row_error_[i];
+        }
+        return result;
+    }
+
+    bool DiscreteOptimalTransport::optimize() {
+        index_t n = nb_source_points();
+        index_t m = nb_target_points();
+        geo_assert(n != 0 && m != 0);
+
+        double start = SystemStopwatch::now();
+
+        // Squared diameter of the bounding box.
+        double D2 = 0.0;
+        for(coord_index_t c=0; c<dimension_; ++c) {
+            double xmin = Numeric::max_float64();
+            double xmax = -Numeric::max_float64();
+            for(index_t i=0; i<n; ++i) {
+                xmin = geo_min(xmin, x_[i*dimension_+c]);
+                xmax = geo_max(xmax, x_[i*dimension_+c]);
+            }
+            for(index_t j=0; j<m; ++j) {
+                xmin = geo_min(xmin, y_[j*dimension_+c]);
+                xmax = geo_max(xmax, y_[j*dimension_+c]);
+            }
+            D2 += geo_sqr(xmax - xmin);
+        }
+        if(D2 == 0.0) {
+            D2 = 1.0;
+        }
+
+        f_.assign(n, 0.0);
+        g_.assign(m, 0.0);
+        row_error_.assign(n, 0.0);
+
+        // epsilon-scaling: starts with a large regularization, where
+        // the problem is easy, and decreases it geometrically.
+        double eps_final = epsilon_ * D2;
+        eps_ = D2;
+        index_t nb_iter = 0;
+        for(;;) {
+            bool last_scale = (eps_ * epsilon_scaling_ < eps_final);
+            if(last_scale) {
+                eps_ = eps_final;
+            }
+            index_t max_iter = 
+                last_scale ? max_iterations_ : nb_iterations_per_scale;
+            for(index_t k=0; k<max_iter; ++k) {
+                if(k % nb_iterations_per_kernel == 0) {
+                    compute_kernel_pattern();
+                }
+                marginal_error_ = iterate();
+                ++nb_iter;
+                if(marginal_error_ < marginal_epsilon_) {
+                    break;
+                }
+            }
+            if(verbose_) {
+                Logger::out("Sinkhorn")
+                    << "eps=" << eps_ / D2
+                    << " iter=" << nb_iter
+                    << " couplings=" << nb_couplings()
+                    << " error=" << marginal_error_ << std::endl;
+            }
+            if(last_scale) {
+                break;
+            }
+            eps_ *= epsilon_scaling_;
+        }
+
+        if(verbose_) {
+            Logger::out("Sinkhorn")
+                << "Used " << nb_iter << " iterations, "
+                << SystemStopwatch::now() - start << " s" << std::endl;
+        }
+        return (marginal_error_ < marginal_epsilon_);
+    }
+
+    double DiscreteOptimalTransport::coupling_mass(
+        index_t c, index_t i
+    ) const {
+        index_t j = col_[c];
+        return ::exp(
+            log_a_[i] + log_b_[j] + (f_[i] + g_[j] - cost_[c]) / eps_
+        );
+    }
+
+    double DiscreteOptimalTransport::transport_cost() const {
+        double result = 0.0;
+        for(index_t i=0; i<nb_source_points(); ++i) {
+            for(index_t c=row_begin(i); c<row_end(i); ++c) {
+                result += coupling_mass(c,i) * cost_[c];
+            }
+        }
+        return result;
+    }
+
+    void DiscreteOptimalTransport::compute_source_barycenters(
+        double* result
+    ) const {
+        for(index_t i=0; i<nb_source_points(); ++i) {
+            double* p = result + size_t(i) * dimension_;
+            double s = 0.0;
+            for(coord_index_t coord=0; coord<dimension_; ++coord) {
+                p[coord] = 0.0;
+            }
+            for(index_t c=row_begin(i); c<row_end(i); ++c) {
+                double w = coupling_mass(c,i);
+                const double* q = y_.data() + size_t(col_[c]) * dimension_;
+                for(coord_index_t coord=0; coord<dimension_; ++coord) {
+                    p[coord] += w * q[coord];
+                }
+                s += w;
+            }
+            for(coord_index_t coord=0; coord<dimension_; ++coord) {
+                p[coord] /= s;
+            }
+        }
+    }
+
+    void DiscreteOptimalTransport::compute_target_barycenters(
+        double* result
+    ) const {
+        for(index_t j=0; j<nb_target_points(); ++j) {
+            double* p = result + size_t(j) * dimension_;
+            double s = 0.0;
+            for(coord_index_t coord=0; coord<dimension_; ++coord) {
+                p[coord] = 0.0;
+            }
+            for(index_t c=col_ptr_[j]; c<col_ptr_[j+1]; ++c) {
+                index_t i = row_[c];
+                double w = ::exp(
+                    log_a_[i] + log_b_[j] + (f_[i] + g_[j] - cost_t_[c]) / eps_
+                );
+                const double* q = x_.data() + size_t(i) * dimension_;
+                for(coord_index_t coord=0; coord<dimension_; ++coord) {
+                    p[coord] += w * q[coord];
+                }
+                s += w;
+            }
+            for(coord_index_t coord=0; coord<dimension_; ++coord) {
+                p[coord] /= s;
+            }
+        }
+    }
+}
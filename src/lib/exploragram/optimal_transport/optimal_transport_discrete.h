@@ -0,0 +1,350 @@
+
+/*
+ *  OGF/Graphite: Geometry and Graphics Programming Library + Utilities
+ *  Copyright (C) 2000-2009 INRIA - Project ALICE
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy - levy@loria.fr
+ *
+ *     Project ALICE
+ *     LORIA, INRIA Lorraine, 
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX 
+ *     FRANCE
+ *
+ *  Note that the GNU General Public License does not permit incorporating
+ *  the Software into proprietary programs. 
+ *
+ * As an exception to the GPL, Graphite can be linked with 
+ *     the following (non-GPL) libraries:
+ *     Qt, SuperLU, WildMagic and CGAL
+ */
+
+#ifndef H_EXPLORAGRAM_OPTIMAL_TRANSPORT_OPTIMAL_TRANSPORT_DISCRETE_H
+#define H_EXPLORAGRAM_OPTIMAL_TRANSPORT_OPTIMAL_TRANSPORT_DISCRETE_H
+
+#include <exploragram/basic/common.h>
+#include <geogram/basic/memory.h>
+
+/**
+ * \file exploragram/optimal_transport/optimal_transport_discrete.h
+ * \brief Solver for discrete (point to point) optimal transport
+ *  with entropic regularization (Sinkhorn algorithm).
+ */
+
+namespace GEO {
+
+    /**
+     * \brief Computes entropy-regularized optimal transport between
+     *  two weighted pointsets.
+     * \details The transport plan \f$ \pi \f$ minimizes
+     *  \f$ \sum_{ij} \pi_{ij} \| x_i - y_j \|^2 +
+     *      \epsilon KL(\pi | a \otimes b) \f$
+     *  subject to the marginal constraints
+     *  \f$ \sum_j \pi_{ij} = a_i \f$, \f$ \sum_i \pi_{ij} = b_j \f$.
+     *  It is computed with the Sinkhorn algorithm in the log domain
+     *  (stable for small \f$ \epsilon \f$), with \f$ \epsilon \f$-scaling
+     *  (the algorithm starts with a large \f$ \epsilon \f$ and decreases
+     *  it geometrically). The kernel is truncated: in each row and each
+     *  column, only the largest coefficients are kept, found by nearest
+     *  neighbor queries in the pointsets lifted by the current potentials.
+     *  The truncated kernel is updated at each scale, and gives a sparse
+     *  transport plan.
+     *  The rows and columns updates are computed in parallel.
+     *  Whereas OptimalTransportMap computes semi-discrete transport
+     *  (from a volumetric or surfacic measure to a pointset), this class
+     *  computes transport between two pointsets, e.g. for morphing.
+     */
+    class EXPLORAGRAM_API DiscreteOptimalTransport {
+    public:
+        /**
+         * \brief DiscreteOptimalTransport constructor.
+         * \param[in] dimension dimension of the points
+         */
+        DiscreteOptimalTransport(coord_index_t dimension);
+
+        /**
+         * \brief Gets the dimension of the points.
+         * \return the dimension
+         */
+        coord_index_t dimension() const {
+            return dimension_;
+        }
+
+        /**
+         * \brief Sets the source pointset.
+         * \details The points are copied.
+         * \param[in] nb_points number of points
+         * \param[in] points a pointer to the contiguous coordinates of
+         *  the points
+         * \param[in] mass an optional pointer to the masses of the
+         *  points. If nil, all the points have the same mass.
+         *  The masses are normalized so that they sum to 1.
+         */
+        void set_source(
+            index_t nb_points, const double* points, const double* mass=nil
+        );
+
+        /**
+         * \brief Sets the target pointset.
+         * \details The points are copied.
+         * \param[in] nb_points number of points
+         * \param[in] points a pointer to the contiguous coordinates of
+         *  the points
+         * \param[in] mass an optional pointer to the masses of the
+         *  points. If nil, all the points have the same mass.
+         *  The masses are normalized so that they sum to 1.
+         */
+        void set_target(
+            index_t nb_points, const double* points, const double* mass=nil
+        );
+
+        /**
+         * \brief Gets the number of source points.
+         */
+        index_t nb_source_points() const {
+            return a_.size();
+        }
+
+        /**
+         * \brief Gets the number of target points.
+         */
+        index_t nb_target_points() const {
+            return b_.size();
+        }
+
+        /**
+         * \brief Sets the entropic regularization.
+         * \param[in] eps the regularization parameter, relative to the
+         *  squared diameter of the bounding box of the pointsets.
+         */
+        void set_epsilon(double eps) {
+            epsilon_ = eps;
+        }
+
+        /**
+         * \brief Sets the factor applied to epsilon between two scales.
+         * \param[in] x a number in (0,1), the smaller the fewer scales
+         */
+        void set_epsilon_scaling(double x) {
+            geo_assert(x > 0.0 && x < 1.0);
+            epsilon_scaling_ = x;
+        }
+
+        /**
+         * \brief Sets the number of coefficients kept in each row and
+         *  each column of the truncated kernel.
+         * \param[in] nb number of nearest neighbors of each point
+         *  in the other (lifted) pointset
+         */
+        void set_nb_neighbors(index_t nb) {
+            geo_assert(nb != 0);
+            nb_neighbors_ = nb;
+        }
+
+        /**
+         * \brief Sets the maximum error.
+         * \param[in] eps maximum L1 norm of the deviation of the marginals
+         *  of the transport plan from the masses of the points.
+         */
+        void set_marginal_epsilon(double eps) {
+            marginal_epsilon_ = eps;
+        }
+
+        /**
+         * \brief Sets the maximum number of Sinkhorn iterations with
+         *  the final value of epsilon.
+         * \param[in] nb the maximum number of iterations
+         */
+        void set_max_iterations(index_t nb) {
+            max_iterations_ = nb;
+        }
+
+        /**
+         * \brief Displays additional information during computation.
+         * \param[in] x if true, additional information is displayed
+         */
+        void set_verbose(bool x) {
+            verbose_ = x;
+        }
+
+        /**
+         * \brief Computes the transport plan.
+         * \retval true if the marginal constraints are satisfied up to the
+         *  threshold specified by set_marginal_epsilon()
+         * \retval false otherwise
+         */
+        bool optimize();
+
+        /**
+         * \brief Gets the L1 norm of the deviation of the marginals
+         *  from the masses, measured at the last iteration.
+         */
+        double marginal_error() const {
+            return marginal_error_;
+        }
+
+        /**
+         * \brief Gets the dual potential associated with a source point.
+         * \param[in] i index of the source point
+         */
+        double source_potential(index_t i) const {
+            return f_[i];
+        }
+
+        /**
+         * \brief Gets the dual potential associated with a target point.
+         * \param[in] j index of the target point
+         */
+        double target_potential(index_t j) const {
+            return g_[j];
+        }
+
+        /**
+         * \brief Gets the number of non-zero coefficients in the
+         *  (truncated) transport plan.
+         */
+        index_t nb_couplings() const {
+            return col_.size();
+        }
+
+        /**
+         * \brief Gets the range of couplings associated with a source
+         *  point.
+         * \details The couplings of source point \p i are
+         *  [ row_begin(i) ... row_end(i) - 1 ]
+         * \param[in] i index of the source point
+         */
+        index_t row_begin(index_t i) const {
+            return row_ptr_[i];
+        }
+
+        /**
+         * \copydoc row_begin()
+         */
+        index_t row_end(index_t i) const {
+            return row_ptr_[i+1];
+        }
+
+        /**
+         * \brief Gets the target point of a coupling.
+         * \param[in] c index of the coupling
+         */
+        index_t coupling_target(index_t c) const {
+            return col_[c];
+        }
+
+        /**
+         * \brief Gets the mass transported by a coupling.
+         * \param[in] c index of the coupling
+         * \param[in] i index of the source point of the coupling
+         */
+        double coupling_mass(index_t c, index_t i) const;
+
+        /**
+         * \brief Gets the transport cost of the current transport plan.
+         * \return \f$ \sum_{ij} \pi_{ij} \| x_i - y_j \|^2 \f$
+         */
+        double transport_cost() const;
+
+        /**
+         * \brief Computes for each source point the barycenter of the
+         *  target points it is transported to.
+         * \param[out] result a pointer to nb_source_points() * dimension()
+         *  coordinates
+         */
+        void compute_source_barycenters(double* result) const;
+
+        /**
+         * \brief Computes for each target point the barycenter of the
+         *  source points that are transported to it.
+         * \details With a uniform sampling of a domain as the source,
+         *  this is the discrete counterpart of the centroids of the
+         *  Laguerre cells computed by semi-discrete transport.
+         * \param[out] result a pointer to nb_target_points() * dimension()
+         *  coordinates
+         */
+        void compute_target_barycenters(double* result) const;
+
+    protected:
+        /**
+         * \brief Computes the sparse set of pairs (i,j) that are
+         *  considered, using nearest neighbor queries.
+         * \details Uses the current potentials.
+         */
+        void compute_kernel_pattern();
+
+        /**
+         * \brief Updates the potentials of the source points.
+         * \details Used by parallel_for()
+         * \param[in] i index of the source point
+         */
+        void update_source_potential(index_t i);
+
+        /**
+         * \brief Updates the potentials of the target points.
+         * \details Used by parallel_for()
+         * \param[in] j index of the target point
+         */
+        void update_target_potential(index_t j);
+
+        /**
+         * \brief Does one iteration of the Sinkhorn algorithm.
+         * \return the L1 norm of the deviation of the row marginals
+         *  from the source masses before the iteration
+         */
+        double iterate();
+
+    private:
+        coord_index_t dimension_;
+        vector<double> x_;  /**< \brief Coordinates of the source points */
+        vector<double> y_;  /**< \brief Coordinates of the target points */
+        vector<double> a_;  /**< \brief Masses of the source points */
+        vector<double> b_;  /**< \brief Masses of the target points */
+        vector<double> log_a_;
+        vector<double> log_b_;
+        vector<double> f_;  /**< \brief Potentials of the source points */
+        vector<double> g_;  /**< \brief Potentials of the target points */
+
+        /** \brief Truncated kernel, by rows (source points) */
+        vector<index_t> row_ptr_;
+        vector<index_t> col_;
+        vector<double> cost_;
+
+        /** \brief Truncated kernel, by columns (target points) */
+        vector<index_t> col_ptr_;
+        vector<index_t> row_;
+        vector<double> cost_t_;
+
+        /** \brief Row marginal error of each source point */
+        vector<double> row_error_;
+
+        double eps_;        /**< \brief Current regularization */
+        double epsilon_;
+        double epsilon_scaling_;
+        index_t nb_neighbors_;
+        double marginal_epsilon_;
+        double marginal_error_;
+        index_t max_iterations_;
+        bool verbose_;
+    };
+}
+
+#endif
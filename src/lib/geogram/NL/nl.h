@@ -473,7 +473,7 @@ typedef void* NLContext;
  *  the used preconditioner.
  * \details Should be one of 
  *  (\ref NL_PRECOND_NONE, \ref NL_PRECOND_JACOBI, 
-     \ref NL_PRECOND_SSOR, \ref NL_PRECOND_USER).
+     \ref NL_PRECOND_SSOR, \ref NL_PRECOND_MULTIGRID, \ref NL_PRECOND_USER).
  *  If NL_PRECOND_USER is used, then the user-defined preconditioner is 
  *  specified using nlSetFunction(). Usage:
  * \code
@@ -514,6 +514,40 @@ typedef void* NLContext;
  *  define or query the number of linear systems to be solved.
  */    
 #define NL_NB_SYSTEMS       0x10e
+
+/**
+ * \brief Symbolic constant for nlSolverParameteri()/nlGetIntegerv() to
+ *  define or query the number of threads that assemble the matrix
+ *  concurrently.
+ * \details When set to a non-zero value before nlBegin(NL_SYSTEM), the 
+ *  matrix is stored as an unsorted list of coefficients with one buffer 
+ *  per thread, and nlThreadAddIJCoefficient() can be called concurrently 
+ *  by different threads. The coefficients are sorted and summed in 
+ *  parallel by nlEnd(NL_MATRIX). Usage:
+ * \code
+ *   nlSolverParameteri(NL_ASSEMBLY_THREADS, nb_threads);
+ * \endcode
+ *  With the SSOR preconditioner, that needs a dynamic sparse matrix, the
+ *  coefficients are copied into one by nlEnd(NL_MATRIX).
+ * \see nlThreadAddIJCoefficient()
+ */    
+#define NL_ASSEMBLY_THREADS 0x10f
+
+/**
+ * \brief Symbolic constant for nlSolverParameteri()/nlGetIntegerv() to
+ *  define or query the number of interleaved components of the variables,
+ *  used by the multigrid preconditioner.
+ * \details Variable i belongs to component i modulo the number of
+ *  components (for instance, with 2 components, the even variables are
+ *  u coordinates and the odd ones v coordinates). The multigrid 
+ *  preconditioner only groups variables of the same component. Default
+ *  value is 1. Usage:
+ * \code
+ *   nlSolverParameteri(NL_MULTIGRID_COMPONENTS, 2);
+ * \endcode
+ * \see NL_PRECOND_MULTIGRID
+ */    
+#define NL_MULTIGRID_COMPONENTS 0x110
     
 /**
  * @}
@@ -625,6 +659,22 @@ typedef void* NLContext;
  */    
 #define NL_PRECOND_SSOR       0x301
 
+/**
+ * \brief Symbolic constant for nlSolverParameteri()
+ *  to use an algebraic multigrid preconditioner.
+ * \details
+ * Usage:
+ * \code
+ *   nlSolverParameteri(NL_PRECONDITIONER, NL_PRECOND_MULTIGRID);
+ * \endcode
+ * The multigrid preconditioner is meant to be used with NL_CG 
+ * (least squares or symmetric systems). It has a higher setup cost
+ * than the Jacobi preconditioner, but the number of iterations 
+ * grows much slower with the size of the system, which makes it
+ * interesting for large meshes.
+ */    
+#define NL_PRECOND_MULTIGRID  0x304
+
 /**
  * \brief Symbolic constant for nlSolverParameteri()
  *  to use a user-defined preconditioner.
@@ -687,6 +737,53 @@ typedef void* NLContext;
  */
 #define NL_VERBOSE         0x401
 
+/**
+ * \brief Symbolic constant for nlEnable() / nlDisable()
+ *  to enable or disable SIMD-friendly matrix storage in
+ *  iterative solvers.
+ * \details When enabled, the iterative solver uses a copy of the
+ *  matrix in the sliced ELLPACK (SELL-C-sigma) format. The matrix
+ *  itself stays in CRS format. This improves the throughput of the sparse
+ *  matrix-vector product on processors with wide SIMD units,
+ *  at the expense of additional memory for padding. It is ignored
+ *  with symmetric storage (SSOR preconditioner) and with the CUDA
+ *  extension. Usage:
+ * \code
+ *   nlEnable(NL_SELL_STORAGE)
+ * \endcode
+ * or
+ * \code
+ *   nlDisable(NL_SELL_STORAGE)
+ * \endcode
+ * \see nlEnable(), nlDisable(), nlIsEnabled()
+ */
+#define NL_SELL_STORAGE    0x402
+
+/**
+ * \brief Symbolic constant for nlEnable() / nlDisable()
+ *  to enable or disable mixed-precision iterative solves.
+ * \details When enabled, a single-precision copy of the matrix 
+ *  is used by the inner Krylov iterations (CG or BICGSTAB, with
+ *  Jacobi preconditioning), and the solution is corrected by 
+ *  double-precision iterative refinement until the residual meets 
+ *  \ref NL_THRESHOLD. This halves the memory bandwidth used by the 
+ *  matrix-vector products, and is well adapted to reasonably 
+ *  well-conditioned systems. If refinement stagnates, the solve is 
+ *  finished in double precision. The achieved accuracy can be queried 
+ *  with \ref NL_ERROR, and the speed with \ref NL_ELAPSED_TIME and 
+ *  \ref NL_GFLOPS. It is ignored with GMRES, with symmetric storage 
+ *  (SSOR preconditioner) and with the CUDA extension. Usage:
+ * \code
+ *   nlEnable(NL_MIXED_PRECISION)
+ * \endcode
+ * or
+ * \code
+ *   nlDisable(NL_MIXED_PRECISION)
+ * \endcode
+ * \see nlEnable(), nlDisable(), nlIsEnabled()
+ */
+#define NL_MIXED_PRECISION 0x403
+
 /**
  * @}
  * \name Context management
@@ -699,7 +796,9 @@ typedef void* NLContext;
  *  On exit, the newly created context is the current OpenNL
  *  context. Several OpenNL context may coexist. All OpenNL calls are
  *  forwarded to the current OpenNL context. Use nlMakeCurrent() 
- *  to switch between multiple OpenNL contexts.
+ *  to switch between multiple OpenNL contexts. Each thread has its
+ *  own current context, thus different threads can assemble and solve 
+ *  different systems concurrently, each one in its own context.
  *  Any created context needs to be destroyed before the end
  *  of the program using nlDeleteContext().
  * \return a handle to the newly created context.
@@ -717,13 +816,15 @@ typedef void* NLContext;
  * \brief Sets the current OpenNL context.
  * \details If several OpenNL contexts need to be used simultaneously,
  *  this function can be used to redirect all OpenNL calls to a specific
- *  context.
+ *  context. The current context is local to the calling thread. A 
+ *  context should not be current in two threads at the same time.
+ * \param[in] context the context, or NULL
  */
     NLAPI void NLAPIENTRY nlMakeCurrent(NLContext context);
 
 /**
  * \brief Gets the current context
- * \return a handle to the current OpenNL context
+ * \return a handle to the current OpenNL context of the calling thread
  */
     NLAPI NLContext NLAPIENTRY nlGetCurrent(void);
 
@@ -800,7 +901,8 @@ typedef void* NLContext;
  *    number of intermediate vectors used by GMRES;
  *   \arg if \p pname = \ref NL_PRECONDITIONER then \p param is the 
  *    symbolic constant that specifies the preconditioner, i.e. one of 
- *    (\ref NL_PRECOND_NONE, \ref NL_PRECOND_JACOBI, \ref NL_PRECOND_SSOR).
+ *    (\ref NL_PRECOND_NONE, \ref NL_PRECOND_JACOBI, \ref NL_PRECOND_SSOR,
+ *     \ref NL_PRECOND_MULTIGRID).
  *
  *  \see NL_SOLVER, NL_NB_VARIABLES, NL_LEAST_SQUARES, NL_MAX_ITERATIONS, 
  *    NL_SYMMETRIC, NL_INNER_ITERATIONS, NL_PRECONDITIONER
@@ -1130,6 +1232,27 @@ typedef void* NLContext;
         NLuint i, NLuint j, NLdouble value
     );
 
+/**
+ * \brief Adds a coefficient to the current matrix, from one of the
+ *  threads that assemble the matrix concurrently.
+ * \details This function should be called between a
+ *   nlBegin(NL_MATRIX) / nlEnd(NL_MATRIX) pair, with 
+ *   \ref NL_ASSEMBLY_THREADS set to a non-zero value. Different threads
+ *   can call this function concurrently provided that they use a 
+ *   different \p thread index. Since the current context is thread-local,
+ *   each thread should first bind the context with nlMakeCurrent(). 
+ *   Coefficients with the same (i,j) indices are summed. There should 
+ *   not be any locked variable when using this function.
+ * \param[in] thread index of the calling thread, in
+ *   0 .. nlGetInteger(NL_ASSEMBLY_THREADS)-1
+ * \param[in] i , j indices
+ * \param[in] value value to be added to the coefficient
+ * \see NL_ASSEMBLY_THREADS
+ */    
+    NLAPI void NLAPIENTRY nlThreadAddIJCoefficient(
+        NLuint thread, NLuint i, NLuint j, NLdouble value
+    );
+
 
 /**
  * \brief Adds a coefficient to a component of the right hand side 
@@ -75,6 +75,26 @@ static NLSparseMatrix* nlGetCurrentSparseMatrix() {
 }
 
 
+/**
+ * \brief Adds a coefficient to the current matrix.
+ * \details The current matrix is either stored in a dynamic sparse
+ *  matrix, or in a COO matrix if parallel assembly is used
+ *  (see NL_ASSEMBLY_THREADS). In the latter case, the coefficient 
+ *  is added to the buffer of the first thread.
+ * \param[in] i , j indices
+ * \param[in] value value to be added to the coefficient
+ */
+static void nlCurrentMatrixAdd(NLuint i, NLuint j, NLdouble value) {
+    if(
+	nlCurrentContext->matrix_mode == NL_STIFFNESS_MATRIX &&
+	nlCurrentContext->M->type == NL_MATRIX_COO
+    ) {
+	nlCOOMatrixAdd((NLCOOMatrix*)nlCurrentContext->M, 0, i, j, value);
+    } else {
+	nlSparseMatrixAdd(nlGetCurrentSparseMatrix(), i, j, value);
+    }
+}
+
 /*****************************************************************************/
 
 NLboolean nlInitExtension(const char* extension) {
@@ -196,6 +216,14 @@ void nlSolverParameteri(NLenum pname, NLint param) {
         nlCurrentContext->preconditioner = (NLuint)param;
         nlCurrentContext->preconditioner_defined = NL_TRUE;
     } break;
+    case NL_ASSEMBLY_THREADS: {
+        nl_assert(param >= 0);
+        nlCurrentContext->assembly_threads = (NLuint)param;
+    } break;
+    case NL_MULTIGRID_COMPONENTS: {
+        nl_assert(param > 0);
+        nlCurrentContext->multigrid_components = (NLuint)param;
+    } break;
     default: {
         nlError("nlSolverParameteri","Invalid parameter");
         nl_assert_not_reached;
@@ -276,6 +304,12 @@ void nlGetIntegerv(NLenum pname, NLint* params) {
     case NL_NNZ: {
         *params = (NLint)(nlMatrixNNZ(nlCurrentContext->M));
     } break;
+    case NL_ASSEMBLY_THREADS: {
+        *params = (NLint)(nlCurrentContext->assembly_threads);
+    } break;
+    case NL_MULTIGRID_COMPONENTS: {
+        *params = (NLint)(nlCurrentContext->multigrid_components);
+    } break;
     default: {
         nlError("nlGetIntegerv","Invalid parameter");
         nl_assert_not_reached;
@@ -295,6 +329,12 @@ void nlEnable(NLenum pname) {
 	case NL_VERBOSE: {
 	    nlCurrentContext->verbose = NL_TRUE;
 	} break;
+	case NL_SELL_STORAGE: {
+	    nlCurrentContext->sell_storage = NL_TRUE;
+	} break;
+	case NL_MIXED_PRECISION: {
+	    nlCurrentContext->mixed_precision = NL_TRUE;
+	} break;
 	case NL_VARIABLES_BUFFER: {
 	    nlCurrentContext->user_variable_buffers = NL_TRUE;
 	} break;
@@ -314,6 +354,12 @@ void nlDisable(NLenum pname) {
 	case NL_VERBOSE: {
 	    nlCurrentContext->verbose = NL_FALSE;
 	} break;
+	case NL_SELL_STORAGE: {
+	    nlCurrentContext->sell_storage = NL_FALSE;
+	} break;
+	case NL_MIXED_PRECISION: {
+	    nlCurrentContext->mixed_precision = NL_FALSE;
+	} break;
 	case NL_VARIABLES_BUFFER: {
 	    nlCurrentContext->user_variable_buffers = NL_FALSE;
 	} break;
@@ -333,6 +379,12 @@ NLboolean nlIsEnabled(NLenum pname) {
 	case NL_VERBOSE: {
 	    result = nlCurrentContext->verbose;
 	} break;
+	case NL_SELL_STORAGE: {
+	    result = nlCurrentContext->sell_storage;
+	} break;
+	case NL_MIXED_PRECISION: {
+	    result = nlCurrentContext->mixed_precision;
+	} break;
 	case NL_VARIABLES_BUFFER: {
 	    result = nlCurrentContext->user_variable_buffers;
 	} break;
@@ -519,10 +571,39 @@ static void nlEndSystem() {
     nlTransition(NL_STATE_MATRIX_CONSTRUCTED, NL_STATE_SYSTEM_CONSTRUCTED);    
 }
 
+/**
+ * \brief Gets the storage flags of the dynamic sparse matrix used to
+ *  assemble the current system.
+ * \details The solver, preconditioner and symmetry of the current
+ *  context need to be initialized.
+ * \return a bitwise or combination of NL_MATRIX_STORE_ROWS, 
+ *  NL_MATRIX_STORE_COLUMNS and NL_MATRIX_STORE_SYMMETRIC
+ */
+static NLenum nlCurrentSparseMatrixStorage() {
+    NLenum storage = NL_MATRIX_STORE_ROWS;
+    
+    /* SSOR preconditioner requires rows and columns */
+    if(nlCurrentContext->preconditioner == NL_PRECOND_SSOR) {
+        storage = (storage | NL_MATRIX_STORE_COLUMNS);
+    }
+
+    if(
+	nlCurrentContext->symmetric &&
+        nlCurrentContext->preconditioner == NL_PRECOND_SSOR 
+    ) {
+	/* 
+	 * For now, only used with SSOR preconditioner, because
+	 * for other modes it is either unsupported (SUPERLU) or
+	 * causes performance loss (non-parallel sparse SpMV)
+	 */
+        storage = (storage | NL_MATRIX_STORE_SYMMETRIC);
+    }
+    return storage;
+}
+
 static void nlInitializeM() {
     NLuint i;
     NLuint n = 0;
-    NLenum storage = NL_MATRIX_STORE_ROWS;
 
 
     for(i=0; i<nlCurrentContext->nb_variables; i++) {
@@ -557,34 +638,28 @@ static void nlInitializeM() {
         }
     }
 
-    
-    /* SSOR preconditioner requires rows and columns */
-    if(nlCurrentContext->preconditioner == NL_PRECOND_SSOR) {
-        storage = (storage | NL_MATRIX_STORE_COLUMNS);
-    }
 
     /* a least squares problem results in a symmetric matrix */
     if(nlCurrentContext->least_squares) {
         nlCurrentContext->symmetric = NL_TRUE;
     }
 
-    if(
-	nlCurrentContext->symmetric &&
-        nlCurrentContext->preconditioner == NL_PRECOND_SSOR 
-    ) {
-	/* 
-	 * For now, only used with SSOR preconditioner, because
-	 * for other modes it is either unsupported (SUPERLU) or
-	 * causes performance loss (non-parallel sparse SpMV)
-	 */
-        storage = (storage | NL_MATRIX_STORE_SYMMETRIC);
+    /* 
+     * Parallel assembly uses COO storage, that is converted 
+     * by nlEndMatrix().
+     */
+    if(nlCurrentContext->assembly_threads != 0) {
+	nlCurrentContext->M = nlCOOMatrixNew(
+	    n, n, nlCurrentContext->assembly_threads
+	);
+    } else {
+	nlCurrentContext->M = (NLMatrix)(NL_NEW(NLSparseMatrix));
+	nlSparseMatrixConstruct(
+	    (NLSparseMatrix*)(nlCurrentContext->M), n, n, 
+	    nlCurrentSparseMatrixStorage()
+	);
     }
 
-    nlCurrentContext->M = (NLMatrix)(NL_NEW(NLSparseMatrix));
-    nlSparseMatrixConstruct(
-	     (NLSparseMatrix*)(nlCurrentContext->M), n, n, storage
-    );
-
     nlCurrentContext->x = NL_NEW_ARRAY(
 	NLdouble, n*nlCurrentContext->nb_systems
     );
@@ -608,6 +683,26 @@ static void nlEndMatrix() {
 
     nlRowColumnClear(&nlCurrentContext->af);
     nlRowColumnClear(&nlCurrentContext->al);
+
+    if(
+	nlCurrentContext->matrix_mode == NL_STIFFNESS_MATRIX &&
+	nlCurrentContext->M->type == NL_MATRIX_COO
+    ) {
+	if(nlCOOMatrixNNZ((NLCOOMatrix*)nlCurrentContext->M) != 0) {
+	    nlCurrentContext->ij_coefficient_called = NL_TRUE;
+	}
+	if(nlCurrentContext->preconditioner == NL_PRECOND_SSOR) {
+	    /* SSOR needs a dynamic sparse matrix */
+	    NLMatrix M = nlSparseMatrixNewFromCOOMatrix(
+		(NLCOOMatrix*)nlCurrentContext->M,
+		nlCurrentSparseMatrixStorage()
+	    );
+	    nlDeleteMatrix(nlCurrentContext->M);
+	    nlCurrentContext->M = M;
+	} else {
+	    nlMatrixCompress(&nlCurrentContext->M);
+	}
+    }
     
     if(!nlCurrentContext->least_squares) {
         nl_assert(
@@ -662,7 +757,6 @@ static void nlNormalizeRow(NLdouble weight) {
 static void nlEndRow() {
     NLRowColumn*    af = &nlCurrentContext->af;
     NLRowColumn*    al = &nlCurrentContext->al;
-    NLSparseMatrix* M  = nlGetCurrentSparseMatrix();
     NLdouble* b        = nlCurrentContext->b;
     NLuint nf          = af->size;
     NLuint nl          = al->size;
@@ -686,8 +780,8 @@ static void nlEndRow() {
     if(nlCurrentContext->least_squares) {
         for(i=0; i<nf; i++) {
             for(j=0; j<nf; j++) {
-                nlSparseMatrixAdd(
-                    M, af->coeff[i].index, af->coeff[j].index,
+                nlCurrentMatrixAdd(
+                    af->coeff[i].index, af->coeff[j].index,
                     af->coeff[i].value * af->coeff[j].value
                 );
             }
@@ -705,8 +799,8 @@ static void nlEndRow() {
 	}
     } else {
         for(jj=0; jj<nf; ++jj) {
-            nlSparseMatrixAdd(
-                M, current_row, af->coeff[jj].index, af->coeff[jj].value
+            nlCurrentMatrixAdd(
+                current_row, af->coeff[jj].index, af->coeff[jj].value
             );
         }
 	for(k=0; k<nlCurrentContext->nb_systems; ++k) {
@@ -747,7 +841,6 @@ void nlCoefficient(NLuint index, NLdouble value) {
 }
 
 void nlAddIJCoefficient(NLuint i, NLuint j, NLdouble value) {
-    NLSparseMatrix* M  = nlGetCurrentSparseMatrix();    
     nlCheckState(NL_STATE_MATRIX);
     nl_debug_range_assert(i, 0, nlCurrentContext->nb_variables - 1);
     nl_debug_range_assert(j, 0, nlCurrentContext->nb_variables - 1);
@@ -756,10 +849,32 @@ void nlAddIJCoefficient(NLuint i, NLuint j, NLdouble value) {
         nl_debug_assert(!nlCurrentContext->variable_is_locked[i]);
     }
 #endif    
-    nlSparseMatrixAdd(M, i, j, value);
+    nlCurrentMatrixAdd(i, j, value);
     nlCurrentContext->ij_coefficient_called = NL_TRUE;
 }
 
+void nlThreadAddIJCoefficient(
+    NLuint thread, NLuint i, NLuint j, NLdouble value
+) {
+    /*
+     * Note: ij_coefficient_called is not updated here, to avoid
+     * concurrent writes. It is updated by nlEndMatrix().
+     */
+    NLCOOMatrix* M = NULL;
+    nl_debug_assert(nlCurrentContext->state == NL_STATE_MATRIX);
+    nl_debug_assert(nlCurrentContext->matrix_mode == NL_STIFFNESS_MATRIX);
+    /* 
+     * Checked in release mode as well: without NL_ASSEMBLY_THREADS,
+     * the current matrix is not a COO matrix.
+     */
+    nl_assert(nlCurrentContext->M->type == NL_MATRIX_COO);
+    M = (NLCOOMatrix*)nlCurrentContext->M;
+    nl_range_assert(thread, 0, M->nb_buffers - 1);
+    nl_debug_range_assert(i, 0, nlCurrentContext->nb_variables - 1);
+    nl_debug_range_assert(j, 0, nlCurrentContext->nb_variables - 1);
+    nlCOOMatrixAdd(M, thread, i, j, value);
+}
+
 void nlAddIRightHandSide(NLuint i, NLdouble value) {
     nlCheckState(NL_STATE_MATRIX);
     nl_debug_range_assert(i, 0, nlCurrentContext->nb_variables - 1);
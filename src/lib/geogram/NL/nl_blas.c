@@ -242,7 +242,7 @@ static int NL_FORTRAN_WRAP(lsame)(const char *ca, const char *cb)
     integer i__1;
 
     /* Local variables */
-    static integer i, m, ix, iy, mp1;
+    integer i, m, ix, iy, mp1;
 
 
 /*     constant times a vector plus a vector.   
@@ -332,9 +332,9 @@ static doublereal NL_FORTRAN_WRAP(ddot)(integer *n, doublereal *dx, integer *inc
     doublereal ret_val;
 
     /* Local variables */
-    static integer i, m;
-    static doublereal dtemp;
-    static integer ix, iy, mp1;
+    integer i, m;
+    doublereal dtemp;
+    integer ix, iy, mp1;
 
 
 /*     forms the dot product of two vectors.   
@@ -422,7 +422,7 @@ L60:
     integer i__1, i__2;
 
     /* Local variables */
-    static integer i, m, nincx, mp1;
+    integer i, m, nincx, mp1;
 
 
 /*     scales a vector by a constant.   
@@ -508,9 +508,9 @@ static doublereal NL_FORTRAN_WRAP(dnrm2)(integer *n, doublereal *x, integer *inc
     /*double sqrt(doublereal); */
 
     /* Local variables */
-    static doublereal norm, scale, absxi;
-    static integer ix;
-    static doublereal ssq;
+    doublereal norm, scale, absxi;
+    integer ix;
+    doublereal ssq;
 
 
 /*  DNRM2 returns the euclidean norm of a vector via the function   
@@ -587,7 +587,7 @@ static doublereal NL_FORTRAN_WRAP(dnrm2)(integer *n, doublereal *x, integer *inc
     integer i__1;
 
     /* Local variables */
-    static integer i, m, ix, iy, mp1;
+    integer i, m, ix, iy, mp1;
 
 
 /*     copies a vector, x, to a vector, y.   
@@ -679,11 +679,11 @@ L40:
     integer i__1, i__2; 
 
     /* Local variables */
-    static integer info;
-    static doublereal temp;
-    static integer lenx, leny, i, j;
+    integer info;
+    doublereal temp;
+    integer lenx, leny, i, j;
 /*    extern logical lsame_(char *, char *); */
-    static integer ix, iy, jx, jy, kx, ky;
+    integer ix, iy, jx, jy, kx, ky;
 /*    extern int xerbla_(char *, integer *); */
 
 
@@ -1016,13 +1016,13 @@ static int NL_FORTRAN_WRAP(dtpsv)(
     integer i__1, i__2;
 
     /* Local variables */
-    static integer info;
-    static doublereal temp;
-    static integer i__, j, k;
+    integer info;
+    doublereal temp;
+    integer i__, j, k;
 /*    extern logical lsame_(); */
-    static integer kk, ix, jx, kx;
+    integer kk, ix, jx, kx = 0;
 /*    extern int xerbla_(); */
-    static logical nounit;
+    logical nounit;
 
 /* ***BEGIN PROLOGUE  DTPSV */
 /* ***PURPOSE  Solve one of the systems of equations. */
@@ -1502,8 +1502,12 @@ static void host_blas_dtpsv(
 }
 
 NLBlas_t nlHostBlas() {
-    static NLboolean initialized = NL_FALSE;
-    static struct NLBlas blas;
+    /* 
+     * Thread-local, since it stores the statistics (flops, residual)
+     * of the solver that runs in the current thread.
+     */
+    static NL_THREAD_LOCAL NLboolean initialized = NL_FALSE;
+    static NL_THREAD_LOCAL struct NLBlas blas;
     if(!initialized) {
 	memset(&blas, 0, sizeof(blas));
 	blas.has_unified_memory = NL_TRUE;
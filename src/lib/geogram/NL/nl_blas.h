@@ -53,6 +53,10 @@
 #ifndef OPENNL_BLAS_H
 #define OPENNL_BLAS_H
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /**
  * \brief The opaque structure used by the BLAS abstraction layer.
  */
@@ -382,7 +386,7 @@ NLulong nlBlasMaxUsedRam(NLBlas_t blas, NLmemoryType type);
  *  BLAS operation on the host CPU.
  * \return a pointer to the BLAS abstraction layer.
  */
-NLBlas_t nlHostBlas(void);
+NLAPI NLBlas_t NLAPIENTRY nlHostBlas(void);
 
 /**
  * \brief Allocates a vector of doubles;
@@ -405,4 +409,8 @@ NLBlas_t nlHostBlas(void);
 
 /******************************************************************************/
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif
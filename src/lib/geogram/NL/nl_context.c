@@ -51,7 +51,7 @@
 #include "nl_mkl.h"
 #include "nl_cuda.h"
 
-NLContextStruct* nlCurrentContext = NULL;
+NL_THREAD_LOCAL NLContextStruct* nlCurrentContext = NULL;
 
 NLContext nlNewContext() {
     NLContextStruct* result     = NL_NEW(NLContextStruct);
@@ -62,6 +62,7 @@ NLContext nlNewContext() {
     result->omega               = 1.5;
     result->row_scaling         = 1.0;
     result->inner_iterations    = 5;
+    result->multigrid_components = 1;
     result->solver_func         = nlDefaultSolver;
     result->progress_func       = NULL;
     result->verbose             = NL_FALSE;
@@ -129,6 +130,30 @@ void nlTransition(NLenum from_state, NLenum to_state) {
 /************************************************************************/
 /* Preconditioner setup and default solver */
 
+/**
+ * \brief Creates the multigrid preconditioner for the matrix of the
+ *  current context.
+ * \details The component of each unknown is deduced from the index of
+ *  the corresponding variable.
+ */
+static NLMatrix nlNewMultigridPreconditionerFromContext() {
+    NLMatrix result = NULL;
+    NLuint* component = NULL;
+    NLuint i;
+    if(nlCurrentContext->multigrid_components > 1) {
+	component = NL_NEW_ARRAY(NLuint, nlCurrentContext->n);
+	for(i=0; i<nlCurrentContext->nb_variables; ++i) {
+	    if(!nlCurrentContext->variable_is_locked[i]) {
+		component[nlCurrentContext->variable_index[i]] =
+		    i % nlCurrentContext->multigrid_components;
+	    }
+	}
+    }
+    result = nlNewMultigridPreconditioner(nlCurrentContext->M, component);
+    NL_DELETE_ARRAY(component);
+    return result;
+}
+
 static void nlSetupPreconditioner() {
     /* Check compatibility between solver and preconditioner */
     if(
@@ -196,6 +221,9 @@ static void nlSetupPreconditioner() {
 	    nlCurrentContext->M,nlCurrentContext->omega
 	);	
         break;
+    case NL_PRECOND_MULTIGRID:
+	nlCurrentContext->P = nlNewMultigridPreconditionerFromContext();
+        break;
     case NL_PRECOND_USER:
         break;
     default:
@@ -209,6 +237,57 @@ static void nlSetupPreconditioner() {
     }
 }
 
+/**
+ * \brief Tests whether the iterative solver of the current context
+ *  should use mixed precision.
+ * \details Mixed precision is used if requested and if the solver is
+ *  CG or BICGSTAB, with a CRS matrix without symmetric storage and without
+ *  the CUDA extension.
+ */
+static NLboolean nlUseMixedPrecision() {
+    return (
+        nlCurrentContext->mixed_precision &&
+        (nlCurrentContext->solver == NL_CG ||
+         nlCurrentContext->solver == NL_BICGSTAB) &&
+        nlCurrentContext->M->type == NL_MATRIX_CRS &&
+        !((NLCRSMatrix*)(nlCurrentContext->M))->symmetric_storage &&
+        !nlExtensionIsInitialized_CUDA()
+    );
+}
+
+/**
+ * \brief Creates a SELL-C-sigma copy of the matrix of the current
+ *  context if requested.
+ * \details The matrix of the current context is left in CRS format, the
+ *  copy is only used by the matrix-vector products of the iterative
+ *  solver. The CUDA extension, mixed precision and symmetric storage 
+ *  require the CRS format, in these cases no copy is created.
+ * \return the SELL-C-sigma matrix, to be deleted by the caller, or
+ *  NULL if the CRS matrix is used
+ */
+static NLMatrix nlNewSELLMatrix() {
+    NLMatrix SELL = NULL;
+    if(
+        !nlCurrentContext->sell_storage ||
+        nlUseMixedPrecision() ||
+        nlCurrentContext->M->type != NL_MATRIX_CRS ||
+        ((NLCRSMatrix*)(nlCurrentContext->M))->symmetric_storage ||
+        nlExtensionIsInitialized_CUDA()
+    ) {
+        return NULL;
+    }
+    SELL = nlSELLMatrixNewFromCRSMatrix(
+        (NLCRSMatrix*)(nlCurrentContext->M), 8, 256
+    );
+    if(nlCurrentContext->verbose) {
+        nl_printf(
+            "Using SELL-8-256 storage, fill ratio=%f\n",
+            nlSELLMatrixFillRatio((NLSELLMatrix*)SELL)
+        );
+    }
+    return SELL;
+}
+
 static NLboolean nlSolveDirect() {
     NLdouble* b = nlCurrentContext->b;
     NLdouble* x = nlCurrentContext->x;
@@ -239,6 +318,9 @@ static NLboolean nlSolveIterative() {
     NLBlas_t blas = nlHostBlas();
     NLMatrix M = nlCurrentContext->M;
     NLMatrix P = nlCurrentContext->P;
+    NLMatrix Mf = NULL;
+    NLMatrix Msell = NULL;
+    NLuint its;
     
     /*
      * For CUDA: it is implemented for
@@ -267,19 +349,70 @@ static NLboolean nlSolveIterative() {
      */
     nlCurrentContext->start_time = nlCurrentTime();     
     nlBlasResetStats(blas);
+
+    /* 
+     * For mixed precision, the construction of the single-precision
+     * matrix is counted, so that NL_ELAPSED_TIME can be compared with
+     * a double-precision solve.
+     */
+    if(!use_CUDA && nlUseMixedPrecision()) {
+	if(nlCurrentContext->verbose) { 
+	    nl_printf("Using mixed precision\n");
+	} 
+	Mf = nlFloatCRSMatrixNewFromCRSMatrix((NLCRSMatrix*)M);
+    }
+
+    if(!use_CUDA && Mf == NULL) {
+	Msell = nlNewSELLMatrix();
+	if(Msell != NULL) {
+	    M = Msell;
+	}
+    }
     
     for(k=0; k<nlCurrentContext->nb_systems; ++k) {
-	nlSolveSystemIterative(
-	    blas,
-	    M,
-	    P,
-	    b,
-	    x,
-	    nlCurrentContext->solver,
-	    nlCurrentContext->threshold,
-	    nlCurrentContext->max_iterations,
-	    nlCurrentContext->inner_iterations
-	);
+	if(Mf != NULL) {
+	    its = nlSolveSystemMixedPrecision(
+		M,
+		Mf,
+		b,
+		x,
+		nlCurrentContext->solver,
+		nlCurrentContext->threshold,
+		nlCurrentContext->max_iterations
+	    );
+	    if(
+		nlCurrentContext->error > nlCurrentContext->threshold &&
+		its < nlCurrentContext->max_iterations
+	    ) {
+		if(nlCurrentContext->verbose) { 
+		    nl_printf("Finishing in double precision\n");
+		}
+		nlSolveSystemIterative(
+		    blas,
+		    M,
+		    P,
+		    b,
+		    x,
+		    nlCurrentContext->solver,
+		    nlCurrentContext->threshold,
+		    nlCurrentContext->max_iterations - its,
+		    nlCurrentContext->inner_iterations
+		);
+		nlCurrentContext->used_iterations += its;
+	    }
+	} else {
+	    nlSolveSystemIterative(
+		blas,
+		M,
+		P,
+		b,
+		x,
+		nlCurrentContext->solver,
+		nlCurrentContext->threshold,
+		nlCurrentContext->max_iterations,
+		nlCurrentContext->inner_iterations
+	    );
+	}
 	b += n;
 	x += n;
     }
@@ -290,6 +423,8 @@ static NLboolean nlSolveIterative() {
 	nlDeleteMatrix(M);
 	nlDeleteMatrix(P);
     }
+    nlDeleteMatrix(Mf);
+    nlDeleteMatrix(Msell);
     
     return NL_TRUE;
 }
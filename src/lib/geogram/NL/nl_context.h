@@ -235,6 +235,18 @@ typedef struct {
      */
     NLuint           nb_systems;
 
+    /**
+     * \brief The number of threads that assemble the matrix
+     *  concurrently, or 0 if the matrix is assembled by a single thread.
+     */
+    NLuint           assembly_threads;
+
+    /**
+     * \brief The number of interleaved components of the variables,
+     *  used by the multigrid preconditioner.
+     */
+    NLuint           multigrid_components;
+    
     /**
      * \brief True if NLIJCoefficient() was called
      */
@@ -334,6 +346,18 @@ typedef struct {
      */
     NLboolean        verbose;
 
+    /**
+     * \brief if true, the matrix is converted to SELL-C-sigma
+     *  format before iterative solves.
+     */
+    NLboolean        sell_storage;
+
+    /**
+     * \brief if true, iterative solves use single-precision inner
+     *  iterations and double-precision iterative refinement.
+     */
+    NLboolean        mixed_precision;
+
     /**
      * \brief Total number of floating point operations
      *  used during latest solve.
@@ -374,8 +398,9 @@ typedef struct {
 
 /**
  * \brief Pointer to the current context.
+ * \details Each thread has its own current context.
  */
-extern NLContextStruct* nlCurrentContext;
+extern NL_THREAD_LOCAL NLContextStruct* nlCurrentContext;
 
 /**
  * \brief Makes sure that the finite state automaton is
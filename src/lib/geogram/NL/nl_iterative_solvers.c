@@ -450,6 +450,33 @@ static NLuint nlSolveSystem_GMRES(
 /************************************************************************/
 /* Main driver routine */
 
+/**
+ * \brief Stores the relative residual and the number of used iterations
+ *  in the current context, and displays them in verbose mode.
+ * \param[in] bnorm norm of the right-hand side
+ * \param[in] rnorm norm of the residual
+ * \param[in] its number of used iterations
+ */
+static void nlReportResidual(NLdouble bnorm, NLdouble rnorm, NLuint its) {
+    if(nlCurrentContext == NULL) {
+	return;
+    }
+    if(bnorm == 0.0) {
+	nlCurrentContext->error = rnorm;
+	if(nlCurrentContext->verbose) {
+	    nl_printf("in OpenNL : ||Ax-b|| = %e\n",nlCurrentContext->error);
+	}
+    } else {
+	nlCurrentContext->error = rnorm/bnorm;
+	if(nlCurrentContext->verbose) {
+	    nl_printf("in OpenNL : ||Ax-b||/||b|| = %e\n",
+		      nlCurrentContext->error
+	    );
+	}
+    }
+    nlCurrentContext->used_iterations = its;
+}
+
 NLuint nlSolveSystemIterative(
     NLBlas_t blas,
     NLMatrix M, NLMatrix P, NLdouble* b_in, NLdouble* x_in,
@@ -503,24 +530,9 @@ NLuint nlSolveSystemIterative(
 
 
     /* Get residual norm and rhs norm from BLAS context */
-    if(nlCurrentContext != NULL) {
-	bnorm = sqrt(blas->sq_bnorm);
-	rnorm = sqrt(blas->sq_rnorm);
-	if(bnorm == 0.0) {
-	    nlCurrentContext->error = rnorm;
-	    if(nlCurrentContext->verbose) {
-		nl_printf("in OpenNL : ||Ax-b|| = %e\n",nlCurrentContext->error);
-	    }
-	} else {
-	    nlCurrentContext->error = rnorm/bnorm;
-	    if(nlCurrentContext->verbose) {
-		nl_printf("in OpenNL : ||Ax-b||/||b|| = %e\n",
-		       nlCurrentContext->error
-		);
-	    }
-	}
-    }
-    nlCurrentContext->used_iterations = result;
+    bnorm = sqrt(blas->sq_bnorm);
+    rnorm = sqrt(blas->sq_rnorm);
+    nlReportResidual(bnorm, rnorm, result);
 
     if(!nlBlasHasUnifiedMemory(blas)) {
 	blas->Memcpy(
@@ -535,3 +547,297 @@ NLuint nlSolveSystemIterative(
 }
 
 /************************************************************************/
+/* Mixed-precision solver */
+
+/**
+ * \brief Single-precision dot product, accumulated in double precision
+ */
+static double nlFdot(int n, const float* x, const float* y) {
+    int i;
+    double result = 0.0;
+
+#if defined(_OPENMP)
+#pragma omp parallel for private(i) reduction(+:result)
+#endif
+
+    for(i=0; i<n; ++i) {
+	result += (double)x[i] * (double)y[i];
+    }
+    nlHostBlas()->flops += (NLulong)(2*n);
+    return result;
+}
+
+/**
+ * \brief Single-precision y <- a x + y
+ */
+static void nlFaxpy(int n, double a, const float* x, float* y) {
+    int i;
+    float af = (float)a;
+
+#if defined(_OPENMP)
+#pragma omp parallel for private(i)
+#endif
+
+    for(i=0; i<n; ++i) {
+	y[i] += af * x[i];
+    }
+    nlHostBlas()->flops += (NLulong)(2*n);
+}
+
+/**
+ * \brief Single-precision y <- x + b y
+ */
+static void nlFxpby(int n, const float* x, double b, float* y) {
+    int i;
+    float bf = (float)b;
+
+#if defined(_OPENMP)
+#pragma omp parallel for private(i)
+#endif
+
+    for(i=0; i<n; ++i) {
+	y[i] = x[i] + bf * y[i];
+    }
+    nlHostBlas()->flops += (NLulong)(2*n);
+}
+
+/**
+ * \brief Single-precision Jacobi preconditioner y <- D x
+ * \param[in] D inverse of the diagonal of the matrix
+ */
+static void nlFJacobi(int n, const float* D, const float* x, float* y) {
+    int i;
+
+#if defined(_OPENMP)
+#pragma omp parallel for private(i)
+#endif
+
+    for(i=0; i<n; ++i) {
+	y[i] = D[i] * x[i];
+    }
+    nlHostBlas()->flops += (NLulong)n;
+}
+
+/**
+ * \brief Single-precision Jacobi-preconditioned conjugate gradient.
+ * \details Starts from x = 0.
+ * \param[in] M the matrix
+ * \param[in] D inverse of the diagonal of \p M
+ * \param[in] b the right-hand side
+ * \param[out] x the solution
+ * \param[in] eps relative residual to be reached
+ * \param[in] max_iter maximum number of iterations
+ * \return the number of used iterations
+ */
+static NLuint nlSolveSystemFloat_PRE_CG(
+    NLFloatCRSMatrix* M, const float* D, const float* b, float* x,
+    double eps, NLuint max_iter
+) {
+    int N = (int)M->n;
+    float* r  = NL_NEW_ARRAY(float, N);
+    float* z  = NL_NEW_ARRAY(float, N);
+    float* p  = NL_NEW_ARRAY(float, N);
+    float* Ap = NL_NEW_ARRAY(float, N);
+    NLuint its = 0;
+    double rz, pAp, alpha, beta;
+    double err = eps*eps*nlFdot(N,b,b);
+    double curr_err;
+
+    memset(x, 0, (size_t)N*sizeof(float));
+    memcpy(r, b, (size_t)N*sizeof(float));
+    nlFJacobi(N,D,r,z);
+    memcpy(p, z, (size_t)N*sizeof(float));
+    rz = nlFdot(N,r,z);
+    curr_err = nlFdot(N,r,r);
+
+    while(curr_err > err && its < max_iter) {
+	nlFloatCRSMatrixMult(M,p,Ap);
+	pAp = nlFdot(N,p,Ap);
+	if(fabs(pAp) < 1e-40) {
+	    break;
+	}
+	alpha = rz/pAp;
+	nlFaxpy(N,alpha,p,x);
+	nlFaxpy(N,-alpha,Ap,r);
+	nlFJacobi(N,D,r,z);
+	beta = 1.0/rz;
+	rz = nlFdot(N,r,z);
+	beta *= rz;
+	nlFxpby(N,z,beta,p);
+	curr_err = nlFdot(N,r,r);
+	++its;
+    }
+    
+    NL_DELETE_ARRAY(r);
+    NL_DELETE_ARRAY(z);
+    NL_DELETE_ARRAY(p);
+    NL_DELETE_ARRAY(Ap);
+    return its;
+}
+
+/**
+ * \brief Single-precision BICGSTAB with right Jacobi preconditioning.
+ * \details Starts from x = 0.
+ * \param[in] M the matrix
+ * \param[in] D inverse of the diagonal of \p M
+ * \param[in] b the right-hand side
+ * \param[out] x the solution
+ * \param[in] eps relative residual to be reached
+ * \param[in] max_iter maximum number of iterations
+ * \return the number of used iterations
+ */
+static NLuint nlSolveSystemFloat_PRE_BICGSTAB(
+    NLFloatCRSMatrix* M, const float* D, const float* b, float* x,
+    double eps, NLuint max_iter
+) {
+    int N = (int)M->n;
+    float* r  = NL_NEW_ARRAY(float, N);
+    float* rT = NL_NEW_ARRAY(float, N);
+    float* p  = NL_NEW_ARRAY(float, N);
+    float* v  = NL_NEW_ARRAY(float, N);
+    float* y  = NL_NEW_ARRAY(float, N);
+    float* z  = NL_NEW_ARRAY(float, N);
+    float* t  = NL_NEW_ARRAY(float, N);
+    NLuint its = 0;
+    double rho = 1.0, alpha = 1.0, omega = 1.0;
+    double rho_new, rTv, tt, beta;
+    double err = eps*eps*nlFdot(N,b,b);
+    double curr_err;
+
+    memset(x, 0, (size_t)N*sizeof(float));
+    memcpy(r,  b, (size_t)N*sizeof(float));
+    memcpy(rT, b, (size_t)N*sizeof(float));
+    curr_err = nlFdot(N,r,r);
+
+    while(curr_err > err && its < max_iter) {
+	rho_new = nlFdot(N,rT,r);
+	if(fabs(rho_new) < 1e-40) {
+	    break;
+	}
+	beta = (rho_new/rho)*(alpha/omega);
+	rho = rho_new;
+	/* p <- r + beta (p - omega v) */
+	nlFaxpy(N,-omega,v,p);
+	nlFxpby(N,r,beta,p);
+	nlFJacobi(N,D,p,y);
+	nlFloatCRSMatrixMult(M,y,v);
+	rTv = nlFdot(N,rT,v);
+	if(fabs(rTv) < 1e-40) {
+	    break;
+	}
+	alpha = rho/rTv;
+	/* s <- r - alpha v, stored in r */
+	nlFaxpy(N,-alpha,v,r);
+	nlFaxpy(N,alpha,y,x);
+	nlFJacobi(N,D,r,z);
+	nlFloatCRSMatrixMult(M,z,t);
+	tt = nlFdot(N,t,t);
+	omega = (tt < 1e-40) ? 0.0 : nlFdot(N,t,r)/tt;
+	nlFaxpy(N,omega,z,x);
+	nlFaxpy(N,-omega,t,r);
+	curr_err = nlFdot(N,r,r);
+	++its;
+	if(omega == 0.0) {
+	    break;
+	}
+    }
+
+    NL_DELETE_ARRAY(r);
+    NL_DELETE_ARRAY(rT);
+    NL_DELETE_ARRAY(p);
+    NL_DELETE_ARRAY(v);
+    NL_DELETE_ARRAY(y);
+    NL_DELETE_ARRAY(z);
+    NL_DELETE_ARRAY(t);
+    return its;
+}
+
+NLuint nlSolveSystemMixedPrecision(
+    NLMatrix M, NLMatrix Mf, NLdouble* b, NLdouble* x,
+    NLenum solver, double eps, NLuint max_iter
+) {
+    NLBlas_t blas = nlHostBlas();
+    NLFloatCRSMatrix* F = (NLFloatCRSMatrix*)Mf;
+    int n = (int)M->n;
+    int i;
+    NLuint jj;
+    double* r  = NL_NEW_ARRAY(double, n);
+    float*  rf = NL_NEW_ARRAY(float, n);
+    float*  df = NL_NEW_ARRAY(float, n);
+    float*  D  = NL_NEW_ARRAY(float, n);
+    NLuint its = 0;
+    NLuint nb_steps = 0;
+    double inner_eps = 1e-4;
+    double step_eps;
+    double bnorm = sqrt(blas->Ddot(blas,n,b,1,b,1));
+    double rnorm = 0.0;
+    double prev_rnorm = 0.0;
+
+    nl_assert(M->m == M->n);
+    nl_assert(Mf->type == NL_MATRIX_CRS_FLOAT);
+    nl_assert(solver == NL_CG || solver == NL_BICGSTAB);
+
+    for(i=0; i<n; ++i) {
+	D[i] = 1.0f;
+	for(jj=F->rowptr[i]; jj<F->rowptr[i+1]; ++jj) {
+	    if(F->colind[jj] == (NLuint)i && F->val[jj] != 0.0f) {
+		D[i] = 1.0f / F->val[jj];
+	    }
+	}
+    }
+
+    for(;;) {
+	/* r <- b - Mx, in double precision */
+	nlMultMatrixVector(M,x,r);
+	blas->Dscal(blas,n,-1.0,r,1);
+	blas->Daxpy(blas,n,1.0,b,1,r,1);
+	rnorm = sqrt(blas->Ddot(blas,n,r,1,r,1));
+	if(rnorm <= eps*bnorm || its >= max_iter) {
+	    break;
+	}
+	/* refinement stagnates, the single-precision matrix is too
+	 * far from the double-precision one */
+	if(nb_steps != 0 && rnorm > 0.5*prev_rnorm) {
+	    break;
+	}
+	prev_rnorm = rnorm;
+	/* Do not iterate further than needed by the last step */
+	step_eps = eps*bnorm/rnorm;
+	if(step_eps < inner_eps) {
+	    step_eps = inner_eps;
+	}
+	/* The residual is normalized to stay in the range of floats */
+	for(i=0; i<n; ++i) {
+	    rf[i] = (float)(r[i]/rnorm);
+	}
+	if(solver == NL_CG) {
+	    its += nlSolveSystemFloat_PRE_CG(
+		F,D,rf,df,step_eps,max_iter-its
+	    );
+	} else {
+	    its += nlSolveSystemFloat_PRE_BICGSTAB(
+		F,D,rf,df,step_eps,max_iter-its
+	    );
+	}
+	blas->flops += (NLulong)(2*n);
+	for(i=0; i<n; ++i) {
+	    x[i] += rnorm * (double)(df[i]);
+	}
+	++nb_steps;
+    }
+
+    if(nlCurrentContext != NULL && nlCurrentContext->verbose) {
+	nl_printf(
+	    "in OpenNL : mixed precision, %d refinement steps\n", nb_steps
+	);
+    }
+    nlReportResidual(bnorm, rnorm, its);
+    
+    NL_DELETE_ARRAY(r);
+    NL_DELETE_ARRAY(rf);
+    NL_DELETE_ARRAY(df);
+    NL_DELETE_ARRAY(D);
+    return its;
+}
+
+/************************************************************************/
@@ -54,6 +54,10 @@
  * \brief Internal OpenNL functions that implement iterative solvers.
  */
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /**
  * \brief Solves a linear system using an iterative solver
  * \details The implementation of the solvers is inspired by 
@@ -84,5 +88,37 @@ NLAPI NLuint NLAPIENTRY nlSolveSystemIterative(
     double eps, NLuint max_iter, NLuint inner_iter
 );
 
+/**
+ * \brief Solves a linear system using single-precision iterations 
+ *  and double-precision iterative refinement.
+ * \details At each refinement step, the residual is computed in double
+ *  precision with \p M, and the correction is computed by a 
+ *  Jacobi-preconditioned single-precision solver with \p Mf, to a 
+ *  relative accuracy of 1e-4 (or less if it suffices to reach \p eps).
+ *  Refinement stops when the residual 
+ *  meets \p eps, when \p max_iter inner iterations are reached, or when
+ *  it stagnates. In the latter case, the caller may finish the solve in
+ *  double precision.
+ * \param[in] M the matrix of the system
+ * \param[in] Mf a single-precision copy of \p M, of type 
+ *  NL_MATRIX_CRS_FLOAT
+ * \param[in] b the right-hand side of the system
+ * \param[in,out] x the initial guess and the solution of the system
+ * \param[in] solver one of NL_CG, NL_BICGSTAB, used for the inner 
+ *  single-precision iterations
+ * \param[in] eps convergence bound, iterations are stopped as soon as
+ *   \f$ \| Mx - b \| / \| b \| <  \mbox{eps}\f$
+ * \param[in] max_iter maximum total number of inner iterations
+ * \return the total number of inner iterations
+ */
+NLAPI NLuint NLAPIENTRY nlSolveSystemMixedPrecision(
+    NLMatrix M, NLMatrix Mf, NLdouble* b, NLdouble* x,
+    NLenum solver, double eps, NLuint max_iter
+);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif
 
@@ -49,6 +49,10 @@
 #include "nl_context.h"
 #include "nl_blas.h"
 
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
 /*
  Some warnings about const cast in callback for
  qsort() function.
@@ -329,6 +333,689 @@ void nlCRSMatrixConstructSymmetric(
     M->symmetric_storage = NL_TRUE;
 }
 
+/**
+ * \brief Gets the number of slices used by the parallel matrix-vector
+ *  product
+ * \return the number of OpenMP threads, or 1 if OpenMP is not supported
+ */
+static NLuint nlCRSMatrixDefaultNbSlices(void) {
+#if defined(_OPENMP)
+    int nb_threads = omp_get_max_threads();
+    return nb_threads > 1 ? (NLuint)nb_threads : 1u;
+#else
+    return 1u;
+#endif
+}
+
+/**
+ * \brief Computes the slices used by the parallel matrix-vector product
+ * \details The rows are partitioned into CRS->nslices slices with 
+ *  approximately the same number of non-zero coefficients. Does nothing
+ *  if \p CRS has symmetric storage.
+ * \param[in,out] CRS a pointer to an NLCRSMatrix, with rowptr 
+ *  already computed
+ * \relates NLCRSMatrix
+ */
+static void nlCRSMatrixComputeSlices(NLCRSMatrix* CRS) {
+    NLuint nslices = CRS->nslices;
+    NLuint slice_size, slice, cur_bound, cur_NNZ, cur_row;
+    if(CRS->sliceptr == NULL) {
+	return;
+    }
+    slice_size = nlCRSMatrixNNZ(CRS) / nslices;
+    cur_bound = slice_size;
+    cur_NNZ = 0;
+    cur_row = 0;
+    CRS->sliceptr[0]=0;
+    for(slice=1; slice<nslices; ++slice) {
+	while(cur_NNZ < cur_bound && cur_row < CRS->m) {
+	    ++cur_row;
+	    cur_NNZ += CRS->rowptr[cur_row+1] - CRS->rowptr[cur_row];
+	}
+	CRS->sliceptr[slice] = cur_row;
+	cur_bound += slice_size;
+    }
+    CRS->sliceptr[nslices]=CRS->m;
+}
+
+/******************************************************************************/
+/* SELL-C-sigma data structure */
+
+/**
+ * \brief Destroys a NLSELLMatrix
+ * \details Only the memory allocated by the NLSELLMatrix is freed,
+ *  The NLSELLMatrix structure is not freed.
+ * \param[in,out] M pointer to an NLSELLMatrix
+ * \relates NLSELLMatrix
+ */
+static void nlSELLMatrixDestroy(NLSELLMatrix* M) {
+    NL_DELETE_ARRAY(M->chunkptr);
+    NL_DELETE_ARRAY(M->val);
+    NL_DELETE_ARRAY(M->colind);
+    NL_DELETE_ARRAY(M->perm);
+    M->m = 0;
+    M->n = 0;
+    M->nchunks = 0;
+}
+
+/**
+ * \brief Computes a matrix-vector product
+ * \details The inner loop operates on the C rows of a chunk, that
+ *  are stored contiguously, so that it can be vectorized.
+ * \param[in] M a pointer to the matrix
+ * \param[in] x the vector to be multiplied, size = A->n
+ * \param[in] y where to store the result, size = A->m
+ * \relates NLSELLMatrix
+ */
+static void nlSELLMatrixMult(
+    NLSELLMatrix* M, const double* x, double* y
+) {
+    /* 
+     * Note: OpenMP does not like unsigned ints, 
+     * see nlSparseMatrix_mult_rows()
+     */
+    int nchunks = (int)(M->nchunks);
+    int C = (int)(M->C);
+    int c,r,j,width;
+    NLuint row;
+    const NLdouble* val = NULL;
+    const NLuint* colind = NULL;
+    double sum[NL_SELL_MAX_CHUNK];
+
+#if defined(_OPENMP)
+#pragma omp parallel for private(c,r,j,width,row,val,colind,sum)
+#endif
+
+    for(c=0; c<nchunks; ++c) {
+        width = (int)(M->chunkptr[c+1] - M->chunkptr[c]) / C;
+        val = M->val + M->chunkptr[c];
+        colind = M->colind + M->chunkptr[c];
+        for(r=0; r<C; ++r) {
+            sum[r] = 0.0;
+        }
+        for(j=0; j<width; ++j) {
+            for(r=0; r<C; ++r) {
+                sum[r] += val[r] * x[colind[r]];
+            }
+            val += C;
+            colind += C;
+        }
+        for(r=0; r<C; ++r) {
+            row = M->perm[c*C+r];
+            if(row != NL_UINT_MAX) {
+                y[row] = sum[r];
+            }
+        }
+    }
+    
+    nlHostBlas()->flops += (NLulong)(2*M->nnz);
+}
+
+/**
+ * \brief A row of a NLCRSMatrix, used to sort
+ *   rows by decreasing length.
+ */
+typedef struct {
+    NLuint len;
+    NLuint index;
+} NLSELLRow;
+
+static int nlSELLRowCompare(const void* p1, const void* p2) {
+    const NLSELLRow* r1 = (const NLSELLRow*)p1;
+    const NLSELLRow* r2 = (const NLSELLRow*)p2;
+    if(r1->len != r2->len) {
+        return (r1->len > r2->len) ? -1 : 1;
+    }
+    /* Tie-break on the index to keep the order deterministic */
+    return (r1->index < r2->index) ? -1 : (r1->index > r2->index);
+}
+
+NLMatrix nlSELLMatrixNewFromCRSMatrix(
+    NLCRSMatrix* M, NLuint C, NLuint sigma
+) {
+    NLSELLMatrix* SELL = NL_NEW(NLSELLMatrix);
+    NLSELLRow* rows = NULL;
+    NLuint mpad,i,ib,ie,c,r,j,k,width,len,row,off;
+    
+    nl_assert(M->type == NL_MATRIX_CRS);
+    nl_assert(!M->symmetric_storage);
+    nl_range_assert(C, 1, NL_SELL_MAX_CHUNK);
+
+    /* sigma = 1 (or 0) means no sorting */
+    if(sigma <= 1) {
+        sigma = 1;
+    } else {
+        if(sigma < C) {
+            sigma = C;
+        }
+        sigma = ((sigma + C - 1) / C) * C;
+    }
+
+    SELL->m = M->m;
+    SELL->n = M->n;
+    SELL->type = NL_MATRIX_SELL;
+    SELL->destroy_func = (NLDestroyMatrixFunc)nlSELLMatrixDestroy;
+    SELL->mult_func = (NLMultMatrixVectorFunc)nlSELLMatrixMult;
+    SELL->C = C;
+    SELL->sigma = sigma;
+    SELL->nchunks = (M->m + C - 1) / C;
+    SELL->nnz = nlCRSMatrixNNZ(M);
+    mpad = SELL->nchunks * C;
+
+    /* Sort the rows by decreasing length within each window */
+    rows = NL_NEW_ARRAY(NLSELLRow, mpad);
+    for(i=0; i<mpad; ++i) {
+        rows[i].index = i;
+        rows[i].len = (i < M->m) ? (M->rowptr[i+1] - M->rowptr[i]) : 0;
+    }
+    if(sigma > 1) {
+        for(ib=0; ib<mpad; ib += sigma) {
+            ie = MIN(ib+sigma, mpad);
+            qsort(rows+ib, ie-ib, sizeof(NLSELLRow), nlSELLRowCompare);
+        }
+    }
+    
+    SELL->perm = NL_NEW_ARRAY(NLuint, mpad);
+    for(i=0; i<mpad; ++i) {
+        SELL->perm[i] = (rows[i].index < M->m) ? rows[i].index : NL_UINT_MAX;
+    }
+
+    /* Compute chunk widths and chunk pointers */
+    SELL->chunkptr = NL_NEW_ARRAY(NLuint, SELL->nchunks+1);
+    SELL->chunkptr[0] = 0;
+    for(c=0; c<SELL->nchunks; ++c) {
+        width = 0;
+        for(r=0; r<C; ++r) {
+            width = MAX(width, rows[c*C+r].len);
+        }
+        SELL->chunkptr[c+1] = SELL->chunkptr[c] + width * C;
+    }
+
+    /* 
+     * Copy the coefficients. Padding coefficients are zero and
+     * reference column 0, so that the product does not need to test
+     * them.
+     */
+    SELL->val = NL_NEW_ARRAY(NLdouble, SELL->chunkptr[SELL->nchunks]);
+    SELL->colind = NL_NEW_ARRAY(NLuint, SELL->chunkptr[SELL->nchunks]);
+    for(c=0; c<SELL->nchunks; ++c) {
+        for(r=0; r<C; ++r) {
+            row = SELL->perm[c*C+r];
+            if(row == NL_UINT_MAX) {
+                continue;
+            }
+            len = M->rowptr[row+1] - M->rowptr[row];
+            for(j=0; j<len; ++j) {
+                k = M->rowptr[row] + j;
+                off = SELL->chunkptr[c] + j*C + r;
+                SELL->val[off] = M->val[k];
+                SELL->colind[off] = M->colind[k];
+            }
+        }
+    }
+    
+    NL_DELETE_ARRAY(rows);
+    return (NLMatrix)SELL;
+}
+
+NLuint nlSELLMatrixNNZ(NLSELLMatrix* M) {
+    return M->nnz;
+}
+
+double nlSELLMatrixFillRatio(NLSELLMatrix* M) {
+    if(M->nnz == 0) {
+        return 1.0;
+    }
+    return (double)(M->chunkptr[M->nchunks]) / (double)(M->nnz);
+}
+
+/******************************************************************************/
+/* COO data structure */
+
+/**
+ * \brief Destroys a NLCOOMatrix
+ * \details Only the memory allocated by the NLCOOMatrix is freed,
+ *  The NLCOOMatrix structure is not freed.
+ * \param[in,out] M pointer to an NLCOOMatrix
+ * \relates NLCOOMatrix
+ */
+static void nlCOOMatrixDestroy(NLCOOMatrix* M) {
+    NLuint b;
+    for(b=0; b<M->nb_buffers; ++b) {
+	NL_DELETE_ARRAY(M->buffer[b].triplet);
+    }
+    NL_DELETE_ARRAY(M->buffer);
+    M->m = 0;
+    M->n = 0;
+    M->nb_buffers = 0;
+}
+
+/**
+ * \brief Computes a matrix-vector product
+ * \details This function is not optimized, COO matrices are meant
+ *  to be converted into CRS matrices before solving.
+ * \param[in] M a pointer to the matrix
+ * \param[in] x the vector to be multiplied, size = A->n
+ * \param[in] y where to store the result, size = A->m
+ * \relates NLCOOMatrix
+ */
+static void nlCOOMatrixMult(
+    NLCOOMatrix* M, const double* x, double* y
+) {
+    NLuint b,k;
+    const NLTriplet* t = NULL;
+    NL_CLEAR_ARRAY(NLdouble, y, M->m);
+    for(b=0; b<M->nb_buffers; ++b) {
+	for(k=0; k<M->buffer[b].size; ++k) {
+	    t = &(M->buffer[b].triplet[k]);
+	    y[t->i] += t->value * x[t->j];
+	}
+    }
+    nlHostBlas()->flops += (NLulong)(2*nlCOOMatrixNNZ(M));
+}
+
+NLMatrix nlCOOMatrixNew(NLuint m, NLuint n, NLuint nb_buffers) {
+    NLCOOMatrix* M = NL_NEW(NLCOOMatrix);
+    nl_assert(nb_buffers > 0);
+    M->m = m;
+    M->n = n;
+    M->type = NL_MATRIX_COO;
+    M->destroy_func = (NLDestroyMatrixFunc)nlCOOMatrixDestroy;
+    M->mult_func = (NLMultMatrixVectorFunc)nlCOOMatrixMult;
+    M->nb_buffers = nb_buffers;
+    M->buffer = NL_NEW_ARRAY(NLTripletBuffer, nb_buffers);
+    return (NLMatrix)M;
+}
+
+void nlCOOMatrixAdd(
+    NLCOOMatrix* M, NLuint buffer, NLuint i, NLuint j, NLdouble value
+) {
+    NLTripletBuffer* B = NULL;
+    nl_debug_range_assert(buffer, 0, M->nb_buffers - 1);
+    nl_parano_range_assert(i, 0, M->m - 1);
+    nl_parano_range_assert(j, 0, M->n - 1);
+    B = &(M->buffer[buffer]);
+    if(B->size == B->capacity) {
+	B->capacity = (B->capacity == 0) ? 1024 : 2*B->capacity;
+	B->triplet = NL_RENEW_ARRAY(NLTriplet, B->triplet, B->capacity);
+    }
+    B->triplet[B->size].i = i;
+    B->triplet[B->size].j = j;
+    B->triplet[B->size].value = value;
+    ++B->size;
+}
+
+void nlCOOMatrixZero(NLCOOMatrix* M) {
+    NLuint b;
+    for(b=0; b<M->nb_buffers; ++b) {
+	M->buffer[b].size = 0;
+    }
+}
+
+NLuint nlCOOMatrixNNZ(NLCOOMatrix* M) {
+    NLuint b, result = 0;
+    for(b=0; b<M->nb_buffers; ++b) {
+	result += M->buffer[b].size;
+    }
+    return result;
+}
+
+/**
+ * \brief Sorts the triplets of an NLCOOMatrix by row index.
+ * \details Rows are partitioned into slices. Triplets are first 
+ *  distributed into slices (in parallel over the buffers), then
+ *  sorted by row within each slice (in parallel over the slices).
+ *  Within a row, the triplets remain in the order of the buffers 
+ *  and in insertion order, so that the result is deterministic.
+ * \param[in] M a pointer to the NLCOOMatrix
+ * \param[out] rowptr row pointers, size = M->m + 1. On exit, the 
+ *  triplets of row i are in sorted[rowptr[i]] ... sorted[rowptr[i+1]-1]
+ * \param[out] sorted the sorted triplets, size = nlCOOMatrixNNZ(M)
+ * \relates NLCOOMatrix
+ */
+static void nlCOOMatrixSortRows(
+    NLCOOMatrix* M, NLuint* rowptr, NLTriplet* sorted
+) {
+    /* 
+     * Note: OpenMP does not like unsigned ints, 
+     * see nlSparseMatrix_mult_rows()
+     */
+    int nb_buffers = (int)M->nb_buffers;
+    int nslices = 4*nb_buffers;
+    NLuint slice_height = (M->m + (NLuint)nslices - 1) / (NLuint)nslices;
+    NLuint nnz = nlCOOMatrixNNZ(M);
+    NLuint* offset = NL_NEW_ARRAY(NLuint, nslices*nb_buffers);
+    NLuint* slice_begin = NL_NEW_ARRAY(NLuint, nslices+1);
+    NLuint* cursor = NL_NEW_ARRAY(NLuint, M->m);
+    NLTriplet* tmp = NL_NEW_ARRAY(NLTriplet, nnz);
+    const NLTripletBuffer* B = NULL;
+    const NLTriplet* t = NULL;
+    NLuint k, cur, ibegin, iend, i;
+    int b, s;
+
+    if(slice_height == 0) {
+	slice_height = 1;
+    }
+    
+    /* Count the triplets of each buffer in each slice */
+#if defined(_OPENMP)
+#pragma omp parallel for private(b,k,B)
+#endif
+    for(b=0; b<nb_buffers; ++b) {
+	B = &(M->buffer[b]);
+	for(k=0; k<B->size; ++k) {
+	    ++offset[b*nslices + (int)(B->triplet[k].i / slice_height)];
+	}
+    }
+
+    /* Compute where each buffer writes in each slice */
+    cur = 0;
+    for(s=0; s<nslices; ++s) {
+	slice_begin[s] = cur;
+	for(b=0; b<nb_buffers; ++b) {
+	    k = offset[b*nslices+s];
+	    offset[b*nslices+s] = cur;
+	    cur += k;
+	}
+    }
+    slice_begin[nslices] = cur;
+
+    /* Distribute the triplets into the slices */
+#if defined(_OPENMP)
+#pragma omp parallel for private(b,k,B,t)
+#endif
+    for(b=0; b<nb_buffers; ++b) {
+	B = &(M->buffer[b]);
+	for(k=0; k<B->size; ++k) {
+	    t = &(B->triplet[k]);
+	    tmp[offset[b*nslices + (int)(t->i / slice_height)]++] = *t;
+	}
+    }
+
+    /* Counting sort by row index within each slice */
+#if defined(_OPENMP)
+#pragma omp parallel for private(s,k,cur,ibegin,iend,i,t)
+#endif
+    for(s=0; s<nslices; ++s) {
+	ibegin = MIN((NLuint)s*slice_height, M->m);
+	iend = MIN(ibegin + slice_height, M->m);
+	for(i=ibegin; i<iend; ++i) {
+	    cursor[i] = 0;
+	}
+	for(k=slice_begin[s]; k<slice_begin[s+1]; ++k) {
+	    ++cursor[tmp[k].i];
+	}
+	cur = slice_begin[s];
+	for(i=ibegin; i<iend; ++i) {
+	    rowptr[i] = cur;
+	    cur += cursor[i];
+	    cursor[i] = rowptr[i];
+	}
+	for(k=slice_begin[s]; k<slice_begin[s+1]; ++k) {
+	    t = &(tmp[k]);
+	    sorted[cursor[t->i]++] = *t;
+	}
+    }
+    rowptr[M->m] = nnz;
+    
+    NL_DELETE_ARRAY(tmp);
+    NL_DELETE_ARRAY(cursor);
+    NL_DELETE_ARRAY(slice_begin);
+    NL_DELETE_ARRAY(offset);
+}
+
+/**
+ * \brief Sorts the triplets of a row by column index and
+ *  sums the duplicates.
+ * \details Insertion sort is used, since rows are short in 
+ *  general, and it keeps the order of the duplicates, which makes
+ *  the result deterministic.
+ * \param[in,out] row a pointer to the first triplet of the row
+ * \param[in] len number of triplets in the row
+ * \return the number of triplets after removing duplicates
+ */
+static NLuint nlTripletsSortAndSum(NLTriplet* row, NLuint len) {
+    NLuint k,l,result;
+    NLTriplet t;
+    for(k=1; k<len; ++k) {
+	t = row[k];
+	l = k;
+	while(l > 0 && row[l-1].j > t.j) {
+	    row[l] = row[l-1];
+	    --l;
+	}
+	row[l] = t;
+    }
+    result = 0;
+    for(k=0; k<len; ++k) {
+	if(result > 0 && row[result-1].j == row[k].j) {
+	    row[result-1].value += row[k].value;
+	} else {
+	    row[result] = row[k];
+	    ++result;
+	}
+    }
+    return result;
+}
+
+NLMatrix nlCRSMatrixNewFromCOOMatrix(NLCOOMatrix* M) {
+    NLuint nnz = nlCOOMatrixNNZ(M);
+    NLuint nslices = nlCRSMatrixDefaultNbSlices();
+    NLuint* rowptr = NL_NEW_ARRAY(NLuint, M->m+1);
+    NLuint* rowlen = NL_NEW_ARRAY(NLuint, M->m);
+    NLTriplet* sorted = NL_NEW_ARRAY(NLTriplet, nnz);
+    NLCRSMatrix* CRS = NL_NEW(NLCRSMatrix);
+    int m = (int)M->m;
+    int i;
+    NLuint k, cur;
+
+    nlCOOMatrixSortRows(M, rowptr, sorted);
+    
+#if defined(_OPENMP)
+#pragma omp parallel for private(i)
+#endif
+    for(i=0; i<m; ++i) {
+	rowlen[i] = nlTripletsSortAndSum(
+	    sorted + rowptr[i], rowptr[i+1] - rowptr[i]
+	);
+    }
+
+    cur = 0;
+    for(i=0; i<m; ++i) {
+	cur += rowlen[i];
+    }
+    
+    nlCRSMatrixConstruct(CRS, M->m, M->n, cur, nslices);
+    cur = 0;
+    for(i=0; i<m; ++i) {
+	CRS->rowptr[i] = cur;
+	cur += rowlen[i];
+    }
+    CRS->rowptr[m] = cur;
+
+#if defined(_OPENMP)
+#pragma omp parallel for private(i,k)
+#endif
+    for(i=0; i<m; ++i) {
+	for(k=0; k<rowlen[i]; ++k) {
+	    CRS->colind[CRS->rowptr[i]+k] = sorted[rowptr[i]+k].j;
+	    CRS->val[CRS->rowptr[i]+k] = sorted[rowptr[i]+k].value;
+	}
+    }
+    nlCRSMatrixComputeSlices(CRS);
+    
+    NL_DELETE_ARRAY(sorted);
+    NL_DELETE_ARRAY(rowlen);
+    NL_DELETE_ARRAY(rowptr);
+    return (NLMatrix)CRS;
+}
+
+NLMatrix nlSparseMatrixNewFromCOOMatrix(NLCOOMatrix* M, NLenum storage) {
+    NLSparseMatrix* result = (NLSparseMatrix*)nlSparseMatrixNew(
+	M->m, M->n, storage
+    );
+    NLuint b,k;
+    for(b=0; b<M->nb_buffers; ++b) {
+	for(k=0; k<M->buffer[b].size; ++k) {
+	    nlSparseMatrixAdd(
+		result,
+		M->buffer[b].triplet[k].i,
+		M->buffer[b].triplet[k].j,
+		M->buffer[b].triplet[k].value
+	    );
+	}
+    }
+    return (NLMatrix)result;
+}
+
+NLboolean nlCRSMatrixUpdateFromCOOMatrix(
+    NLCRSMatrix* CRS, NLCOOMatrix* M
+) {
+    NLuint nnz = nlCOOMatrixNNZ(M);
+    NLuint* rowptr = NL_NEW_ARRAY(NLuint, M->m+1);
+    NLTriplet* sorted = NL_NEW_ARRAY(NLTriplet, nnz);
+    int m = (int)M->m;
+    int nb_missing = 0;
+    int i;
+    NLuint k, lo, hi, mid, j;
+
+    nl_assert(CRS->type == NL_MATRIX_CRS);
+    nl_assert(!CRS->symmetric_storage);
+    nl_assert(CRS->m == M->m);
+    nl_assert(CRS->n == M->n);
+    
+    nlCOOMatrixSortRows(M, rowptr, sorted);
+
+#if defined(_OPENMP)
+#pragma omp parallel for private(i,k,lo,hi,mid,j) reduction(+:nb_missing)
+#endif
+    for(i=0; i<m; ++i) {
+	for(k=CRS->rowptr[i]; k<CRS->rowptr[i+1]; ++k) {
+	    CRS->val[k] = 0.0;
+	}
+	for(k=rowptr[i]; k<rowptr[i+1]; ++k) {
+	    /* Binary search of the column in the row */
+	    j = sorted[k].j;
+	    lo = CRS->rowptr[i];
+	    hi = CRS->rowptr[i+1];
+	    while(lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if(CRS->colind[mid] < j) {
+		    lo = mid + 1;
+		} else {
+		    hi = mid;
+		}
+	    }
+	    if(lo < CRS->rowptr[i+1] && CRS->colind[lo] == j) {
+		CRS->val[lo] += sorted[k].value;
+	    } else {
+		++nb_missing;
+	    }
+	}
+    }
+    
+    NL_DELETE_ARRAY(sorted);
+    NL_DELETE_ARRAY(rowptr);
+    return (nb_missing == 0) ? NL_TRUE : NL_FALSE;
+}
+
+/******************************************************************************/
+/* Single-precision CRS data structure */
+
+/**
+ * \brief Destroys a NLFloatCRSMatrix
+ * \details Only the coefficients are freed, the other arrays are
+ *  owned by the NLCRSMatrix the NLFloatCRSMatrix was created from.
+ * \param[in,out] M pointer to an NLFloatCRSMatrix
+ * \relates NLFloatCRSMatrix
+ */
+static void nlFloatCRSMatrixDestroy(NLFloatCRSMatrix* M) {
+    NL_DELETE_ARRAY(M->val);
+    M->rowptr = NULL;
+    M->colind = NULL;
+    M->sliceptr = NULL;
+    M->m = 0;
+    M->n = 0;
+    M->nslices = 0;
+}
+
+/**
+ * \brief Computes a matrix-vector product with double-precision vectors
+ * \param[in] M a pointer to the matrix
+ * \param[in] x the vector to be multiplied, size = M->n
+ * \param[out] y where to store the result, size = M->m
+ * \relates NLFloatCRSMatrix
+ */
+static void nlFloatCRSMatrixMultDouble(
+    NLFloatCRSMatrix* M, const double* x, double* y
+) {
+    int i;
+    int m = (int)(M->m);
+    NLuint jj;
+
+#if defined(_OPENMP)
+#pragma omp parallel for private(i,jj)
+#endif
+
+    for(i=0; i<m; ++i) {
+	double sum = 0.0;
+	for(jj=M->rowptr[i]; jj<M->rowptr[i+1]; ++jj) {
+	    sum += (double)(M->val[jj]) * x[M->colind[jj]];
+	}
+	y[i] = sum;
+    }
+    nlHostBlas()->flops += (NLulong)(2*M->rowptr[M->m]);
+}
+
+void nlFloatCRSMatrixMult(
+    NLFloatCRSMatrix* M, const float* x, float* y
+) {
+    int slice;
+    int nslices = (int)(M->nslices);
+    NLuint i,jj;
+
+#if defined(_OPENMP)
+#pragma omp parallel for private(slice,i,jj)
+#endif
+
+    for(slice=0; slice<nslices; ++slice) {
+	for(i=M->sliceptr[slice]; i<M->sliceptr[slice+1]; ++i) {
+	    float sum = 0.0f;
+	    for(jj=M->rowptr[i]; jj<M->rowptr[i+1]; ++jj) {
+		sum += M->val[jj] * x[M->colind[jj]];
+	    }
+	    y[i] = sum;
+	}
+    }
+    nlHostBlas()->flops += (NLulong)(2*M->rowptr[M->m]);
+}
+
+NLMatrix nlFloatCRSMatrixNewFromCRSMatrix(NLCRSMatrix* CRS) {
+    NLFloatCRSMatrix* M = NL_NEW(NLFloatCRSMatrix);
+    NLuint nnz = nlCRSMatrixNNZ(CRS);
+    int k;
+    nl_assert(!CRS->symmetric_storage);
+    M->m = CRS->m;
+    M->n = CRS->n;
+    M->type = NL_MATRIX_CRS_FLOAT;
+    M->destroy_func = (NLDestroyMatrixFunc)nlFloatCRSMatrixDestroy;
+    M->mult_func = (NLMultMatrixVectorFunc)nlFloatCRSMatrixMultDouble;
+    M->val = NL_NEW_ARRAY(float, nnz);
+    M->rowptr = CRS->rowptr;
+    M->colind = CRS->colind;
+    M->nslices = CRS->nslices;
+    M->sliceptr = CRS->sliceptr;
+
+#if defined(_OPENMP)
+#pragma omp parallel for private(k)
+#endif
+
+    for(k=0; k<(int)nnz; ++k) {
+	M->val[k] = (float)(CRS->val[k]);
+    }
+    return (NLMatrix)M;
+}
+
 /******************************************************************************/
 /* SparseMatrix data structure */
 
@@ -779,10 +1466,8 @@ void nlSparseMatrixAddColumn( NLSparseMatrix* M) {
 
 NLMatrix nlCRSMatrixNewFromSparseMatrix(NLSparseMatrix* M) {
     NLuint nnz = nlSparseMatrixNNZ(M);
-    NLuint nslices = 8; /* TODO: get number of cores */
-    NLuint slice, cur_bound, cur_NNZ, cur_row;
+    NLuint nslices = nlCRSMatrixDefaultNbSlices();
     NLuint i,ij,k; 
-    NLuint slice_size = nnz / nslices;
     NLCRSMatrix* CRS = NL_NEW(NLCRSMatrix);
 
     nl_assert(M->storage & NL_MATRIX_STORE_ROWS);
@@ -810,21 +1495,7 @@ NLMatrix nlCRSMatrixNewFromSparseMatrix(NLSparseMatrix* M) {
     CRS->rowptr[M->m] = k;
         
     /* Create "slices" to be used by parallel sparse matrix vector product */
-    if(CRS->sliceptr != NULL) {
-	cur_bound = slice_size;
-	cur_NNZ = 0;
-	cur_row = 0;
-	CRS->sliceptr[0]=0;
-	for(slice=1; slice<nslices; ++slice) {
-	    while(cur_NNZ < cur_bound && cur_row < M->m) {
-		++cur_row;
-		cur_NNZ += CRS->rowptr[cur_row+1] - CRS->rowptr[cur_row];
-	    }
-	    CRS->sliceptr[slice] = cur_row;
-	    cur_bound += slice_size;
-	}
-	CRS->sliceptr[nslices]=M->m;
-    }
+    nlCRSMatrixComputeSlices(CRS);
     return (NLMatrix)CRS;
 }
 
@@ -879,10 +1550,13 @@ NLMatrix nlCRSMatrixNewFromSparseMatrixSymmetric(NLSparseMatrix* M) {
 
 void nlMatrixCompress(NLMatrix* M) {
     NLMatrix CRS = NULL;
-    if((*M)->type != NL_MATRIX_SPARSE_DYNAMIC) {
+    if((*M)->type == NL_MATRIX_SPARSE_DYNAMIC) {
+	CRS = nlCRSMatrixNewFromSparseMatrix((NLSparseMatrix*)*M);
+    } else if((*M)->type == NL_MATRIX_COO) {
+	CRS = nlCRSMatrixNewFromCOOMatrix((NLCOOMatrix*)*M);
+    } else {
         return;
     }
-    CRS = nlCRSMatrixNewFromSparseMatrix((NLSparseMatrix*)*M);
     nlDeleteMatrix(*M);
     *M = CRS;
 }
@@ -892,6 +1566,12 @@ NLuint nlMatrixNNZ(NLMatrix M) {
 	return nlSparseMatrixNNZ((NLSparseMatrix*)M);
     } else if(M->type == NL_MATRIX_CRS) {
 	return nlCRSMatrixNNZ((NLCRSMatrix*)M);	
+    } else if(M->type == NL_MATRIX_SELL) {
+	return nlSELLMatrixNNZ((NLSELLMatrix*)M);
+    } else if(M->type == NL_MATRIX_COO) {
+	return nlCOOMatrixNNZ((NLCOOMatrix*)M);
+    } else if(M->type == NL_MATRIX_CRS_FLOAT) {
+	return ((NLFloatCRSMatrix*)M)->rowptr[M->m];
     }
     return M->m * M->n;
 }
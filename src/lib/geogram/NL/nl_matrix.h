@@ -78,6 +78,9 @@ typedef void(*NLMultMatrixVectorFunc)(NLMatrix M, const double* x, double* y);
 #define NL_MATRIX_CHOLMOD_EXT    0x1004    
 #define NL_MATRIX_FUNCTION       0x1005
 #define NL_MATRIX_OTHER          0x1006
+#define NL_MATRIX_SELL           0x1007
+#define NL_MATRIX_COO            0x1008
+#define NL_MATRIX_CRS_FLOAT      0x1009
     
 /**
  * \brief The base class for abstract matrices.
@@ -98,6 +101,7 @@ struct NLMatrixStruct {
      * \details One of NL_MATRIX_SPARSE_DYNAMIC, 
      *  NL_MATRIX_CRS, NL_MATRIX_SUPERLU_EXT,
      *  NL_CHOLDMOD_MATRIX_EXT, NL_MATRIX_FUNCTION,
+     *  NL_MATRIX_SELL, NL_MATRIX_COO, NL_MATRIX_CRS_FLOAT,
      *  NL_MATRIX_OTHER
      */
     NLenum type;
@@ -388,6 +392,412 @@ NLAPI NLboolean NLAPIENTRY nlCRSMatrixSave(
  */
 NLAPI NLuint NLAPIENTRY nlCRSMatrixNNZ(NLCRSMatrix* M);
     
+/******************************************************************************/
+/* Sliced ELLPACK (SELL-C-sigma) storage */
+
+/**
+ * \brief Maximum chunk height of an NLSELLMatrix.
+ */
+#define NL_SELL_MAX_CHUNK 16
+
+/**
+ * \brief A SIMD-friendly storage for sparse matrices.
+ * \details Rows are grouped into chunks of C consecutive rows. Within
+ *  each chunk, coefficients are stored column-major and padded to the
+ *  length of the longest row, so that the inner loop of the matrix-vector
+ *  product operates on C rows at once and can be vectorized by the compiler.
+ *  To limit padding, rows are sorted by decreasing length within windows
+ *  of sigma rows, and the permutation is kept to scatter the result. 
+ *  See Kreutzer et al., A unified sparse matrix data format for efficient
+ *  general sparse matrix-vector multiply on modern processors with wide
+ *  SIMD units, SIAM J. Sci. Comput., 2014.
+ */
+typedef struct {
+    /**
+     * \brief number of rows 
+     */    
+    NLuint m;
+    
+    /**
+     * \brief number of columns
+     */    
+    NLuint n;
+
+    /**
+     * \brief Matrix type, NL_MATRIX_SELL
+     */
+    NLenum type;
+    
+    /**
+     * \brief destructor
+     */
+    NLDestroyMatrixFunc destroy_func;
+
+    /**
+     * \brief Matrix x vector product
+     */
+    NLMultMatrixVectorFunc mult_func;
+
+    /**
+     * \brief chunk height, in 1..NL_SELL_MAX_CHUNK
+     */
+    NLuint C;
+
+    /**
+     * \brief sorting window, a multiple of C, or 1 if
+     *  rows are not sorted
+     */
+    NLuint sigma;
+    
+    /**
+     * \brief number of chunks, (m + C - 1) / C
+     */
+    NLuint nchunks;
+
+    /**
+     * \brief chunk pointers, size = nchunks + 1. Chunk c occupies
+     *  entries chunkptr[c] .. chunkptr[c+1]-1 in val and colind.
+     */
+    NLuint* chunkptr;
+
+    /**
+     * \brief coefficient values, including padding.
+     */
+    NLdouble* val;
+
+    /**
+     * \brief column indices, including padding.
+     */
+    NLuint* colind;
+
+    /**
+     * \brief row permutation, size = nchunks * C. The i-th stored
+     *  row corresponds to row perm[i] of the matrix 
+     *  (NL_UINT_MAX for padding rows).
+     */
+    NLuint* perm;
+
+    /**
+     * \brief number of non-zero coefficients, without padding.
+     */
+    NLuint nnz;
+} NLSELLMatrix;
+
+/**
+ * \brief Creates a SELL-C-sigma matrix from a compressed row storage matrix.
+ * \param[in] M a pointer to an NLCRSMatrix. It should not use
+ *  symmetric storage.
+ * \param[in] C chunk height, in 1..NL_SELL_MAX_CHUNK. It is typically
+ *  chosen as the number of doubles in a SIMD register (4 for AVX2,
+ *  8 for AVX-512).
+ * \param[in] sigma the size of the window in which rows are sorted by
+ *  decreasing length. If greater than 1, it is rounded up to a 
+ *  multiple of \p C. Using sigma = 1 (or 0) keeps the rows in their
+ *  initial order.
+ * \return a pointer to the created NLSELLMatrix
+ * \relates NLSELLMatrix
+ */
+NLAPI NLMatrix NLAPIENTRY nlSELLMatrixNewFromCRSMatrix(
+    NLCRSMatrix* M, NLuint C, NLuint sigma
+);
+
+/**
+ * \brief Gets the number of non-zero coefficients
+ *  in an NLSELLMatrix
+ * \details Padding coefficients are not counted.
+ * \param[in] M a pointer to the NLSELLMatrix
+ * \return the number of non-zero coefficients in \p M
+ * \relates NLSELLMatrix
+ */
+NLAPI NLuint NLAPIENTRY nlSELLMatrixNNZ(NLSELLMatrix* M);
+
+/**
+ * \brief Gets the fill ratio of an NLSELLMatrix
+ * \param[in] M a pointer to the NLSELLMatrix
+ * \return the number of stored coefficients (including padding) 
+ *  divided by the number of non-zero coefficients
+ * \relates NLSELLMatrix
+ */
+NLAPI double NLAPIENTRY nlSELLMatrixFillRatio(NLSELLMatrix* M);
+    
+/******************************************************************************/
+/* Coordinate (triplet) storage, used for parallel assembly */
+
+/**
+ * \brief A coefficient of a sparse matrix, with its row and column index.
+ * \relates NLCOOMatrix
+ */
+typedef struct {
+    /**
+     * \brief row index
+     */
+    NLuint i;
+
+    /**
+     * \brief column index
+     */
+    NLuint j;
+
+    /**
+     * \brief value of the coefficient
+     */
+    NLdouble value;
+} NLTriplet;
+
+/**
+ * \brief A dynamic array of triplets, written by a single thread.
+ * \details Padded to the size of a cache line, so that threads
+ *  that write to different buffers do not compete for the same 
+ *  cache line when updating the size.
+ * \relates NLCOOMatrix
+ */
+typedef struct {
+    /**
+     * \brief number of stored triplets
+     */
+    NLuint size;
+
+    /**
+     * \brief number of triplets that can be stored without
+     *  reallocating memory
+     */
+    NLuint capacity;
+
+    /**
+     * \brief the array of triplets
+     */
+    NLTriplet* triplet;
+
+    /**
+     * \brief padding to avoid false sharing
+     */
+    char padding[64 - 2*sizeof(NLuint) - sizeof(NLTriplet*)];
+} NLTripletBuffer;
+
+/**
+ * \brief A sparse matrix stored as an unsorted list of coefficients.
+ * \details Coefficients are appended to one of nb_buffers independent
+ *  buffers, without any search nor sort. Each thread writes to its own
+ *  buffer, so that the matrix can be assembled concurrently without
+ *  locking. Duplicate coefficients are summed when the matrix is converted
+ *  to compressed row storage by nlCRSMatrixNewFromCOOMatrix().
+ */
+typedef struct {
+    /**
+     * \brief number of rows 
+     */    
+    NLuint m;
+    
+    /**
+     * \brief number of columns
+     */    
+    NLuint n;
+
+    /**
+     * \brief Matrix type, NL_MATRIX_COO
+     */
+    NLenum type;
+    
+    /**
+     * \brief destructor
+     */
+    NLDestroyMatrixFunc destroy_func;
+
+    /**
+     * \brief Matrix x vector product
+     */
+    NLMultMatrixVectorFunc mult_func;
+
+    /**
+     * \brief number of buffers, typically the number of threads
+     */
+    NLuint nb_buffers;
+
+    /**
+     * \brief the buffers, size = nb_buffers
+     */
+    NLTripletBuffer* buffer;
+} NLCOOMatrix;
+
+/**
+ * \brief Creates a new NLCOOMatrix
+ * \param[in] m number of rows
+ * \param[in] n number of columns
+ * \param[in] nb_buffers number of independent buffers, i.e. maximum 
+ *   number of threads that can add coefficients concurrently
+ * \return a pointer to a dynamically allocated NLCOOMatrix.
+ *   It can be later deallocated by nlDeleteMatrix().
+ * \relates NLCOOMatrix
+ */
+NLAPI NLMatrix NLAPIENTRY nlCOOMatrixNew(
+    NLuint m, NLuint n, NLuint nb_buffers
+);
+
+/**
+ * \brief Adds a coefficient to an NLCOOMatrix
+ * \details Performs \f$ a_{i,j} \leftarrow a_{i,j} + \mbox{value} \f$.
+ *  Different threads can call this function concurrently provided that
+ *  they use different buffers.
+ * \param[in,out] M a pointer to an NLCOOMatrix
+ * \param[in] buffer the index of the buffer, in 0..nb_buffers-1
+ * \param[in] i index of the row
+ * \param[in] j index of the column
+ * \param[in] value the coefficient to be added
+ * \relates NLCOOMatrix
+ */
+NLAPI void NLAPIENTRY nlCOOMatrixAdd(
+    NLCOOMatrix* M, NLuint buffer, NLuint i, NLuint j, NLdouble value
+);
+
+/**
+ * \brief Removes all the coefficients of an NLCOOMatrix
+ * \details The memory is not freed, so that the matrix can be assembled
+ *  again without reallocation.
+ * \param[in,out] M a pointer to an NLCOOMatrix
+ * \relates NLCOOMatrix
+ */
+NLAPI void NLAPIENTRY nlCOOMatrixZero(NLCOOMatrix* M);
+
+/**
+ * \brief Gets the number of coefficients stored in an NLCOOMatrix
+ * \details Duplicate coefficients are counted as many times as they
+ *  were added.
+ * \param[in] M a pointer to an NLCOOMatrix
+ * \return the number of stored triplets
+ * \relates NLCOOMatrix
+ */
+NLAPI NLuint NLAPIENTRY nlCOOMatrixNNZ(NLCOOMatrix* M);
+
+/**
+ * \brief Creates a compressed row storage matrix from a COO matrix.
+ * \details Triplets are sorted by row then column in parallel, and
+ *  duplicate coefficients are summed. The result does not depend on the
+ *  number of threads.
+ * \param[in] M a pointer to the NLCOOMatrix
+ * \return a pointer to the created NLCRSMatrix
+ * \relates NLCRSMatrix
+ */
+NLAPI NLMatrix NLAPIENTRY nlCRSMatrixNewFromCOOMatrix(NLCOOMatrix* M);
+
+/**
+ * \brief Creates a dynamic sparse matrix from a COO matrix.
+ * \details Used by the preconditioners that need an NLSparseMatrix 
+ *  (SSOR). Duplicate coefficients are summed, in the order of the buffers.
+ * \param[in] M a pointer to the NLCOOMatrix
+ * \param[in] storage a bitwise or combination of flags that
+ *  indicate what needs to be stored in the matrix.
+ * \return a pointer to the created NLSparseMatrix
+ * \relates NLSparseMatrix
+ */
+NLAPI NLMatrix NLAPIENTRY nlSparseMatrixNewFromCOOMatrix(
+    NLCOOMatrix* M, NLenum storage
+);
+
+/**
+ * \brief Replaces the coefficients of a CRS matrix with the ones 
+ *   of a COO matrix, keeping the sparsity pattern.
+ * \details This avoids sorting columns and reallocating memory when
+ *   the same sparsity pattern is assembled several times, for instance
+ *   in the successive iterations of a Newton solver.
+ * \param[in,out] CRS a pointer to an NLCRSMatrix, with non-symmetric
+ *   storage
+ * \param[in] M a pointer to an NLCOOMatrix of the same size
+ * \retval NL_TRUE if all the coefficients of \p M are in the sparsity
+ *   pattern of \p CRS
+ * \retval NL_FALSE otherwise. In this case the coefficients that are 
+ *   not in the pattern are ignored, and a new CRS matrix should be 
+ *   created with nlCRSMatrixNewFromCOOMatrix().
+ * \relates NLCRSMatrix
+ */
+NLAPI NLboolean NLAPIENTRY nlCRSMatrixUpdateFromCOOMatrix(
+    NLCRSMatrix* CRS, NLCOOMatrix* M
+);
+    
+/******************************************************************************/
+/* Single-precision Compressed Row Storage, used for mixed-precision solves */
+
+/**
+ * \brief A single-precision copy of the coefficients of an NLCRSMatrix.
+ * \details The row pointers, column indices and slices are shared with 
+ *  the NLCRSMatrix it was created from, that should not be destroyed 
+ *  before. The generic matrix-vector product (nlMultMatrixVector()) 
+ *  operates on double-precision vectors, nlFloatCRSMatrixMult() operates
+ *  on single-precision vectors.
+ */
+typedef struct {
+    /**
+     * \brief number of rows 
+     */    
+    NLuint m;
+    
+    /**
+     * \brief number of columns
+     */    
+    NLuint n;
+
+    /**
+     * \brief Matrix type, NL_MATRIX_CRS_FLOAT
+     */
+    NLenum type;
+    
+    /**
+     * \brief destructor
+     */
+    NLDestroyMatrixFunc destroy_func;
+
+    /**
+     * \brief Matrix x vector product
+     */
+    NLMultMatrixVectorFunc mult_func;
+
+    /**
+     * \brief array of coefficient values, size = NNZ
+     */    
+    float* val;    
+
+    /**
+     * \brief row pointers, size = m+1, shared with the NLCRSMatrix
+     */    
+    NLuint* rowptr;
+
+    /**
+     * \brief column indices, size = NNZ, shared with the NLCRSMatrix
+     */    
+    NLuint* colind;
+
+    /**
+     * \brief number of slices, used by parallel spMv
+     */    
+    NLuint nslices;
+
+    /** 
+     * \brief slice pointers, size = nslices + 1, shared with the
+     *  NLCRSMatrix
+     */    
+    NLuint* sliceptr;
+} NLFloatCRSMatrix;
+
+/**
+ * \brief Creates a single-precision copy of an NLCRSMatrix.
+ * \param[in] CRS a pointer to an NLCRSMatrix, without symmetric 
+ *  storage. Its rowptr, colind and sliceptr arrays are shared, 
+ *  it should not be destroyed before the result.
+ * \return a pointer to a new NLFloatCRSMatrix
+ * \relates NLFloatCRSMatrix
+ */
+NLAPI NLMatrix NLAPIENTRY nlFloatCRSMatrixNewFromCRSMatrix(NLCRSMatrix* CRS);
+
+/**
+ * \brief Computes a single-precision matrix-vector product
+ * \param[in] M a pointer to the matrix
+ * \param[in] x the vector to be multiplied, size = M->n
+ * \param[out] y where to store the result, size = M->m
+ * \relates NLFloatCRSMatrix
+ */
+NLAPI void NLAPIENTRY nlFloatCRSMatrixMult(
+    NLFloatCRSMatrix* M, const float* x, float* y
+);
+
 /******************************************************************************/
 /* SparseMatrix data structure */
 
@@ -668,9 +1078,9 @@ NLAPI NLMatrix NLAPIENTRY nlCRSMatrixNewFromSparseMatrixSymmetric(
 
     
 /**
- * \brief Compresses a dynamic sparse matrix into a CRS matrix.
- * \details If the input matrix is not a dynamic sparse matrix, it is left
- *  unmodified.
+ * \brief Compresses a dynamic sparse matrix or a COO matrix into a CRS matrix.
+ * \details If the input matrix is neither a dynamic sparse matrix nor a
+ *  COO matrix, it is left unmodified.
  * \param[in,out] M a pointer to the matrix to be compressed
  * \relates NLMatrix
  */
@@ -53,17 +53,22 @@
  * \brief Internal OpenNL functions that implement preconditioners.
  */
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /******************************************************************************/
 /* preconditioners */
 
 /**
  * \brief Creates a new Jacobi preconditioner
  * \param[in] M the matrix, needs to be of type NL_MATRIX_SPARSE_DYNAMIC
+ *  or NL_MATRIX_CRS
  * \details The inverse of the diagonal is stored in the preconditioner. 
  *  No reference to the input data is kept.
  * \return the Jacobi preconditioner
  */
-NLMatrix nlNewJacobiPreconditioner(NLMatrix M);
+NLAPI NLMatrix NLAPIENTRY nlNewJacobiPreconditioner(NLMatrix M);
 
 /**
  * \brief Creates a new SSOR preconditioner
@@ -76,4 +81,25 @@ NLMatrix nlNewJacobiPreconditioner(NLMatrix M);
  */
 NLMatrix nlNewSSORPreconditioner(NLMatrix M, double omega);
 
+/**
+ * \brief Creates a new smoothed aggregation multigrid preconditioner
+ * \param[in] M the matrix, needs to be symmetric, of type 
+ *  NL_MATRIX_SPARSE_DYNAMIC or NL_MATRIX_CRS, without symmetric storage.
+ * \param[in] component if non-NULL, an array of size M->n with the 
+ *  component of each unknown (for instance, 0 for the u coordinates and
+ *  1 for the v coordinates). Only unknowns of the same component are 
+ *  grouped in the same aggregate. 
+ * \details The unknowns are recursively grouped into aggregates of 
+ *  strongly connected neighbors, and the coarse matrices are obtained by
+ *  Galerkin products. Applying the preconditioner runs a V-cycle with 
+ *  symmetric Gauss-Seidel smoothing. No reference to the input data is 
+ *  kept.
+ * \return the multigrid preconditioner
+ */
+NLMatrix nlNewMultigridPreconditioner(NLMatrix M, const NLuint* component);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif
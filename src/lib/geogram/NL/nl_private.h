@@ -78,6 +78,18 @@
 #define NL_OS_WINDOWS
 #endif
 
+/**
+ * \brief Declares a thread-local variable.
+ * \details Each thread has its own copy of the variable. It is used for 
+ *  the current context and for the statistics of the host BLAS, so that 
+ *  different threads can use different contexts concurrently.
+ */
+#if defined(_MSC_VER)
+#define NL_THREAD_LOCAL __declspec(thread)
+#else
+#define NL_THREAD_LOCAL __thread
+#endif
+
 /**
  * \brief Suppresses unsused argument warnings
  * \details Some callbacks do not necessary use all their
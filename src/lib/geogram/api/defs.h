@@ -46,6 +46,8 @@
 #ifndef GEOGRAM_API_DEFS
 #define GEOGRAM_API_DEFS
 
+#include <geogram/api/config.h>
+
 /**
  * \file geogram/api/defs.h
  * \brief Basic definitions for the Geogram C API
@@ -110,6 +112,26 @@ typedef int GeoMesh;
  */
 typedef unsigned char geo_coord_index_t;
 
+#ifdef GEOGRAM_WITH_64BIT_INDICES
+
+#include <stdint.h>
+
+/**
+ * \brief Represents indices.
+ * \details Used by the C API. Geogram was configured with
+ *  GEOGRAM_WITH_64BIT_INDICES, thus indices are 64 bits wide, and
+ *  meshes can have more than 4 billion elements.
+ */
+typedef uint64_t geo_index_t;
+
+/**
+ * \brief Represents possibly negative indices.
+ * \details Used by the C API.
+ */
+typedef int64_t geo_signed_index_t;
+
+#else
+
 /**
  * \brief Represents indices.
  * \details Used by the C API.
@@ -122,6 +144,8 @@ typedef unsigned int geo_index_t;
  */
 typedef int geo_signed_index_t;
 
+#endif
+
 /**
  * \brief Represents floating-point coordinates.
  * \details Used by the C API.
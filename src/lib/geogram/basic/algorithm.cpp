@@ -45,6 +45,224 @@
 
 #include <geogram/basic/algorithm.h>
 #include <geogram/basic/command_line.h>
+#include <geogram/basic/process.h>
+
+namespace {
+
+    using namespace GEO;
+
+    /**
+     * \brief Number of bits of the digits used by the radix sort.
+     */
+    const index_t RADIX_BITS = 8;
+
+    /**
+     * \brief Number of different digits.
+     */
+    const index_t RADIX_SIZE = 1u << RADIX_BITS;
+
+    /**
+     * \brief Minimum number of keys processed by each thread.
+     */
+    const index_t RADIX_MIN_CHUNK_SIZE = 65536;
+
+    /**
+     * \brief Implementation of the parallel radix sort.
+     * \details The keys are split into contiguous chunks, one per
+     *  thread. Each pass sorts the keys by one digit: the histograms of
+     *  the chunks are computed in parallel, then a prefix sum (in digit
+     *  major, chunk minor order) gives for each chunk and each digit
+     *  the position where the keys are moved, in parallel. Since the
+     *  chunks are contiguous and keep their order, each pass is stable.
+     * \tparam KEY type of the keys, an unsigned integer
+     */
+    template <class KEY> class RadixSort {
+    public:
+        /**
+         * \brief RadixSort constructor.
+         * \param[in,out] keys the keys to be sorted
+         * \param[in,out] indices the indices moved with the keys or nil
+         */
+        RadixSort(vector<KEY>& keys, vector<index_t>* indices) :
+            keys_(keys),
+            indices_(indices),
+            shift_(0) {
+            index_t n = keys.size();
+            nb_chunks_ = geo_max(
+                index_t(1),
+                geo_min(
+                    Process::maximum_concurrent_threads(),
+                    n / RADIX_MIN_CHUNK_SIZE
+                )
+            );
+            chunk_size_ = n / nb_chunks_;
+            if(n % nb_chunks_ != 0) {
+                ++chunk_size_;
+            }
+            diff_.assign(nb_chunks_, KEY(0));
+            offset_.assign(nb_chunks_ * RADIX_SIZE, 0);
+        }
+
+        /**
+         * \brief Sorts the keys.
+         */
+        void sort() {
+            index_t n = keys_.size();
+            if(n < 2) {
+                return;
+            }
+
+            // Find the digits that differ between the keys.
+            parallel_for(
+                parallel_for_member_callback(this, &RadixSort::find_diff),
+                0, nb_chunks_
+            );
+            KEY diff = KEY(0);
+            for(index_t c = 0; c < nb_chunks_; ++c) {
+                diff |= diff_[c];
+            }
+
+            vector<KEY> keys_tmp(n);
+            vector<index_t> indices_tmp;
+            if(indices_ != nil) {
+                geo_assert(indices_->size() == n);
+                indices_tmp.resize(n);
+            }
+            src_keys_ = keys_.data();
+            dst_keys_ = keys_tmp.data();
+            src_indices_ = nil;
+            dst_indices_ = nil;
+            if(indices_ != nil) {
+                src_indices_ = indices_->data();
+                dst_indices_ = indices_tmp.data();
+            }
+
+            bool swapped = false;
+            for(
+                shift_ = 0; shift_ < index_t(sizeof(KEY) * 8);
+                shift_ += RADIX_BITS
+            ) {
+                if(((diff >> shift_) & KEY(RADIX_SIZE - 1)) == KEY(0)) {
+                    continue;
+                }
+                parallel_for(
+                    parallel_for_member_callback(this, &RadixSort::count),
+                    0, nb_chunks_
+                );
+                index_t cur = 0;
+                for(index_t d = 0; d < RADIX_SIZE; ++d) {
+                    for(index_t c = 0; c < nb_chunks_; ++c) {
+                        index_t nb = offset_[c * RADIX_SIZE + d];
+                        offset_[c * RADIX_SIZE + d] = cur;
+                        cur += nb;
+                    }
+                }
+                parallel_for(
+                    parallel_for_member_callback(this, &RadixSort::scatter),
+                    0, nb_chunks_
+                );
+                std::swap(src_keys_, dst_keys_);
+                std::swap(src_indices_, dst_indices_);
+                swapped = !swapped;
+            }
+
+            if(swapped) {
+                keys_.swap(keys_tmp);
+                if(indices_ != nil) {
+                    indices_->swap(indices_tmp);
+                }
+            }
+        }
+
+    protected:
+        /**
+         * \brief Gets the first key of a chunk.
+         * \param[in] c index of the chunk
+         */
+        index_t chunk_begin(index_t c) const {
+            return geo_min(c * chunk_size_, index_t(keys_.size()));
+        }
+
+        /**
+         * \brief Gets one position past the last key of a chunk.
+         * \param[in] c index of the chunk
+         */
+        index_t chunk_end(index_t c) const {
+            return chunk_begin(c + 1);
+        }
+
+        /**
+         * \brief Computes the bits that differ between the keys of
+         *  a chunk and the first key.
+         * \details Used by parallel_for()
+         * \param[in] c index of the chunk
+         */
+        void find_diff(index_t c) {
+            const KEY* keys = keys_.data();
+            KEY key0 = keys[0];
+            KEY diff = KEY(0);
+            index_t e = chunk_end(c);
+            for(index_t i = chunk_begin(c); i < e; ++i) {
+                diff |= (keys[i] ^ key0);
+            }
+            diff_[c] = diff;
+        }
+
+        /**
+         * \brief Computes the histogram of the current digit in a chunk.
+         * \details Used by parallel_for()
+         * \param[in] c index of the chunk
+         */
+        void count(index_t c) {
+            index_t* histo = &offset_[c * RADIX_SIZE];
+            for(index_t d = 0; d < RADIX_SIZE; ++d) {
+                histo[d] = 0;
+            }
+            index_t e = chunk_end(c);
+            for(index_t i = chunk_begin(c); i < e; ++i) {
+                ++histo[index_t(src_keys_[i] >> shift_) & (RADIX_SIZE - 1)];
+            }
+        }
+
+        /**
+         * \brief Moves the keys of a chunk to their position.
+         * \details Used by parallel_for()
+         * \param[in] c index of the chunk
+         */
+        void scatter(index_t c) {
+            index_t* offset = &offset_[c * RADIX_SIZE];
+            index_t e = chunk_end(c);
+            if(src_indices_ == nil) {
+                for(index_t i = chunk_begin(c); i < e; ++i) {
+                    KEY k = src_keys_[i];
+                    index_t d = index_t(k >> shift_) & (RADIX_SIZE - 1);
+                    dst_keys_[offset[d]++] = k;
+                }
+            } else {
+                for(index_t i = chunk_begin(c); i < e; ++i) {
+                    KEY k = src_keys_[i];
+                    index_t d = index_t(k >> shift_) & (RADIX_SIZE - 1);
+                    index_t j = offset[d]++;
+                    dst_keys_[j] = k;
+                    dst_indices_[j] = src_indices_[i];
+                }
+            }
+        }
+
+    private:
+        vector<KEY>& keys_;
+        vector<index_t>* indices_;
+        index_t nb_chunks_;
+        index_t chunk_size_;
+        index_t shift_;
+        vector<KEY> diff_;
+        vector<index_t> offset_;
+        KEY* src_keys_;
+        KEY* dst_keys_;
+        index_t* src_indices_;
+        index_t* dst_indices_;
+    };
+}
 
 namespace GEO {
 
@@ -59,5 +277,28 @@ namespace GEO {
         }
         return result;
     }
-}
 
+    void radix_sort(vector<Numeric::uint32>& keys) {
+        RadixSort<Numeric::uint32> sorter(keys, nil);
+        sorter.sort();
+    }
+
+    void radix_sort(vector<Numeric::uint64>& keys) {
+        RadixSort<Numeric::uint64> sorter(keys, nil);
+        sorter.sort();
+    }
+
+    void radix_sort(
+        vector<Numeric::uint32>& keys, vector<index_t>& indices
+    ) {
+        RadixSort<Numeric::uint32> sorter(keys, &indices);
+        sorter.sort();
+    }
+
+    void radix_sort(
+        vector<Numeric::uint64>& keys, vector<index_t>& indices
+    ) {
+        RadixSort<Numeric::uint64> sorter(keys, &indices);
+        sorter.sort();
+    }
+}
@@ -47,6 +47,8 @@
 #define GEOGRAM_BASIC_ALGORITHM
 
 #include <geogram/basic/common.h>
+#include <geogram/basic/numeric.h>
+#include <geogram/basic/memory.h>
 
 #if defined(GEO_OS_LINUX) && defined(GEO_OPENMP)
 #if (__GNUC__ >= 4) && (__GNUC_MINOR__ >= 4) && !defined(GEO_OS_ANDROID)
@@ -201,7 +203,136 @@ namespace GEO {
 	    std::swap(items[2], items[3]);
 	}
     }
-    
+
+    /**
+     * \brief Sorts integer keys in parallel.
+     * \details Uses a least significant digit radix sort, with 8-bits
+     *  digits. Each pass computes the histograms of the digits of
+     *  contiguous chunks of keys in parallel, then moves the keys in
+     *  parallel. Digits that are the same for all the keys are skipped.
+     *  The cost is linear in the number of keys.
+     * \param[in,out] keys the keys to be sorted
+     */
+    void GEOGRAM_API radix_sort(vector<Numeric::uint32>& keys);
+
+    /**
+     * \copydoc radix_sort(vector<Numeric::uint32>&)
+     */
+    void GEOGRAM_API radix_sort(vector<Numeric::uint64>& keys);
+
+    /**
+     * \brief Sorts integer keys and associated indices in parallel.
+     * \details The sort is stable: indices associated with equal keys
+     *  stay in the same order. Initializing \p indices with the
+     *  identity gives the permutation that sorts the keys.
+     * \param[in,out] keys the keys to be sorted
+     * \param[in,out] indices the indices associated with the keys,
+     *  moved together with them
+     * \pre indices.size() == keys.size()
+     * \see radix_sort(vector<Numeric::uint32>&)
+     */
+    void GEOGRAM_API radix_sort(
+        vector<Numeric::uint32>& keys, vector<index_t>& indices
+    );
+
+    /**
+     * \copydoc radix_sort(vector<Numeric::uint32>&,vector<index_t>&)
+     */
+    void GEOGRAM_API radix_sort(
+        vector<Numeric::uint64>& keys, vector<index_t>& indices
+    );
+
+    /**
+     * \brief Number of bits of each coordinate used by Morton_key_3d()
+     *  and Hilbert_key_3d().
+     */
+    const index_t SPATIAL_KEY_BITS = 21;
+
+    /**
+     * \brief Spreads the bits of an integer.
+     * \details Inserts two zero bits between two consecutive bits.
+     * \param[in] x an integer, only the SPATIAL_KEY_BITS least significant
+     *  bits are used
+     * \return an integer where bit \p i of \p x is bit \p 3i
+     */
+    inline Numeric::uint64 spread_bits_3d(Numeric::uint32 x) {
+        Numeric::uint64 r = Numeric::uint64(x) & 0x1fffffull;
+        r = (r | (r << 32)) & 0x1f00000000ffffull;
+        r = (r | (r << 16)) & 0x1f0000ff0000ffull;
+        r = (r | (r << 8))  & 0x100f00f00f00f00full;
+        r = (r | (r << 4))  & 0x10c30c30c30c30c3ull;
+        r = (r | (r << 2))  & 0x1249249249249249ull;
+        return r;
+    }
+
+    /**
+     * \brief Computes the index of a cell of a regular grid along
+     *  the Morton (Z-order) curve.
+     * \details The bits of the coordinates are interleaved, without any
+     *  branch.
+     * \param[in] x , y , z the integer coordinates of the cell, in
+     *  [0, 2^SPATIAL_KEY_BITS - 1]
+     * \return the index of the cell along the curve, on 63 bits
+     */
+    inline Numeric::uint64 Morton_key_3d(
+        Numeric::uint32 x, Numeric::uint32 y, Numeric::uint32 z
+    ) {
+        return
+            (spread_bits_3d(x) << 2) |
+            (spread_bits_3d(y) << 1) |
+            spread_bits_3d(z);
+    }
+
+    /**
+     * \brief Computes the index of a cell of a regular grid along
+     *  the Hilbert curve.
+     * \details Uses the algorithm in:
+     *  - John Skilling, Programming the Hilbert curve, AIP Conference
+     *   Proceedings 707, 2004.
+     *
+     *  that transforms the coordinates with bitwise operations, written
+     *  here without branches.
+     * \param[in] x , y , z the integer coordinates of the cell, in
+     *  [0, 2^SPATIAL_KEY_BITS - 1]
+     * \return the index of the cell along the curve, on 63 bits
+     */
+    inline Numeric::uint64 Hilbert_key_3d(
+        Numeric::uint32 x, Numeric::uint32 y, Numeric::uint32 z
+    ) {
+        const Numeric::uint32 M = 1u << (SPATIAL_KEY_BITS - 1);
+        // Inverse undo
+        for(Numeric::uint32 Q = M; Q > 1; Q >>= 1) {
+            Numeric::uint32 P = Q - 1;
+            Numeric::uint32 t;
+            Numeric::uint32 invert;
+
+            // x: invert low bits of x if bit Q of x is set
+            x ^= (0u - Numeric::uint32((x & Q) != 0)) & P;
+
+            // y: invert low bits of x or exchange low bits of x and y
+            invert = 0u - Numeric::uint32((y & Q) != 0);
+            t = (x ^ y) & P & ~invert;
+            x ^= (P & invert) | t;
+            y ^= t;
+
+            // z: same as y
+            invert = 0u - Numeric::uint32((z & Q) != 0);
+            t = (x ^ z) & P & ~invert;
+            x ^= (P & invert) | t;
+            z ^= t;
+        }
+        // Gray encode
+        y ^= x;
+        z ^= y;
+        Numeric::uint32 t = 0;
+        for(Numeric::uint32 Q = M; Q > 1; Q >>= 1) {
+            t ^= (0u - Numeric::uint32((z & Q) != 0)) & (Q - 1);
+        }
+        x ^= t;
+        y ^= t;
+        z ^= t;
+        return Morton_key_3d(x,y,z);
+    }
 }
 
 #endif
@@ -83,7 +83,8 @@ namespace GEO {
         dimension_(dim),
         cached_base_addr_(nil),
         cached_size_(0),
-        lock_(GEOGRAM_SPINLOCK_INIT)
+        lock_(GEOGRAM_SPINLOCK_INIT),
+        shared_(false)
     {
     }
     
@@ -129,9 +130,19 @@ namespace GEO {
         Process::release_spinlock(lock_);                
     }
 
+    void AttributeStore::unshare_store() {
+        Process::acquire_spinlock(lock_);
+        if(shared_) {
+            unshare_data();
+            shared_ = false;
+        }
+        Process::release_spinlock(lock_);
+    }
+
     void AttributeStore::apply_permutation(
         const vector<index_t>& permutation
     ) {
+        unshare();
         geo_debug_assert(permutation.size() <= cached_size_);
         Permutation::apply(
             cached_base_addr_, permutation, element_size_ * dimension_
@@ -141,6 +152,7 @@ namespace GEO {
     void AttributeStore::compress(
         const vector<index_t>& old2new
     ) {
+        unshare();
         geo_debug_assert(old2new.size() <= cached_size_);
         index_t item_size = element_size_ * dimension_;
         for(index_t i=0; i<old2new.size(); ++i) {
@@ -158,6 +170,7 @@ namespace GEO {
     }
 
     void AttributeStore::zero() {
+        unshare();
         Memory::clear(
             cached_base_addr_, element_size_ * dimension_ * cached_size_
         );
@@ -165,6 +178,40 @@ namespace GEO {
     
     /*************************************************************************/
 
+    namespace {
+
+        /** \brief The interned names, indexed by AttributeKey::id() */
+        std::vector<const std::string*>* key_names_ = nil;
+
+        /** \brief Maps each interned name to its AttributeKey::id() */
+        std::map<std::string, index_t>* key_ids_ = nil;
+
+        Process::spinlock keys_lock_ = GEOGRAM_SPINLOCK_INIT;
+    }
+
+    AttributeKey::AttributeKey(const std::string& name) {
+        Process::acquire_spinlock(keys_lock_);
+        // Allocated on first use, since keys can be static variables
+        // initialized before this file's static variables, and never
+        // deallocated, since they can also be destroyed after them.
+        if(key_ids_ == nil) {
+            key_ids_ = new std::map<std::string, index_t>;
+            key_names_ = new std::vector<const std::string*>;
+        }
+        std::map<std::string, index_t>::iterator it = key_ids_->find(name);
+        if(it == key_ids_->end()) {
+            it = key_ids_->insert(
+                std::make_pair(name, index_t(key_names_->size()))
+            ).first;
+            key_names_->push_back(&(it->first));
+        }
+        id_ = it->second;
+        name_ = &(it->first);
+        Process::release_spinlock(keys_lock_);
+    }
+
+    /*************************************************************************/
+
     AttributesManager::AttributesManager() : size_(0) {
     }
 
@@ -189,6 +236,28 @@ namespace GEO {
     void AttributesManager::apply_permutation(
         const vector<index_t>& permutation
     ) {
+        // Large attributes are permuted all together, in parallel.
+        if(
+            attributes_.size() > 1 &&
+            permutation.size() >= Permutation::OUT_OF_PLACE_THRESHOLD
+        ) {
+            vector<void*> data;
+            vector<index_t> elemsize;
+            for(
+                std::map<std::string, AttributeStore*>::iterator
+                    it=attributes_.begin();
+                it != attributes_.end(); ++it
+            ) {
+                data.push_back(it->second->data());
+                elemsize.push_back(
+                    index_t(it->second->element_size()) *
+                    it->second->dimension()
+                );
+            }
+            if(Permutation::apply_out_of_place(data, elemsize, permutation)) {
+                return;
+            }
+        }
         for(
             std::map<std::string, AttributeStore*>::iterator
                 it=attributes_.begin();
@@ -216,6 +285,13 @@ namespace GEO {
     ) {
         geo_assert(find_attribute_store(name) == nil);
         attributes_[name] = as;
+        // Interns the name, so that AttributeKeys created later with
+        // the same name find the store.
+        AttributeKey key(name);
+        if(key.id() >= store_by_key_.size()) {
+            store_by_key_.resize(key.id() + 1, nil);
+        }
+        store_by_key_[key.id()] = as;
         as->resize(size_);
     }
 
@@ -258,6 +334,10 @@ namespace GEO {
             it = attributes_.find(name);
         geo_assert(it != attributes_.end());
         geo_assert(!it->second->has_observers());
+        std::replace(
+            store_by_key_.begin(), store_by_key_.end(),
+            it->second, (AttributeStore*)(nil)
+        );
         delete it->second;
         attributes_.erase(it);
     }
@@ -269,6 +349,10 @@ namespace GEO {
             it != attributes_.end(); ++it
         ) {
             if(it->second == as) {
+                std::replace(
+                    store_by_key_.begin(), store_by_key_.end(),
+                    as, (AttributeStore*)(nil)
+                );
                 delete as;
                 attributes_.erase(it);
                 return;
@@ -296,6 +380,7 @@ namespace GEO {
                 delete it->second;
             }
             attributes_.clear();
+            store_by_key_.clear();
         }
         size_ = 0;
     }
@@ -430,6 +515,17 @@ namespace GEO {
         if(store->element_typeid_name() == typeid(vec3).name()) {
             return ET_VEC3;
         }
+
+        if(store->element_typeid_name() == typeid(Numeric::float16).name()) {
+            return ET_FLOAT16;
+        }
+
+        if(
+            store->element_typeid_name() ==
+            typeid(QuantizedAttributeStore).name()
+        ) {
+            return ET_QUANTIZED16;
+        }
         
         return ET_NONE;
     }
@@ -498,6 +594,124 @@ namespace GEO {
     }
     
     /************************************************************************/ 
+
+    namespace {
+
+        /**
+         * \brief Gets the elements of an attribute of real numbers.
+         * \param[in] store a pointer to the AttributeStore
+         * \param[out] values the decoded elements
+         * \retval true if \p store is an attribute of real numbers
+         * \retval false otherwise (then \p values is unchanged)
+         */
+        bool get_real_elements(
+            const AttributeStore* store, vector<double>& values
+        ) {
+            const std::string type = store->element_typeid_name();
+            index_t nb = store->size() * store->dimension();
+            if(type == typeid(double).name()) {
+                const double* data = (const double*)(store->data());
+                values.resize(nb);
+                for(index_t i=0; i<nb; ++i) {
+                    values[i] = data[i];
+                }
+            } else if(type == typeid(float).name()) {
+                const float* data = (const float*)(store->data());
+                values.resize(nb);
+                for(index_t i=0; i<nb; ++i) {
+                    values[i] = double(data[i]);
+                }
+            } else if(type == typeid(Numeric::float16).name()) {
+                const Numeric::float16* data =
+                    (const Numeric::float16*)(store->data());
+                values.resize(nb);
+                for(index_t i=0; i<nb; ++i) {
+                    values[i] = double(float(data[i]));
+                }
+            } else if(type == typeid(QuantizedAttributeStore).name()) {
+                const QuantizedAttributeStore* qstore =
+                    static_cast<const QuantizedAttributeStore*>(store);
+                const Numeric::uint16* data =
+                    (const Numeric::uint16*)(store->data());
+                values.resize(nb);
+                for(index_t i=0; i<nb; ++i) {
+                    values[i] = qstore->decode(data[i]);
+                }
+            } else {
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * \brief Creates an attribute store and copies real numbers
+         *  into it.
+         * \tparam T the type of the elements, that can be 
+         *  constructed from a double
+         * \param[in] dim the dimension of the attribute
+         * \param[in] values the elements
+         * \return a pointer to the new AttributeStore
+         */
+        template <class T> AttributeStore* create_real_store(
+            index_t dim, const vector<double>& values
+        ) {
+            TypedAttributeStore<T>* store = new TypedAttributeStore<T>(dim);
+            store->resize(values.size() / dim);
+            T* data = (T*)(store->data());
+            for(index_t i=0; i<values.size(); ++i) {
+                data[i] = T(values[i]);
+            }
+            return store;
+        }
+    }
+
+    bool set_attribute_encoding(
+        AttributesManager& manager, const std::string& name,
+        AttributeEncoding encoding
+    ) {
+        AttributeStore* store = manager.find_attribute_store(name);
+        if(store == nil || store->has_observers()) {
+            return false;
+        }
+        vector<double> values;
+        if(!get_real_elements(store, values)) {
+            return false;
+        }
+        index_t dim = store->dimension();
+        AttributeStore* new_store = nil;
+        switch(encoding) {
+        case ATTRIBUTE_FLOAT64:
+            new_store = create_real_store<double>(dim, values);
+            break;
+        case ATTRIBUTE_FLOAT32:
+            new_store = create_real_store<float>(dim, values);
+            break;
+        case ATTRIBUTE_FLOAT16:
+            new_store = create_real_store<Numeric::float16>(dim, values);
+            break;
+        case ATTRIBUTE_QUANTIZED16: {
+            double vmin = 0.0;
+            double vmax = 0.0;
+            if(values.size() != 0) {
+                vmin = *std::min_element(values.begin(), values.end());
+                vmax = *std::max_element(values.begin(), values.end());
+            }
+            QuantizedAttributeStore* qstore =
+                new QuantizedAttributeStore(dim, vmin, vmax);
+            qstore->resize(store->size());
+            Numeric::uint16* data = (Numeric::uint16*)(qstore->data());
+            for(index_t i=0; i<values.size(); ++i) {
+                data[i] = qstore->encode(values[i]);
+            }
+            new_store = qstore;
+        } break;
+        }
+        manager.delete_attribute_store(name);
+        manager.bind_attribute_store(name, new_store);
+        return true;
+    }
+
+    /************************************************************************/ 
     
 }
 
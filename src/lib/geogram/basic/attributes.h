@@ -315,9 +315,36 @@ namespace GEO {
          * \brief Creates a new AttributeStore that is a carbon copy
          *  of this AttributeStore.
          * \details Only the data is copied, observers are not copied.
+         *  The copy is done in constant time: both AttributeStore%s
+         *  share the same memory block until one of them is modified
+         *  (copy-on-write).
          */
         virtual AttributeStore* clone() const = 0;
 
+        /**
+         * \brief Tests whether the stored data may be shared with
+         *  a clone.
+         * \retval true if the data may be shared, then unshare() needs
+         *  to be called before modifying it
+         * \retval false if the data is owned by this AttributeStore
+         */
+        bool is_shared() const {
+            return shared_;
+        }
+
+        /**
+         * \brief Makes sure the stored data is not shared with a
+         *  clone, by duplicating it if need be.
+         * \details The observers are notified if the base address
+         *  changes. It is called by all the functions that give write
+         *  access to the data. The function is thread-safe.
+         */
+        void unshare() {
+            if(shared_) {
+                unshare_store();
+            }
+        }
+
 
         /**
          * \brief Copies an item
@@ -325,6 +352,7 @@ namespace GEO {
          * \param[in] from index of the source item
          */
         void copy_item(index_t to, index_t from) {
+            unshare();
             geo_debug_assert(from < cached_size_);
             geo_debug_assert(to < cached_size_);
             index_t item_size = element_size_ * dimension_;            
@@ -337,9 +365,12 @@ namespace GEO {
 
         /**
          * \brief Gets a pointer to the stored data.
+         * \details If the data is shared with a clone, it is
+         *  duplicated.
          * \return A pointer to the memory block
          */
         void* data() {
+            unshare();
             return cached_base_addr_;
         }
 
@@ -501,6 +532,19 @@ namespace GEO {
          */
         void unregister_observer(AttributeStoreObserver* observer);
 
+        /**
+         * \brief Duplicates the data shared with a clone.
+         * \details Called by unshare(), with the lock held.
+         *  Derived classes notify the observers if the base address
+         *  changes.
+         */
+        virtual void unshare_data() = 0;
+
+        /**
+         * \brief Implementation of unshare(), used when the data may
+         *  be shared.
+         */
+        void unshare_store();
         
     protected:
         index_t element_size_;
@@ -509,6 +553,7 @@ namespace GEO {
         index_t cached_size_;
         std::set<AttributeStoreObserver*> observers_;
         Process::spinlock lock_;
+        mutable bool shared_;
 
         static std::map<std::string, AttributeStoreCreator_var>
             type_name_to_creator_;
@@ -543,6 +588,11 @@ namespace GEO {
         }
 
         virtual void resize(index_t new_size) {
+            geo_memory_tag("attributes");
+            if(new_size*dimension_ == store_.size()) {
+                return;
+            }
+            unshare();
             store_.resize(new_size*dimension_);
             notify(
                 store_.empty() ? nil : Memory::pointer(store_.data()),
@@ -552,7 +602,7 @@ namespace GEO {
         }
 
         virtual void clear(bool keep_memory=false) {
-            if(keep_memory) {
+            if(keep_memory && !store_.is_shared()) {
                 store_.resize(0);
             } else {
                 store_.clear();
@@ -562,16 +612,19 @@ namespace GEO {
 
         
         virtual void redim(index_t dim) {
+            geo_memory_tag("attributes");
             if(dim == dimension()) {
                 return;
             }
             vector<T> new_store(size()*dim);
             index_t copy_dim = GEO::geo_min(dim, dimension());
+            const cow_vector<T>& old_store = store_;
             for(index_t i = 0; i < size(); ++i) {
                 for(index_t c = 0; c < copy_dim; ++c) {
-                    new_store[dim * i + c] = store_[dimension_ * i + c];
+                    new_store[dim * i + c] = old_store[dimension_ * i + c];
                 }
             }
+            store_.clear();
             store_.swap(new_store);
             notify(
                 store_.empty() ? nil : Memory::pointer(store_.data()),
@@ -591,16 +644,44 @@ namespace GEO {
         virtual AttributeStore* clone() const {
             TypedAttributeStore<T>* result =
                 new TypedAttributeStore<T>(dimension());
-            result->resize(size());
             result->store_ = store_;
+            result->shared_ = true;
+            shared_ = true;
+            result->notify(
+                cached_base_addr_, size(), dimension_
+            );
             return result;
         }
 
+        /**
+         * \brief Gets the vector that stores the data.
+         * \details If the data is shared with a clone, it is
+         *  duplicated.
+         * \return a modifiable reference to the vector
+         */
         vector<T>& get_vector() {
-            return store_;
+            unshare();
+            return store_.get_vector();
+        }
+
+        /**
+         * \brief Gets the vector that stores the data.
+         * \return a const reference to the vector
+         */
+        const vector<T>& get_vector() const {
+            return store_.get_vector();
         }
         
     protected:
+        virtual void unshare_data() {
+            store_.unshare();
+            notify(
+                store_.empty() ? nil : Memory::pointer(store_.data()),
+                size(),
+                dimension_
+            );
+        }
+
         virtual void notify(
             Memory::pointer base_addr, index_t size, index_t dim
         ) {
@@ -608,8 +689,8 @@ namespace GEO {
             geo_assert(size*dim <= store_.size());
         }
         
-    private:
-        vector<T> store_;
+    protected:
+        cow_vector<T> store_;
     };
 
     /*********************************************************************/    
@@ -631,6 +712,130 @@ namespace GEO {
 
     /*********************************************************************/
 
+    /**
+     * \brief Stores real numbers quantized to 16 bits fixed point.
+     * \details Each element is stored as a 16 bits code, that represents
+     *  a number in [min(), max()], with a precision of 
+     *  (max() - min()) / 65535. Numbers outside of the bounds are clamped.
+     *  The bounds are shared by all the elements (and all the coordinates 
+     *  of vector attributes). Compared to a double attribute, it uses 4
+     *  times less memory. The codes can be accessed as an
+     *  Attribute<Numeric::uint16>, and the decoded numbers through 
+     *  a QuantizedAttribute or a ReadOnlyScalarAttributeAdapter.
+     */
+    class GEOGRAM_API QuantizedAttributeStore :
+        public TypedAttributeStore<Numeric::uint16> {
+    public:
+        /**
+         * \brief Creates a new empty quantized attribute store.
+         * \param[in] dim number of elements in each item
+         * \param[in] min , max the bounds of the represented numbers
+         */
+        QuantizedAttributeStore(
+            index_t dim=1, double min=0.0, double max=1.0
+        ) : TypedAttributeStore<Numeric::uint16>(dim) {
+            set_bounds(min,max);
+        }
+
+        /**
+         * \brief Sets the bounds of the represented numbers.
+         * \details The stored codes are not changed, thus changing the
+         *  bounds changes the represented numbers.
+         * \param[in] min , max the new bounds
+         * \pre max >= min
+         */
+        void set_bounds(double min, double max) {
+            geo_assert(max >= min);
+            min_ = min;
+            max_ = max;
+        }
+
+        /**
+         * \brief Gets the lower bound of the represented numbers.
+         */
+        double min() const {
+            return min_;
+        }
+
+        /**
+         * \brief Gets the upper bound of the represented numbers.
+         */
+        double max() const {
+            return max_;
+        }
+
+        /**
+         * \brief Encodes a number.
+         * \param[in] x the number, clamped to [min(), max()]
+         * \return the code of the nearest represented number
+         */
+        Numeric::uint16 encode(double x) const {
+            if(max_ == min_ || !(x > min_)) {
+                return 0;
+            }
+            if(x >= max_) {
+                return 65535;
+            }
+            return Numeric::uint16(
+                (x - min_) / (max_ - min_) * 65535.0 + 0.5
+            );
+        }
+
+        /**
+         * \brief Decodes a number.
+         * \param[in] code the code
+         * \return the represented number
+         */
+        double decode(Numeric::uint16 code) const {
+            return min_ + double(code) * ((max_ - min_) / 65535.0);
+        }
+
+        virtual bool elements_type_matches(
+            const std::string& type_name
+        ) const {
+            return 
+                type_name == typeid(Numeric::uint16).name() ||
+                type_name == typeid(QuantizedAttributeStore).name();
+        }
+
+        virtual std::string element_typeid_name() const {
+            return typeid(QuantizedAttributeStore).name();
+        }
+
+        virtual AttributeStore* clone() const {
+            QuantizedAttributeStore* result =
+                new QuantizedAttributeStore(dimension(), min_, max_);
+            result->store_ = store_;
+            result->shared_ = true;
+            shared_ = true;
+            result->notify(
+                cached_base_addr_, size(), dimension_
+            );
+            return result;
+        }
+
+    private:
+        double min_;
+        double max_;
+    };
+
+    /**
+     * \brief Implementation of AttributeStoreCreator for 
+     *  QuantizedAttributeStore.
+     * \details The bounds of created stores are [0,1].
+     */
+    class QuantizedAttributeStoreCreator : public AttributeStoreCreator {
+    public:
+        /**
+         * \copydoc AttributeStoreCreator::create_attribute_store()
+         */
+        virtual AttributeStore* create_attribute_store(index_t dim) {
+            return new QuantizedAttributeStore(dim);
+        }
+    };
+
+    /*********************************************************************/
+
     /**
      * \brief Helper class to register new attribute types
      * \tparam T attribute element type
@@ -666,6 +871,52 @@ namespace GEO {
         }
     };
 
+    /*********************************************************************/
+
+    /**
+     * \brief An interned attribute name.
+     * \details Each different name is associated once for all with a
+     *  small integer, so that finding an attribute with an AttributeKey
+     *  in an AttributesManager does not need any string comparison.
+     *  AttributeKeys are meant to be created
+     *  once, for instance as static variables, and used by code that
+     *  binds attributes repeatedly.
+     * \par Example:
+     * \code
+     * static const AttributeKey weight_key("weight");
+     * Attribute<double> weight(M.vertices.attributes(), weight_key);
+     * \endcode
+     */
+    class GEOGRAM_API AttributeKey {
+    public:
+        /**
+         * \brief Creates or retrieves the key associated with a name.
+         * \param[in] name the name of the attribute
+         */
+        explicit AttributeKey(const std::string& name);
+
+        /**
+         * \brief Gets the unique identifier of this key.
+         * \return a small integer, that is the same for all the
+         *  AttributeKeys created with the same name.
+         */
+        index_t id() const {
+            return id_;
+        }
+
+        /**
+         * \brief Gets the name.
+         * \return a const reference to the name of the attribute
+         */
+        const std::string& name() const {
+            return *name_;
+        }
+
+    private:
+        index_t id_;
+        const std::string* name_;
+    };
+
     /*********************************************************************/    
     
     /**
@@ -762,6 +1013,36 @@ namespace GEO {
             const std::string& name
         ) const;
 
+        /**
+         * \brief Finds an AttributeStore by key.
+         * \details No string is compared. The function does not modify
+         *  the AttributesManager, it can be called from concurrent
+         *  threads.
+         * \param[in] key the key of the name under which the
+         *  AttributeStore was bound
+         * \return a pointer to the attribute store or nil if is is undefined.
+         */
+        AttributeStore* find_attribute_store(const AttributeKey& key) {
+            return key.id() < store_by_key_.size() ?
+                store_by_key_[key.id()] : nil;
+        }
+
+        /**
+         * \brief Finds an AttributeStore by key.
+         * \details No string is compared. The function can be called
+         *  from concurrent threads.
+         * \param[in] key the key of the name under which the
+         *  AttributeStore was bound
+         * \return a const pointer to the attribute store or nil if is is
+         *  undefined.
+         */
+        const AttributeStore* find_attribute_store(
+            const AttributeKey& key
+        ) const {
+            return key.id() < store_by_key_.size() ?
+                store_by_key_[key.id()] : nil;
+        }
+
         
         /**
          * \brief Tests whether an attribute is defined.
@@ -860,6 +1141,15 @@ namespace GEO {
     private:
         index_t size_;
         std::map<std::string, AttributeStore*> attributes_;
+
+        /**
+         * \brief The AttributeStores indexed by the AttributeKey::id()
+         *  of their name, nil if undefined.
+         * \details It is filled by bind_attribute_store() and updated by
+         *  the functions that delete attributes, so that looking up a
+         *  key never modifies it.
+         */
+        std::vector<AttributeStore*> store_by_key_;
     } ;
 
 
@@ -896,6 +1186,20 @@ namespace GEO {
             bind(manager, name);
         }
 
+        /**
+         * \brief Creates or retreives a persistent attribute attached to 
+         *  a given AttributesManager.
+         * \details Same as the version that takes a name, but faster
+         *  when the same key is used several times.
+         * \param[in] manager a reference to the AttributesManager
+         * \param[in] key the key of the name of the attribute
+         */
+        AttributeBase(AttributesManager& manager, const AttributeKey& key) :
+            manager_(nil),
+            store_(nil) {
+            bind(manager, key);
+        }
+
         /**
          * \brief Tests whether an Attribute is bound.
          * \retval true if this Attribute is bound
@@ -938,6 +1242,26 @@ namespace GEO {
             register_me(store_);
         }
 
+        /**
+         * \brief Binds this Attribute to an AttributesManager.
+         * \details Same as the version that takes a name, but faster
+         *  when the same key is used several times.
+         * \param[in] manager a reference to the AttributesManager
+         * \param[in] key the key of the name of the attribute
+         * \pre !is_bound()
+         */
+        void bind(AttributesManager& manager, const AttributeKey& key) {
+            geo_assert(!is_bound());
+            manager_ = &manager;
+            store_ = manager_->find_attribute_store(key);
+            if(store_ == nil) {
+                store_ = new TypedAttributeStore<T>();
+                manager_->bind_attribute_store(key.name(),store_);
+            } else {
+                geo_assert(store_->elements_type_matches(typeid(T).name()));
+            }
+            register_me(store_);
+        }
 
         /**
          * \brief Binds this Attribute to an AttributesManager if it
@@ -957,6 +1281,25 @@ namespace GEO {
                 register_me(store_);                
             }
         }
+
+        /**
+         * \brief Binds this Attribute to an AttributesManager if it
+         *  already exists in the AttributesManager.
+         * \param[in] manager a reference to the AttributesManager
+         * \param[in] key the key of the name of the attribute
+         * \pre !is_bound()
+         */
+        void bind_if_is_defined(
+            AttributesManager& manager, const AttributeKey& key
+        ) {
+            geo_assert(!is_bound());
+            manager_ = &manager;
+            store_ = manager_->find_attribute_store(key);
+            if(store_ != nil) {
+                geo_assert(store_->elements_type_matches(typeid(T).name()));
+                register_me(store_);                
+            }
+        }
         
         /**
          * \brief Creates and binds a new vector attribute.
@@ -1038,6 +1381,25 @@ namespace GEO {
             );
         }
 
+        /**
+         * \brief Tests whether an attribute with the specified key and with
+         *  corresponding type exists in an AttributesManager.
+         * \param[in] manager a reference to the AttributesManager
+         * \param[in] key the key of the name of the attribute
+         * \param[in] dim dimension, or 0 if any dimension can match
+         */
+        static bool is_defined(
+            AttributesManager& manager, const AttributeKey& key,
+            index_t dim = 0
+        ) {
+            AttributeStore* store = manager.find_attribute_store(key);
+            return (
+                store != nil &&
+                store->elements_type_matches(typeid(T).name()) &&
+                ((dim == 0) || (store->dimension() == dim))
+            );
+        }
+
         /**
          * \brief Gets the size.
          * \return The number of items in this attribute.
@@ -1094,8 +1456,8 @@ namespace GEO {
          *  attribute.
          */
         const vector<T>& get_vector() const {
-            TypedAttributeStore<T>* typed_store =
-                dynamic_cast<TypedAttributeStore<T>*>(store_);
+            const TypedAttributeStore<T>* typed_store =
+                dynamic_cast<const TypedAttributeStore<T>*>(store_);
             geo_assert(typed_store != nil);
             return typed_store->get_vector();
         }
@@ -1144,13 +1506,51 @@ namespace GEO {
             superclass(manager, name) {
         }
 
+        /**
+         * \brief Creates or retreives a persistent attribute attached to 
+         *  a given AttributesManager.
+         * \details Same as the version that takes a name, but faster
+         *  when the same key is used several times.
+         * \param[in] manager a reference to the AttributesManager
+         * \param[in] key the key of the name of the attribute
+         */
+        Attribute(AttributesManager& manager, const AttributeKey& key) :
+            superclass(manager, key) {
+        }
+
+        /**
+         * \brief Gets a pointer to all the elements.
+         * \details The nb_elements() elements are contiguous, and the
+         *  elements of item \p i are at indices 
+         *  [ i*dimension() ... (i+1)*dimension() - 1 ]. The pointer is
+         *  invalidated by any change of the size of the attribute.
+         * \return a pointer to the first element, or nil if the
+         *  attribute is empty
+         */
+        T* data() {
+            superclass::store_->unshare();
+            return (T*)(void*)superclass::base_addr_;
+        }
+
+        /**
+         * \copydoc data()
+         */
+        const T* data() const {
+            return (const T*)(void*)superclass::base_addr_;
+        }
+
         /**
          * \brief Gets a modifiable element by index
+         * \details Each call tests whether the data is shared with a
+         *  copy (copy-on-write), which prevents the compiler from
+         *  vectorizing simple loops. Loops over many elements should
+         *  rather get the pointer once with data().
          * \param [in] i index of the element
          * \return a modifiable reference to the \p i%th element
          */
-        T& operator[](unsigned int i) {
+        T& operator[](index_t i) {
             geo_debug_assert(i < superclass::nb_elements());
+            superclass::store_->unshare();
             return ((T*)(void*)superclass::base_addr_)[i];
         }
 
@@ -1159,7 +1559,7 @@ namespace GEO {
          * \param [in] i index of the element
          * \return a const reference to the \p i%th element
          */
-        const T& operator[](unsigned int i) const {
+        const T& operator[](index_t i) const {
             geo_debug_assert(i < superclass::nb_elements());
             return ((const T*)(void*)superclass::base_addr_)[i];
         }
@@ -1170,8 +1570,9 @@ namespace GEO {
          * \param[in] val the value
          */
         void fill(const T& val) {
+            T* elements = data();
             for(index_t i=0; i<superclass::nb_elements(); ++i) {
-                (*this)[i] = val;
+                elements[i] = val;
             }
         }
 
@@ -1207,6 +1608,10 @@ namespace GEO {
             superclass(manager,name) {
         }
 
+        Attribute(AttributesManager& manager, const AttributeKey& key) :
+            superclass(manager,key) {
+        }
+
         class BoolAttributeAccessor;
         
 
@@ -1349,8 +1754,9 @@ namespace GEO {
          * \param [in] i index of the element
          * \return a modifiable reference to the \p i%th element
          */
-        Numeric::uint8& element(unsigned int i) {
+        Numeric::uint8& element(index_t i) {
             geo_debug_assert(i < superclass::nb_elements());
+            superclass::store_->unshare();
             return ((Numeric::uint8*)superclass::base_addr_)[i];
         }
 
@@ -1359,7 +1765,7 @@ namespace GEO {
          * \param [in] i index of the element
          * \return a const reference to the \p i%th element
          */
-        const Numeric::uint8& element(unsigned int i) const {
+        const Numeric::uint8& element(index_t i) const {
             geo_debug_assert(i < superclass::nb_elements());
             return ((const Numeric::uint8*)superclass::base_addr_)[i];
         }
@@ -1492,6 +1898,342 @@ namespace GEO {
     
     /***********************************************************/
 
+    /**
+     * \brief Manages an attribute of real numbers quantized to 16 bits
+     *  fixed point.
+     * \details The elements are stored in a QuantizedAttributeStore, and
+     *  are encoded and decoded on access.
+     * \par Example:
+     * \code
+     * QuantizedAttribute density(M.vertices.attributes(),"density",0.0,10.0);
+     * density.set(v, 3.14);
+     * double d = density[v]; // d = 3.14 +/- 10.0 / 65535 / 2
+     * \endcode
+     */
+    class QuantizedAttribute : public AttributeBase<Numeric::uint16> {
+    public:
+        typedef AttributeBase<Numeric::uint16> superclass;
+
+        /**
+         * \brief Creates an unitialized (unbound) QuantizedAttribute.
+         */
+        QuantizedAttribute() : superclass() {
+        }
+
+        /**
+         * \brief Creates or retreives a persistent quantized attribute
+         *  attached to a given AttributesManager.
+         * \details If the attribute already exists with the specified
+         *  name in the AttributesManager then it is retreived (and the
+         *  bounds are ignored), else it is created with the specified 
+         *  bounds.
+         * \param[in] manager a reference to the AttributesManager
+         * \param[in] name name of the attribute
+         * \param[in] min , max the bounds of the represented numbers,
+         *  used if the attribute is created
+         */
+        QuantizedAttribute(
+            AttributesManager& manager, const std::string& name,
+            double min = 0.0, double max = 1.0
+        ) : superclass() {
+            bind(manager, name, min, max);
+        }
+
+        /**
+         * \brief Binds this QuantizedAttribute to an AttributesManager.
+         * \details If the attribute already exists with the specified 
+         *  name in the AttributesManager then it is retreived (and the
+         *  bounds are ignored), else it is created with the specified 
+         *  bounds.
+         * \param[in] manager a reference to the AttributesManager
+         * \param[in] name name of the attribute
+         * \param[in] min , max the bounds of the represented numbers,
+         *  used if the attribute is created
+         * \pre !is_bound()
+         */
+        void bind(
+            AttributesManager& manager, const std::string& name,
+            double min = 0.0, double max = 1.0
+        ) {
+            geo_assert(!is_bound());
+            manager_ = &manager;
+            store_ = manager_->find_attribute_store(name);
+            if(store_ == nil) {
+                store_ = new QuantizedAttributeStore(1, min, max);
+                manager_->bind_attribute_store(name,store_);
+            } else {
+                geo_assert(
+                    store_->element_typeid_name() ==
+                    typeid(QuantizedAttributeStore).name()
+                );
+            }
+            register_me(store_);
+        }
+
+        /**
+         * \brief Binds this QuantizedAttribute to an AttributesManager 
+         *  if it already exists in the AttributesManager.
+         * \param[in] manager a reference to the AttributesManager
+         * \param[in] name name of the attribute
+         * \pre !is_bound()
+         */
+        void bind_if_is_defined(
+            AttributesManager& manager, const std::string& name
+        ) {
+            geo_assert(!is_bound());
+            manager_ = &manager;
+            store_ = manager_->find_attribute_store(name);
+            if(store_ != nil) {
+                geo_assert(
+                    store_->element_typeid_name() ==
+                    typeid(QuantizedAttributeStore).name()
+                );
+                register_me(store_);
+            }
+        }
+
+        /**
+         * \brief Tests whether a quantized attribute with the specified 
+         *  name exists in an AttributesManager.
+         * \param[in] manager a reference to the AttributesManager
+         * \param[in] name name of the attribute
+         */
+        static bool is_defined(
+            const AttributesManager& manager, const std::string& name
+        ) {
+            const AttributeStore* store = manager.find_attribute_store(name);
+            return (
+                store != nil &&
+                store->element_typeid_name() ==
+                typeid(QuantizedAttributeStore).name()
+            );
+        }
+
+        /**
+         * \brief Gets the QuantizedAttributeStore.
+         * \pre is_bound()
+         */
+        const QuantizedAttributeStore* quantized_store() const {
+            geo_debug_assert(is_bound());
+            return static_cast<const QuantizedAttributeStore*>(store_);
+        }
+
+        /**
+         * \brief Gets the lower bound of the represented numbers.
+         */
+        double min() const {
+            return quantized_store()->min();
+        }
+
+        /**
+         * \brief Gets the upper bound of the represented numbers.
+         */
+        double max() const {
+            return quantized_store()->max();
+        }
+
+        /**
+         * \brief Gets an element by index
+         * \param [in] i index of the element
+         * \return the decoded value of the \p i%th element
+         */
+        double operator[](index_t i) const {
+            geo_debug_assert(i < nb_elements());
+            return quantized_store()->decode(
+                ((const Numeric::uint16*)(void*)base_addr_)[i]
+            );
+        }
+
+        /**
+         * \brief Sets an element by index
+         * \param [in] i index of the element
+         * \param [in] x the value, encoded with the nearest code
+         */
+        void set(index_t i, double x) {
+            geo_debug_assert(i < nb_elements());
+            store_->unshare();
+            ((Numeric::uint16*)(void*)base_addr_)[i] =
+                quantized_store()->encode(x);
+        }
+
+    private:
+        /**
+         * \brief Forbids copy.
+         */
+        QuantizedAttribute(const QuantizedAttribute& rhs);
+        /**
+         * \brief Forbids copy.
+         */
+        QuantizedAttribute& operator=(const QuantizedAttribute& rhs);
+    };
+
+    /***********************************************************/
+
+    /**
+     * \brief Read-only access to the elements of an attribute, without
+     *  binding.
+     * \details Unlike Attribute, a ReadOnlyAttributeView does not
+     *  register itself as an observer of the AttributeStore, so that
+     *  creating and destroying it is cheap. In exchange, it is
+     *  invalidated by any modification of the size or dimension of
+     *  the attribute, and by the first modification of an attribute
+     *  that shares its memory with a copy. It is meant to be used in
+     *  loops that only read the attribute.
+     * \tparam T type of the elements. For Attribute<bool>, use
+     *  Numeric::uint8.
+     */
+    template <class T> class ReadOnlyAttributeView {
+    public:
+        /**
+         * \brief Creates an empty ReadOnlyAttributeView.
+         */
+        ReadOnlyAttributeView() :
+            data_(nil),
+            size_(0),
+            dimension_(0) {
+        }
+
+        /**
+         * \brief Creates a ReadOnlyAttributeView of an attribute.
+         * \details If the attribute is not defined, the
+         *  ReadOnlyAttributeView is empty.
+         * \param[in] manager a reference to the AttributesManager
+         * \param[in] key the key of the name of the attribute
+         */
+        ReadOnlyAttributeView(
+            AttributesManager& manager, const AttributeKey& key
+        ) {
+            init(manager.find_attribute_store(key));
+        }
+
+        /**
+         * \brief Creates a ReadOnlyAttributeView of an attribute.
+         * \details If the attribute is not defined, the
+         *  ReadOnlyAttributeView is empty.
+         * \param[in] manager a const reference to the AttributesManager
+         * \param[in] key the key of the name of the attribute
+         */
+        ReadOnlyAttributeView(
+            const AttributesManager& manager, const AttributeKey& key
+        ) {
+            init(manager.find_attribute_store(key));
+        }
+
+        /**
+         * \brief Creates a ReadOnlyAttributeView of an attribute.
+         * \details If the attribute is not defined, the
+         *  ReadOnlyAttributeView is empty.
+         * \param[in] manager a reference to the AttributesManager
+         * \param[in] name the name of the attribute
+         */
+        ReadOnlyAttributeView(
+            const AttributesManager& manager, const std::string& name
+        ) {
+            init(manager.find_attribute_store(name));
+        }
+
+        /**
+         * \brief Creates a ReadOnlyAttributeView of a bound Attribute.
+         * \param[in] attribute the attribute
+         */
+        ReadOnlyAttributeView(const Attribute<T>& attribute) :
+            data_(attribute.data()),
+            size_(attribute.size()),
+            dimension_(attribute.dimension()) {
+        }
+
+        /**
+         * \brief Tests whether this ReadOnlyAttributeView refers to
+         *  an attribute.
+         */
+        bool is_bound() const {
+            return (dimension_ != 0);
+        }
+
+        /**
+         * \brief Gets the size.
+         * \return the number of items
+         */
+        index_t size() const {
+            return size_;
+        }
+
+        /**
+         * \brief Gets the dimension.
+         * \return the number of elements per item
+         */
+        index_t dimension() const {
+            return dimension_;
+        }
+
+        /**
+         * \brief Gets the total number of elements.
+         */
+        index_t nb_elements() const {
+            return size_ * dimension_;
+        }
+
+        /**
+         * \brief Gets a pointer to all the elements.
+         * \details The nb_elements() elements are contiguous, and the
+         *  elements of item \p i are at indices 
+         *  [ i*dimension() ... (i+1)*dimension() - 1 ].
+         */
+        const T* data() const {
+            return data_;
+        }
+
+        /**
+         * \brief Gets a pointer to the first element.
+         */
+        const T* begin() const {
+            return data_;
+        }
+
+        /**
+         * \brief Gets a pointer one position past the last element.
+         */
+        const T* end() const {
+            return data_ + nb_elements();
+        }
+
+        /**
+         * \brief Gets an element by index
+         * \param [in] i index of the element
+         * \return a const reference to the \p i%th element
+         */
+        const T& operator[](index_t i) const {
+            geo_debug_assert(i < nb_elements());
+            return data_[i];
+        }
+
+    protected:
+        /**
+         * \brief Initializes this ReadOnlyAttributeView from
+         *  an AttributeStore.
+         * \param[in] store a pointer to the AttributeStore or nil
+         */
+        void init(const AttributeStore* store) {
+            if(store == nil) {
+                data_ = nil;
+                size_ = 0;
+                dimension_ = 0;
+                return;
+            }
+            geo_assert(store->elements_type_matches(typeid(T).name()));
+            data_ = static_cast<const T*>(store->data());
+            size_ = store->size();
+            dimension_ = store->dimension();
+        }
+
+    private:
+        const T* data_;
+        index_t size_;
+        index_t dimension_;
+    };
+
+    /***********************************************************/
+
     /**
      * \brief Access to an attribute as a double regardless its type.
      * \details The attribute can be an element of a vector attribute.
@@ -1512,7 +2254,9 @@ namespace GEO {
             ET_FLOAT32=5,
             ET_FLOAT64=6,
             ET_VEC2=7,
-            ET_VEC3=8
+            ET_VEC3=8,
+            ET_FLOAT16=9,
+            ET_QUANTIZED16=10
         };
 
         /**
@@ -1616,7 +2360,7 @@ namespace GEO {
          *  elements.
          * \return one of ET_NONE (if unbound), ET_UINT8,
          *  ET_INT8, ET_UINT32, ET_INT32, ET_FLOAT32, 
-         *  ET_FLOAT64, ET_VEC2, ET_VEC3
+         *  ET_FLOAT64, ET_VEC2, ET_VEC3, ET_FLOAT16, ET_QUANTIZED16
          */
         ElementType element_type() const {
             return element_type_;
@@ -1674,6 +2418,14 @@ namespace GEO {
             case ET_VEC3:
                 result = get_element<Numeric::float64>(i,3);
                 break;
+            case ET_FLOAT16:
+                result = get_element<Numeric::float16>(i);
+                break;
+            case ET_QUANTIZED16:
+                result = static_cast<const QuantizedAttributeStore*>(
+                    store_
+                )->decode(get_raw_element<Numeric::uint16>(i));
+                break;
             case ET_NONE:
                 geo_assert_not_reached;
             }
@@ -1725,7 +2477,8 @@ namespace GEO {
          * \brief Gets the element type stored in an AttributeStore.
          * \param[in] store a const pointer to the AttributeStore
          * \return one of ET_UINT8, ET_INT8, ET_UINT32, ET_INT32, 
-         *  ET_FLOAT32, ET_FLOAT64 if the type of the attribute is
+         *  ET_FLOAT32, ET_FLOAT64, ET_VEC2, ET_VEC3, ET_FLOAT16, 
+         *  ET_QUANTIZED16 if the type of the attribute is
          *  compatible with those types, or ET_NONE if it is incompatible.
          */
         static ElementType element_type(const AttributeStore* store);
@@ -1746,6 +2499,18 @@ namespace GEO {
                     ]
                 );
         }
+
+        /**
+         * \brief Gets an element without converting it.
+         * \param[in] i index of the element
+         */
+        template <class T> T get_raw_element(index_t i) {
+            geo_debug_assert(is_bound());
+            geo_debug_assert(i < size());
+            return static_cast<const T*>(store_->data())[
+                i * store_->dimension() + element_index_
+            ];
+        }
         
     private:
         const AttributesManager* manager_;
@@ -1755,6 +2520,47 @@ namespace GEO {
     };
 
     /***********************************************************/
+
+    /**
+     * \brief Specifies how the elements of an attribute of real numbers
+     *  are stored.
+     * \details ATTRIBUTE_FLOAT16 and ATTRIBUTE_QUANTIZED16 use 4 times
+     *  less memory than ATTRIBUTE_FLOAT64.
+     *  - ATTRIBUTE_FLOAT64: double
+     *  - ATTRIBUTE_FLOAT32: float
+     *  - ATTRIBUTE_FLOAT16: Numeric::float16 (3 significant digits)
+     *  - ATTRIBUTE_QUANTIZED16: 16 bits fixed point, in the bounding 
+     *    interval of the values (see QuantizedAttributeStore)
+     */
+    enum AttributeEncoding {
+        ATTRIBUTE_FLOAT64,
+        ATTRIBUTE_FLOAT32,
+        ATTRIBUTE_FLOAT16,
+        ATTRIBUTE_QUANTIZED16
+    };
+
+    /**
+     * \brief Changes how the elements of an attribute of real numbers
+     *  are stored.
+     * \details The attribute keeps its name and its dimension, and the
+     *  values are converted to the new encoding (with rounding when 
+     *  precision is lost). Code that accesses the attribute through
+     *  a ReadOnlyScalarAttributeAdapter (e.g., the viewers) and 
+     *  the .geogram file format support all the encodings.
+     * \param[in] manager a reference to the AttributesManager
+     * \param[in] name the name of the attribute
+     * \param[in] encoding the new encoding
+     * \retval true if the attribute was converted
+     * \retval false if the attribute does not exist, is not an attribute
+     *  of real numbers (double, float, Numeric::float16 or quantized) 
+     *  or is bound to an Attribute
+     */
+    bool GEOGRAM_API set_attribute_encoding(
+        AttributesManager& manager, const std::string& name,
+        AttributeEncoding encoding
+    );
+
+    /***********************************************************/
 }
 
 #endif
@@ -396,6 +396,21 @@ namespace {
         );
     }
 
+    /**
+     * \brief Imports the profiler option group
+     */
+    void import_arg_group_profile() {
+        declare_arg_group("profile", "Profiler settings", ARG_ADVANCED);
+        declare_arg(
+            "profile:trace", "",
+            "Saves a trace (Chrome trace event format) in the specified file"
+        );
+        declare_arg(
+            "profile:summary", false,
+            "Displays the time spent in each profiled span on exit"
+        );
+    }
+
     /**
      * \brief Imports the reconstruction option group
      */
@@ -818,6 +833,7 @@ namespace GEO {
                 import_arg_group_sys();
 		import_arg_group_nl();		
                 import_arg_group_log();
+                import_arg_group_profile();
 		import_arg_group_biblio();
             } else if(name == "global") {
                 import_arg_group_global();
@@ -827,6 +843,8 @@ namespace GEO {
                 import_arg_group_sys();
             } else if(name == "log") {
                 import_arg_group_log();
+            } else if(name == "profile") {
+                import_arg_group_profile();
             } else if(name == "pre") {
                 import_arg_group_pre();
             } else if(name == "remesh") {
@@ -49,6 +49,7 @@
 #include <geogram/basic/progress.h>
 #include <geogram/basic/command_line.h>
 #include <geogram/basic/stopwatch.h>
+#include <geogram/basic/profiler.h>
 #include <geogram/numerics/multi_precision.h>
 #include <geogram/numerics/predicates.h>
 #include <geogram/delaunay/delaunay.h>
@@ -91,6 +92,9 @@ namespace GEO {
         Logger::initialize();
         Process::initialize();
         Progress::initialize();
+#ifndef GEOGRAM_PSM
+        Profiler::initialize();
+#endif
         CmdLine::initialize();
         PCK::initialize();
         Delaunay::initialize();
@@ -118,6 +122,18 @@ namespace GEO {
 
         geo_register_attribute_type<vec2>("vec2");
         geo_register_attribute_type<vec3>("vec3");
+
+        // Encoded attribute types, that use less memory.
+        geo_register_attribute_type<Numeric::float16>("float16");
+        AttributeStore::register_attribute_creator(
+            new QuantizedAttributeStoreCreator, "quantized16",
+            typeid(QuantizedAttributeStore).name()
+        );
+        GeoFile::register_ascii_attribute_serializer(
+            "quantized16",
+            read_ascii_attribute<Numeric::uint16>,
+            write_ascii_attribute<Numeric::uint16>
+        );
 #endif
 	
 #ifdef GEO_OS_EMSCRIPTEN
@@ -149,6 +165,10 @@ namespace GEO {
             Process::show_stats();
         }
 
+#ifndef GEOGRAM_PSM
+        Profiler::terminate();
+#endif
+        
         PCK::terminate();
 	
 #ifndef GEOGRAM_PSM					
@@ -47,6 +47,7 @@
 #include <geogram/basic/string.h>
 #include <geogram/basic/logger.h>
 #include <geogram/third_party/pstdint.h>
+#include <algorithm>
 
 
 /* Using portable printf modifier for 64 bit ints from pstdint.h */
@@ -79,6 +80,84 @@ namespace {
         return result;
     }
 
+    /**
+     * \brief Maximum number of bytes transferred by a single call
+     *  to gzread() or gzwrite() (that take an unsigned int size).
+     */
+    const size_t MAX_GZ_BLOCK = size_t(1) << 30;
+
+    /**
+     * \brief Reads data from a compressed file, possibly larger
+     *  than 4GB.
+     * \param[in] file the file
+     * \param[out] addr where to store the data
+     * \param[in] size the number of bytes to read
+     * \retval true if all the bytes could be read
+     * \retval false otherwise
+     */
+    bool gzread_all(gzFile file, void* addr, size_t size) {
+        char* p = static_cast<char*>(addr);
+        while(size != 0) {
+            unsigned int block = (unsigned int)(std::min(size, MAX_GZ_BLOCK));
+            int check = gzread(file, p, block);
+            if(check != int(block)) {
+                return false;
+            }
+            p += block;
+            size -= block;
+        }
+        return true;
+    }
+
+    /**
+     * \brief Writes data to a compressed file, possibly larger
+     *  than 4GB.
+     * \param[in] file the file
+     * \param[in] addr the data
+     * \param[in] size the number of bytes to write
+     * \retval true if all the bytes could be written
+     * \retval false otherwise
+     */
+    bool gzwrite_all(gzFile file, const void* addr, size_t size) {
+        const char* p = static_cast<const char*>(addr);
+        while(size != 0) {
+            unsigned int block = (unsigned int)(std::min(size, MAX_GZ_BLOCK));
+            int check = gzwrite(file, p, block);
+            if(check != int(block)) {
+                return false;
+            }
+            p += block;
+            size -= block;
+        }
+        return true;
+    }
+
+    /**
+     * \brief Converts an array of indices between 32 bits and 64 bits.
+     * \details Invalid indices (all bits set, e.g. NO_CELL) are mapped
+     *  to invalid indices.
+     * \param[in] from the input indices
+     * \param[out] to the output indices
+     * \param[in] nb the number of indices
+     * \retval true if all the indices could be represented
+     * \retval false otherwise
+     */
+    template <class FROM, class TO> bool convert_indices(
+        const FROM* from, TO* to, size_t nb
+    ) {
+        for(size_t i=0; i<nb; ++i) {
+            if(from[i] == FROM(-1)) {
+                to[i] = TO(-1);
+            } else {
+                to[i] = TO(from[i]);
+                if(FROM(to[i]) != from[i] || to[i] == TO(-1)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    
     std::string decode(const std::string& s) {
         std::string result;
         size_t i=0;
@@ -141,7 +220,8 @@ namespace GEO {
         ascii_file_(nil),
         current_chunk_class_("0000"),
         current_chunk_size_(0),
-        current_chunk_file_pos_(0) {
+        current_chunk_file_pos_(0),
+        index64_(false) {
         ascii_ = String::string_ends_with(filename, "_ascii");
     }
     
@@ -235,6 +315,11 @@ namespace GEO {
     
     void GeoFile::write_int(index_t x_in, const char* comment) {
         Numeric::uint32 x = Numeric::uint32(x_in);
+#ifdef GEOGRAM_WITH_64BIT_INDICES
+        if(index_t(x) != x_in) {
+            throw GeoFileException("Integer does not fit in 32 bits");
+        }
+#endif
         if(ascii_) {
             if(comment == nil) {
                 if(fprintf(ascii_file_,"%u\n",x) ==0) {
@@ -416,7 +501,7 @@ namespace GEO {
     size_t GeoFile::string_array_size(
         const std::vector<std::string>& strings
     ) const {
-        size_t result = sizeof(index_t);
+        size_t result = sizeof(Numeric::uint32);
         for(index_t i=0; i<strings.size(); ++i) {
             result += string_size(strings[i]);
         }
@@ -427,6 +512,32 @@ namespace GEO {
         attribute_sets_.clear();
     }
     
+    index_t GeoFile::read_nb_items() {
+        if(!index64_) {
+            return read_int();
+        }
+        size_t result = read_size();
+        if(Numeric::uint64(index_t(result)) != Numeric::uint64(result)) {
+            throw GeoFileException(
+                "File has more than 4G items, recompile geogram with "
+                "GEOGRAM_WITH_64BIT_INDICES"
+            );
+        }
+        return index_t(result);
+    }
+
+    void GeoFile::write_nb_items(index_t x, const char* comment) {
+        if(index64_) {
+            write_size(size_t(x));
+        } else {
+            write_int(x, comment);
+        }
+    }
+
+    size_t GeoFile::nb_items_size() const {
+        return index64_ ? sizeof(Numeric::uint64) : sizeof(Numeric::uint32);
+    }
+    
     /**********************************************************************/
     
     InputGeoFile::InputGeoFile(
@@ -463,6 +574,30 @@ namespace GEO {
         }
         std::string version = read_string();
         Logger::out("I/O") << "GeoFile version: " << version << std::endl;
+
+        // Optional flags, after the version. Geogram versions that do
+        // not know them detect a chunk size mismatch and refuse to
+        // read the file.
+        bool has_flags = false;
+        if(ascii_) {
+            int cur;
+            do {
+                cur = fgetc(ascii_file_);
+            } while(cur == ' ' || cur == '\n' || cur == '\r' || cur == '\t');
+            has_flags = (cur == '\"');
+            if(cur != EOF) {
+                ungetc(cur, ascii_file_);
+            }
+        } else {
+            has_flags = (
+                gztell(file_) < current_chunk_file_pos_ + current_chunk_size_
+            );
+        }
+        if(has_flags) {
+            std::string flags = read_string();
+            index64_ = (flags.find("index64") != std::string::npos);
+            Logger::out("I/O") << "GeoFile flags: " << flags << std::endl;
+        }
         check_chunk_size();
     }
 
@@ -485,7 +620,7 @@ namespace GEO {
         
         if(current_chunk_class_ == "ATTS") {
             std::string attribute_set_name = read_string();
-            index_t nb_items = read_int();
+            index_t nb_items = read_nb_items();
             check_chunk_size();
             
             if(find_attribute_set(attribute_set_name) != nil) {
@@ -543,22 +678,49 @@ namespace GEO {
     void InputGeoFile::read_attribute(void* addr) {
         geo_assert(current_chunk_class_ == "ATTR");
         if(ascii_) {
-            AsciiAttributeSerializer read_attribute_func =
-                ascii_attribute_read_[current_attribute_->element_type];
-            if(read_attribute_func == nil) {
-                throw GeoFileException(
-                    "No ASCII serializer for type:" +
-                    current_attribute_->element_type
-                );                
-            }
-            bool result = (*read_attribute_func)(
-                ascii_file_,
-                Memory::pointer(addr),
-                index_t(
-                    current_attribute_set_->nb_items*
-                    current_attribute_->dimension
-                )
+            index_t nb_elements = index_t(
+                current_attribute_set_->nb_items*
+                current_attribute_->dimension
             );
+            bool result = false;
+            if(
+                current_attribute_->element_type == "index_t" &&
+                index64_ != (sizeof(index_t) == sizeof(Numeric::uint64))
+            ) {
+                // Indices written by a geogram version with a different
+                // index size are converted.
+                if(index64_) {
+                    std::vector<Numeric::uint64> buffer(nb_elements);
+                    result = read_ascii_attribute<Numeric::uint64>(
+                        ascii_file_, Memory::pointer(buffer.data()),
+                        nb_elements
+                    ) && convert_indices(
+                        buffer.data(), static_cast<index_t*>(addr),
+                        size_t(nb_elements)
+                    );
+                } else {
+                    std::vector<Numeric::uint32> buffer(nb_elements);
+                    result = read_ascii_attribute<Numeric::uint32>(
+                        ascii_file_, Memory::pointer(buffer.data()),
+                        nb_elements
+                    ) && convert_indices(
+                        buffer.data(), static_cast<index_t*>(addr),
+                        size_t(nb_elements)
+                    );
+                }
+            } else {
+                AsciiAttributeSerializer read_attribute_func =
+                    ascii_attribute_read_[current_attribute_->element_type];
+                if(read_attribute_func == nil) {
+                    throw GeoFileException(
+                        "No ASCII serializer for type:" +
+                        current_attribute_->element_type
+                    );                
+                }
+                result = (*read_attribute_func)(
+                    ascii_file_, Memory::pointer(addr), nb_elements
+                );
+            }
             if(!result) {
                 throw GeoFileException(
                     "Could not read attribute " + current_attribute_->name +
@@ -567,17 +729,49 @@ namespace GEO {
             }
             return;
         }
-        size_t size =
-            size_t(current_attribute_->element_size) *
+        size_t nb_elements =
             size_t(current_attribute_->dimension) *
             size_t(current_attribute_set_->nb_items);
-        int check = gzread(file_, addr, index_t(size));
-        if(size_t(check) != size) {
+        size_t size = size_t(current_attribute_->element_size) * nb_elements;
+
+        // Indices written by a geogram version with a different
+        // index size are converted.
+        if(
+            current_attribute_->element_type == "index_t" &&
+            current_attribute_->element_size != sizeof(index_t)
+        ) {
+            bool ok = false;
+            if(current_attribute_->element_size == sizeof(Numeric::uint32)) {
+                std::vector<Numeric::uint32> buffer(nb_elements);
+                ok = gzread_all(file_, buffer.data(), size) &&
+                    convert_indices(
+                        buffer.data(), static_cast<index_t*>(addr), nb_elements
+                    );
+            } else if(
+                current_attribute_->element_size == sizeof(Numeric::uint64)
+            ) {
+                std::vector<Numeric::uint64> buffer(nb_elements);
+                ok = gzread_all(file_, buffer.data(), size) &&
+                    convert_indices(
+                        buffer.data(), static_cast<index_t*>(addr), nb_elements
+                    );
+            }
+            if(!ok) {
+                throw GeoFileException(
+                    "Could not convert indices in attribute " +
+                    current_attribute_->name +
+                    " in set " + current_attribute_set_->name
+                );
+            }
+            check_chunk_size();
+            return;
+        }
+
+        if(!gzread_all(file_, addr, size)) {
             throw GeoFileException(
                 "Could not read attribute " + current_attribute_->name +
                 " in set " + current_attribute_set_->name +
-                " (" + String::to_string(check) + "/"
-                + String::to_string(size) + " bytes read)"
+                " (" + String::to_string(size) + " bytes expected)"
             );
         }
         check_chunk_size();
@@ -634,11 +828,22 @@ namespace GEO {
             }
         }
         
+#ifdef GEOGRAM_WITH_64BIT_INDICES
+        index64_ = true;
+#endif
         std::string magic = "GEOGRAM";
         std::string version = "1.0";
-        write_chunk_header("HEAD", string_size(magic) + string_size(version));
+        std::string flags = "index64";
+        write_chunk_header(
+            "HEAD",
+            string_size(magic) + string_size(version) +
+            (index64_ ? string_size(flags) : 0)
+        );
         write_string(magic);
         write_string(version);
+        if(index64_) {
+            write_string(flags, "the flags");
+        }
         check_chunk_size();
         write_comment(
             "geogram version=" + Environment::instance()->get_value("version")
@@ -664,11 +869,11 @@ namespace GEO {
         write_chunk_header(
             "ATTS",
             string_size(attribute_set_name) +
-            sizeof(index_t)
+            nb_items_size()
         );
         
         write_string(attribute_set_name, "the name of this attribute set");
-        write_int(nb_items, "the number of items in this attribute set");
+        write_nb_items(nb_items, "the number of items in this attribute set");
 
         check_chunk_size();
     }
@@ -696,8 +901,8 @@ namespace GEO {
             string_size(attribute_set_name) +
             string_size(attribute_name) +
             string_size(element_type) +
-            sizeof(index_t) +
-            sizeof(index_t) +
+            sizeof(Numeric::uint32) +
+            sizeof(Numeric::uint32) +
             data_size
         );
         
@@ -723,8 +928,7 @@ namespace GEO {
                 throw GeoFileException("Could not write attribute data");                
             }
         } else {
-            int check = gzwrite(file_, data, index_t(data_size));
-            if(size_t(check) != data_size) {
+            if(!gzwrite_all(file_, data, data_size)) {
                 throw GeoFileException("Could not write attribute data");
             }
         }
@@ -243,6 +243,55 @@ namespace GEO {
         return true;
     }
 
+    /**
+     * \brief Reads an ASCII attribute from a file.
+     * \details Template specialization for float16, needed because
+     *  float16 is read as a float32 and then converted.
+     * \param[in] file the input file, obtained through fopen()
+     * \param[out] base_addr an array with sufficient space for
+     *  storing nb_elements of type float16
+     * \param[in] nb_elements the number of elements to be read
+     * \retval true on success
+     * \retval false otherwise
+     */
+    template <> inline bool read_ascii_attribute<Numeric::float16>(
+        FILE* file, Memory::pointer base_addr, index_t nb_elements
+    ) {
+        Numeric::float16* attrib =
+            reinterpret_cast<Numeric::float16*>(base_addr);
+        for(index_t i=0; i<nb_elements; ++i) {
+            float val;
+            if(fscanf(file, "%f", &val) != 1) {
+                return false;
+            }
+            attrib[i] = Numeric::float16(val);
+        }
+        return true;
+    }
+
+    /**
+     * \brief Writes an ASCII attribute to a file.
+     * \details Template specialization for float16, needed because
+     *  float16 is written as a float32.
+     * \param[in] file the output file, obtained through fopen()
+     * \param[in] base_addr an array with nb_elements of type float16
+     * \param[in] nb_elements the number of elements to be written
+     * \retval true on success
+     * \retval false otherwise
+     */
+    template <> inline bool write_ascii_attribute<Numeric::float16>(
+        FILE* file, Memory::pointer base_addr, index_t nb_elements
+    ) {
+        Numeric::float16* attrib =
+            reinterpret_cast<Numeric::float16*>(base_addr);
+        for(index_t i=0; i<nb_elements; ++i) {
+            if(fprintf(file, "%.9g\n", double(float(attrib[i]))) < 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     /**************************************************************/
     
     /**
@@ -318,6 +367,20 @@ namespace GEO {
             return ascii_;
         }
 
+        /**
+         * \brief Tests whether this GeoFile uses 64 bits indices.
+         * \details Files written by geogram compiled with
+         *  GEOGRAM_WITH_64BIT_INDICES have a flag in their header, store
+         *  the number of items of the attribute sets on 64 bits, and their
+         *  index_t attributes have 64 bits elements. Indices are converted
+         *  when reading a file written with a different index size.
+         * \retval true if this GeoFile uses 64 bits indices
+         * \retval false otherwise
+         */
+        bool has_64bit_indices() const {
+            return index64_;
+        }
+
         /**
          * \brief Gets the current chunk class.
          * \return the current chunk class
@@ -596,7 +659,7 @@ namespace GEO {
          *  file.
          */
         size_t string_size(const std::string& s) const {
-            return sizeof(index_t) + s.length();
+            return sizeof(Numeric::uint32) + s.length();
         }
 
         /**
@@ -608,6 +671,28 @@ namespace GEO {
         size_t string_array_size(
             const std::vector<std::string>& strings
         ) const ;
+
+        /**
+         * \brief Reads the number of items of an attribute set.
+         * \details It is stored on 64 bits if has_64bit_indices() is set,
+         *  and on 32 bits otherwise.
+         * \return the number of items
+         */
+        index_t read_nb_items();
+
+        /**
+         * \brief Writes the number of items of an attribute set.
+         * \param[in] x the number of items
+         * \param[in] comment an optional comment string, written to ASCII
+         *  geofiles
+         */
+        void write_nb_items(index_t x, const char* comment = nil);
+
+        /**
+         * \brief Gets the size in bytes used by the number of items of
+         *  an attribute set in the file.
+         */
+        size_t nb_items_size() const;
         
         /**
          * \brief Reads a chunk header from the file.
@@ -654,6 +739,7 @@ namespace GEO {
         std::string current_chunk_class_;
         long current_chunk_size_;
         long current_chunk_file_pos_;
+        bool index64_;
         std::map<std::string, AttributeSetInfo> attribute_sets_;
 
         static std::map<std::string, AsciiAttributeSerializer>
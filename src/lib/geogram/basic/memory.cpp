@@ -0,0 +1,504 @@
+/*
+ *  Copyright (c) 2012-2014, Bruno Levy
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *  this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *  this list of conditions and the following disclaimer in the documentation
+ *  and/or other materials provided with the distribution.
+ *  * Neither the name of the ALICE Project-Team nor the names of its
+ *  contributors may be used to endorse or promote products derived from this
+ *  software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     Bruno.Levy@inria.fr
+ *     http://www.loria.fr/~levy
+ *
+ *     ALICE Project
+ *     LORIA, INRIA Lorraine, 
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX 
+ *     FRANCE
+ *
+ */
+
+#include <geogram/basic/memory.h>
+#include <geogram/basic/process.h>
+#include <geogram/basic/logger.h>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+/****************************************************************************/
+
+namespace {
+
+    using namespace GEO;
+
+    /** \brief Maximum number of memory tags */
+    const index_t MAX_MEMORY_TAGS = 64;
+
+    /**
+     * \brief Header stored in front of each block allocated by
+     *  tagged_malloc().
+     */
+    struct BlockHeader {
+        size_t size;
+        Numeric::uint32 tag;
+        Numeric::uint32 offset;
+    };
+
+    /** \brief Size reserved in front of the blocks for the BlockHeader */
+    const size_t HEADER_SIZE = 16;
+
+    const char* tag_names_[MAX_MEMORY_TAGS] = { "untagged" };
+    index_t nb_tags_ = 1;
+    Process::spinlock tags_lock_ = GEOGRAM_SPINLOCK_INIT;
+
+    volatile size_t used_[MAX_MEMORY_TAGS];
+    volatile size_t max_used_[MAX_MEMORY_TAGS];
+    volatile size_t total_used_ = 0;
+    volatile size_t total_max_used_ = 0;
+
+    /**
+     * \brief The memory tag of the current thread.
+     * \details Declared as a file-scope static variable (and not as a
+     *  member of Memory), because Visual C++ does not accept to export
+     *  thread local storage variables in DLLs.
+     */
+    GEO_THREAD_LOCAL index_t geo_current_memory_tag_ = 0;
+
+    /**
+     * \brief Atomically adds a value to a counter.
+     * \param[in,out] x a pointer to the counter
+     * \param[in] delta the value to be added (may wrap around to
+     *  subtract)
+     * \return the new value of the counter
+     */
+    inline size_t atomic_add(volatile size_t* x, size_t delta) {
+#if defined(GEO_COMPILER_GCC) || defined(GEO_COMPILER_CLANG) || \
+    defined(GEO_COMPILER_INTEL)
+        return __sync_add_and_fetch(x, delta);
+#elif defined(GEO_COMPILER_MSVC) && defined(_WIN64)
+        return size_t(InterlockedExchangeAdd64(
+            (volatile LONG64*)(x), LONG64(delta)
+        )) + delta;
+#elif defined(GEO_COMPILER_MSVC)
+        return size_t(InterlockedExchangeAdd(
+            (volatile LONG*)(x), LONG(delta)
+        )) + delta;
+#else
+        *x += delta;
+        return *x;
+#endif
+    }
+
+    /**
+     * \brief Atomically updates a maximum.
+     * \param[in,out] x a pointer to the maximum
+     * \param[in] value the new value, that replaces \p x if greater
+     */
+    inline void atomic_max(volatile size_t* x, size_t value) {
+        size_t cur = *x;
+        while(value > cur) {
+#if defined(GEO_COMPILER_GCC) || defined(GEO_COMPILER_CLANG) || \
+    defined(GEO_COMPILER_INTEL)
+            size_t prev = __sync_val_compare_and_swap(x, cur, value);
+#elif defined(GEO_COMPILER_MSVC) && defined(_WIN64)
+            size_t prev = size_t(InterlockedCompareExchange64(
+                (volatile LONG64*)(x), LONG64(value), LONG64(cur)
+            ));
+#elif defined(GEO_COMPILER_MSVC)
+            size_t prev = size_t(InterlockedCompareExchange(
+                (volatile LONG*)(x), LONG(value), LONG(cur)
+            ));
+#else
+            size_t prev = *x;
+            *x = value;
+#endif
+            if(prev == cur) {
+                break;
+            }
+            cur = prev;
+        }
+    }
+
+    /**
+     * \brief An entry in the pool of arenas.
+     * \details Entries are never deallocated before the end of the
+     *  program, so that a thread can keep a pointer to the last arena
+     *  it used, and try to reacquire it without taking the lock.
+     */
+    struct ArenaPoolEntry {
+        Memory::Arena arena;
+        volatile long in_use;
+        ArenaPoolEntry* next;
+    };
+
+    ArenaPoolEntry* arena_pool_ = nil;
+    Process::spinlock arena_pool_lock_ = GEOGRAM_SPINLOCK_INIT;
+
+    /**
+     * \brief The arena used by the current thread (may be in use by
+     *  another thread if the current thread has no active ArenaScope).
+     */
+    GEO_THREAD_LOCAL ArenaPoolEntry* geo_thread_arena_ = nil;
+
+    /**
+     * \brief The number of nested ArenaScope%s in the current thread.
+     */
+    GEO_THREAD_LOCAL index_t geo_arena_depth_ = 0;
+
+    /**
+     * \brief Tries to acquire an entry of the arena pool.
+     * \param[in] E a pointer to the entry
+     * \retval true if the entry was free and is now owned by the
+     *  current thread
+     * \retval false otherwise
+     */
+    inline bool try_acquire_arena(ArenaPoolEntry* E) {
+#if defined(GEO_COMPILER_GCC) || defined(GEO_COMPILER_CLANG) || \
+    defined(GEO_COMPILER_INTEL)
+        return __sync_bool_compare_and_swap(&E->in_use, 0l, 1l);
+#elif defined(GEO_COMPILER_MSVC)
+        return InterlockedCompareExchange(&E->in_use, 1, 0) == 0;
+#else
+        if(E->in_use != 0) {
+            return false;
+        }
+        E->in_use = 1;
+        return true;
+#endif
+    }
+
+    /**
+     * \brief Gives back an entry of the arena pool.
+     * \param[in] E a pointer to the entry, owned by the current thread
+     */
+    inline void release_arena(ArenaPoolEntry* E) {
+#if defined(GEO_COMPILER_GCC) || defined(GEO_COMPILER_CLANG) || \
+    defined(GEO_COMPILER_INTEL)
+        __sync_lock_release(&E->in_use);
+#elif defined(GEO_COMPILER_MSVC)
+        InterlockedExchange(&E->in_use, 0);
+#else
+        E->in_use = 0;
+#endif
+    }
+
+    /**
+     * \brief Finds a free arena in the pool, or creates a new one.
+     * \return a pointer to an entry of the pool, owned by the current
+     *  thread
+     */
+    ArenaPoolEntry* acquire_arena_from_pool() {
+        Process::acquire_spinlock(arena_pool_lock_);
+        ArenaPoolEntry* result = arena_pool_;
+        while(result != nil && !try_acquire_arena(result)) {
+            result = result->next;
+        }
+        if(result == nil) {
+            result = new ArenaPoolEntry;
+            result->in_use = 1;
+            result->next = arena_pool_;
+            arena_pool_ = result;
+        }
+        Process::release_spinlock(arena_pool_lock_);
+        return result;
+    }
+
+    /**
+     * \brief Deallocates the pool of arenas at exit.
+     */
+    class ArenaPoolCleanup {
+    public:
+        ~ArenaPoolCleanup() {
+            while(arena_pool_ != nil) {
+                ArenaPoolEntry* next = arena_pool_->next;
+                delete arena_pool_;
+                arena_pool_ = next;
+            }
+        }
+    };
+
+    ArenaPoolCleanup arena_pool_cleanup_;
+
+    /**
+     * \brief Serializes the copies done by the copy-on-write containers.
+     */
+    Process::spinlock shared_buffers_lock_ = GEOGRAM_SPINLOCK_INIT;
+
+#ifdef GEOGRAM_WITH_MEMORY_ACCOUNTING
+
+    /**
+     * \brief Converts a number of bytes into a string with units.
+     * \param[in] bytes the number of bytes
+     * \return a string with the number of megabytes (or kilobytes
+     *  for small numbers)
+     */
+    std::string memory_to_string(size_t bytes) {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(1);
+        if(bytes < size_t(1024*1024)) {
+            out << double(bytes) / 1024.0 << " K";
+        } else {
+            out << double(bytes) / (1024.0 * 1024.0) << " M";
+        }
+        return out.str();
+    }
+
+#endif
+}
+
+/****************************************************************************/
+
+namespace GEO {
+
+    namespace Memory {
+
+        index_t memory_tag(const char* name) {
+            Process::acquire_spinlock(tags_lock_);
+            index_t result = nb_tags_;
+            for(index_t i=0; i<nb_tags_; ++i) {
+                if(!strcmp(tag_names_[i], name)) {
+                    result = i;
+                    break;
+                }
+            }
+            if(result == nb_tags_) {
+                geo_assert(nb_tags_ < MAX_MEMORY_TAGS);
+                tag_names_[nb_tags_] = name;
+                ++nb_tags_;
+            }
+            Process::release_spinlock(tags_lock_);
+            return result;
+        }
+
+        index_t current_memory_tag() {
+            return geo_current_memory_tag_;
+        }
+
+        void set_current_memory_tag(index_t tag) {
+            geo_current_memory_tag_ = tag;
+        }
+
+        index_t nb_memory_tags() {
+            return nb_tags_;
+        }
+
+        const char* memory_tag_name(index_t tag) {
+            geo_debug_assert(tag < nb_tags_);
+            return tag_names_[tag];
+        }
+
+        size_t memory_tag_used(index_t tag) {
+            geo_debug_assert(tag < nb_tags_);
+            return used_[tag];
+        }
+
+        size_t memory_tag_max_used(index_t tag) {
+            geo_debug_assert(tag < nb_tags_);
+            return max_used_[tag];
+        }
+
+        void show_memory_tags() {
+#ifdef GEOGRAM_WITH_MEMORY_ACCOUNTING
+            Logger::out("Memory") << "Memory used by tag (current / peak):"
+                                  << std::endl;
+            for(index_t i=0; i<nb_tags_; ++i) {
+                if(max_used_[i] == 0) {
+                    continue;
+                }
+                std::ostringstream line;
+                line << std::setw(12) << memory_to_string(used_[i])
+                     << std::setw(12) << memory_to_string(max_used_[i])
+                     << "  " << tag_names_[i];
+                Logger::out("Memory") << line.str() << std::endl;
+            }
+            std::ostringstream line;
+            line << std::setw(12) << memory_to_string(total_used_)
+                 << std::setw(12) << memory_to_string(total_max_used_)
+                 << "  (total)";
+            Logger::out("Memory") << line.str() << std::endl;
+#endif
+        }
+
+        void* tagged_malloc(size_t size, size_t alignment) {
+            size_t offset = alignment > HEADER_SIZE ? alignment : HEADER_SIZE;
+            Memory::pointer base = static_cast<Memory::pointer>(
+                aligned_malloc(size + offset, alignment)
+            );
+            if(base == nil) {
+                return nil;
+            }
+            Memory::pointer result = base + offset;
+            index_t tag = geo_current_memory_tag_;
+            BlockHeader* header = reinterpret_cast<BlockHeader*>(
+                result - HEADER_SIZE
+            );
+            header->size = size;
+            header->tag = Numeric::uint32(tag);
+            header->offset = Numeric::uint32(offset);
+            atomic_max(&max_used_[tag], atomic_add(&used_[tag], size));
+            atomic_max(&total_max_used_, atomic_add(&total_used_, size));
+            return result;
+        }
+
+        void tagged_free(void* p) {
+            if(p == nil) {
+                return;
+            }
+            Memory::pointer block = static_cast<Memory::pointer>(p);
+            BlockHeader* header = reinterpret_cast<BlockHeader*>(
+                block - HEADER_SIZE
+            );
+            atomic_add(&used_[header->tag], size_t(0) - header->size);
+            atomic_add(&total_used_, size_t(0) - header->size);
+            aligned_free(block - header->offset);
+        }
+
+        /*****************************************************************/
+
+        Arena::Arena() :
+            nb_used_chunks_(0),
+            chunk_(nil),
+            chunk_size_(0),
+            offset_(0) {
+            for(index_t c=0; c<NB_SIZE_CLASSES; ++c) {
+                free_list_[c] = nil;
+            }
+        }
+
+        Arena::~Arena() {
+            for(index_t i=0; i<chunks_.size(); ++i) {
+#ifdef GEOGRAM_WITH_MEMORY_ACCOUNTING
+                tagged_free(chunks_[i].data);
+#else
+                aligned_free(chunks_[i].data);
+#endif
+            }
+        }
+
+        void Arena::release(const Mark& m) {
+            nb_used_chunks_ = m.chunk;
+            if(nb_used_chunks_ == 0) {
+                chunk_ = nil;
+                chunk_size_ = 0;
+            } else {
+                chunk_ = chunks_[nb_used_chunks_-1].data;
+                chunk_size_ = chunks_[nb_used_chunks_-1].size;
+            }
+            offset_ = m.offset;
+            // The free lists of the released region reference released
+            // blocks, restore the ones of the enclosing region.
+            for(index_t c=0; c<NB_SIZE_CLASSES; ++c) {
+                free_list_[c] = static_cast<FreeBlock*>(m.free_list[c]);
+            }
+        }
+
+        size_t Arena::capacity() const {
+            size_t result = 0;
+            for(index_t i=0; i<chunks_.size(); ++i) {
+                result += chunks_[i].size;
+            }
+            return result;
+        }
+
+        void* Arena::allocate_in_new_chunk(size_t size) {
+            // Find an unused chunk that is large enough, and move
+            // it right after the used ones.
+            index_t found = index_t(chunks_.size());
+            for(index_t i=nb_used_chunks_; i<chunks_.size(); ++i) {
+                if(chunks_[i].size >= size) {
+                    found = i;
+                    break;
+                }
+            }
+            if(found == chunks_.size()) {
+                Chunk C;
+                C.size = size > CHUNK_SIZE ? size : size_t(CHUNK_SIZE);
+#ifdef GEOGRAM_WITH_MEMORY_ACCOUNTING
+                C.data = static_cast<Memory::pointer>(
+                    tagged_malloc(C.size, GEO_MEMORY_ALIGNMENT)
+                );
+#else
+                C.data = static_cast<Memory::pointer>(
+                    aligned_malloc(C.size)
+                );
+#endif
+                geo_assert(C.data != nil);
+                chunks_.push_back(C);
+            }
+            std::swap(chunks_[found], chunks_[nb_used_chunks_]);
+            chunk_ = chunks_[nb_used_chunks_].data;
+            chunk_size_ = chunks_[nb_used_chunks_].size;
+            ++nb_used_chunks_;
+            offset_ = size;
+            return chunk_;
+        }
+
+        Arena& current_arena() {
+            geo_debug_assert(geo_arena_depth_ != 0);
+            return geo_thread_arena_->arena;
+        }
+
+        ArenaScope::ArenaScope() {
+            if(geo_arena_depth_ == 0) {
+                if(
+                    geo_thread_arena_ == nil ||
+                    !try_acquire_arena(geo_thread_arena_)
+                ) {
+                    geo_thread_arena_ = acquire_arena_from_pool();
+                }
+            }
+            ++geo_arena_depth_;
+            arena_ = &geo_thread_arena_->arena;
+            mark_ = arena_->mark();
+        }
+
+        ArenaScope::~ArenaScope() {
+            arena_->release(mark_);
+            --geo_arena_depth_;
+            if(geo_arena_depth_ == 0) {
+                release_arena(geo_thread_arena_);
+            }
+        }
+
+        void atomic_ref(volatile size_t& nb_refs) {
+            atomic_add(&nb_refs, 1);
+        }
+
+        size_t atomic_unref(volatile size_t& nb_refs) {
+            return atomic_add(&nb_refs, size_t(0) - 1);
+        }
+
+        void lock_shared_buffers() {
+            Process::acquire_spinlock(shared_buffers_lock_);
+        }
+
+        void unlock_shared_buffers() {
+            Process::release_spinlock(shared_buffers_lock_);
+        }
+    }
+}
@@ -52,6 +52,7 @@
 #include <geogram/basic/argused.h>
 #include <geogram/basic/atomics.h>
 #include <vector>
+#include <algorithm>
 #include <string.h>
 #include <stdlib.h>
 
@@ -317,6 +318,155 @@ namespace GEO {
 #endif
         }
 
+        /**
+         * \brief Gets the identifier of a memory tag.
+         * \details Memory tags are used to account for the memory allocated
+         *  by the different subsystems (Delaunay, RVD, AABB, attributes...).
+         *  Tag 0 is reserved for untagged allocations. If no tag with
+         *  the specified name exists, a new one is created.
+         *  Accounting is only done when geogram is compiled with
+         *  GEOGRAM_WITH_MEMORY_ACCOUNTING.
+         * \param[in] name the name of the tag. Its address is kept, 
+         *  thus it needs to be a string literal (or to have static storage).
+         * \return the identifier of the tag
+         */
+        index_t GEOGRAM_API memory_tag(const char* name);
+
+        /**
+         * \brief Gets the memory tag used by the current thread.
+         * \return the identifier of the tag that is charged for
+         *  the allocations done by the current thread
+         */
+        index_t GEOGRAM_API current_memory_tag();
+
+        /**
+         * \brief Sets the memory tag used by the current thread.
+         * \param[in] tag the identifier of the tag, as returned by
+         *  memory_tag()
+         * \see MemoryTagScope
+         */
+        void GEOGRAM_API set_current_memory_tag(index_t tag);
+
+        /**
+         * \brief Gets the number of memory tags.
+         * \return the number of memory tags, including the tag for
+         *  untagged allocations
+         */
+        index_t GEOGRAM_API nb_memory_tags();
+
+        /**
+         * \brief Gets the name of a memory tag.
+         * \param[in] tag the identifier of the tag
+         * \return the name of the tag
+         */
+        const char* GEOGRAM_API memory_tag_name(index_t tag);
+
+        /**
+         * \brief Gets the memory currently allocated with a tag.
+         * \param[in] tag the identifier of the tag
+         * \return the number of bytes currently allocated, or 0 if memory
+         *  accounting is not enabled
+         */
+        size_t GEOGRAM_API memory_tag_used(index_t tag);
+
+        /**
+         * \brief Gets the maximum memory allocated with a tag.
+         * \param[in] tag the identifier of the tag
+         * \return the maximum number of bytes allocated simultaneously
+         *  since the beginning of the program, or 0 if memory
+         *  accounting is not enabled
+         */
+        size_t GEOGRAM_API memory_tag_max_used(index_t tag);
+
+        /**
+         * \brief Displays the current and maximum memory used by each tag.
+         * \details Does nothing if memory accounting is not enabled.
+         */
+        void GEOGRAM_API show_memory_tags();
+
+        /**
+         * \brief Allocates aligned memory and charges it to the current
+         *  memory tag.
+         * \details The size and tag of the block are stored in front of it.
+         *  Used by aligned_allocator when GEOGRAM_WITH_MEMORY_ACCOUNTING is
+         *  defined.
+         * \param[in] size size of the block to allocate
+         * \param[in] alignment memory alignment (must be a power of 2)
+         * \return a pointer to the allocated block
+         */
+        void* GEOGRAM_API tagged_malloc(size_t size, size_t alignment);
+
+        /**
+         * \brief Deallocates memory allocated by tagged_malloc().
+         * \details The size of the block is subtracted from the tag it
+         *  was charged to.
+         * \param[in] p a pointer to the block, returned by tagged_malloc()
+         */
+        void GEOGRAM_API tagged_free(void* p);
+
+        /**
+         * \brief Charges the allocations of the current thread to a 
+         *  memory tag during the lifetime of this object.
+         * \details Threads started by the current thread (using
+         *  parallel_for() or ThreadManager) inherit the current
+         *  memory tag.
+         * \see geo_memory_tag()
+         */
+        class MemoryTagScope {
+        public:
+            /**
+             * \brief MemoryTagScope constructor.
+             * \param[in] tag the identifier of the tag, as returned
+             *  by memory_tag()
+             */
+            explicit MemoryTagScope(index_t tag) :
+                prev_tag_(current_memory_tag()) {
+                set_current_memory_tag(tag);
+            }
+
+            /**
+             * \brief MemoryTagScope destructor.
+             * \details Restores the previous memory tag.
+             */
+            ~MemoryTagScope() {
+                set_current_memory_tag(prev_tag_);
+            }
+
+        private:
+            index_t prev_tag_;
+        };
+
+#define GEO_MEMORY_TAG_CONCAT2(x,y) x##y
+#define GEO_MEMORY_TAG_CONCAT(x,y) GEO_MEMORY_TAG_CONCAT2(x,y)
+
+        /**
+         * \def geo_memory_tag(name)
+         * \brief Charges the memory allocated until the end of the current
+         *  scope to a memory tag.
+         * \details Expands to nothing if geogram is not compiled with
+         *  GEOGRAM_WITH_MEMORY_ACCOUNTING.
+         * \param[in] name the name of the memory tag, as a string literal
+         * \par Example
+         * \code
+         * void build_tree() {
+         *     geo_memory_tag("AABB");
+         *     ...
+         * }
+         * \endcode
+         */
+#ifdef GEOGRAM_WITH_MEMORY_ACCOUNTING
+#define geo_memory_tag(name)                                            \
+    static const GEO::index_t                                           \
+        GEO_MEMORY_TAG_CONCAT(geo_memory_tag_id_,__LINE__) =            \
+        GEO::Memory::memory_tag(name);                                  \
+    GEO::Memory::MemoryTagScope                                         \
+        GEO_MEMORY_TAG_CONCAT(geo_memory_tag_scope_,__LINE__)(          \
+            GEO_MEMORY_TAG_CONCAT(geo_memory_tag_id_,__LINE__)          \
+        )
+#else
+#define geo_memory_tag(name)
+#endif
+
         /**
          * \def geo_decl_aligned(var)
          * \brief Specifies that a given variable should be memory-aligned.
@@ -519,9 +669,15 @@ namespace GEO {
                 size_type nb_elt, ::std::allocator<void>::const_pointer hint = 0
             ) {
                 geo_argused(hint);
+#ifdef GEOGRAM_WITH_MEMORY_ACCOUNTING
+                pointer result = static_cast<pointer>(
+                    tagged_malloc(sizeof(T) * nb_elt, ALIGN)
+                );
+#else
                 pointer result = static_cast<pointer>(
                     aligned_malloc(sizeof(T) * nb_elt, ALIGN)
                 );
+#endif
                 return result;
             }
 
@@ -538,7 +694,11 @@ namespace GEO {
              */
             void deallocate(pointer p, size_type nb_elt) {
                 geo_argused(nb_elt);
+#ifdef GEOGRAM_WITH_MEMORY_ACCOUNTING
+                tagged_free(p);
+#else
                 aligned_free(p);
+#endif
             }
 
             /**
@@ -613,6 +773,448 @@ namespace GEO {
         ) {
             return false;
         }
+
+        /*********************************************************************/
+
+        /**
+         * \brief A bump allocator for short-lived temporaries.
+         * \details Memory is allocated by incrementing a pointer in
+         *  large chunks, that are kept from one use to the next.
+         *  Blocks are aligned on 16 bytes. Small blocks (up to 
+         *  MAX_SMALL_BLOCK bytes) are rounded up to a power of two, 
+         *  and deallocated small blocks are recycled in free lists,
+         *  so that containers that repeatedly allocate and free 
+         *  blocks of the same size (e.g. std::deque) do not make the 
+         *  arena grow. All the blocks allocated after a mark() are
+         *  released at once by release().
+         *  Each thread has its own arena, that is accessed through an
+         *  ArenaScope.
+         * \see ArenaScope, arena_allocator
+         */
+        class GEOGRAM_API Arena {
+        public:
+            /**
+             * \brief Maximum size of the blocks that are recycled in
+             *  free lists.
+             */
+            static const size_t MAX_SMALL_BLOCK = 4096;
+
+            /**
+             * \brief Number of size classes for small blocks.
+             */
+            static const index_t NB_SIZE_CLASSES = 9;
+
+            /**
+             * \brief Default size of the chunks.
+             */
+            static const size_t CHUNK_SIZE = 65536;
+
+            /**
+             * \brief A position in an Arena, and the free lists that
+             *  were active at this position.
+             * \see mark(), release()
+             */
+            struct Mark {
+                index_t chunk;
+                size_t offset;
+                void* free_list[NB_SIZE_CLASSES];
+            };
+
+            /**
+             * \brief Arena constructor.
+             * \details No memory is allocated until the first call to
+             *  allocate().
+             */
+            Arena();
+
+            /**
+             * \brief Arena destructor.
+             * \details Deallocates all the chunks.
+             */
+            ~Arena();
+
+            /**
+             * \brief Allocates a block of memory.
+             * \param[in] size size of the block, in bytes
+             * \return a pointer to the block, aligned on 16 bytes
+             */
+            void* allocate(size_t size) {
+                size = (size + 15) & ~size_t(15);
+                if(size <= MAX_SMALL_BLOCK) {
+                    index_t c = size_class(size);
+                    if(free_list_[c] != nil) {
+                        FreeBlock* result = free_list_[c];
+                        free_list_[c] = result->next;
+                        return result;
+                    }
+                    size = size_t(16) << c;
+                }
+                if(offset_ + size > chunk_size_) {
+                    return allocate_in_new_chunk(size);
+                }
+                void* result = chunk_ + offset_;
+                offset_ += size;
+                return result;
+            }
+
+            /**
+             * \brief Deallocates a block of memory.
+             * \details If the block is the last allocated one, the memory
+             *  is given back to the arena. Else small blocks are recycled
+             *  by subsequent allocations of the same size, and large blocks
+             *  are lost until the next release().
+             * \param[in] p a pointer to the block, returned by allocate()
+             * \param[in] size the size of the block, as specified to 
+             *  allocate()
+             */
+            void deallocate(void* p, size_t size) {
+                size = (size + 15) & ~size_t(15);
+                index_t c = 0;
+                if(size <= MAX_SMALL_BLOCK) {
+                    c = size_class(size);
+                    size = size_t(16) << c;
+                }
+                Memory::pointer block = static_cast<Memory::pointer>(p);
+                if(block + size == chunk_ + offset_) {
+                    offset_ -= size;
+                } else if(size <= MAX_SMALL_BLOCK) {
+                    FreeBlock* free_block = static_cast<FreeBlock*>(p);
+                    free_block->next = free_list_[c];
+                    free_list_[c] = free_block;
+                }
+            }
+
+            /**
+             * \brief Starts a new region in this Arena.
+             * \details The blocks deallocated from now on are only 
+             *  recycled for allocations in the new region. The free
+             *  lists of the enclosing region are restored by release().
+             * \return a Mark that can be used to release all the blocks
+             *  allocated from now on
+             */
+            Mark mark() {
+                Mark result;
+                result.chunk = nb_used_chunks_;
+                result.offset = offset_;
+                for(index_t c=0; c<NB_SIZE_CLASSES; ++c) {
+                    result.free_list[c] = free_list_[c];
+                    free_list_[c] = nil;
+                }
+                return result;
+            }
+
+            /**
+             * \brief Releases all the blocks allocated since a mark.
+             * \details The chunks are kept for subsequent allocations.
+             * \param[in] m a mark, previously obtained by mark(). Regions
+             *  need to be released in the reverse order of their creation.
+             */
+            void release(const Mark& m);
+
+            /**
+             * \brief Gets the total size of the chunks.
+             * \return the number of bytes allocated by this arena
+             *  from the system
+             */
+            size_t capacity() const;
+
+        protected:
+            /**
+             * \brief Gets the size class of a small block.
+             * \param[in] size the size of the block, a multiple of 16,
+             *  smaller than MAX_SMALL_BLOCK
+             * \return c such that \f$ 16 \times 2^{c-1} < size \leq 
+             *  16 \times 2^c \f$
+             */
+            static index_t size_class(size_t size) {
+                index_t result = 0;
+                while((size_t(16) << result) < size) {
+                    ++result;
+                }
+                return result;
+            }
+
+            /**
+             * \brief Allocates a block at the beginning of a new chunk.
+             * \details Reuses a previously allocated chunk if there is one
+             *  that is large enough.
+             * \param[in] size size of the block, in bytes
+             * \return a pointer to the block
+             */
+            void* allocate_in_new_chunk(size_t size);
+
+        private:
+            /**
+             * \brief Stores the chaining of the free lists in the 
+             *  deallocated blocks.
+             */
+            struct FreeBlock {
+                FreeBlock* next;
+            };
+
+            /**
+             * \brief A chunk of memory, allocated from the system.
+             */
+            struct Chunk {
+                Memory::pointer data;
+                size_t size;
+            };
+
+            std::vector<Chunk> chunks_;
+            index_t nb_used_chunks_;
+            Memory::pointer chunk_;
+            size_t chunk_size_;
+            size_t offset_;
+            FreeBlock* free_list_[NB_SIZE_CLASSES];
+
+            /** \brief Forbids copy */
+            Arena(const Arena&);
+
+            /** \brief Forbids copy */
+            Arena& operator=(const Arena&);
+        };
+
+        /**
+         * \brief Gets the Arena of the current thread.
+         * \pre there is an active ArenaScope in the current thread
+         * \return a reference to the Arena of the current thread
+         */
+        Arena& GEOGRAM_API current_arena();
+
+        /**
+         * \brief Gives access to the Arena of the current thread, and
+         *  releases all the blocks allocated within its lifetime.
+         * \details ArenaScope%s can be nested. The Arena of a thread is 
+         *  obtained from a pool when the outermost ArenaScope is created,
+         *  and given back to the pool when it is destroyed, so that the
+         *  arenas are reused by the threads created by subsequent calls
+         *  to parallel_for().
+         *  Containers that use an arena_allocator need to be declared
+         *  after the ArenaScope, so that they are destroyed before it.
+         * \par Example
+         * \code
+         * void compute_cell(index_t i) {
+         *     Memory::ArenaScope scope;
+         *     std::vector<index_t, Memory::arena_allocator<index_t> > neigh;
+         *     ...
+         * }
+         * \endcode
+         */
+        class GEOGRAM_API ArenaScope {
+        public:
+            /**
+             * \brief ArenaScope constructor.
+             */
+            ArenaScope();
+
+            /**
+             * \brief ArenaScope destructor.
+             * \details Releases all the blocks allocated since the 
+             *  construction of this ArenaScope.
+             */
+            ~ArenaScope();
+
+            /**
+             * \brief Gets the Arena.
+             * \return a reference to the Arena of the current thread
+             */
+            Arena& arena() {
+                return *arena_;
+            }
+
+        private:
+            Arena* arena_;
+            Arena::Mark mark_;
+
+            /** \brief Forbids copy */
+            ArenaScope(const ArenaScope&);
+
+            /** \brief Forbids copy */
+            ArenaScope& operator=(const ArenaScope&);
+        };
+
+        /**
+         * \brief An allocator that allocates from the Arena of the
+         *  current thread.
+         * \details The allocator can be used as a template argument for 
+         *  STL containers, that are used as temporaries in hot loops.
+         *  Allocation is done by incrementing a pointer, and does not 
+         *  take any lock. The containers need to be created and destroyed
+         *  by the same thread, within an ArenaScope.
+         * \see ArenaScope
+         */
+        template <class T>
+        class arena_allocator {
+        public:
+            /** \brief Element type */
+            typedef T value_type;
+
+            /** \brief Pointer to element */
+            typedef T* pointer;
+
+            /** \brief Reference to element */
+            typedef T& reference;
+
+            /** \brief Pointer to constant element */
+            typedef const T* const_pointer;
+
+            /** \brief Reference to constant element */
+            typedef const T& const_reference;
+
+            /** \brief Quantities of elements */
+            typedef ::std::size_t size_type;
+
+            /** \brief Difference between two pointers */
+            typedef ::std::ptrdiff_t difference_type;
+
+            /**
+             * \brief Defines the same allocator for other types
+             * \tparam U type of the elements to allocate
+             */
+            template <class U>
+            struct rebind {
+                /** Equivalent allocator type to allocate elements of type \p U*/
+                typedef arena_allocator<U> other;
+            };
+
+            /**
+             * \brief Constructs an arena_allocator.
+             */
+            arena_allocator() {
+            }
+
+            /**
+             * \brief Constructs an arena_allocator from an arena_allocator
+             *  of another type.
+             * \details Required by the STL containers that allocate
+             *  internal nodes.
+             */
+            template <class U> arena_allocator(const arena_allocator<U>&) {
+            }
+
+            /**
+             * \brief Gets the address of an object
+             * \param[in] x a reference to an object of type T
+             * \return a pointer to \p x
+             */
+            pointer address(reference x) {
+                return &x;
+            }
+
+            /**
+             * \brief Gets the address of a object
+             * \param[in] x a const reference to an object of type T
+             * \return a const_pointer to \p x
+             */
+            const_pointer address(const_reference x) {
+                return &x;
+            }
+
+            /**
+             * \brief Allocates a block of storage in the Arena of the
+             *  current thread.
+             * \param[in] nb_elt number of elements to allocate
+             * \param[in] hint ignored
+             * \return A pointer to the initial element in the block of storage
+             */
+            pointer allocate(size_type nb_elt, const void* hint = 0) {
+                geo_argused(hint);
+                return static_cast<pointer>(
+                    current_arena().allocate(sizeof(T) * nb_elt)
+                );
+            }
+
+            /**
+             * \brief Releases a block of storage
+             * \param[in] p Pointer to a block of storage previously allocated
+             *  with arena_allocator::allocate.
+             * \param[in] nb_elt Number of elements allocated on the call to
+             *  arena_allocator::allocate() for this block of storage.
+             */
+            void deallocate(pointer p, size_type nb_elt) {
+                current_arena().deallocate(p, sizeof(T) * nb_elt);
+            }
+
+            /**
+             * \brief Gets the maximum size possible to allocate
+             * \return the maximum number of elements, each of member type
+             * \c value_type that could potentially be allocated by a call to
+             * member allocate().
+             */
+            size_type max_size() const {
+                ::std::allocator<char> a;
+                return a.max_size() / sizeof(T);
+            }
+
+            /**
+             * \brief Constructs an object
+             * \param[in] p pointer to a location with enough storage space to
+             *  contain an element of type value_type.
+             * \param[in] val value to initialize the constructed element to.
+             */
+            void construct(pointer p, const_reference val) {
+                new (static_cast<void*>(p))value_type(val);
+            }
+
+            /**
+             * \brief Destroys an object
+             * \param[in] p pointer to the object to be destroyed.
+             */
+            void destroy(pointer p) {
+                p->~value_type();
+#ifdef GEO_COMPILER_MSVC
+                (void) p; // to avoid a "unreferenced variable" warning
+#endif
+            }
+        };
+
+        /**
+         * \brief Tests whether two arena_allocator%s are equal.
+         * \return Always true (all the arena_allocator%s of a thread
+         *  use the same Arena).
+         */
+        template <typename T1, typename T2>
+        inline bool operator== (
+            const arena_allocator<T1>&, const arena_allocator<T2>&
+        ) {
+            return true;
+        }
+
+        /**
+         * \brief Tests whether two arena_allocator%s are different.
+         * \return Always false.
+         */
+        template <typename T1, typename T2>
+        inline bool operator!= (
+            const arena_allocator<T1>&, const arena_allocator<T2>&
+        ) {
+            return false;
+        }
+
+        /**
+         * \brief Atomically increments a reference counter.
+         * \param[in,out] nb_refs the reference counter
+         */
+        void GEOGRAM_API atomic_ref(volatile size_t& nb_refs);
+
+        /**
+         * \brief Atomically decrements a reference counter.
+         * \param[in,out] nb_refs the reference counter
+         * \return the new value of the reference counter
+         */
+        size_t GEOGRAM_API atomic_unref(volatile size_t& nb_refs);
+
+        /**
+         * \brief Acquires the lock that serializes the copies done
+         *  by copy-on-write containers.
+         * \see cow_vector
+         */
+        void GEOGRAM_API lock_shared_buffers();
+
+        /**
+         * \brief Releases the lock acquired by lock_shared_buffers().
+         */
+        void GEOGRAM_API unlock_shared_buffers();
     }
 
     /************************************************************************/
@@ -715,6 +1317,45 @@ namespace GEO {
             return baseclass::operator[] (index_t(i));
         }
 
+#ifdef GEOGRAM_WITH_64BIT_INDICES
+        /**
+         * \brief Gets a vector element
+         * \details With 64 bits indices, int and unsigned int arguments
+         *  (e.g. literal constants) would be ambiguous without these
+         *  overloads.
+         * \param[in] i index of the element
+         * \return A reference to the element at position \p i in the vector.
+         */
+        T& operator[] (int i) {
+            geo_debug_assert(i >= 0 && index_t(i) < size());
+            return baseclass::operator[] (index_t(i));
+        }
+
+        /**
+         * \copydoc operator[](int)
+         */
+        const T& operator[] (int i) const {
+            geo_debug_assert(i >= 0 && index_t(i) < size());
+            return baseclass::operator[] (index_t(i));
+        }
+
+        /**
+         * \copydoc operator[](int)
+         */
+        T& operator[] (unsigned int i) {
+            geo_debug_assert(index_t(i) < size());
+            return baseclass::operator[] (index_t(i));
+        }
+
+        /**
+         * \copydoc operator[](int)
+         */
+        const T& operator[] (unsigned int i) const {
+            geo_debug_assert(index_t(i) < size());
+            return baseclass::operator[] (index_t(i));
+        }
+#endif
+
         /**
          * \brief Gets a pointer to the array of elements
          * \return a pointer to the first element of the vector
@@ -771,6 +1412,289 @@ namespace GEO {
         // TODO: operator[] with bounds checking (more complicated
         // than just returning bool&, check implementation in STL).
     };
+
+    /************************************************************************/
+
+    /**
+     * \brief A vector with copy-on-write semantics.
+     * \details Copying a cow_vector is done in constant time: both copies
+     *  share the same reference-counted buffer. The buffer is duplicated
+     *  the first time one of the copies is accessed through a non-const
+     *  member function (this includes the non-const operator[] and
+     *  data(), even when they are used only to read). Pointers and
+     *  references obtained from a non-const cow_vector before it was
+     *  copied must not be used to modify it after the copy.
+     *  Several threads may access a shared cow_vector concurrently, the
+     *  first one that modifies it takes the copy.
+     * \tparam T type of the elements
+     */
+    template <class T>
+    class cow_vector {
+    public:
+        /**
+         * \brief Creates an empty cow_vector.
+         */
+        cow_vector() :
+            buffer_(new Buffer),
+            shared_(false) {
+        }
+
+        /**
+         * \brief Creates a cow_vector that shares the buffer of another
+         *  one.
+         * \param[in] rhs the cow_vector to be copied
+         */
+        cow_vector(const cow_vector<T>& rhs) :
+            buffer_(rhs.buffer_),
+            shared_(true) {
+            Memory::atomic_ref(buffer_->nb_refs);
+            rhs.shared_ = true;
+        }
+
+        /**
+         * \brief cow_vector destructor.
+         */
+        ~cow_vector() {
+            release(buffer_);
+        }
+
+        /**
+         * \brief Shares the buffer of another cow_vector.
+         * \param[in] rhs the cow_vector to be copied
+         * \return a reference to this cow_vector
+         */
+        cow_vector<T>& operator=(const cow_vector<T>& rhs) {
+            if(rhs.buffer_ != buffer_) {
+                Memory::atomic_ref(rhs.buffer_->nb_refs);
+                release(buffer_);
+                buffer_ = rhs.buffer_;
+                shared_ = true;
+                rhs.shared_ = true;
+            }
+            return *this;
+        }
+
+        /**
+         * \brief Copies the elements of a vector.
+         * \param[in] rhs the vector to be copied
+         * \return a reference to this cow_vector
+         */
+        cow_vector<T>& operator=(const vector<T>& rhs) {
+            discard();
+            buffer_->data = rhs;
+            return *this;
+        }
+
+        /**
+         * \brief Gets the number of elements.
+         */
+        index_t size() const {
+            return buffer_->data.size();
+        }
+
+        /**
+         * \brief Tests whether this cow_vector is empty.
+         */
+        bool empty() const {
+            return buffer_->data.empty();
+        }
+
+        /**
+         * \brief Gets a modifiable element.
+         * \details Duplicates the buffer if it is shared.
+         * \param[in] i index of the element
+         */
+        T& operator[](index_t i) {
+            return get_vector()[i];
+        }
+
+        /**
+         * \brief Gets an element.
+         * \param[in] i index of the element
+         */
+        const T& operator[](index_t i) const {
+            return buffer_->data[i];
+        }
+
+        /**
+         * \brief Gets a pointer to the array of elements.
+         * \details Duplicates the buffer if it is shared.
+         */
+        T* data() {
+            return get_vector().data();
+        }
+
+        /**
+         * \brief Gets a const pointer to the array of elements.
+         */
+        const T* data() const {
+            return buffer_->data.data();
+        }
+
+        /**
+         * \brief Resizes this cow_vector.
+         * \param[in] new_size the new number of elements
+         */
+        void resize(index_t new_size) {
+            get_vector().resize(new_size);
+        }
+
+        /**
+         * \brief Resizes this cow_vector.
+         * \param[in] new_size the new number of elements
+         * \param[in] val the value of the new elements
+         */
+        void resize(index_t new_size, const T& val) {
+            get_vector().resize(new_size, val);
+        }
+
+        /**
+         * \brief Reserves memory.
+         * \param[in] new_capacity the number of elements that can be
+         *  stored without reallocation
+         */
+        void reserve(index_t new_capacity) {
+            get_vector().reserve(new_capacity);
+        }
+
+        /**
+         * \brief Appends an element.
+         * \param[in] val the element to be appended
+         */
+        void push_back(const T& val) {
+            get_vector().push_back(val);
+        }
+
+        /**
+         * \brief Removes all the elements.
+         * \details If the buffer is shared, it is not duplicated.
+         */
+        void clear() {
+            discard();
+            buffer_->data.clear();
+        }
+
+        /**
+         * \brief Replaces the elements with copies of a value.
+         * \details If the buffer is shared, it is not duplicated.
+         * \param[in] new_size the new number of elements
+         * \param[in] val the value of the elements
+         */
+        void assign(index_t new_size, const T& val) {
+            discard();
+            buffer_->data.assign(new_size, val);
+        }
+
+        /**
+         * \brief Swaps the elements with the elements of a vector.
+         * \param[in,out] rhs the vector
+         */
+        void swap(vector<T>& rhs) {
+            get_vector().swap(rhs);
+        }
+
+        /**
+         * \brief Swaps two cow_vector%s in constant time.
+         * \param[in,out] rhs the other cow_vector
+         */
+        void swap(cow_vector<T>& rhs) {
+            std::swap(buffer_, rhs.buffer_);
+            std::swap(shared_, rhs.shared_);
+        }
+
+        /**
+         * \brief Tests whether the buffer may be shared with another
+         *  cow_vector.
+         */
+        bool is_shared() const {
+            return shared_;
+        }
+
+        /**
+         * \brief Gets the vector that stores the elements.
+         * \details Duplicates the buffer if it is shared.
+         * \return a modifiable reference to the vector
+         */
+        vector<T>& get_vector() {
+            if(shared_) {
+                unshare();
+            }
+            return buffer_->data;
+        }
+
+        /**
+         * \brief Gets the vector that stores the elements.
+         * \return a const reference to the vector
+         */
+        const vector<T>& get_vector() const {
+            return buffer_->data;
+        }
+
+        /**
+         * \brief Duplicates the buffer if it is shared with another
+         *  cow_vector.
+         */
+        void unshare() {
+            Memory::lock_shared_buffers();
+            if(shared_) {
+                if(buffer_->nb_refs != 1) {
+                    Buffer* old_buffer = buffer_;
+                    Buffer* new_buffer = new Buffer;
+                    new_buffer->data = old_buffer->data;
+                    buffer_ = new_buffer;
+                    release(old_buffer);
+                }
+                shared_ = false;
+            }
+            Memory::unlock_shared_buffers();
+        }
+
+    protected:
+        /**
+         * \brief If the buffer is shared, replaces it with an empty one
+         *  instead of duplicating it.
+         */
+        void discard() {
+            if(!shared_) {
+                return;
+            }
+            Memory::lock_shared_buffers();
+            if(shared_) {
+                if(buffer_->nb_refs != 1) {
+                    Buffer* old_buffer = buffer_;
+                    buffer_ = new Buffer;
+                    release(old_buffer);
+                }
+                shared_ = false;
+            }
+            Memory::unlock_shared_buffers();
+        }
+
+        /**
+         * \brief The reference-counted buffer.
+         */
+        struct Buffer {
+            Buffer() : nb_refs(1) {
+            }
+            vector<T> data;
+            volatile size_t nb_refs;
+        };
+
+        /**
+         * \brief Releases a reference to a buffer, and deallocates it
+         *  if it was the last one.
+         * \param[in] buffer a pointer to the buffer
+         */
+        static void release(Buffer* buffer) {
+            if(Memory::atomic_unref(buffer->nb_refs) == 0) {
+                delete buffer;
+            }
+        }
+
+    private:
+        Buffer* buffer_;
+        mutable bool shared_;
+    };
 }
 
 #endif
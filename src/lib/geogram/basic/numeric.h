@@ -50,6 +50,7 @@
 #include <math.h>
 #include <float.h>
 #include <limits.h>
+#include <string.h>
 
 // Visual C++ ver. < 2010 does not have C99 stdint.h,
 // using a fallback portable one.
@@ -117,6 +118,136 @@ namespace GEO {
         /** Floating point type with a width of 64 bits */
         typedef double float64;
 
+        /**
+         * \brief Floating point type with a width of 16 bits.
+         * \details Uses the IEEE 754 binary16 format (1 sign bit,
+         *  5 exponent bits, 10 mantissa bits), that represents numbers
+         *  up to 65504 with 3 significant decimal digits. It is only a
+         *  storage format, for instance for attributes that do not need
+         *  a high precision (colors, texture coordinates, scalar fields):
+         *  values are converted from and to float32, with rounding to
+         *  nearest even.
+         */
+        class float16 {
+        public:
+            /**
+             * \brief Creates a zero float16.
+             */
+            float16() : bits_(0) {
+            }
+
+            /**
+             * \brief Creates a float16 from a number.
+             * \param[in] x the number, rounded to the nearest float16.
+             *  Numbers larger than 65504 in absolute value are converted
+             *  to infinity.
+             */
+            float16(float64 x) : bits_(encode(float32(x))) {
+            }
+
+            /**
+             * \brief Converts this float16 to a float32.
+             */
+            operator float32() const {
+                return decode(bits_);
+            }
+
+            /**
+             * \brief Gets the binary representation.
+             */
+            uint16 bits() const {
+                return bits_;
+            }
+
+            /**
+             * \brief Creates a float16 from its binary representation.
+             * \param[in] bits the binary representation
+             */
+            static float16 from_bits(uint16 bits) {
+                float16 result;
+                result.bits_ = bits;
+                return result;
+            }
+
+            /**
+             * \brief Converts a float32 to the binary representation of
+             *  the nearest float16.
+             * \param[in] x the float32
+             * \return the binary representation of the float16
+             */
+            static uint16 encode(float32 x) {
+                uint32 f;
+                ::memcpy(&f, &x, sizeof(uint32));
+                uint32 sign = (f >> 16) & 0x8000u;
+                uint32 a = f & 0x7fffffffu;
+                if(a >= 0x7f800000u) {
+                    // Infinity or NaN (NaN stays NaN).
+                    uint32 nan = (a > 0x7f800000u) ? 
+                        (0x200u | ((a >> 13) & 0x3ffu)) : 0u;
+                    return uint16(sign | 0x7c00u | nan);
+                }
+                if(a >= 0x477ff000u) {
+                    // Larger than the largest float16 after rounding.
+                    return uint16(sign | 0x7c00u);
+                }
+                if(a < 0x38800000u) {
+                    // Smaller than the smallest normal float16.
+                    if(a <= 0x33000000u) {
+                        return uint16(sign);
+                    }
+                    uint32 e = a >> 23;
+                    uint32 m = (a & 0x7fffffu) | 0x800000u;
+                    uint32 shift = 126u - e;
+                    uint32 code = m >> shift;
+                    uint32 rem = m & ((1u << shift) - 1u);
+                    uint32 half = 1u << (shift - 1u);
+                    if(rem > half || (rem == half && (code & 1u) != 0)) {
+                        ++code;
+                    }
+                    return uint16(sign | code);
+                }
+                // Rebias the exponent and round the mantissa.
+                uint32 code = (a - 0x38000000u) >> 13;
+                uint32 rem = a & 0x1fffu;
+                if(rem > 0x1000u || (rem == 0x1000u && (code & 1u) != 0)) {
+                    ++code;
+                }
+                return uint16(sign | code);
+            }
+
+            /**
+             * \brief Converts the binary representation of a float16
+             *  to a float32.
+             * \param[in] bits the binary representation of the float16
+             * \return the float32, that represents exactly the float16
+             */
+            static float32 decode(uint16 bits) {
+                uint32 sign = uint32(bits & 0x8000u) << 16;
+                uint32 e = (uint32(bits) >> 10) & 0x1fu;
+                uint32 m = uint32(bits) & 0x3ffu;
+                uint32 f;
+                if(e == 0) {
+                    if(m == 0) {
+                        f = sign;
+                    } else {
+                        // Subnormal float16, normal float32.
+                        float32 result = float32(m) * 5.9604644775390625e-8f;
+                        return (sign != 0) ? -result : result;
+                    }
+                } else if(e == 31) {
+                    f = sign | 0x7f800000u | (m << 13);
+                } else {
+                    f = sign | ((e + 112u) << 23) | (m << 13);
+                }
+                float32 result;
+                ::memcpy(&result, &f, sizeof(float32));
+                return result;
+            }
+
+        private:
+            uint16 bits_;
+        };
+
         /**
          * \brief Gets 32 bits float maximum positive value
          */
@@ -0,0 +1,227 @@
+/*
+ *  Copyright (c) 2012-2014, Bruno Levy
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *  this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *  this list of conditions and the following disclaimer in the documentation
+ *  and/or other materials provided with the distribution.
+ *  * Neither the name of the ALICE Project-Team nor the names of its
+ *  contributors may be used to endorse or promote products derived from this
+ *  software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     Bruno.Levy@inria.fr
+ *     http://www.loria.fr/~levy
+ *
+ *     ALICE Project
+ *     LORIA, INRIA Lorraine, 
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX 
+ *     FRANCE
+ *
+ */
+
+#include <geogram/basic/permutation.h>
+#include <geogram/basic/process.h>
+
+namespace {
+
+    using namespace GEO;
+
+    /**
+     * \brief Number of elements processed by each iteration of the
+     *  parallel loops.
+     */
+    const index_t CHUNK_SIZE = 4096;
+
+    /**
+     * \brief Copies an element.
+     * \details Common element sizes are copied without calling memcpy().
+     * \param[in] to address of the destination
+     * \param[in] from address of the source
+     * \param[in] elemsize size of the element in bytes
+     */
+    inline void copy_element(
+        Memory::pointer to, const Memory::byte* from, index_t elemsize
+    ) {
+        switch(elemsize) {
+        case 4:
+            *(Numeric::uint32*)(void*)to = *(const Numeric::uint32*)(
+                const void*
+            )from;
+            break;
+        case 8:
+            *(Numeric::uint64*)(void*)to = *(const Numeric::uint64*)(
+                const void*
+            )from;
+            break;
+        default:
+            Memory::copy(to, from, elemsize);
+            break;
+        }
+    }
+
+    /**
+     * \brief Gathers the permuted elements of several arrays
+     *  into temporary buffers, then copies them back.
+     * \details Used by Permutation::apply_out_of_place(). The
+     *  two steps are done by parallel loops over chunks of elements.
+     */
+    class PermutationGather {
+    public:
+        /**
+         * \brief PermutationGather constructor.
+         * \param[in] data the arrays to be permuted
+         * \param[in] elemsize the size of the elements of each array
+         * \param[in] temp the temporary buffers, one per array
+         * \param[in] permutation the permutation
+         */
+        PermutationGather(
+            const vector<void*>& data,
+            const vector<index_t>& elemsize,
+            const vector<Memory::pointer>& temp,
+            const vector<index_t>& permutation
+        ) :
+            data_(data),
+            elemsize_(elemsize),
+            temp_(temp),
+            permutation_(permutation) {
+        }
+
+        /**
+         * \brief Copies the permuted elements of a chunk into the
+         *  temporary buffers.
+         * \param[in] chunk index of the chunk
+         */
+        void gather(index_t chunk) {
+            index_t b = chunk * CHUNK_SIZE;
+            index_t e = geo_min(b + CHUNK_SIZE, permutation_.size());
+            for(index_t k = 0; k < data_.size(); ++k) {
+                const Memory::byte* from =
+                    static_cast<const Memory::byte*>(data_[k]);
+                Memory::pointer to = temp_[k];
+                index_t elemsize = elemsize_[k];
+                for(index_t i = b; i < e; ++i) {
+                    copy_element(
+                        to + i * elemsize,
+                        from + permutation_[i] * elemsize,
+                        elemsize
+                    );
+                }
+            }
+        }
+
+        /**
+         * \brief Copies a chunk of the temporary buffers back
+         *  into the arrays.
+         * \param[in] chunk index of the chunk
+         */
+        void copy_back(index_t chunk) {
+            index_t b = chunk * CHUNK_SIZE;
+            index_t e = geo_min(b + CHUNK_SIZE, permutation_.size());
+            for(index_t k = 0; k < data_.size(); ++k) {
+                index_t elemsize = elemsize_[k];
+                Memory::copy(
+                    static_cast<Memory::pointer>(data_[k]) + b * elemsize,
+                    temp_[k] + b * elemsize,
+                    (e - b) * elemsize
+                );
+            }
+        }
+
+    private:
+        const vector<void*>& data_;
+        const vector<index_t>& elemsize_;
+        const vector<Memory::pointer>& temp_;
+        const vector<index_t>& permutation_;
+    };
+}
+
+namespace GEO {
+
+    namespace Permutation {
+
+        bool apply_out_of_place(
+            const vector<void*>& data,
+            const vector<index_t>& elemsize,
+            const vector<index_t>& permutation
+        ) {
+            geo_assert(data.size() == elemsize.size());
+            geo_debug_assert(is_valid(permutation));
+            if(permutation.size() == 0 || data.size() == 0) {
+                return true;
+            }
+
+            // Allocates all the temporary buffers, or none of them
+            // if there is not enough memory.
+            vector<Memory::pointer> temp(data.size(), nil);
+            for(index_t k = 0; k < data.size(); ++k) {
+                temp[k] = static_cast<Memory::pointer>(
+                    Memory::aligned_malloc(
+                        size_t(permutation.size()) * size_t(elemsize[k])
+                    )
+                );
+                if(temp[k] == nil) {
+                    for(index_t kk = 0; kk < k; ++kk) {
+                        Memory::aligned_free(temp[kk]);
+                    }
+                    return false;
+                }
+            }
+
+            PermutationGather gather(data, elemsize, temp, permutation);
+            index_t nb_chunks =
+                (permutation.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+            parallel_for(
+                parallel_for_member_callback(
+                    &gather, &PermutationGather::gather
+                ),
+                0, nb_chunks
+            );
+            parallel_for(
+                parallel_for_member_callback(
+                    &gather, &PermutationGather::copy_back
+                ),
+                0, nb_chunks
+            );
+
+            for(index_t k = 0; k < data.size(); ++k) {
+                Memory::aligned_free(temp[k]);
+            }
+            return true;
+        }
+
+        bool apply_out_of_place(
+            void* data, const vector<index_t>& permutation,
+            index_t elemsize
+        ) {
+            vector<void*> data_array(1, data);
+            vector<index_t> elemsize_array(1, elemsize);
+            return apply_out_of_place(
+                data_array, elemsize_array, permutation
+            );
+        }
+    }
+}
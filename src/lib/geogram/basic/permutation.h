@@ -139,6 +139,54 @@ namespace GEO {
             permutation[i] = index_t(-signed_index_t(permutation[i]) - 1);
         }
 
+        /**
+         * \brief Minimum number of elements for which apply() uses
+         *  apply_out_of_place().
+         * \details For smaller arrays, the in-place algorithm is faster
+         *  than starting the threads.
+         */
+        const index_t OUT_OF_PLACE_THRESHOLD = 65536;
+
+        /**
+         * \brief Applies the same permutation to several arrays, using
+         *  temporary buffers and parallel loops.
+         * \details Each array is gathered into a temporary buffer by a
+         *  parallel loop that traverses the permutation only once for all
+         *  the arrays, then the buffers are copied back. This is much
+         *  faster than following the cycles of the permutation, but needs
+         *  \c permutation.size() times the sum of the element sizes
+         *  of additional memory.
+         * \param[in,out] data pointers to the arrays to be permuted, each
+         *  of them with at least \c permutation.size() elements
+         * \param[in] elemsize the size of the elements of each array,
+         *  in bytes
+         * \param[in] permutation the permutation
+         * \retval true if the permutation was applied
+         * \retval false if the temporary buffers could not be allocated,
+         *  then the arrays are left unchanged
+         */
+        bool GEOGRAM_API apply_out_of_place(
+            const vector<void*>& data,
+            const vector<index_t>& elemsize,
+            const vector<index_t>& permutation
+        );
+
+        /**
+         * \brief Applies a permutation to an array, using a temporary
+         *  buffer and parallel loops.
+         * \param[in,out] data an array of \c permutation.size() elements
+         *  to permute
+         * \param[in] permutation the permutation
+         * \param[in] elemsize size of the elements, in bytes
+         * \retval true if the permutation was applied
+         * \retval false if the temporary buffer could not be allocated,
+         *  then the array is left unchanged
+         */
+        bool GEOGRAM_API apply_out_of_place(
+            void* data, const vector<index_t>& permutation,
+            index_t elemsize
+        );
+        
         /**
          * \brief Applies a permutation in-place.
          * Permutes the first \p N elements of size \p elemsize in array \p
@@ -161,11 +209,19 @@ namespace GEO {
          *  It is temporarily changed during execution of the
          *  function, but identical to the input on exit.
          * \param[in] elemsize size of the vector elements
+         * \note For large arrays, apply_out_of_place() is used if there
+         *  is enough memory for the temporary buffer.
          */
         inline void apply(
             void* data, const vector<index_t>& permutation_in,
             index_t elemsize
         ) {
+            if(
+                permutation_in.size() >= OUT_OF_PLACE_THRESHOLD &&
+                apply_out_of_place(data, permutation_in, elemsize)
+            ) {
+                return;
+            }
             Memory::pointer pdata = (Memory::pointer) (data);
             vector<index_t>& permutation =
                 const_cast<vector<index_t>&>(permutation_in);
@@ -263,6 +263,9 @@ namespace GEO {
 
     void Thread::set_current(Thread* thread) {
         geo_current_thread_ = thread;
+        if(thread != nil) {
+            Memory::set_current_memory_tag(thread->memory_tag_);
+        }
     }
 
     Thread* Thread::current() {
@@ -398,6 +401,8 @@ namespace GEO {
             Logger::out("Process") << "Maximum used memory: " 
                                    << max_mem << " (" << s << ")"
                                    << std::endl;
+
+            Memory::show_memory_tags();
         }
 
         void terminate() {
@@ -96,8 +96,11 @@ namespace GEO {
 
         /**
          * \brief Thread constructor.
+         * \details The thread inherits the memory tag of the thread
+         *  that creates it.
+         * \see Memory::MemoryTagScope
          */
-        Thread() : id_(0) {
+        Thread() : id_(0), memory_tag_(Memory::current_memory_tag()) {
         }
 
         /**
@@ -150,6 +153,7 @@ namespace GEO {
         static void set_current(Thread* thread);
 
         index_t id_;
+        index_t memory_tag_;
 
         // ThreadManager needs to access set_current() and 
         // set_id().
@@ -651,7 +655,7 @@ namespace GEO {
             Process::maximum_concurrent_threads() * threads_per_core
         );
 
-	nb_threads = geo_max(1u, nb_threads);
+	nb_threads = geo_max(index_t(1), nb_threads);
 	
         index_t batch_size = (to - from) / nb_threads;
         if(Process::is_running_threads() || nb_threads == 1) {
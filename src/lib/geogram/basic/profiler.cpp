@@ -0,0 +1,535 @@
+/*
+ *  Copyright (c) 2012-2014, Bruno Levy
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *  this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *  this list of conditions and the following disclaimer in the documentation
+ *  and/or other materials provided with the distribution.
+ *  * Neither the name of the ALICE Project-Team nor the names of its
+ *  contributors may be used to endorse or promote products derived from this
+ *  software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     Bruno.Levy@inria.fr
+ *     http://www.loria.fr/~levy
+ *
+ *     ALICE Project
+ *     LORIA, INRIA Lorraine, 
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX 
+ *     FRANCE
+ *
+ */
+
+#include <geogram/basic/profiler.h>
+#include <geogram/basic/process.h>
+#include <geogram/basic/environment.h>
+#include <geogram/basic/logger.h>
+#include <geogram/basic/string.h>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#ifdef GEO_OS_WINDOWS
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace {
+
+    using namespace GEO;
+
+    /**
+     * \brief An event recorded by the Profiler.
+     */
+    struct Event {
+        Numeric::uint64 time;  /**< \brief in microseconds */
+        double value;          /**< \brief for counters */
+        index_t name;          /**< \brief name id, unused for 'E' */
+        char type;             /**< \brief one of 'B', 'E', 'C' */
+    };
+
+    /**
+     * \brief The events recorded by a thread.
+     */
+    struct ThreadBuffer {
+        index_t id;            /**< \brief track in the trace */
+        std::string name;      /**< \brief name of the track */
+        std::vector<Event> events;
+    };
+
+    /**
+     * \brief Statistics of a span, used by show_summary().
+     */
+    struct SpanStats {
+        SpanStats() : nb_calls(0), total(0), self(0) {
+        }
+        index_t nb_calls;
+        Numeric::uint64 total;
+        Numeric::uint64 self;
+    };
+
+    /**
+     * \brief An opened span, used by show_summary().
+     */
+    struct OpenSpan {
+        index_t name;
+        Numeric::uint64 begin;
+        Numeric::uint64 children;
+    };
+
+    /**
+     * \brief Sorts the names by decreasing total time.
+     */
+    class TotalTimeGreater {
+    public:
+        TotalTimeGreater(const std::vector<SpanStats>& stats) :
+            stats_(stats) {
+        }
+        bool operator()(index_t i, index_t j) const {
+            return stats_[i].total > stats_[j].total;
+        }
+    private:
+        const std::vector<SpanStats>& stats_;
+    };
+
+    Process::spinlock lock_ = GEOGRAM_SPINLOCK_INIT;
+    std::vector<ThreadBuffer*> buffers_;
+    std::vector<ThreadBuffer*> worker_buffers_;
+    std::vector<std::string> names_;
+    std::map<std::string, index_t> name_to_id_;
+    std::string trace_filename_;
+    bool summary_ = false;
+    bool initialized_ = false;
+    Numeric::uint64 origin_ = 0;
+
+    /**
+     * \brief The buffer of the current thread, if it was not started
+     *  by the ThreadManager (main thread, OpenMP threads).
+     * \details Allocated when the thread records its first event.
+     */
+    GEO_THREAD_LOCAL ThreadBuffer* own_buffer_ = nil;
+
+    /**
+     * \brief The last Thread that recorded an event in the current 
+     *  system thread, its id, and its buffer.
+     * \details The ThreadManager starts new system threads for each
+     *  parallel_for(), the buffers of its threads are indexed by
+     *  Thread::id() so that they are reused from one call to the next.
+     */
+    GEO_THREAD_LOCAL Thread* worker_ = nil;
+    GEO_THREAD_LOCAL index_t worker_id_ = 0;
+    GEO_THREAD_LOCAL ThreadBuffer* worker_buffer_ = nil;
+
+    /**
+     * \brief Gets the current time of the monotonic clock.
+     * \return the current time, in microseconds
+     */
+    Numeric::uint64 clock_time() {
+#ifdef GEO_OS_WINDOWS
+        LARGE_INTEGER frequency;
+        LARGE_INTEGER counter;
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&counter);
+        return Numeric::uint64(
+            double(counter.QuadPart) * 1e6 / double(frequency.QuadPart)
+        );
+#else
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return Numeric::uint64(ts.tv_sec) * Numeric::uint64(1000000) +
+            Numeric::uint64(ts.tv_nsec) / Numeric::uint64(1000);
+#endif
+    }
+
+    /**
+     * \brief Creates a new buffer.
+     * \details The lock needs to be held by the caller.
+     * \param[in] worker true for the buffer of a thread started by
+     *  the ThreadManager, false otherwise
+     */
+    ThreadBuffer* new_buffer(bool worker) {
+        ThreadBuffer* result = new ThreadBuffer;
+        result->id = index_t(buffers_.size());
+        if(result->id == 0) {
+            result->name = "main";
+        } else {
+            result->name = std::string(worker ? "worker " : "thread ") +
+                String::to_string(result->id);
+        }
+        buffers_.push_back(result);
+        return result;
+    }
+
+    /**
+     * \brief Gets the buffer of the current thread.
+     * \details Allocates it if need be.
+     */
+    ThreadBuffer* buffer() {
+        Thread* thread = Thread::current();
+        if(thread == nil) {
+            if(own_buffer_ == nil) {
+                Process::acquire_spinlock(lock_);
+                own_buffer_ = new_buffer(false);
+                Process::release_spinlock(lock_);
+            }
+            return own_buffer_;
+        }
+        if(
+            worker_buffer_ == nil || thread != worker_ ||
+            thread->id() != worker_id_
+        ) {
+            index_t id = thread->id();
+            Process::acquire_spinlock(lock_);
+            if(id >= worker_buffers_.size()) {
+                worker_buffers_.resize(id+1, nil);
+            }
+            if(worker_buffers_[id] == nil) {
+                worker_buffers_[id] = new_buffer(true);
+            }
+            worker_buffer_ = worker_buffers_[id];
+            Process::release_spinlock(lock_);
+            worker_ = thread;
+            worker_id_ = id;
+        }
+        return worker_buffer_;
+    }
+
+    /**
+     * \brief Records an event in the current thread.
+     */
+    void record(char type, index_t name, double value) {
+        Event e;
+        e.time = Profiler::now();
+        e.value = value;
+        e.name = name;
+        e.type = type;
+        buffer()->events.push_back(e);
+    }
+
+    /**
+     * \brief Escapes a string to be used in a JSON file.
+     */
+    std::string json_string(const std::string& s) {
+        std::string result = "\"";
+        for(size_t i=0; i<s.length(); ++i) {
+            char c = s[i];
+            if(c == '"' || c == '\\') {
+                result.push_back('\\');
+                result.push_back(c);
+            } else if((unsigned char)(c) < 32) {
+                result.push_back(' ');
+            } else {
+                result.push_back(c);
+            }
+        }
+        result.push_back('"');
+        return result;
+    }
+
+    /**
+     * \brief Updates the enabled flag from the command line arguments.
+     */
+    void update_enabled() {
+        bool enable = (trace_filename_ != "" || summary_);
+#ifndef GEOGRAM_WITH_PROFILER
+        if(enable) {
+            Logger::warn("Profile")
+                << "geogram was compiled without GEOGRAM_WITH_PROFILER"
+                << std::endl;
+        }
+#endif
+        Profiler::set_enabled(enable);
+    }
+
+    /**
+     * \brief Profiler Environment
+     * \details This environment exposes and controls the configuration of
+     *  the Profiler (profile:xxx properties).
+     */
+    class ProfilerEnvironment : public Environment {
+    protected:
+        /**
+         * \copydoc Environment::get_local_value()
+         */
+        virtual bool get_local_value(
+            const std::string& name, std::string& value
+        ) const {
+            if(name == "profile:trace") {
+                value = trace_filename_;
+                return true;
+            }
+            if(name == "profile:summary") {
+                value = String::to_string(summary_);
+                return true;
+            }
+            return false;
+        }
+
+        /**
+         * \copydoc Environment::set_local_value()
+         */
+        virtual bool set_local_value(
+            const std::string& name, const std::string& value
+        ) {
+            if(name == "profile:trace") {
+                trace_filename_ = value;
+                update_enabled();
+                return true;
+            }
+            if(name == "profile:summary") {
+                summary_ = String::to_bool(value);
+                update_enabled();
+                return true;
+            }
+            return false;
+        }
+
+        /** ProfilerEnvironment destructor */
+        virtual ~ProfilerEnvironment() {
+        }
+    };
+}
+
+namespace GEO {
+
+    namespace Profiler {
+
+        bool enabled_ = false;
+
+        void initialize() {
+            if(initialized_) {
+                return;
+            }
+            origin_ = clock_time();
+            // The main thread is thread 0.
+            buffer();
+            Environment::instance()->add_environment(new ProfilerEnvironment);
+            initialized_ = true;
+        }
+
+        void terminate() {
+            if(!initialized_) {
+                return;
+            }
+            set_enabled(false);
+            if(trace_filename_ != "") {
+                if(save_trace(trace_filename_)) {
+                    Logger::out("Profile") << "Saved trace in "
+                                           << trace_filename_ << std::endl;
+                } else {
+                    Logger::err("Profile") << "Could not save trace in "
+                                           << trace_filename_ << std::endl;
+                }
+            }
+            if(summary_) {
+                show_summary();
+            }
+            // The buffers of the threads are not deallocated,
+            // since other threads may still reference them.
+            clear();
+            initialized_ = false;
+        }
+
+        void set_enabled(bool x) {
+            enabled_ = x;
+        }
+
+        Numeric::uint64 now() {
+            return clock_time() - origin_;
+        }
+
+        index_t name_id(const std::string& name) {
+            Process::acquire_spinlock(lock_);
+            index_t result;
+            std::map<std::string, index_t>::iterator it =
+                name_to_id_.find(name);
+            if(it == name_to_id_.end()) {
+                result = index_t(names_.size());
+                names_.push_back(name);
+                name_to_id_[name] = result;
+            } else {
+                result = it->second;
+            }
+            Process::release_spinlock(lock_);
+            return result;
+        }
+
+        void begin_span(index_t name) {
+            record('B', name, 0.0);
+        }
+
+        void end_span() {
+            record('E', index_t(-1), 0.0);
+        }
+
+        void counter(index_t name, double value) {
+            record('C', name, value);
+        }
+
+        void clear() {
+            Process::acquire_spinlock(lock_);
+            for(index_t i=0; i<buffers_.size(); ++i) {
+                buffers_[i]->events.clear();
+            }
+            Process::release_spinlock(lock_);
+        }
+
+        bool save_trace(const std::string& filename) {
+            std::ofstream out(filename.c_str());
+            if(!out) {
+                return false;
+            }
+            Numeric::uint64 last_time = now();
+            out << "{\"traceEvents\":[" << std::endl;
+            bool first = true;
+            for(index_t b=0; b<buffers_.size(); ++b) {
+                const ThreadBuffer& buff = *buffers_[b];
+                if(buff.events.empty()) {
+                    continue;
+                }
+                out << (first ? "" : ",\n")
+                    << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,"
+                    << "\"tid\":" << buff.id << ",\"args\":{\"name\":"
+                    << json_string(buff.name)
+                    << "}}";
+                first = false;
+                index_t depth = 0;
+                for(index_t i=0; i<buff.events.size(); ++i) {
+                    const Event& e = buff.events[i];
+                    if(e.type == 'E' && depth == 0) {
+                        // span started before the last clear()
+                        continue;
+                    }
+                    out << ",\n{\"ph\":\"" << e.type << "\",\"pid\":0,"
+                        << "\"tid\":" << buff.id << ",\"ts\":" << e.time;
+                    if(e.type == 'B') {
+                        ++depth;
+                        out << ",\"name\":" << json_string(names_[e.name]);
+                    } else if(e.type == 'E') {
+                        --depth;
+                    } else {
+                        out << ",\"name\":" << json_string(names_[e.name])
+                            << ",\"args\":{\"value\":" << e.value << "}";
+                    }
+                    out << "}";
+                }
+                // Close the spans that are still opened.
+                for(; depth != 0; --depth) {
+                    out << ",\n{\"ph\":\"E\",\"pid\":0,"
+                        << "\"tid\":" << buff.id << ",\"ts\":" << last_time
+                        << "}";
+                }
+            }
+            out << "\n],\"displayTimeUnit\":\"ms\"}" << std::endl;
+            return bool(out);
+        }
+
+        void show_summary() {
+            std::vector<SpanStats> stats(names_.size());
+            std::vector<double> counter_value(names_.size(), 0.0);
+            std::vector<index_t> counter_nb(names_.size(), 0);
+            Numeric::uint64 last_time = now();
+            for(index_t b=0; b<buffers_.size(); ++b) {
+                const ThreadBuffer& buff = *buffers_[b];
+                std::vector<OpenSpan> stack;
+                for(index_t i=0; i<=buff.events.size(); ++i) {
+                    bool at_end = (i == buff.events.size());
+                    if(!at_end && buff.events[i].type == 'B') {
+                        OpenSpan span;
+                        span.name = buff.events[i].name;
+                        span.begin = buff.events[i].time;
+                        span.children = 0;
+                        stack.push_back(span);
+                    } else if(!at_end && buff.events[i].type == 'C') {
+                        counter_value[buff.events[i].name] =
+                            buff.events[i].value;
+                        ++counter_nb[buff.events[i].name];
+                    } else {
+                        // 'E' event, or end of the buffer: closes
+                        // one span (or all the spans at the end).
+                        Numeric::uint64 t =
+                            at_end ? last_time : buff.events[i].time;
+                        index_t nb_close = index_t(
+                            at_end ? stack.size() : geo_min(
+                                stack.size(), size_t(1)
+                            )
+                        );
+                        for(index_t k=0; k<nb_close; ++k) {
+                            const OpenSpan& span = stack.back();
+                            Numeric::uint64 duration = t - span.begin;
+                            SpanStats& S = stats[span.name];
+                            ++S.nb_calls;
+                            S.total += duration;
+                            S.self += duration - span.children;
+                            stack.pop_back();
+                            if(!stack.empty()) {
+                                stack.back().children += duration;
+                            }
+                        }
+                    }
+                }
+            }
+
+            std::vector<index_t> spans;
+            std::vector<index_t> counters;
+            for(index_t i=0; i<names_.size(); ++i) {
+                if(stats[i].nb_calls != 0) {
+                    spans.push_back(i);
+                }
+                if(counter_nb[i] != 0) {
+                    counters.push_back(i);
+                }
+            }
+            std::sort(spans.begin(), spans.end(), TotalTimeGreater(stats));
+
+            Logger::div("Profile");
+            std::ostringstream header;
+            header << std::setw(12) << "total (s)" << std::setw(12)
+                   << "self (s)" << std::setw(10) << "calls" << "  span";
+            Logger::out("Profile") << header.str() << std::endl;
+            for(index_t i=0; i<spans.size(); ++i) {
+                const SpanStats& S = stats[spans[i]];
+                std::ostringstream line;
+                line << std::fixed << std::setprecision(3)
+                     << std::setw(12) << double(S.total) * 1e-6
+                     << std::setw(12) << double(S.self) * 1e-6
+                     << std::setw(10) << S.nb_calls
+                     << "  " << names_[spans[i]];
+                Logger::out("Profile") << line.str() << std::endl;
+            }
+            for(index_t i=0; i<counters.size(); ++i) {
+                Logger::out("Profile") << "counter " << names_[counters[i]]
+                                       << " = " << counter_value[counters[i]]
+                                       << " (" << counter_nb[counters[i]]
+                                       << " samples)" << std::endl;
+            }
+        }
+    }
+}
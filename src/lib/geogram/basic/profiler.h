@@ -0,0 +1,288 @@
+/*
+ *  Copyright (c) 2012-2014, Bruno Levy
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *  this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *  this list of conditions and the following disclaimer in the documentation
+ *  and/or other materials provided with the distribution.
+ *  * Neither the name of the ALICE Project-Team nor the names of its
+ *  contributors may be used to endorse or promote products derived from this
+ *  software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     Bruno.Levy@inria.fr
+ *     http://www.loria.fr/~levy
+ *
+ *     ALICE Project
+ *     LORIA, INRIA Lorraine, 
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX 
+ *     FRANCE
+ *
+ */
+
+#ifndef GEOGRAM_BASIC_PROFILER
+#define GEOGRAM_BASIC_PROFILER
+
+#include <geogram/basic/common.h>
+#include <geogram/basic/numeric.h>
+#include <string>
+
+/**
+ * \file geogram/basic/profiler.h
+ * \brief A tracing profiler, that records nested time spans and counters
+ *  in each thread.
+ * \details The profiler is enabled by the command line arguments of
+ *  the "profile" group:
+ *  - profile:trace=filename.json saves the trace on exit in the
+ *    Chrome trace event format (that can be displayed by
+ *    chrome://tracing or https://ui.perfetto.dev);
+ *  - profile:summary=true displays on exit a table with the total time
+ *    spent in each span.
+ *
+ *  Spans are declared with geo_profile_scope() or Stopwatch, counters
+ *  with geo_profile_counter(). When geogram is configured without
+ *  GEOGRAM_WITH_PROFILER, the macros expand to nothing.
+ *
+ * \code
+ * void my_function() {
+ *     geo_profile_scope("my_function");
+ *     for(index_t iter=0; iter<nb_iter; ++iter) {
+ *         ...
+ *         geo_profile_counter("energy", E);
+ *     }
+ * }
+ * \endcode
+ */
+
+namespace GEO {
+
+    /**
+     * \brief Records nested time spans and counters.
+     * \details Each thread records its events in its own buffer, thus
+     *  recording does not need any synchronization. The threads started
+     *  by the ThreadManager use one buffer per Thread::id(), that is
+     *  reused by the successive parallel_for() calls. The buffers are
+     *  exported on exit, when all the threads are finished.
+     */
+    namespace Profiler {
+
+        /**
+         * \brief Initializes the Profiler.
+         * \details This function is called by GEO::initialize().
+         */
+        void GEOGRAM_API initialize();
+
+        /**
+         * \brief Terminates the Profiler.
+         * \details Saves the trace and displays the summary if they were
+         *  requested. This function is called by GEO::terminate().
+         */
+        void GEOGRAM_API terminate();
+
+        /**
+         * \brief The flag that indicates whether the profiler records
+         *  events.
+         * \details Use enabled() instead.
+         */
+        extern GEOGRAM_API bool enabled_;
+
+        /**
+         * \brief Tests whether the profiler records events.
+         * \details It is the case if profile:trace or profile:summary
+         *  is set.
+         */
+        inline bool enabled() {
+            return enabled_;
+        }
+
+        /**
+         * \brief Enables or disables recording.
+         * \param[in] x true to enable recording, false to disable it
+         */
+        void GEOGRAM_API set_enabled(bool x);
+
+        /**
+         * \brief Gets the current time.
+         * \return the time elapsed since the initialization of the
+         *  Profiler, in microseconds (measured with a monotonic wall
+         *  clock)
+         */
+        Numeric::uint64 GEOGRAM_API now();
+
+        /**
+         * \brief Gets the unique id associated with a name.
+         * \details Events store name ids instead of strings. The first
+         *  call with a given name allocates the id.
+         * \param[in] name the name of a span or of a counter
+         * \return the id associated with \p name
+         */
+        index_t GEOGRAM_API name_id(const std::string& name);
+
+        /**
+         * \brief Starts a span in the current thread.
+         * \param[in] name the id of the name of the span, as returned
+         *  by name_id()
+         */
+        void GEOGRAM_API begin_span(index_t name);
+
+        /**
+         * \brief Ends the last started span in the current thread.
+         */
+        void GEOGRAM_API end_span();
+
+        /**
+         * \brief Records the value of a counter in the current thread.
+         * \param[in] name the id of the name of the counter, as returned
+         *  by name_id()
+         * \param[in] value the value of the counter
+         */
+        void GEOGRAM_API counter(index_t name, double value);
+
+        /**
+         * \brief Clears all the recorded events.
+         * \details Should not be called while other threads are recording
+         *  events.
+         */
+        void GEOGRAM_API clear();
+
+        /**
+         * \brief Saves all the recorded events in the Chrome trace event
+         *  format.
+         * \param[in] filename name of the JSON file
+         * \retval true on success
+         * \retval false otherwise
+         */
+        bool GEOGRAM_API save_trace(const std::string& filename);
+
+        /**
+         * \brief Displays a table with the number of calls, total time and
+         *  self time (time not spent in nested spans) of each span, and
+         *  the last value of each counter.
+         */
+        void GEOGRAM_API show_summary();
+    }
+
+    /**
+     * \brief Records a span during the lifetime of this object.
+     * \details If the Profiler is disabled when the ProfileScope is
+     *  created, nothing is recorded.
+     */
+    class ProfileScope {
+    public:
+        /**
+         * \brief ProfileScope constructor.
+         * \param[in] name the id of the name of the span, as returned
+         *  by Profiler::name_id()
+         */
+        explicit ProfileScope(index_t name) :
+            active_(Profiler::enabled()) {
+            if(active_) {
+                Profiler::begin_span(name);
+            }
+        }
+
+        /**
+         * \brief ProfileScope constructor.
+         * \param[in] name the name of the span
+         */
+        explicit ProfileScope(const std::string& name) :
+            active_(Profiler::enabled()) {
+            if(active_) {
+                Profiler::begin_span(Profiler::name_id(name));
+            }
+        }
+
+        /**
+         * \brief ProfileScope destructor.
+         * \details Ends the span.
+         */
+        ~ProfileScope() {
+            if(active_) {
+                Profiler::end_span();
+            }
+        }
+
+    private:
+        /** \brief Forbids copy */
+        ProfileScope(const ProfileScope&);
+
+        /** \brief Forbids copy */
+        ProfileScope& operator=(const ProfileScope&);
+
+        bool active_;
+    };
+}
+
+/**
+ * \cond
+ */
+#define GEO_PROFILE_CONCAT2(x,y) x##y
+#define GEO_PROFILE_CONCAT(x,y) GEO_PROFILE_CONCAT2(x,y)
+/**
+ * \endcond
+ */
+
+#ifdef GEOGRAM_WITH_PROFILER
+
+/**
+ * \brief Records a span until the end of the current scope.
+ * \details The id of the name is computed once.
+ * \param[in] name the name of the span, a string literal
+ */
+#define geo_profile_scope(name)                                         \
+    static const GEO::index_t                                           \
+        GEO_PROFILE_CONCAT(geo_profile_id_,__LINE__) =                  \
+        GEO::Profiler::name_id(name);                                   \
+    GEO::ProfileScope GEO_PROFILE_CONCAT(geo_profile_scope_,__LINE__)(  \
+        GEO_PROFILE_CONCAT(geo_profile_id_,__LINE__)                    \
+    )
+
+/**
+ * \brief Records the value of a counter.
+ * \param[in] name the name of the counter, a string literal
+ * \param[in] value the value of the counter
+ */
+#define geo_profile_counter(name, value) {                              \
+        if(GEO::Profiler::enabled()) {                                  \
+            static const GEO::index_t                                   \
+                GEO_PROFILE_CONCAT(geo_profile_id_,__LINE__) =          \
+                GEO::Profiler::name_id(name);                           \
+            GEO::Profiler::counter(                                     \
+                GEO_PROFILE_CONCAT(geo_profile_id_,__LINE__),           \
+                double(value)                                           \
+            );                                                          \
+        }                                                               \
+}
+
+#else
+
+#define geo_profile_scope(name)
+
+#define geo_profile_counter(name, value)
+
+#endif
+
+#endif
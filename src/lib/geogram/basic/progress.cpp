@@ -235,7 +235,7 @@ namespace GEO {
         task_name_(task_name),
         start_time_(SystemStopwatch::now()),
         quiet_(quiet),
-        max_steps_(geo_max(1u, max_steps)),
+        max_steps_(geo_max(index_t(1), max_steps)),
         step_(0),
         percent_(0)
     {
@@ -250,7 +250,7 @@ namespace GEO {
         task_name_(task_name),
         start_time_(SystemStopwatch::now()),
         quiet_(Logger::instance()->is_quiet()),
-        max_steps_(geo_max(1u, max_steps)),
+        max_steps_(geo_max(index_t(1), max_steps)),
         step_(0),
         percent_(0)
     {
@@ -273,7 +273,7 @@ namespace GEO {
     }
 
     void ProgressTask::reset(index_t max_steps) {
-        max_steps_ = geo_max(1u, max_steps);
+        max_steps_ = geo_max(index_t(1), max_steps);
         reset();
     }
 
@@ -294,7 +294,7 @@ namespace GEO {
     }
 
     void ProgressTask::update() {
-        percent_ = geo_min(100u, step_ * 100u / max_steps_);
+        percent_ = geo_min(index_t(100), step_ * 100 / max_steps_);
         if(!quiet_) {
             task_progress(step_, percent_);
         }
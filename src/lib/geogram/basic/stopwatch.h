@@ -50,6 +50,10 @@
 #include <geogram/basic/numeric.h>
 #include <geogram/basic/logger.h>
 
+#ifdef GEOGRAM_WITH_PROFILER
+#include <geogram/basic/profiler.h>
+#endif
+
 /****************************************************************************/
 
 #ifdef GEO_OS_WINDOWS
@@ -173,7 +177,9 @@ namespace GEO {
      * \brief Scope restricted stopwatch
      * \details Stopwatch prints the elapsed time
      * since its construction when it goes out of scope.
-     * It uses SystemStopwatch to measure time.
+     * It uses SystemStopwatch to measure time. If the Profiler is
+     * enabled, the lifetime of the Stopwatch is recorded as a span
+     * named after the task.
      *
      * \code
      * {
@@ -192,7 +198,11 @@ namespace GEO {
 	 *  when this Stopwatch is destroyed, else nothing is displayed.
          */
         Stopwatch(const std::string& task_name, bool verbose=true) :
-  	    task_name_(task_name), verbose_(verbose) {
+  	    task_name_(task_name), verbose_(verbose)
+#ifdef GEOGRAM_WITH_PROFILER
+            , scope_(task_name)
+#endif
+        {
         }
 
         /**
@@ -224,6 +234,9 @@ namespace GEO {
         std::string task_name_;
 	bool verbose_;
         SystemStopwatch W_;
+#ifdef GEOGRAM_WITH_PROFILER
+        ProfileScope scope_;
+#endif
     };
 }
 
@@ -448,7 +448,7 @@ namespace GEO {
             void acquire_spinlock(index_t i) {
                 geo_thread_sync_assert(i < size());
                 index_t w = i >> 5;
-                index_t b = i & 31;
+                Numeric::uint32 b = Numeric::uint32(i & 31);
                 while(atomic_bittestandset_x86(&spinlocks_[w], b)) {
                     // Intel recommends to have a PAUSE asm instruction
                     // in the spinlock loop. It is generated using the
@@ -465,7 +465,7 @@ namespace GEO {
             void release_spinlock(index_t i) {
                 geo_thread_sync_assert(i < size());
                 index_t w = i >> 5;
-                index_t b = i & 31;
+                Numeric::uint32 b = Numeric::uint32(i & 31);
                 // Note: we need here to use a synchronized bit reset
                 // since &= is not atomic.
                 atomic_bittestandreset_x86(&spinlocks_[w], b);
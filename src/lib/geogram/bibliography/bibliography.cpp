@@ -48,6 +48,7 @@
 #include <geogram/basic/command_line.h>
 #include <geogram/basic/logger.h>
 #include <geogram/basic/stopwatch.h>
+#include <geogram/basic/process.h>
 #include <string>
 
 namespace {
@@ -75,6 +76,10 @@ namespace {
     };
     
     vector<CitationRecord> citations_;
+
+    // Algorithms can be called from concurrent threads (e.g. the chart
+    // workers of the atlas maker), and cite() from there.
+    Process::spinlock citations_lock_ = GEOGRAM_SPINLOCK_INIT;
 }
 
 void register_embedded_bib_file(void);
@@ -196,16 +201,17 @@ namespace GEO {
 	    }
 	    shortfunction = shortfunction.substr(pos, shortfunction.length()-pos);
 	    
+	    std::string context = std::string(shortfunction) + " (" +
+		shortfile + ":" +
+		String::to_string(line) + ")" ;
+
+	    Process::acquire_spinlock(citations_lock_);
 	    citations_.push_back(
 		CitationRecord(
 		    ref, shortfile, line, shortfunction, (info != nil) ? info : ""
 		)
 	    );
 	    
-	    std::string context = std::string(shortfunction) + " (" +
-		shortfile + ":" +
-		String::to_string(line) + ")" ;
-	    
 	    if(
 		CmdLine::arg_is_declared("biblio") &&
 		CmdLine::get_arg_bool("biblio")
@@ -214,11 +220,14 @@ namespace GEO {
 		    << "[" << ref << "] cited from: "
 		    << context << std::endl;
 	    }
+	    Process::release_spinlock(citations_lock_);
 	}
 
 	void reset_citations() {
+	    Process::acquire_spinlock(citations_lock_);
 	    citations_.clear();
 	    timeorigin = SystemStopwatch::now();	    
+	    Process::release_spinlock(citations_lock_);
 	}
     }
     
@@ -252,6 +252,29 @@ namespace GEO {
         }
     }
 
+#ifdef GEOGRAM_WITH_64BIT_INDICES
+    void Delaunay::set_arrays(
+        index_t nb_cells, const int* cell_to_v, const int* cell_to_cell
+    ) {
+        index_t nb = nb_cells * cell_size();
+        converted_cell_to_v_.resize(nb);
+        for(index_t i = 0; i < nb; ++i) {
+            converted_cell_to_v_[i] = signed_index_t(cell_to_v[i]);
+        }
+        converted_cell_to_cell_.clear();
+        if(cell_to_cell != nil) {
+            converted_cell_to_cell_.resize(nb);
+            for(index_t i = 0; i < nb; ++i) {
+                converted_cell_to_cell_[i] = signed_index_t(cell_to_cell[i]);
+            }
+        }
+        set_arrays(
+            nb_cells, converted_cell_to_v_.data(),
+            cell_to_cell == nil ? nil : converted_cell_to_cell_.data()
+        );
+    }
+#endif
+
     bool Delaunay::supports_constraints() const {
         return false;
     }
@@ -288,8 +311,8 @@ namespace GEO {
         );
     }
 
-    void Delaunay::get_neighbors_internal(
-        index_t v, vector<index_t>& neighbors
+    template <class VECTOR> void Delaunay::collect_neighbors(
+        index_t v, VECTOR& neighbors
     ) const {
         // Step 1: traverse the incident cells list, and insert
         // all neighbors (may be duplicated)
@@ -316,14 +339,23 @@ namespace GEO {
         sort_unique(neighbors);
     }
 
+    void Delaunay::get_neighbors_internal(
+        index_t v, vector<index_t>& neighbors
+    ) const {
+        collect_neighbors(v, neighbors);
+    }
+
     void Delaunay::store_neighbors_CB(index_t i) {
-        // TODO: this one is not multithread-friendly
-        // since it does dynamic memory allocation
-        // (but not really a problem, since the one
-        // that is used is in Delaunay_ANN).
-        vector<index_t> neighbors;
-        get_neighbors_internal(i, neighbors);
-        neighbors_.set_array(i, neighbors);
+        // The temporary list of neighbors is allocated in the
+        // arena of the thread, so that there is no dynamic
+        // memory allocation in the parallel loop.
+        Memory::ArenaScope arena_scope;
+        std::vector<index_t, Memory::arena_allocator<index_t> > neighbors;
+        collect_neighbors(i, neighbors);
+        neighbors_.set_array(
+            i, index_t(neighbors.size()),
+            neighbors.empty() ? nil : &neighbors[0]
+        );
     }
 
     void Delaunay::update_v_to_cell() {
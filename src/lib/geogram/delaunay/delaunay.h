@@ -665,6 +665,20 @@ namespace GEO {
             index_t v, vector<index_t>& neighbors
         ) const;
 
+        /**
+         * \brief Computes the neighbors of a vertex from the 
+         *  combinatorics of the cells.
+         * \details Implementation of get_neighbors_internal(), that
+         *  can use any type of vector (for instance a vector allocated
+         *  in a Memory::Arena).
+         * \tparam VECTOR a vector of index_t
+         * \param[in] v index of the Delaunay vertex
+         * \param[out] neighbors the neighbors of vertex \p v, sorted
+         */
+        template <class VECTOR> void collect_neighbors(
+            index_t v, VECTOR& neighbors
+        ) const;
+
         /**
          * \brief Sets the arrays that represent the combinatorics
          *  of this Delaunay.
@@ -677,6 +691,22 @@ namespace GEO {
             const signed_index_t* cell_to_v, const signed_index_t* cell_to_cell
         );
 
+#ifdef GEOGRAM_WITH_64BIT_INDICES
+        /**
+         * \brief Sets the arrays that represent the combinatorics
+         *  of this Delaunay from 32 bits indices.
+         * \details Used with external libraries (tetgen, triangle) when
+         *  geogram is compiled with 64 bits indices. The arrays are
+         *  converted and copied.
+         * \param[in] nb_cells number of cells
+         * \param[in] cell_to_v the cell-to-vertex incidence array
+         * \param[in] cell_to_cell the cell-to-cell adjacency array
+         */
+        void set_arrays(
+            index_t nb_cells, const int* cell_to_v, const int* cell_to_cell
+        );
+#endif
+
         /**
          * \brief Stores for each vertex v a cell incident to v.
          */
@@ -750,6 +780,10 @@ namespace GEO {
         index_t nb_cells_;
         const signed_index_t* cell_to_v_;
         const signed_index_t* cell_to_cell_;
+#ifdef GEOGRAM_WITH_64BIT_INDICES
+        vector<signed_index_t> converted_cell_to_v_;
+        vector<signed_index_t> converted_cell_to_cell_;
+#endif
         vector<signed_index_t> v_to_cell_;
         vector<signed_index_t> cicl_;
         bool is_locked_;
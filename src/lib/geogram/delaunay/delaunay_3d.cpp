@@ -237,6 +237,7 @@ namespace GEO {
     void Delaunay3d::set_vertices(
         index_t nb_vertices, const double* vertices
     ) {
+        geo_memory_tag("Delaunay");
         Stopwatch* W = nil;
         if(benchmark_mode_) {
             W = new Stopwatch("DelInternal");
@@ -103,6 +103,7 @@ namespace GEO {
     void Delaunay_NearestNeighbors::set_vertices(
         index_t nb_vertices, const double* vertices
     ) {
+        geo_memory_tag("Delaunay");
         Delaunay::set_vertices(nb_vertices, vertices);
         NN_->set_points(nb_vertices, vertices);
         update_neighbors();
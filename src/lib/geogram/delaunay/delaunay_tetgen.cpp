@@ -87,6 +87,7 @@ namespace GEO {
     void DelaunayTetgen::set_vertices(
         index_t nb_vertices, const double* vertices
     ) {
+        geo_memory_tag("Delaunay");
         if(constraints_ != nil) {
             set_vertices_constrained(nb_vertices, vertices);
         } else {
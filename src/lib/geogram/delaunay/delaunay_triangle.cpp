@@ -103,6 +103,7 @@ namespace GEO {
     void DelaunayTriangle::set_vertices(
         index_t nb_vertices, const double* vertices
     ) {
+        geo_memory_tag("Delaunay");
         Delaunay::set_vertices(nb_vertices, vertices);
         free_triangulateio(&triangle_out_);
         triangle_in_.numberofpoints = int(nb_vertices);
@@ -52,6 +52,7 @@
 #include <geogram/basic/stopwatch.h>
 #include <geogram/basic/command_line.h>
 #include <geogram/basic/permutation.h>
+#include <geogram/basic/profiler.h>
 #include <geogram/bibliography/bibliography.h>
 
 // ParallelDelaunayThread class, declared locally, has
@@ -420,7 +421,7 @@ namespace GEO {
             }
             geo_debug_assert(work_begin_ != -1);
             geo_debug_assert(work_end_ != -1);
-            return index_t(geo_max(work_end_ - work_begin_ + 1,0));
+            return index_t(geo_max(work_end_ - work_begin_ + 1,signed_index_t(0)));
         }
 
         /**
@@ -451,6 +452,7 @@ namespace GEO {
          *  by set_work(). 
          */
         virtual void run() {
+            geo_profile_scope("PDEL thread");
             
             finished_ = false;
 
@@ -2753,6 +2755,8 @@ namespace GEO {
     void ParallelDelaunay3d::set_vertices(
         index_t nb_vertices, const double* vertices
     ) {
+        geo_memory_tag("Delaunay");
+        geo_profile_scope("PDEL");
         Stopwatch* W = nil ;
         if(benchmark_mode_) {
             W = new Stopwatch("DelInternal");
@@ -295,6 +295,9 @@ namespace GEO {
 	int x_;
     };
 
+#ifndef GEOGRAM_WITH_64BIT_INDICES
+    // With 64 bits indices, index_t is Numeric::uint64
+
     /**
      * \brief lua_to specialization for index_t.
      */
@@ -312,6 +315,7 @@ namespace GEO {
       private:
 	index_t x_;
     };
+#endif
 
     /**
      * \brief lua_to specialization for Numeric::uint64.
@@ -481,12 +485,14 @@ namespace GEO {
 	lua_pushinteger(L,lua_Integer(x));
     }
 
+#ifndef GEOGRAM_WITH_64BIT_INDICES
     /**
      * \brief Specialization of lua_push() for index_t.
      */
     template<> inline void lua_push(lua_State* L, index_t x) {
 	lua_pushinteger(L,lua_Integer(x));
     }
+#endif
 
     /**
      * \brief Specialization of lua_push() for Numeric::uint64.
@@ -492,9 +492,10 @@ namespace GEO {
         // for storing the re-numbering map
         vector<index_t>& facets_old2new = to_delete;
 
-        vector<index_t>& corner_vertex = facet_corners_.corner_vertex_;
+        vector<index_t>& corner_vertex =
+            facet_corners_.corner_vertex_.get_vector();
         vector<index_t>& corner_adjacent_facet =
-            facet_corners_.corner_adjacent_facet_;
+            facet_corners_.corner_adjacent_facet_.get_vector();
         
         index_t new_nb_facets = 0;
         index_t new_nb_corners = 0;
@@ -562,9 +563,10 @@ namespace GEO {
     void MeshFacets::permute_elements(vector<index_t>& permutation) {
         attributes_.apply_permutation(permutation);
 
-        vector<index_t>& corner_vertex = facet_corners_.corner_vertex_;
+        vector<index_t>& corner_vertex =
+            facet_corners_.corner_vertex_.get_vector();
         vector<index_t>& corner_adjacent_facet =
-            facet_corners_.corner_adjacent_facet_;
+            facet_corners_.corner_adjacent_facet_.get_vector();
 
         if(facet_corners_.attributes().nb() != 0) {
             vector<index_t> facet_corners_permutation;
@@ -1056,8 +1058,10 @@ namespace GEO {
         // for storing the re-numbering map
         vector<index_t>& cells_old2new = to_delete;
 
-        vector<index_t>& corner_vertex = cell_corners_.corner_vertex_;
-        vector<index_t>& adjacent_cell = cell_facets_.adjacent_cell_;
+        vector<index_t>& corner_vertex =
+            cell_corners_.corner_vertex_.get_vector();
+        vector<index_t>& adjacent_cell =
+            cell_facets_.adjacent_cell_.get_vector();
 
         index_t new_nb_cells = 0;
         index_t new_nb_corner_facets = 0;
@@ -1172,8 +1176,10 @@ namespace GEO {
             }
         }
 
-        vector<index_t>& corner_vertex = cell_corners_.corner_vertex_;
-        vector<index_t>& facet_adjacent_cell = cell_facets_.adjacent_cell_;
+        vector<index_t>& corner_vertex =
+            cell_corners_.corner_vertex_.get_vector();
+        vector<index_t>& facet_adjacent_cell =
+            cell_facets_.adjacent_cell_.get_vector();
         
         if(is_simplicial_) {
             // in-place permutation !
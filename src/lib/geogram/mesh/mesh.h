@@ -435,6 +435,9 @@ namespace GEO {
 
         /**
          * \brief Gets a point
+         * \details As the other non-const accessors, it tests whether
+         *  the coordinates are shared with a copy of the mesh. Loops
+         *  over all the vertices should rather call point_ptr(0) once.
          * \param[in] v the vertex, in 0..nb()-1
          * \return a pointer to the coordinates of the point
          *  that correspond to the vertex
@@ -713,7 +716,7 @@ namespace GEO {
             edge_vertex_ = rhs.edge_vertex_;
         }
         
-        vector<index_t> edge_vertex_;
+        cow_vector<index_t> edge_vertex_;
         friend class Mesh;
         friend class GeogramIOHandler;
     };
@@ -815,7 +818,7 @@ namespace GEO {
         
     protected:
         bool is_simplicial_;
-        vector<index_t> facet_ptr_;
+        cow_vector<index_t> facet_ptr_;
         friend class Mesh;
         friend class GeogramIOHandler;
     };
@@ -947,8 +950,8 @@ namespace GEO {
     protected:
         MeshVertices& vertices_;
         MeshFacetsStore& facets_;
-        vector<index_t> corner_vertex_;
-        vector<index_t> corner_adjacent_facet_;
+        cow_vector<index_t> corner_vertex_;
+        cow_vector<index_t> corner_adjacent_facet_;
 
         friend class MeshFacets;
         friend class Mesh;
@@ -1583,8 +1586,8 @@ namespace GEO {
         
     protected:
         bool is_simplicial_;
-        vector<Numeric::uint8> cell_type_;
-        vector<index_t> cell_ptr_;
+        cow_vector<Numeric::uint8> cell_type_;
+        cow_vector<index_t> cell_ptr_;
 
     protected:
         friend class Mesh;
@@ -1674,7 +1677,7 @@ namespace GEO {
         
     protected:
         MeshVertices& vertices_;
-        vector<index_t> corner_vertex_;
+        cow_vector<index_t> corner_vertex_;
 
         friend class MeshCells;
         friend class Mesh;
@@ -1749,7 +1752,7 @@ namespace GEO {
     protected:
         MeshVertices& vertices_;
         MeshCellsStore& cells_;
-        vector<index_t> adjacent_cell_;
+        cow_vector<index_t> adjacent_cell_;
 
         friend class MeshCells;
         friend class Mesh;
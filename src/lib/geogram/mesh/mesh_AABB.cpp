@@ -326,6 +326,7 @@ namespace GEO {
         Mesh& M, bool reorder
     ) :
         mesh_(M) {
+        geo_memory_tag("AABB");
         if(!M.facets.are_simplices()) {
             mesh_repair(
 		M,
@@ -451,6 +452,7 @@ namespace GEO {
 /****************************************************************************/
 
     MeshCellsAABB::MeshCellsAABB(Mesh& M, bool reorder) : mesh_(M) {
+        geo_memory_tag("AABB");
         if(reorder) {
             mesh_reorder(mesh_, MESH_ORDER_MORTON);
         }
@@ -165,30 +165,39 @@ namespace GEO {
     void simple_Laplacian_smooth(Mesh& M, index_t nb_iter, bool normals_only) {
         geo_assert(M.vertices.dimension() >= 6);
         std::vector<vec3> p(M.vertices.nb());
-        std::vector<double> c(M.vertices.nb());
+        std::vector<double> c(M.vertices.nb(), 0.0);
+
+        // The edges and the number of neighbors do not change
+        // between iterations, they are gathered once.
+        std::vector<index_t> edges;
+        edges.reserve(M.facet_corners.nb());
+        for(index_t f = 0; f < M.facets.nb(); f++) {
+            index_t b = M.facets.corners_begin(f);
+            index_t e = M.facets.corners_end(f);
+            for(index_t c1 = b; c1 != e; c1++) {
+                index_t c2 = (c1 == e - 1) ? b : c1 + 1;
+                index_t v1 = M.facet_corners.vertex(c1);
+                index_t v2 = M.facet_corners.vertex(c2);
+                if(v1 < v2) {
+                    c[v1] += 1.0;
+                    c[v2] += 1.0;
+                    edges.push_back(v1);
+                    edges.push_back(v2);
+                }
+            }
+        }
 
         for(index_t k = 0; k < nb_iter; k++) {
             p.assign(M.vertices.nb(), vec3(0.0, 0.0, 0.0));
-            c.assign(M.vertices.nb(), 0);
-            for(index_t f = 0; f < M.facets.nb(); f++) {
-                index_t b = M.facets.corners_begin(f);
-                index_t e = M.facets.corners_end(f);
-                for(index_t c1 = b; c1 != e; c1++) {
-                    index_t c2 = (c1 == e - 1) ? b : c1 + 1;
-                    index_t v1 = M.facet_corners.vertex(c1);
-                    index_t v2 = M.facet_corners.vertex(c2);
-                    if(v1 < v2) {
-                        double a = 1.0;
-                        c[v1] += a;
-                        c[v2] += a;
-                        if(normals_only) {
-                            p[v1] += a * Geom::mesh_vertex_normal(M, v2);
-                            p[v2] += a * Geom::mesh_vertex_normal(M, v1);
-                        } else {
-                            p[v1] += a * Geom::mesh_vertex(M, v2);
-                            p[v2] += a * Geom::mesh_vertex(M, v1);
-                        }
-                    }
+            for(index_t i = 0; i < edges.size(); i += 2) {
+                index_t v1 = edges[i];
+                index_t v2 = edges[i + 1];
+                if(normals_only) {
+                    p[v1] += Geom::mesh_vertex_normal(M, v2);
+                    p[v2] += Geom::mesh_vertex_normal(M, v1);
+                } else {
+                    p[v1] += Geom::mesh_vertex(M, v2);
+                    p[v2] += Geom::mesh_vertex(M, v1);
                 }
             }
             for(index_t v = 0; v < M.vertices.nb(); v++) {
@@ -53,6 +53,7 @@
 #include <geogram/basic/command_line.h>
 #include <geogram/basic/argused.h>
 #include <geogram/basic/logger.h>
+#include <geogram/basic/profiler.h>
 #include <geogram/basic/geometry.h>
 #include <geogram/bibliography/bibliography.h>
 
@@ -409,6 +410,11 @@ namespace GEO {
             }
 
             bind_attributes(M, ioflags, false);
+            // Attributes are read through const references: the non-const
+            // accessors would duplicate the attributes of a copied mesh.
+            const Attribute<double>& tex_coord = tex_coord_;
+            const Attribute<double>& vertex_tex_coord = vertex_tex_coord_;
+            const Attribute<index_t>& facet_region = facet_region_;
             
             std::vector<std::string> args;
             CmdLine::get_args(args);
@@ -432,25 +438,25 @@ namespace GEO {
 	    // smaller).
 	    vector<index_t> vt_old2new;
 	    vector<index_t> vt_index;
-	    if(tex_coord_.is_bound()) {
+	    if(tex_coord.is_bound()) {
 		index_t nb_vt = Geom::colocate_by_lexico_sort(
-		    &tex_coord_[0], 2, M.facet_corners.nb(), vt_old2new, 2
+		    &tex_coord[0], 2, M.facet_corners.nb(), vt_old2new, 2
 		);
 		vt_index.assign(M.facet_corners.nb(), index_t(-1));
 		index_t cur_vt=0;
 		for(index_t c=0; c<M.facet_corners.nb(); ++c) {
 		    if(vt_old2new[c] == c) {
-			out << "vt " << tex_coord_[2*c] << " "
-			    << tex_coord_[2*c+1] << std::endl;
+			out << "vt " << tex_coord[2*c] << " "
+			    << tex_coord[2*c+1] << std::endl;
 			vt_index[c] = cur_vt;
 			++cur_vt;
 		    }
 		}
 		geo_assert(cur_vt == nb_vt);
-	    } else if(vertex_tex_coord_.is_bound()) {
+	    } else if(vertex_tex_coord.is_bound()) {
 		for(index_t v=0; v<M.vertices.nb(); ++v) {
-		    out << "vt " << vertex_tex_coord_[2*v] << " "
-			<< vertex_tex_coord_[2*v+1] << std::endl;
+		    out << "vt " << vertex_tex_coord[2*v] << " "
+			<< vertex_tex_coord[2*v+1] << std::endl;
 		}
 	    }
 	    
@@ -461,9 +467,9 @@ namespace GEO {
                         c < M.facets.corners_end(f); ++c
                     ) {
                         out << M.facet_corners.vertex(c) + 1;
-			if(tex_coord_.is_bound()) {
+			if(tex_coord.is_bound()) {
 			    out << "/" << vt_index[ vt_old2new[c] ] + 1;
-			} else if(vertex_tex_coord_.is_bound()) {
+			} else if(vertex_tex_coord.is_bound()) {
 			    out << "/" << M.facet_corners.vertex(c) + 1;
 			}
 			out << " ";
@@ -471,13 +477,13 @@ namespace GEO {
                     out << std::endl;
                 }
                 if(
-                    facet_region_.is_bound()
+                    facet_region.is_bound()
                 ) {
                     out << "# attribute chart facet integer" << std::endl;
                     for(index_t f = 0; f < M.facets.nb(); ++f) {
                         out << "# attrs f "
                             << f + 1 << " "
-                            << facet_region_[f] << std::endl;
+                            << facet_region[f] << std::endl;
                     }
                 }
             }
@@ -884,13 +890,16 @@ namespace GEO {
                 return false;
             }
             bind_attributes(M, ioflags, false);
+            const Attribute<index_t>& vertex_region = vertex_region_;
+            const Attribute<index_t>& facet_region = facet_region_;
+            const Attribute<index_t>& cell_region = cell_region_;
 
             // Save vertices
             GmfSetKwd(mesh_file_handle, GmfVertices, M.vertices.nb());
             for(index_t v = 0; v < M.vertices.nb(); ++v) {
                 double xyz[3];
                 index_t ref =
-                    vertex_region_.is_bound() ? vertex_region_[v] : 0;
+                    vertex_region.is_bound() ? vertex_region[v] : 0;
                 get_mesh_point(M, v, xyz, 3);
                 GmfSetLin(
                     mesh_file_handle, GmfVertices, xyz[0], xyz[1], xyz[2], ref
@@ -922,8 +931,8 @@ namespace GEO {
                     for(index_t f = 0; f < M.facets.nb(); ++f) {
                         if(M.facets.nb_vertices(f) == 3) {
                             index_t ref =
-                                facet_region_.is_bound() ?
-                                facet_region_[f] : 0 ;
+                                facet_region.is_bound() ?
+                                facet_region[f] : 0 ;
                             GmfSetLin(
                                 mesh_file_handle, GmfTriangles,
                                 int(M.facets.vertex(f,0)+1),
@@ -940,8 +949,8 @@ namespace GEO {
                     for(index_t f = 0; f < M.facets.nb(); ++f) {
                         if(M.facets.nb_vertices(f) == 4) {
                             index_t ref =
-                                facet_region_.is_bound() ?
-                                facet_region_[f] : 0 ;
+                                facet_region.is_bound() ?
+                                facet_region[f] : 0 ;
                             GmfSetLin(
                                 mesh_file_handle, GmfQuadrilaterals,
                                 int(M.facets.vertex(f,0)+1),
@@ -1006,7 +1015,7 @@ namespace GEO {
                     for(index_t c=0; c<M.cells.nb(); ++c) {
                         if(M.cells.type(c) == MESH_TET) {
                             index_t ref =
-                                cell_region_.is_bound() ? cell_region_[c] : 0;
+                                cell_region.is_bound() ? cell_region[c] : 0;
                             GmfSetLin(
                                 mesh_file_handle, GmfTetrahedra,
                                 int(M.cells.vertex(c,0) + 1),
@@ -1024,7 +1033,7 @@ namespace GEO {
                     for(index_t c=0; c<M.cells.nb(); ++c) {
                         if(M.cells.type(c) == MESH_HEX) {
                             index_t ref =
-                                cell_region_.is_bound() ? cell_region_[c] : 0;
+                                cell_region.is_bound() ? cell_region[c] : 0;
 
                             // Swapping vertices 1<->0 and 4<->5 to
                             // account for differences in the indexing
@@ -1052,7 +1061,7 @@ namespace GEO {
                     for(index_t c=0; c<M.cells.nb(); ++c) {
                         if(M.cells.type(c) == MESH_PRISM) {
                             index_t ref =
-                                cell_region_.is_bound() ? cell_region_[c] : 0;
+                                cell_region.is_bound() ? cell_region[c] : 0;
                             GmfSetLin(
                                 mesh_file_handle, GmfPrisms,
                                 int(M.cells.vertex(c,0) + 1),
@@ -1072,7 +1081,7 @@ namespace GEO {
                     for(index_t c=0; c<M.cells.nb(); ++c) {
                         if(M.cells.type(c) == MESH_PYRAMID) {
                             index_t ref =
-                                cell_region_.is_bound() ? cell_region_[c] : 0;
+                                cell_region.is_bound() ? cell_region[c] : 0;
                             GmfSetLin(
                                 mesh_file_handle, GmfPyramids,
                                 int(M.cells.vertex(c,0) + 1),
@@ -2289,6 +2298,7 @@ namespace GEO {
         ) {
 
             bind_attributes(M, ioflags, false);
+            const Attribute<index_t>& facet_region = facet_region_;
 
             BinaryOutputStream out(filename, BinaryStream::GEO_LITTLE_ENDIAN);
             char header[80];
@@ -2317,8 +2327,8 @@ namespace GEO {
                     );
                     
                     Numeric::uint16 attribute = Numeric::uint16(
-                        facet_region_.is_bound() ?
-                        facet_region_[f] : 0
+                        facet_region.is_bound() ?
+                        facet_region[f] : 0
                     );
                     
                     write_stl_vector(out, normalize(cross(p2-p1,p3-p1)));
@@ -2435,11 +2445,12 @@ namespace GEO {
                 return false;
             }
 
-            Attribute<double> normal;
-            normal.bind_if_is_defined(M.vertices.attributes(), "normal");
-            if(normal.is_bound() && normal.dimension() != 3) {
-                normal.unbind();
+            Attribute<double> normal_attr;
+            normal_attr.bind_if_is_defined(M.vertices.attributes(), "normal");
+            if(normal_attr.is_bound() && normal_attr.dimension() != 3) {
+                normal_attr.unbind();
             }
+            const Attribute<double>& normal = normal_attr;
             
             out << M.vertices.nb() << std::endl;
             
@@ -2899,6 +2910,12 @@ namespace GEO {
     
     /************************************************************************/
 
+    /**
+     * \brief Suffix of the names of the attribute sets that store
+     *  the bounds of the quantized attributes in geogram files.
+     */
+    static const char* const QUANTIZATION_SUFFIX = "::quantization";
+
     /**
      * \brief IO handler for the geogram native file format.
      */
@@ -3284,6 +3301,10 @@ namespace GEO {
                 in.current_attribute().name;
             const std::string& set_name =
                 in.current_attribute_set().name;
+            if(String::string_ends_with(set_name, QUANTIZATION_SUFFIX)) {
+                read_quantization_bounds(in, M, ioflags);
+                return;
+            }
             if(set_name == "GEO::Mesh::vertices") {
                 if(ioflags.has_element(MESH_VERTICES)) {
                     //   Vertex geometry is a special attribute, already
@@ -3336,6 +3357,90 @@ namespace GEO {
             } 
         }
 
+        /**
+         * \brief Reads the bounds of a quantized attribute from a 
+         *  geogram file and applies them to the attribute.
+         * \details The bounds are stored in an additional attribute
+         *  set, with the same name as the attribute set of the quantized
+         *  attribute followed by QUANTIZATION_SUFFIX, and two items.
+         *  It is written after the quantized attribute, thus the 
+         *  attribute is already loaded.
+         * \param[in] in a reference to the InputGeoFile
+         * \param[in] M a reference to the Mesh
+         * \param[in] ioflags the MeshIOFlags that specify which
+         *  attributes and mesh elements should be read
+         */
+        void read_quantization_bounds(
+            InputGeoFile& in,
+            Mesh& M,
+            const MeshIOFlags& ioflags
+        ) {
+            const std::string& set_name = in.current_attribute_set().name;
+            std::string base_set_name = set_name.substr(
+                0, set_name.length() - strlen(QUANTIZATION_SUFFIX)
+            );
+            AttributesManager* attributes = nil;
+            if(
+                base_set_name == "GEO::Mesh::vertices" &&
+                ioflags.has_element(MESH_VERTICES)
+            ) {
+                attributes = &M.vertices.attributes();
+            } else if(
+                base_set_name == "GEO::Mesh::edges" &&
+                ioflags.has_element(MESH_EDGES)
+            ) {
+                attributes = &M.edges.attributes();
+            } else if(
+                base_set_name == "GEO::Mesh::facets" &&
+                ioflags.has_element(MESH_FACETS)
+            ) {
+                attributes = &M.facets.attributes();
+            } else if(
+                base_set_name == "GEO::Mesh::facet_corners" &&
+                ioflags.has_element(MESH_FACETS)
+            ) {
+                attributes = &M.facet_corners.attributes();
+            } else if(
+                base_set_name == "GEO::Mesh::cells" &&
+                ioflags.has_element(MESH_CELLS)
+            ) {
+                attributes = &M.cells.attributes();
+            } else if(
+                base_set_name == "GEO::Mesh::cell_corners" &&
+                ioflags.has_element(MESH_CELLS)
+            ) {
+                attributes = &M.cell_corners.attributes();
+            } else if(
+                base_set_name == "GEO::Mesh::cell_facets" &&
+                ioflags.has_element(MESH_CELLS)
+            ) {
+                attributes = &M.cell_facets.attributes();
+            }
+            if(
+                attributes == nil ||
+                in.current_attribute_set().nb_items != 2 ||
+                in.current_attribute().element_type != "double" ||
+                in.current_attribute().dimension != 1
+            ) {
+                return;
+            }
+            double bounds[2];
+            in.read_attribute(bounds);
+            AttributeStore* store = attributes->find_attribute_store(
+                in.current_attribute().name
+            );
+            if(
+                store != nil &&
+                store->element_typeid_name() ==
+                typeid(QuantizedAttributeStore).name() &&
+                bounds[1] >= bounds[0]
+            ) {
+                static_cast<QuantizedAttributeStore*>(store)->set_bounds(
+                    bounds[0], bounds[1]
+                );
+            }
+        }
+
         /**
          * \brief Reads an internal attribute from a geogram file and
          *  stores it in a mesh.
@@ -3448,17 +3553,19 @@ namespace GEO {
          * \param[out] out a reference to the OutputGeoFile
          * \param[in] attribute_set_name the name to be used for the attribute
          *  set in the geogram file
-         * \param[in] attributes a reference to the AttributesManager
+         * \param[in] attributes a const reference to the AttributesManager
          */
         void save_attributes(
             OutputGeoFile& out,
             const std::string& attribute_set_name,
-            AttributesManager& attributes
+            const AttributesManager& attributes
         ) {
             vector<std::string> attribute_names;
+            vector<std::string> quantized_attribute_names;
+            vector<double> quantization_bounds;
             attributes.list_attribute_names(attribute_names);
             for(index_t i=0; i<attribute_names.size(); ++i) {
-                AttributeStore* store = attributes.find_attribute_store(
+                const AttributeStore* store = attributes.find_attribute_store(
                     attribute_names[i]
                 );
                 if(
@@ -3479,6 +3586,19 @@ namespace GEO {
                         store->dimension(),
                         store->data()
                     );
+
+                    if(
+                        store->element_typeid_name() ==
+                        typeid(QuantizedAttributeStore).name()
+                    ) {
+                        const QuantizedAttributeStore* qstore =
+                            static_cast<const QuantizedAttributeStore*>(store);
+                        quantized_attribute_names.push_back(
+                            attribute_names[i]
+                        );
+                        quantization_bounds.push_back(qstore->min());
+                        quantization_bounds.push_back(qstore->max());
+                    }
                 } else {
                     Logger::warn("I/O")
                         << "Skipping attribute: "
@@ -3493,6 +3613,24 @@ namespace GEO {
                         << std::endl;
                 }
             }
+
+            // The bounds of the quantized attributes are stored in an
+            // additional attribute set (ignored by older versions).
+            if(quantized_attribute_names.size() != 0) {
+                std::string quantization_set_name = 
+                    attribute_set_name + QUANTIZATION_SUFFIX;
+                out.write_attribute_set(quantization_set_name, 2);
+                for(index_t i=0; i<quantized_attribute_names.size(); ++i) {
+                    out.write_attribute(
+                        quantization_set_name,
+                        quantized_attribute_names[i],
+                        "double",
+                        sizeof(double),
+                        1,
+                        &quantization_bounds[2*i]
+                    );
+                }
+            }
         }
     };
 
@@ -3626,6 +3764,7 @@ namespace GEO {
         const std::string& filename, Mesh& M,
         const MeshIOFlags& ioflags
     ) {
+        geo_profile_scope("mesh_load");
         Logger::out("I/O")
             << "Loading file " << filename << "..."
             << std::endl;
@@ -3687,6 +3826,7 @@ namespace GEO {
         const Mesh& M, const std::string& filename,
         const MeshIOFlags& ioflags
     ) {
+        geo_profile_scope("mesh_save");
         Logger::out("I/O")
             << "Saving file " << filename << "..."
             << std::endl;
@@ -55,6 +55,7 @@
 #include <geogram/basic/command_line.h>
 #include <geogram/basic/stopwatch.h>
 #include <geogram/basic/progress.h>
+#include <geogram/basic/profiler.h>
 #include <geogram/bibliography/bibliography.h>
 
 /****************************************************************************/
@@ -69,6 +70,7 @@ namespace GEO {
         index_t nb_Newton_iter,
         index_t Newton_m
     ) {
+        geo_profile_scope("remesh_smooth");
 
         geo_cite("DBLP:journals/cgf/YanLLSW09");
         geo_cite("DBLP:conf/imr/LevyB12");
@@ -48,6 +48,7 @@
 #include <geogram/mesh/mesh_repair.h>
 #include <geogram/mesh/index.h>
 #include <geogram/basic/permutation.h>
+#include <geogram/basic/algorithm.h>
 #include <geogram/basic/process.h>
 #include <geogram/basic/logger.h>
 #include <geogram/bibliography/bibliography.h>
@@ -1182,6 +1183,157 @@ namespace {
             levels->push_back(index_t(e - sorted_indices.begin()));
         }
     }
+
+    /**
+     * \brief Number of vertices above which mesh_reorder() sorts the
+     *  vertices with SpatialKeySort.
+     */
+    const index_t SPATIAL_KEY_SORT_THRESHOLD = 1000000;
+
+    /**
+     * \brief Sorts 3d points along a space-filling curve, using integer
+     *  keys and a radix sort.
+     * \details The bounding box of the points is computed in parallel,
+     *  then the points are snapped to a regular grid of
+     *  2^SPATIAL_KEY_BITS cells along each axis, then the index of the
+     *  cell along the curve is computed for each point, in parallel,
+     *  and the points are sorted with radix_sort(). The cost is linear
+     *  in the number of points.
+     */
+    class SpatialKeySort {
+    public:
+        /**
+         * \brief SpatialKeySort constructor.
+         * \param[in] nb_vertices number of vertices to sort
+         * \param[in] vertices pointer to the coordinates of the vertices
+         * \param[in] stride number of doubles between two consecutive
+         *  vertices
+         * \param[in] hilbert if true, sort along the Hilbert curve,
+         *  else along the Morton curve
+         */
+        SpatialKeySort(
+            index_t nb_vertices, const double* vertices, index_t stride,
+            bool hilbert
+        ) :
+            nb_vertices_(nb_vertices),
+            vertices_(vertices),
+            stride_(stride),
+            hilbert_(hilbert) {
+            nb_chunks_ = (nb_vertices_ + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        }
+
+        /**
+         * \brief Sorts the vertices.
+         * \param[out] sorted_indices the vertex indices, sorted along
+         *  the curve on exit
+         */
+        void sort(vector<index_t>& sorted_indices) {
+            sorted_indices.resize(nb_vertices_);
+            if(nb_vertices_ == 0) {
+                return;
+            }
+            chunk_min_.resize(nb_chunks_ * 3);
+            chunk_max_.resize(nb_chunks_ * 3);
+            parallel_for(
+                parallel_for_member_callback(
+                    this, &SpatialKeySort::compute_bbox
+                ),
+                0, nb_chunks_
+            );
+            double max_extent = 0.0;
+            for(coord_index_t c = 0; c < 3; ++c) {
+                double m = chunk_min_[c];
+                double M = chunk_max_[c];
+                for(index_t i = 1; i < nb_chunks_; ++i) {
+                    m = geo_min(m, chunk_min_[3 * i + c]);
+                    M = geo_max(M, chunk_max_[3 * i + c]);
+                }
+                origin_[c] = m;
+                max_extent = geo_max(max_extent, M - m);
+            }
+            const double nb_cells = double(1u << SPATIAL_KEY_BITS);
+            scale_ = (max_extent > 0.0) ? (nb_cells / max_extent) : 0.0;
+
+            keys_.resize(nb_vertices_);
+            indices_ = &sorted_indices;
+            parallel_for(
+                parallel_for_member_callback(
+                    this, &SpatialKeySort::compute_keys
+                ),
+                0, nb_chunks_
+            );
+            radix_sort(keys_, sorted_indices);
+        }
+
+    protected:
+        /**
+         * \brief Computes the bounding box of a chunk of vertices.
+         * \details Used by parallel_for()
+         * \param[in] chunk index of the chunk
+         */
+        void compute_bbox(index_t chunk) {
+            index_t b = chunk * CHUNK_SIZE;
+            index_t e = geo_min(b + CHUNK_SIZE, nb_vertices_);
+            double* m = &chunk_min_[3 * chunk];
+            double* M = &chunk_max_[3 * chunk];
+            const double* p = vertices_ + b * stride_;
+            for(coord_index_t c = 0; c < 3; ++c) {
+                m[c] = p[c];
+                M[c] = p[c];
+            }
+            for(index_t i = b + 1; i < e; ++i) {
+                p = vertices_ + i * stride_;
+                for(coord_index_t c = 0; c < 3; ++c) {
+                    m[c] = geo_min(m[c], p[c]);
+                    M[c] = geo_max(M[c], p[c]);
+                }
+            }
+        }
+
+        /**
+         * \brief Computes the keys of a chunk of vertices.
+         * \details Used by parallel_for()
+         * \param[in] chunk index of the chunk
+         */
+        void compute_keys(index_t chunk) {
+            index_t b = chunk * CHUNK_SIZE;
+            index_t e = geo_min(b + CHUNK_SIZE, nb_vertices_);
+            const Numeric::uint32 max_coord = (1u << SPATIAL_KEY_BITS) - 1;
+            Numeric::uint32 coord[3];
+            for(index_t i = b; i < e; ++i) {
+                const double* p = vertices_ + i * stride_;
+                for(coord_index_t c = 0; c < 3; ++c) {
+                    coord[c] = geo_min(
+                        Numeric::uint32((p[c] - origin_[c]) * scale_),
+                        max_coord
+                    );
+                }
+                keys_[i] = hilbert_ ?
+                    Hilbert_key_3d(coord[0], coord[1], coord[2]) :
+                    Morton_key_3d(coord[0], coord[1], coord[2]) ;
+                (*indices_)[i] = i;
+            }
+        }
+
+    private:
+        /**
+         * \brief Number of vertices processed by each iteration of the
+         *  parallel loops.
+         */
+        static const index_t CHUNK_SIZE = 16384;
+
+        index_t nb_vertices_;
+        const double* vertices_;
+        index_t stride_;
+        bool hilbert_;
+        index_t nb_chunks_;
+        vector<double> chunk_min_;
+        vector<double> chunk_max_;
+        double origin_[3];
+        double scale_;
+        vector<Numeric::uint64> keys_;
+        vector<index_t>* indices_;
+    };
 }
 
 /****************************************************************************/
@@ -1197,13 +1349,24 @@ namespace GEO {
         // Step 1: reorder vertices
         {
             vector<index_t> sorted_indices;
-            switch(order) {
-                case MESH_ORDER_HILBERT:
-                    hilbert_vsort_3d(M, sorted_indices);
-                    break;
-                case MESH_ORDER_MORTON:
-                    morton_vsort_3d(M, sorted_indices);
-                    break;
+            if(
+                M.vertices.nb() >= SPATIAL_KEY_SORT_THRESHOLD &&
+                !M.vertices.single_precision()
+            ) {
+                SpatialKeySort sorter(
+                    M.vertices.nb(), M.vertices.point_ptr(0),
+                    M.vertices.dimension(), order == MESH_ORDER_HILBERT
+                );
+                sorter.sort(sorted_indices);
+            } else {
+                switch(order) {
+                    case MESH_ORDER_HILBERT:
+                        hilbert_vsort_3d(M, sorted_indices);
+                        break;
+                    case MESH_ORDER_MORTON:
+                        morton_vsort_3d(M, sorted_indices);
+                        break;
+                }
             }
             M.vertices.permute_elements(sorted_indices);
         }
@@ -1239,6 +1402,27 @@ namespace GEO {
 
 #endif
 
+    void compute_Hilbert_order(
+        index_t nb_vertices, const double* vertices,
+        vector<index_t>& sorted_indices,
+        index_t stride
+    ) {
+        SpatialKeySort sorter(
+            nb_vertices, vertices, stride, true
+        );
+        sorter.sort(sorted_indices);
+    }
+
+    void compute_Morton_order(
+        index_t nb_vertices, const double* vertices,
+        vector<index_t>& sorted_indices,
+        index_t stride
+    ) {
+        SpatialKeySort sorter(
+            nb_vertices, vertices, stride, false
+        );
+        sorter.sort(sorted_indices);
+    }
 
     void compute_Hilbert_order(
         index_t total_nb_vertices, const double* vertices,
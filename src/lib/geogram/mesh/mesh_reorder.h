@@ -92,10 +92,12 @@ namespace GEO {
     
     /**
      * \brief Computes the Hilbert order for a set of 3D points.
-     * \details The implementation is inspired by:
-     *  - Christophe Delage and Olivier Devillers. Spatial Sorting. 
-     *   In CGAL User and Reference Manual. CGAL Editorial Board, 
-     *   3.9 edition, 2011
+     * \details The points are snapped to a regular grid, then sorted
+     *  by the index of their cell along the Hilbert curve (see
+     *  Hilbert_key_3d()) with a parallel radix sort. The cost is linear
+     *  in the number of points, which makes it faster than the
+     *  recursive splitting used by the other variant for large
+     *  pointsets. Points in the same cell keep their initial order.
      * \param[in] nb_vertices number of vertices to sort.
      * \param[in] vertices pointer to the coordinates of the vertices
      * \param[out] sorted_indices a vector of vertex indices, sorted
@@ -108,6 +110,23 @@ namespace GEO {
         index_t stride = 3
     );
 
+    /**
+     * \brief Computes the Morton order for a set of 3D points.
+     * \details Same as compute_Hilbert_order(index_t, const double*,
+     *  vector<index_t>&, index_t) with the Morton (Z-order) curve, see
+     *  Morton_key_3d().
+     * \param[in] nb_vertices number of vertices to sort.
+     * \param[in] vertices pointer to the coordinates of the vertices
+     * \param[out] sorted_indices a vector of vertex indices, sorted
+     *  spatially on exit
+     * \param[in] stride number of doubles between two consecutive vertices
+     */
+    void GEOGRAM_API compute_Morton_order(
+        index_t nb_vertices, const double* vertices,
+        vector<index_t>& sorted_indices,
+        index_t stride = 3
+    );
+
 
     /**
      * \brief Computes the Hilbert order for a set of 3D points.
@@ -55,6 +55,7 @@
 #include <geogram/basic/command_line.h>
 #include <geogram/basic/argused.h>
 #include <geogram/basic/algorithm.h>
+#include <geogram/basic/profiler.h>
 #include <stack>
 #include <queue>
 
@@ -1096,6 +1097,7 @@ namespace GEO {
     void mesh_repair(
         Mesh& M, MeshRepairMode mode, double colocate_epsilon
     ) {
+        geo_profile_scope("mesh_repair");
         index_t nb_vertices_in = M.vertices.nb();
         index_t nb_facets_in = M.facets.nb();
         
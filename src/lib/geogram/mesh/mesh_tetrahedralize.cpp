@@ -53,12 +53,14 @@
 #include <geogram/delaunay/delaunay_tetgen.h>
 #include <geogram/basic/logger.h>
 #include <geogram/basic/command_line.h>
+#include <geogram/basic/profiler.h>
 
 namespace GEO {
 
     bool mesh_tetrahedralize(
         Mesh& M, bool preprocess, bool refine, double quality, bool keep_regions
     ) {
+        geo_profile_scope("mesh_tetrahedralize");
         if(!DelaunayFactory::has_creator("tetgen")) {
             Logger::err("TetMeshing")
                 << "Not supported in this version" << std::endl;
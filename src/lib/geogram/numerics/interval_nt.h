@@ -0,0 +1,209 @@
+/*
+ *  Copyright (c) 2012-2014, Bruno Levy
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *  this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *  this list of conditions and the following disclaimer in the documentation
+ *  and/or other materials provided with the distribution.
+ *  * Neither the name of the ALICE Project-Team nor the names of its
+ *  contributors may be used to endorse or promote products derived from this
+ *  software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     Bruno.Levy@inria.fr
+ *     http://www.loria.fr/~levy
+ *
+ *     ALICE Project
+ *     LORIA, INRIA Lorraine, 
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX 
+ *     FRANCE
+ *
+ */
+
+#ifndef GEOGRAM_NUMERICS_INTERVAL_NT
+#define GEOGRAM_NUMERICS_INTERVAL_NT
+
+#include <geogram/basic/common.h>
+#include <geogram/basic/numeric.h>
+#include <math.h>
+
+/**
+ * \file geogram/numerics/interval_nt.h
+ * \brief Interval arithmetics, used to filter exact predicates
+ */
+
+namespace GEO {
+
+    /**
+     * \brief Interval_nt (interval Number Type) encloses the exact 
+     *  value of a polynom evaluated with floating point numbers.
+     * \details Each operation computes the bounds with the current 
+     *  (round-to-nearest) rounding mode and then widens them by one ulp, 
+     *  so that no change of the rounding mode of the FPU is needed. Bounds 
+     *  that overflow become infinite, and then the sign is undetermined.
+     *  Interval_nt is used as an intermediate stage between the 
+     *  semi-static filters and exact expansion arithmetics: it is much 
+     *  cheaper than expansions, and its dynamic bounds are tighter than 
+     *  the static ones.
+     */
+    class interval_nt {
+    public:
+        /**
+         * \brief Constructs a new interval_nt from a double.
+         * \details The interval is reduced to a single point, since the
+         *  double is exact.
+         * \param[in] x the value
+         */
+        explicit interval_nt(double x = 0.0) :
+            lb_(x),
+            ub_(x) {
+        }
+
+        /**
+         * \brief Constructs a new interval_nt from its bounds.
+         * \param[in] lb , ub the lower and upper bounds
+         * \pre lb <= ub
+         */
+        interval_nt(double lb, double ub) :
+            lb_(lb),
+            ub_(ub) {
+        }
+
+        /**
+         * \brief Gets the lower bound.
+         * \return the lower bound of this interval
+         */
+        double lower() const {
+            return lb_;
+        }
+
+        /**
+         * \brief Gets the upper bound.
+         * \return the upper bound of this interval
+         */
+        double upper() const {
+            return ub_;
+        }
+
+        /**
+         * \brief Gets the sign of the enclosed value.
+         * \retval POSITIVE if all the values in the interval are positive
+         * \retval NEGATIVE if all the values in the interval are negative
+         * \retval ZERO if the interval contains zero, then the sign 
+         *  cannot be determined (or the interval is invalid)
+         */
+        Sign sign() const {
+            if(lb_ > 0.0 && ub_ <= std::numeric_limits<double>::max()) {
+                return POSITIVE;
+            }
+            if(ub_ < 0.0 && lb_ >= -std::numeric_limits<double>::max()) {
+                return NEGATIVE;
+            }
+            return ZERO;
+        }
+
+        /**
+         * \brief Computes the opposite of this interval.
+         * \return the opposite of this interval
+         */
+        interval_nt operator- () const {
+            return interval_nt(-ub_, -lb_);
+        }
+
+        /**
+         * \brief Computes the sum of this interval and another one.
+         * \param[in] rhs the other interval
+         * \return an interval that encloses the sum
+         */
+        interval_nt operator+ (const interval_nt& rhs) const {
+            return widen(lb_ + rhs.lb_, ub_ + rhs.ub_);
+        }
+
+        /**
+         * \brief Computes the difference between this interval and 
+         *  another one.
+         * \param[in] rhs the other interval
+         * \return an interval that encloses the difference
+         */
+        interval_nt operator- (const interval_nt& rhs) const {
+            return widen(lb_ - rhs.ub_, ub_ - rhs.lb_);
+        }
+
+        /**
+         * \brief Computes the product of this interval and another one.
+         * \param[in] rhs the other interval
+         * \return an interval that encloses the product
+         */
+        interval_nt operator* (const interval_nt& rhs) const {
+            double p1 = lb_ * rhs.lb_;
+            double p2 = lb_ * rhs.ub_;
+            double p3 = ub_ * rhs.lb_;
+            double p4 = ub_ * rhs.ub_;
+            return widen(
+                geo_min(geo_min(p1,p2),geo_min(p3,p4)),
+                geo_max(geo_max(p1,p2),geo_max(p3,p4))
+            );
+        }
+
+        /**
+         * \brief Computes the square of this interval.
+         * \details The result is tighter than the product of this 
+         *  interval with itself, since it is always positive.
+         * \return an interval that encloses the square
+         */
+        interval_nt sqr() const {
+            if(lb_ >= 0.0) {
+                return widen(lb_*lb_, ub_*ub_);
+            }
+            if(ub_ <= 0.0) {
+                return widen(ub_*ub_, lb_*lb_);
+            }
+            return widen(0.0, geo_max(lb_*lb_, ub_*ub_));
+        }
+
+    protected:
+        /**
+         * \brief Creates an interval from bounds computed in 
+         *  round-to-nearest mode.
+         * \details Since the error of a rounded operation is at most 
+         *  half an ulp, moving each bound to the next floating point 
+         *  number gives an interval that encloses the exact result.
+         * \param[in] lb , ub the lower and upper bounds, rounded to nearest
+         * \return the widened interval
+         */
+        static interval_nt widen(double lb, double ub) {
+            return interval_nt(
+                ::nextafter(lb, -HUGE_VAL), ::nextafter(ub, HUGE_VAL)
+            );
+        }
+
+    private:
+        double lb_;
+        double ub_;
+    };
+}
+
+#endif
@@ -54,6 +54,7 @@
 
 #include <geogram/numerics/predicates.h>
 #include <geogram/numerics/multi_precision.h>
+#include <geogram/numerics/interval_nt.h>
 #include <geogram/basic/assert.h>
 #include <geogram/basic/logger.h>
 #include <geogram/basic/command_line.h>
@@ -184,7 +185,127 @@ namespace {
     }
 
 
-    using namespace GEO;
+    /**
+     * \brief Number of inputs for which batched filters are evaluated 
+     *  together.
+     * \details Eight doubles fill an AVX-512 register, or two AVX2 
+     *  registers.
+     */
+    const index_t BATCH_SIZE = 8;
+
+    /**
+     * \brief Branch-free maximum, that compilers can vectorize.
+     */
+    inline double batch_max(double x, double y) {
+        return (x < y) ? y : x;
+    }
+
+    /**
+     * \brief Branch-free minimum, that compilers can vectorize.
+     */
+    inline double batch_min(double x, double y) {
+        return (y < x) ? y : x;
+    }
+
+    /**
+     * \brief Batched version of the orient_3d_filter().
+     * \details The inputs are the differences between the coordinates of
+     *  the last three vertices and the first one, in structure-of-arrays 
+     *  layout. The bounds and the error constant are the ones of the 
+     *  filter generated from orient3d.pck, so the certified results are 
+     *  the same.
+     * \param[in] n number of tetrahedra, at most BATCH_SIZE
+     * \param[out] result +1, -1 or FPG_UNCERTAIN_VALUE for each tetrahedron
+     */
+    inline void orient_3d_filter_batch(
+        index_t n,
+        const double* a11, const double* a12, const double* a13,
+        const double* a21, const double* a22, const double* a23,
+        const double* a31, const double* a32, const double* a33,
+        int* result
+    ) {
+        for(index_t l=0; l<n; ++l) {
+            double Delta = (
+                (a11[l] * ((a22[l] * a33[l]) - (a23[l] * a32[l]))) -
+                (a21[l] * ((a12[l] * a33[l]) - (a13[l] * a32[l])))
+            ) + (a31[l] * ((a12[l] * a23[l]) - (a13[l] * a22[l])));
+            double max1 = batch_max(
+                batch_max(::fabs(a11[l]), ::fabs(a21[l])), ::fabs(a31[l])
+            );
+            double max2 = batch_max(
+                batch_max(::fabs(a12[l]), ::fabs(a13[l])),
+                batch_max(::fabs(a22[l]), ::fabs(a23[l]))
+            );
+            double max3 = batch_max(
+                batch_max(::fabs(a22[l]), ::fabs(a23[l])),
+                batch_max(::fabs(a32[l]), ::fabs(a33[l]))
+            );
+            double lower_bound = batch_min(batch_min(max1, max2), max3);
+            double upper_bound = batch_max(batch_max(max1, max2), max3);
+            double eps = 5.11071278299732992696e-15 * ((max2 * max3) * max1);
+            int sign = int(Delta > eps) - int(Delta < -eps);
+            bool in_range = 
+                (lower_bound >= 1.63288018496748314939e-98) &&
+                (upper_bound <= 5.59936185544450928309e+101);
+            result[l] = in_range ? sign : FPG_UNCERTAIN_VALUE;
+        }
+    }
+
+    /**
+     * \brief Batched version of in_sphere_3d_filter_optim().
+     * \details The inputs are the differences between the coordinates of
+     *  the vertices of the tetrahedra and the tested points, in 
+     *  structure-of-arrays layout. 
+     * \param[in] n number of inputs, at most BATCH_SIZE
+     * \param[out] result +1, -1 or FPG_UNCERTAIN_VALUE for each input
+     */
+    inline void in_sphere_3d_filter_batch(
+        index_t n,
+        const double* ptx, const double* pty, const double* ptz,
+        const double* qtx, const double* qty, const double* qtz,
+        const double* rtx, const double* rty, const double* rtz,
+        const double* stx, const double* sty, const double* stz,
+        int* result
+    ) {
+        for(index_t l=0; l<n; ++l) {
+            double pt2 = 
+                geo_sqr(ptx[l]) + geo_sqr(pty[l]) + geo_sqr(ptz[l]);
+            double qt2 = 
+                geo_sqr(qtx[l]) + geo_sqr(qty[l]) + geo_sqr(qtz[l]);
+            double rt2 = 
+                geo_sqr(rtx[l]) + geo_sqr(rty[l]) + geo_sqr(rtz[l]);
+            double st2 = 
+                geo_sqr(stx[l]) + geo_sqr(sty[l]) + geo_sqr(stz[l]);
+            double maxx = batch_max(
+                batch_max(::fabs(ptx[l]), ::fabs(qtx[l])),
+                batch_max(::fabs(rtx[l]), ::fabs(stx[l]))
+            );
+            double maxy = batch_max(
+                batch_max(::fabs(pty[l]), ::fabs(qty[l])),
+                batch_max(::fabs(rty[l]), ::fabs(sty[l]))
+            );
+            double maxz = batch_max(
+                batch_max(::fabs(ptz[l]), ::fabs(qtz[l])),
+                batch_max(::fabs(rtz[l]), ::fabs(stz[l]))
+            );
+            double eps = 1.2466136531027298e-13 * maxx * maxy * maxz;
+            double lower_bound = batch_min(batch_min(maxx, maxy), maxz);
+            double upper_bound = batch_max(batch_max(maxx, maxy), maxz);
+            double det = det4x4(
+                ptx[l],pty[l],ptz[l],pt2,
+                rtx[l],rty[l],rtz[l],rt2,
+                qtx[l],qty[l],qtz[l],qt2,
+                stx[l],sty[l],stz[l],st2
+            );
+            eps *= (upper_bound * upper_bound);
+            // Note: inverted as compared to CGAL, see 
+            // in_sphere_3d_filter_optim()
+            int sign = int(det < -eps) - int(det > eps);
+            bool in_range = 
+                (lower_bound >= 1e-58) && (upper_bound < 1e61);
+            result[l] = in_range ? sign : FPG_UNCERTAIN_VALUE;
+        }
+    }
 
     index_t cnt_side1_total = 0;
     index_t cnt_side1_exact = 0;
@@ -214,6 +335,9 @@ namespace {
     
     index_t cnt_side4_total = 0;
     index_t cnt_side4_exact = 0;
+    index_t cnt_side4_batch = 0;
+    index_t cnt_side4_interval = 0;
+    index_t cnt_side4_interval_ok = 0;
     index_t cnt_side4_SOS = 0;
     index_t len_side4_num = 0;
     index_t len_side4_denom = 0;
@@ -225,6 +349,9 @@ namespace {
 
     index_t cnt_orient3d_total = 0;
     index_t cnt_orient3d_exact = 0;
+    index_t cnt_orient3d_batch = 0;
+    index_t cnt_orient3d_interval = 0;
+    index_t cnt_orient3d_interval_ok = 0;
     index_t len_orient3d = 0;
 
     index_t cnt_orient3dh_total = 0;
@@ -1528,6 +1655,115 @@ namespace {
 	return Delta.sign();
     }
     
+    // ====================== interval arithmetics =======================
+
+    /**
+     * \brief Interval arithmetics stage of orient_3d(), used when 
+     *  the semi-static filter fails.
+     * \retval POSITIVE, NEGATIVE if intervals could determine the sign
+     * \retval ZERO if exact arithmetics is needed
+     */
+    Sign orient_3d_interval(
+        const double* p0, const double* p1,
+        const double* p2, const double* p3
+    ) {
+        cnt_orient3d_interval++;
+        
+        interval_nt a11 = interval_nt(p1[0]) - interval_nt(p0[0]);
+        interval_nt a12 = interval_nt(p1[1]) - interval_nt(p0[1]);
+        interval_nt a13 = interval_nt(p1[2]) - interval_nt(p0[2]);
+
+        interval_nt a21 = interval_nt(p2[0]) - interval_nt(p0[0]);
+        interval_nt a22 = interval_nt(p2[1]) - interval_nt(p0[1]);
+        interval_nt a23 = interval_nt(p2[2]) - interval_nt(p0[2]);
+
+        interval_nt a31 = interval_nt(p3[0]) - interval_nt(p0[0]);
+        interval_nt a32 = interval_nt(p3[1]) - interval_nt(p0[1]);
+        interval_nt a33 = interval_nt(p3[2]) - interval_nt(p0[2]);
+
+        interval_nt Delta = 
+            a11 * (a22*a33 - a23*a32) -
+            a21 * (a12*a33 - a13*a32) +
+            a31 * (a12*a23 - a13*a22);
+
+        Sign result = Delta.sign();
+        if(result != ZERO) {
+            cnt_orient3d_interval_ok++;
+        }
+        return result;
+    }
+
+    /**
+     * \brief Computes the squared distance between two points with
+     *  interval arithmetics.
+     */
+    inline interval_nt interval_sq_dist(const double* p1, const double* p2) {
+        return 
+            (interval_nt(p1[0]) - interval_nt(p2[0])).sqr() +
+            (interval_nt(p1[1]) - interval_nt(p2[1])).sqr() +
+            (interval_nt(p1[2]) - interval_nt(p2[2])).sqr() ;
+    }
+    
+    /**
+     * \brief Interval arithmetics stage of side4_3d() and side4_3d_SOS(),
+     *  used when the semi-static filter fails.
+     * \details Follows the same computations as side4_3d_exact_SOS().
+     * \retval POSITIVE, NEGATIVE if intervals could determine the sign
+     * \retval ZERO if exact arithmetics (and possibly symbolic 
+     *  perturbation) is needed
+     */
+    Sign side4_3d_interval(
+        const double* p0, const double* p1, const double* p2, const double* p3,
+        const double* p4
+    ) {
+        cnt_side4_interval++;
+
+        interval_nt a11 = interval_nt(p1[0]) - interval_nt(p0[0]);
+        interval_nt a12 = interval_nt(p1[1]) - interval_nt(p0[1]);
+        interval_nt a13 = interval_nt(p1[2]) - interval_nt(p0[2]);
+        interval_nt a14 = -interval_sq_dist(p1, p0);
+
+        interval_nt a21 = interval_nt(p2[0]) - interval_nt(p0[0]);
+        interval_nt a22 = interval_nt(p2[1]) - interval_nt(p0[1]);
+        interval_nt a23 = interval_nt(p2[2]) - interval_nt(p0[2]);
+        interval_nt a24 = -interval_sq_dist(p2, p0);
+
+        interval_nt a31 = interval_nt(p3[0]) - interval_nt(p0[0]);
+        interval_nt a32 = interval_nt(p3[1]) - interval_nt(p0[1]);
+        interval_nt a33 = interval_nt(p3[2]) - interval_nt(p0[2]);
+        interval_nt a34 = -interval_sq_dist(p3, p0);
+
+        interval_nt a41 = interval_nt(p4[0]) - interval_nt(p0[0]);
+        interval_nt a42 = interval_nt(p4[1]) - interval_nt(p0[1]);
+        interval_nt a43 = interval_nt(p4[2]) - interval_nt(p0[2]);
+        interval_nt a44 = -interval_sq_dist(p4, p0);
+
+        interval_nt m12 = a12*a23 - a22*a13;
+        interval_nt m13 = a12*a33 - a32*a13;
+        interval_nt m14 = a12*a43 - a42*a13;
+        interval_nt m23 = a22*a33 - a32*a23;
+        interval_nt m24 = a22*a43 - a42*a23;
+        interval_nt m34 = a32*a43 - a42*a33;
+
+        interval_nt Delta4 = a11*m23 - a21*m13 + a31*m12;
+        Sign Delta4_sign = Delta4.sign();
+        if(Delta4_sign == ZERO) {
+            return ZERO;
+        }
+        
+        interval_nt Delta1 = a21*m34 - a31*m24 + a41*m23;
+        interval_nt Delta2 = a11*m34 - a31*m14 + a41*m13;
+        interval_nt Delta3 = a11*m24 - a21*m14 + a41*m12;
+
+        interval_nt r = Delta1*a14 - Delta2*a24 + Delta3*a34 - Delta4*a44;
+        Sign r_sign = r.sign();
+        if(r_sign == ZERO) {
+            return ZERO;
+        }
+        cnt_side4_interval_ok++;
+        return Sign(Delta4_sign * r_sign);
+    }
+
     // ================================ statistics ========================
 
     /**
@@ -1559,6 +1795,45 @@ namespace {
             << std::endl;
     }
 
+    /**
+     * \brief Displays the statistics of the interval arithmetics stage
+     *  of a predicate, if it was used.
+     * \param[in] name name of the predicate
+     * \param[in] cnt1 total number of invocations
+     * \param[in] cnt2 number of invocations of the interval stage
+     * \param[in] cnt3 number of invocations of the interval stage that
+     *  could determine the sign
+     */
+    void show_stats_interval(
+        const std::string& name, index_t cnt1, index_t cnt2, index_t cnt3
+    ) {
+        if(cnt2 == 0) {
+            return;
+        }
+        Logger::out(name)
+            << " Interval: " << percent(cnt2, cnt1) << "% "
+            << " decided: " << percent(cnt3, cnt2) << "% "
+            << std::endl;
+    }
+
+    /**
+     * \brief Displays the number of batched invocations of a predicate,
+     *  if any.
+     * \param[in] name name of the predicate
+     * \param[in] cnt1 total number of invocations
+     * \param[in] cnt2 number of invocations through the batched version
+     */
+    void show_stats_batch(
+        const std::string& name, index_t cnt1, index_t cnt2
+    ) {
+        if(cnt2 == 0) {
+            return;
+        }
+        Logger::out(name)
+            << " Batched: " << percent(cnt2, cnt1) << "% "
+            << std::endl;
+    }
+
     /**
      * \brief Displays statistic counters for exact predicates
      * \param[in] name name of the predicate
@@ -1757,6 +2032,9 @@ namespace GEO {
         ) {
             cnt_side4_total++;
             Sign result = Sign(side4_3d_filter(p0, p1, p2, p3, p4));
+            if(result == 0) {
+                result = side4_3d_interval(p0, p1, p2, p3, p4);
+            }
             if(result == 0) {
                 // last argument is false: do not apply symbolic perturbation
                 result = side4_3d_exact_SOS(p0, p1, p2, p3, p4, false);
@@ -1771,6 +2049,9 @@ namespace GEO {
         ) {
             cnt_side4_total++;
             Sign result = Sign(side4_3d_filter(p0, p1, p2, p3, p4));
+            if(result == 0) {
+                result = side4_3d_interval(p0, p1, p2, p3, p4);
+            }
             if(result == 0) {
                 result = side4_3d_exact_SOS(p0, p1, p2, p3, p4);
             }
@@ -1800,12 +2081,69 @@ namespace GEO {
             
             // This specialized filter supposes that orient_3d(p0,p1,p2,p3) > 0
             Sign result = Sign(in_sphere_3d_filter_optim(p0, p1, p2, p3, p4));
+            if(result == 0) {
+                result = side4_3d_interval(p0, p1, p2, p3, p4);
+            }
             if(result == 0) {
                 result = side4_3d_exact_SOS(p0, p1, p2, p3, p4);
             }
             return Sign(-result);
         }
 
+        void in_sphere_3d_SOS_batch(
+            index_t n,
+            const double* const* p0, const double* const* p1,
+            const double* const* p2, const double* const* p3,
+            const double* const* p4,
+            Sign* result
+        ) {
+            double ptx[BATCH_SIZE], pty[BATCH_SIZE], ptz[BATCH_SIZE];
+            double qtx[BATCH_SIZE], qty[BATCH_SIZE], qtz[BATCH_SIZE];
+            double rtx[BATCH_SIZE], rty[BATCH_SIZE], rtz[BATCH_SIZE];
+            double stx[BATCH_SIZE], sty[BATCH_SIZE], stz[BATCH_SIZE];
+            int filter[BATCH_SIZE];
+            cnt_side4_total += n;
+            cnt_side4_batch += n;
+            for(index_t b=0; b<n; b+=BATCH_SIZE) {
+                index_t nb = geo_min(BATCH_SIZE, n-b);
+                for(index_t l=0; l<nb; ++l) {
+                    const double* t = p4[b+l];
+                    ptx[l] = p0[b+l][0] - t[0];
+                    pty[l] = p0[b+l][1] - t[1];
+                    ptz[l] = p0[b+l][2] - t[2];
+                    qtx[l] = p1[b+l][0] - t[0];
+                    qty[l] = p1[b+l][1] - t[1];
+                    qtz[l] = p1[b+l][2] - t[2];
+                    rtx[l] = p2[b+l][0] - t[0];
+                    rty[l] = p2[b+l][1] - t[1];
+                    rtz[l] = p2[b+l][2] - t[2];
+                    stx[l] = p3[b+l][0] - t[0];
+                    sty[l] = p3[b+l][1] - t[1];
+                    stz[l] = p3[b+l][2] - t[2];
+                }
+                in_sphere_3d_filter_batch(
+                    nb,
+                    ptx, pty, ptz, qtx, qty, qtz,
+                    rtx, rty, rtz, stx, sty, stz,
+                    filter
+                );
+                for(index_t l=0; l<nb; ++l) {
+                    Sign s = Sign(filter[l]);
+                    if(s == ZERO) {
+                        s = side4_3d_interval(
+                            p0[b+l], p1[b+l], p2[b+l], p3[b+l], p4[b+l]
+                        );
+                    }
+                    if(s == ZERO) {
+                        s = side4_3d_exact_SOS(
+                            p0[b+l], p1[b+l], p2[b+l], p3[b+l], p4[b+l]
+                        );
+                    }
+                    result[b+l] = Sign(-s);
+                }
+            }
+        }
+
         Sign GEOGRAM_API in_circle_2d_SOS(
             const double* p0, const double* p1, const double* p2,
             const double* p3
@@ -1905,6 +2243,9 @@ namespace GEO {
             ) {
             cnt_orient3d_total++;
             Sign result = Sign(orient_3d_filter(p0, p1, p2, p3));
+            if(result == 0) {
+                result = orient_3d_interval(p0, p1, p2, p3);
+            }
             if(result == 0) {
                 result = orient_3d_exact(p0, p1, p2, p3);
             }
@@ -1912,6 +2253,52 @@ namespace GEO {
         }
 
 
+        void orient_3d_batch(
+            index_t n,
+            const double* const* p0, const double* const* p1,
+            const double* const* p2, const double* const* p3,
+            Sign* result
+        ) {
+            double a11[BATCH_SIZE], a12[BATCH_SIZE], a13[BATCH_SIZE];
+            double a21[BATCH_SIZE], a22[BATCH_SIZE], a23[BATCH_SIZE];
+            double a31[BATCH_SIZE], a32[BATCH_SIZE], a33[BATCH_SIZE];
+            int filter[BATCH_SIZE];
+            cnt_orient3d_total += n;
+            cnt_orient3d_batch += n;
+            for(index_t b=0; b<n; b+=BATCH_SIZE) {
+                index_t nb = geo_min(BATCH_SIZE, n-b);
+                for(index_t l=0; l<nb; ++l) {
+                    const double* q0 = p0[b+l];
+                    a11[l] = p1[b+l][0] - q0[0];
+                    a12[l] = p1[b+l][1] - q0[1];
+                    a13[l] = p1[b+l][2] - q0[2];
+                    a21[l] = p2[b+l][0] - q0[0];
+                    a22[l] = p2[b+l][1] - q0[1];
+                    a23[l] = p2[b+l][2] - q0[2];
+                    a31[l] = p3[b+l][0] - q0[0];
+                    a32[l] = p3[b+l][1] - q0[1];
+                    a33[l] = p3[b+l][2] - q0[2];
+                }
+                orient_3d_filter_batch(
+                    nb, a11, a12, a13, a21, a22, a23, a31, a32, a33, filter
+                );
+                for(index_t l=0; l<nb; ++l) {
+                    Sign s = Sign(filter[l]);
+                    if(s == ZERO) {
+                        s = orient_3d_interval(
+                            p0[b+l], p1[b+l], p2[b+l], p3[b+l]
+                        );
+                    }
+                    if(s == ZERO) {
+                        s = orient_3d_exact(
+                            p0[b+l], p1[b+l], p2[b+l], p3[b+l]
+                        );
+                    }
+                    result[b+l] = s;
+                }
+            }
+        }
+
         Sign orient_3dlifted(
             const double* p0, const double* p1,
             const double* p2, const double* p3, const double* p4,
@@ -2012,6 +2399,13 @@ namespace GEO {
                 cnt_orient3d_total, cnt_orient3d_exact,
                 len_orient3d
             );
+            show_stats_interval(
+                "orient3d", cnt_orient3d_total, 
+                cnt_orient3d_interval, cnt_orient3d_interval_ok
+            );
+            show_stats_batch(
+                "orient3d", cnt_orient3d_total, cnt_orient3d_batch
+            );
             show_stats_sos(
                 "orient3dh",
                 cnt_orient3dh_total, cnt_orient3dh_exact, cnt_orient3dh_SOS,
@@ -2042,6 +2436,13 @@ namespace GEO {
                 cnt_side4_total, cnt_side4_exact, cnt_side4_SOS,
                 len_side4_num, len_side4_denom, len_side4_SOS
             );
+            show_stats_interval(
+                "side4/insph.", cnt_side4_total, 
+                cnt_side4_interval, cnt_side4_interval_ok
+            );
+            show_stats_batch(
+                "side4/insph.", cnt_side4_total, cnt_side4_batch
+            );
         }
     }
 }
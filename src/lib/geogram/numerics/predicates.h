@@ -295,6 +295,31 @@ namespace GEO {
             const double* p4
          );
 
+        /**
+         * \brief Evaluates in_sphere_3d_SOS() for a batch of inputs.
+         * \details The arithmetic filter is evaluated on blocks of
+         *  several inputs at once with a branch-free layout that the 
+         *  compiler can vectorize, and exact arithmetic is only used for
+         *  the inputs that the filter could not decide. The result is 
+         *  the same as calling in_sphere_3d_SOS() on each input. The same 
+         *  point may appear in several inputs, for instance to test one 
+         *  point against many tetrahedra.
+         * \param[in] n number of inputs
+         * \param[in] p0 , p1 , p2 , p3 arrays of \p n pointers to the 
+         *  vertices of the tetrahedra
+         * \param[in] p4 array of \p n pointers to the points to be tested
+         * \param[out] result array of \p n signs, where 
+         *  result[i] = in_sphere_3d_SOS(p0[i],p1[i],p2[i],p3[i],p4[i])
+         * \pre orient_3d(p0[i],p1[i],p2[i],p3[i]) > 0 for all i
+         */
+        void GEOGRAM_API in_sphere_3d_SOS_batch(
+            index_t n,
+            const double* const* p0, const double* const* p1,
+            const double* const* p2, const double* const* p3,
+            const double* const* p4,
+            Sign* result
+        );
+
 
         /**
          * \brief Tests whether a 2d point is inside the 
@@ -462,6 +487,26 @@ namespace GEO {
             return orient_3d(p0.data(),p1.data(),p2.data(),p3.data());
         }
 #endif
+
+        /**
+         * \brief Evaluates orient_3d() for a batch of tetrahedra.
+         * \details The arithmetic filter is evaluated on blocks of
+         *  several tetrahedra at once with a branch-free layout that the 
+         *  compiler can vectorize, and exact arithmetic is only used for
+         *  the tetrahedra that the filter could not decide. The result is 
+         *  the same as calling orient_3d() on each tetrahedron. 
+         * \param[in] n number of tetrahedra
+         * \param[in] p0 , p1 , p2 , p3 arrays of \p n pointers to the 
+         *  vertices of the tetrahedra
+         * \param[out] result array of \p n signs, where 
+         *  result[i] = orient_3d(p0[i],p1[i],p2[i],p3[i])
+         */
+        void GEOGRAM_API orient_3d_batch(
+            index_t n,
+            const double* const* p0, const double* const* p1,
+            const double* const* p2, const double* const* p3,
+            Sign* result
+        );
         
         /**
          * \brief Computes the 4d orientation test.
@@ -547,8 +592,9 @@ namespace GEO {
 	
         /**
          * \brief Displays some statistics about predicates,
-         *  including the number of calls, the number of exact arithmetics 
-         *  calls, and the number of Simulation of Simplicity calls.
+         *  including the number of calls, the number of calls decided by
+         *  interval arithmetics, the number of exact arithmetics calls, 
+         *  and the number of Simulation of Simplicity calls.
          */
         void GEOGRAM_API show_stats();
 
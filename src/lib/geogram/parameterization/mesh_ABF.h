@@ -61,6 +61,10 @@ namespace GEO {
      * \details The method is described in the following reference:
      *   ABF++: fast and robust angle-based flattening, A. Sheffer, B. Levy,
      *   M. Mogilnitsky,  A. Bogomyakov, ACM Transactions on Graphics, 2005
+     *
+     *   The systems of the Newton iterations are solved at full resolution
+     *   by a direct solver, only the final reconstruction of the texture
+     *   coordinates uses mesh_compute_LSCM() and its multigrid solver.
      * \param[in,out] M a reference to a surface mesh. Facets need to be 
      *   triangulated.
      * \param[in] attribute_name the name of the vertex attribute where 
@@ -153,6 +153,14 @@ namespace {
 					    << std::endl;
 		    }
 		    nlSolverParameteri(NL_SOLVER, NL_CHOLMOD_EXT);
+		} else if(mesh_.vertices.nb() > multigrid_threshold()) {
+		    if(verbose_) {
+			Logger::out("LSCM") << "using multigrid CG"
+					    << std::endl;
+		    }
+		    nlSolverParameteri(NL_SOLVER, NL_CG);
+		    nlSolverParameteri(NL_PRECONDITIONER, NL_PRECOND_MULTIGRID);
+		    nlSolverParameteri(NL_MULTIGRID_COMPONENTS, 2);
 		} else {
 		    if(verbose_) {
 			Logger::out("LSCM") << "using JacobiCG"
@@ -570,6 +578,18 @@ namespace {
 	    }
 	}
 	
+	/**
+	 * \brief Gets the minimum number of vertices for using the 
+	 *  multigrid preconditioner.
+	 * \details An iteration with the multigrid preconditioner is
+	 *  several times more expensive than with the Jacobi preconditioner,
+	 *  this only pays off for large charts, where Jacobi needs many 
+	 *  more iterations.
+	 */
+	static index_t multigrid_threshold() {
+	    return 50000;
+	}
+
 	Mesh& mesh_;
 
 	Attribute<double>& tex_coord_;
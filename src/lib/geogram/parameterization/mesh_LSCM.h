@@ -66,6 +66,10 @@ namespace GEO {
      *  - spectral mode: Spectral Conformal Parameterization, 
      *    Mullen, Tong, Alliez, Desbrun, 
      *    Computer Graphics Forum (SGP conf. proc.), 2008
+     *
+     *  In least squares mode, if CHOLMOD is not available, large charts
+     *  are solved by a conjugate gradient preconditioned by algebraic
+     *  multigrid.
      * \param[in,out] M a reference to a surface mesh
      * \param[in] attribute_name the name of the vertex attribute where 
      *   texture coordinates are stored.
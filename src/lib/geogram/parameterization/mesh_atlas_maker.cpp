@@ -53,6 +53,10 @@
 #include <geogram/mesh/mesh_geometry.h>
 #include <geogram/mesh/mesh_io.h>
 #include <geogram/basic/progress.h>
+#include <geogram/basic/process.h>
+#include <geogram/basic/algorithm.h>
+#include <geogram/NL/nl.h>
+#include <algorithm>
 #include <deque>
 #include <stack>
 
@@ -62,8 +66,34 @@
 namespace {
     using namespace GEO;
 
+    /**
+     * \brief Per-thread state used to parameterize charts.
+     * \details Each worker owns the surface mesh in which charts are
+     *  copied, the validator and the local vertex map, so that several
+     *  charts can be parameterized concurrently.
+     */
+    class ChartWorker {
+    public:
+	ChartWorker() {
+	    tex_coord.create_vector_attribute(
+		chart_as_mesh.vertices.attributes(), "tex_coord", 2
+	    );
+	}
+	
+	Mesh chart_as_mesh;
+	Attribute<double> tex_coord;
+	ParamValidator validator;
+	vector<index_t> vertices;
+	vector<index_t> vertex_id;
+    };
+    
     /**
      * \brief Computes a texture atlas.
+     * \details Charts are processed by waves. All the charts of a wave
+     *  are parameterized and validated in parallel, then the charts that
+     *  failed are split, in the order of the wave, to form the next wave.
+     *  Chart ids and facet order are thus the same as with sequential
+     *  processing, whatever the number of threads.
      */
     class AtlasMaker {
     public:
@@ -72,7 +102,8 @@ namespace {
 	    mesh_(mesh),
 	    hard_angles_threshold_(0.0),
 	    chart_(mesh.facets.attributes(),"chart"),
-	    vertex_id_(mesh.vertices.attributes(),"id")	{
+	    next_chart_(0),
+	    lock_(GEOGRAM_SPINLOCK_INIT) {
 	    tex_coord_.bind_if_is_defined(
 		mesh_.facet_corners.attributes(), "tex_coord"
 	    );
@@ -83,25 +114,20 @@ namespace {
 		    mesh_.facet_corners.attributes(), "tex_coord", 2
 		);
 	    }
-	    chart_tex_coord_.create_vector_attribute(
-		chart_as_mesh_.vertices.attributes(), "tex_coord", 2
-	    );
-	    for(index_t v=0; v<mesh_.vertices.nb(); ++v) {
-		vertex_id_[v] = NO_VERTEX;
-	    }
 	    chart_parameterizer_ = PARAM_ABF;
 	    verbose_ = false;
 	}
 
 	~AtlasMaker() {
-	    // TODO: delete vertex_id_ and chart_
-	    // attributes (no longer needed).
-	    // Keeping them for now (for visual debugging).
+	    // TODO: delete chart_ attribute (no longer needed).
+	    // Keeping it for now (for visual debugging).
+	    for(index_t i=0; i<workers_.size(); ++i) {
+		delete workers_[i];
+	    }
 	}
 
 	void set_verbose(bool x) {
 	    verbose_ = x;
-	    validator_.set_verbose(x);
 	}
 	
 	void set_hard_angles_threshold(double x) {
@@ -122,22 +148,41 @@ namespace {
 		}
 		chart_queue_[chart_[f]].facets.push_back(f);
 	    }
+
+	    // Messages of the validator and of the parameterizers are
+	    // not meant to be interleaved, thus verbose mode runs with
+	    // a single worker.
+	    index_t nb_workers =
+		verbose_ ? 1 : Process::maximum_concurrent_threads();
+	    for(index_t i=0; i<nb_workers; ++i) {
+		workers_.push_back(new ChartWorker);
+		workers_[i]->validator.set_verbose(verbose_);
+	    }
+	    init_solver_extensions();
+	    
 	    ProgressTask progress("Atlas",100);
 	    progress.progress(0);
 	    try {
 		while(!chart_queue_.empty()) {
-		    Chart& current_chart = chart_queue_.front();
-		    if(
-			precheck_chart(current_chart) &&
-			parameterize_chart(current_chart) &&
-			postcheck_chart(current_chart)
-		    ) {
-			param_f += current_chart.facets.size();
-			progress.progress(param_f * 100 / total_f);
-		    } else {
-			split_chart(current_chart);
+		    chart_OK_.assign(chart_queue_.size(), 0);
+		    next_chart_ = 0;
+		    parallel_for(
+			parallel_for_member_callback(
+			    this, &AtlasMaker::run_worker
+			),
+			0, nb_workers
+		    );
+		    std::deque<Chart> next_wave;
+		    for(index_t i=0; i<chart_queue_.size(); ++i) {
+			Chart& current_chart = chart_queue_[i];
+			if(chart_OK_[i] != 0) {
+			    param_f += current_chart.facets.size();
+			} else {
+			    split_chart(current_chart, next_wave);
+			}
 		    }
-		    chart_queue_.pop_front();
+		    chart_queue_.swap(next_wave);
+		    progress.progress(param_f * 100 / total_f);
 		}
 	    } catch(...) {
 		Logger::out("Atlas") << "Job canceled" << std::endl;
@@ -166,14 +211,55 @@ namespace {
         } 
         */
 	
+	/**
+	 * \brief Parameterizes and validates the charts of the current
+	 *  wave, until there is no chart left.
+	 * \param[in] w the index of the worker
+	 */
+	void run_worker(index_t w) {
+	    ChartWorker& worker = *workers_[w];
+	    for(;;) {
+		Process::acquire_spinlock(lock_);
+		index_t i = next_chart_;
+		++next_chart_;
+		Process::release_spinlock(lock_);
+		if(i >= chart_queue_.size()) {
+		    break;
+		}
+		Chart& current_chart = chart_queue_[i];
+		if(
+		    precheck_chart(current_chart) &&
+		    parameterize_chart(worker, current_chart) &&
+		    postcheck_chart(worker, current_chart)
+		) {
+		    chart_OK_[i] = 1;
+		}
+	    }
+	}
+
+	/**
+	 * \brief Loads the dynamic OpenNL extensions used by the chart
+	 *  parameterizers before entering the parallel section.
+	 * \details Extensions are global to OpenNL and their initialization
+	 *  is not thread-safe. Once loaded, the workers only query them.
+	 */
+	void init_solver_extensions() {
+	    if(chart_parameterizer_ == PARAM_SPECTRAL_LSCM) {
+		nlInitExtension("ARPACK");
+	    }
+	    // Used by ABF (the default chart parameterizer).
+	    nlInitExtension("SUPERLU");
+	    nlInitExtension("CHOLMOD");
+	}
+	
 	bool precheck_chart(Chart& chart) {
 	    // TODO: topological tests
 	    geo_argused(chart);
 	    return true;
 	}
 
-	bool postcheck_chart(Chart& chart) {
-	    bool OK = validator_.chart_is_valid(chart);
+	bool postcheck_chart(ChartWorker& worker, Chart& chart) {
+	    bool OK = worker.validator.chart_is_valid(chart);
 	    
 	    // Ignore problems for small charts.
 	    // TODO: check if we can remove that
@@ -198,32 +284,72 @@ namespace {
 	    return OK;
 	}
 	
-	void split_chart(Chart& chart) {
-	    chart_queue_.push_back(Chart(mesh_, chart.id));
-	    Chart& chart1 = chart_queue_.back();
-	    chart_queue_.push_back(Chart(mesh_, nb_charts_));
-	    Chart& chart2 = chart_queue_.back();
+	void split_chart(Chart& chart, std::deque<Chart>& queue) {
+	    queue.push_back(Chart(mesh_, chart.id));
+	    Chart& chart1 = queue.back();
+	    queue.push_back(Chart(mesh_, nb_charts_));
+	    Chart& chart2 = queue.back();
 	    ++nb_charts_;
 	    split_chart_along_principal_axis(chart, chart1, chart2);
 	}
+
+	/**
+	 * \brief Gets the slot of a vertex in the vertex map of a worker.
+	 * \param[in] worker the worker, with its sorted vertices
+	 * \param[in] v the index of the vertex in the input mesh
+	 * \return the index of \p v in the sorted vertices of \p worker
+	 */
+	static index_t vertex_slot(const ChartWorker& worker, index_t v) {
+	    vector<index_t>::const_iterator it = std::lower_bound(
+		worker.vertices.begin(), worker.vertices.end(), v
+	    );
+	    geo_debug_assert(it != worker.vertices.end() && *it == v);
+	    return index_t(it - worker.vertices.begin());
+	}
+
+	/**
+	 * \brief Gets the index of a vertex in the mesh of a worker.
+	 * \param[in] worker the worker
+	 * \param[in] v the index of the vertex in the input mesh
+	 * \return the index of \p v in the mesh of \p worker
+	 */
+	static index_t chart_vertex(const ChartWorker& worker, index_t v) {
+	    return worker.vertex_id[vertex_slot(worker, v)];
+	}
 	
-	bool parameterize_chart(Chart& chart) {
+	bool parameterize_chart(ChartWorker& worker, Chart& chart) {
+	    Mesh& chart_as_mesh = worker.chart_as_mesh;
 	    
-	    chart_as_mesh_.clear();
-	    chart_as_mesh_.vertices.set_dimension(3);
+	    chart_as_mesh.clear();
+	    chart_as_mesh.vertices.set_dimension(3);
 	    
-	    // Assign vertices ids and copy vertices
+	    // Assign vertices ids (in the order they are encountered,
+	    // so that the chart mesh does not depend on the worker)
+	    // and copy vertices
+	    worker.vertices.clear();
+	    for(index_t ff=0; ff<chart.facets.size(); ++ff) {
+		index_t f = chart.facets[ff];
+		for(index_t c=chart.mesh.facets.corners_begin(f);
+		    c < chart.mesh.facets.corners_end(f); ++c) {
+		    worker.vertices.push_back(
+			chart.mesh.facet_corners.vertex(c)
+		    );
+		}
+	    }
+	    sort_unique(worker.vertices);
+	    worker.vertex_id.assign(worker.vertices.size(), NO_VERTEX);
 	    index_t cur_vertex = 0;
 	    for(index_t ff=0; ff<chart.facets.size(); ++ff) {
 		index_t f = chart.facets[ff];
 		for(index_t c=chart.mesh.facets.corners_begin(f);
 		    c < chart.mesh.facets.corners_end(f); ++c) {
 		    index_t v = chart.mesh.facet_corners.vertex(c);
-		    if(vertex_id_[v] == NO_VERTEX) {
-			chart_as_mesh_.vertices.create_vertex(
+		    index_t slot = vertex_slot(worker, v);
+		    if(worker.vertex_id[slot] == NO_VERTEX) {
+			chart_as_mesh.vertices.create_vertex(
 			    mesh_.vertices.point_ptr(v)
-			    );
-			vertex_id_[v] = cur_vertex;
+			);
+			worker.vertex_id[slot] = cur_vertex;
 			++cur_vertex;
 		    }
 		}
@@ -233,66 +359,63 @@ namespace {
 	    for(index_t ff=0; ff<chart.facets.size(); ++ff) {
 		index_t f = chart.facets[ff];
 		index_t c1 = chart.mesh.facets.corners_begin(f);
-		index_t v1 = vertex_id_[chart.mesh.facet_corners.vertex(c1)];
+		index_t v1 = chart_vertex(
+		    worker, chart.mesh.facet_corners.vertex(c1)
+		);
 		for(index_t c2 = c1+1;
 		    c2+1 < chart.mesh.facets.corners_end(f); ++c2
 		) {
 		    index_t c3=c2+1;
-		    index_t v2=vertex_id_[chart.mesh.facet_corners.vertex(c2)];
-		    index_t v3=vertex_id_[chart.mesh.facet_corners.vertex(c3)];
-		    geo_assert(v1 < cur_vertex);
-		    geo_assert(v2 < cur_vertex);
-		    geo_assert(v3 < cur_vertex);		    
-		    chart_as_mesh_.facets.create_triangle(v1,v2,v3);
+		    index_t v2=chart_vertex(
+			worker, chart.mesh.facet_corners.vertex(c2)
+		    );
+		    index_t v3=chart_vertex(
+			worker, chart.mesh.facet_corners.vertex(c3)
+		    );
+		    chart_as_mesh.facets.create_triangle(v1,v2,v3);
 		}
 	    }
-	    chart_as_mesh_.facets.connect();
+	    chart_as_mesh.facets.connect();
 
-	    if(chart_as_mesh_.facets.nb() < 5) {
+	    if(chart_as_mesh.facets.nb() < 5) {
 		mesh_compute_LSCM(
-		    chart_as_mesh_, "tex_coord", false, "", verbose_
+		    chart_as_mesh, "tex_coord", false, "", verbose_
 		);
 	    } else {
 		switch(chart_parameterizer_) {
 		    case PARAM_LSCM:
 			mesh_compute_LSCM(
-			    chart_as_mesh_, "tex_coord", false, "", verbose_
+			    chart_as_mesh, "tex_coord", false, "", verbose_
 			);
 			break;
 		    case PARAM_SPECTRAL_LSCM:
 			mesh_compute_LSCM(
-			    chart_as_mesh_, "tex_coord", true, "", verbose_
+			    chart_as_mesh, "tex_coord", true, "", verbose_
 			);
 			break;
 		    case PARAM_ABF:
 			mesh_compute_ABF_plus_plus(
-			    chart_as_mesh_, "tex_coord", verbose_
+			    chart_as_mesh, "tex_coord", verbose_
 			);
 			break;
 		}
 	    }
 	    
-	    // Copy tex coords
+	    // Copy tex coords (each chart has its own facet corners,
+	    // thus concurrent workers never write to the same location).
 	    for(index_t ff=0; ff<chart.facets.size(); ++ff) {
 		index_t f = chart.facets[ff];
 		for(index_t c=chart.mesh.facets.corners_begin(f);
 		    c < chart.mesh.facets.corners_end(f); ++c
 		) {
-		    index_t v = vertex_id_[chart.mesh.facet_corners.vertex(c)];
-			tex_coord_[2*c] = chart_tex_coord_[2*v];
-			tex_coord_[2*c+1] = chart_tex_coord_[2*v+1];
+		    index_t v = chart_vertex(
+			worker, chart.mesh.facet_corners.vertex(c)
+		    );
+		    tex_coord_[2*c] = worker.tex_coord[2*v];
+		    tex_coord_[2*c+1] = worker.tex_coord[2*v+1];
 		}		
 	    }
 	    
-	    // Reset vertex ids
-	    for(index_t ff=0; ff<chart.facets.size(); ++ff) {
-		index_t f = chart.facets[ff];
-		for(index_t c=chart.mesh.facets.corners_begin(f);
-		    c < chart.mesh.facets.corners_end(f); ++c) {
-		    vertex_id_[chart.mesh.facet_corners.vertex(c)] = NO_VERTEX;
-		}
-	    }
-	    
 	    return true;
 	}
 
@@ -333,14 +456,14 @@ namespace {
     private:
 	Mesh& mesh_;
 	ChartParameterizer chart_parameterizer_;
-	ParamValidator validator_;
 	double hard_angles_threshold_;
 	Attribute<index_t> chart_;
-	Attribute<index_t> vertex_id_;
 	Attribute<double> tex_coord_;
-	Mesh chart_as_mesh_;
-	Attribute<double> chart_tex_coord_;
 	std::deque<Chart> chart_queue_;
+	vector<Numeric::uint8> chart_OK_;
+	vector<ChartWorker*> workers_;
+	index_t next_chart_;
+	Process::spinlock lock_;
 	index_t nb_charts_;
 	bool verbose_;
     };
@@ -352,7 +475,7 @@ namespace GEO {
 
     void mesh_make_atlas(
 	Mesh& mesh, double hard_angles_threshold, ChartParameterizer param,
-	bool verbose 
+	bool verbose, ChartPacker pack
     ) {
 	AtlasMaker atlas(mesh);
 	atlas.set_hard_angles_threshold(hard_angles_threshold);
@@ -360,6 +483,7 @@ namespace GEO {
 	atlas.set_verbose(verbose);
 	atlas.make_atlas();
 	Packer packer;
+	packer.set_chart_packer(pack);
 	packer.pack_surface(mesh);
     }
     
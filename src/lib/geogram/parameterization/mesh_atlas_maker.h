@@ -47,6 +47,7 @@
 #define GEOGRAM_MESH_MESH_ATLAS_MAKER
 
 #include <geogram/basic/common.h>
+#include <geogram/parameterization/mesh_param_packer.h>
 
 /**
  * \file geogram/mesh/mesh_atlas_maker.h
@@ -59,12 +60,13 @@ namespace GEO {
     enum ChartParameterizer {
 	PARAM_LSCM, PARAM_SPECTRAL_LSCM, PARAM_ABF
     };
-    
+
     void GEOGRAM_API mesh_make_atlas(
 	Mesh& mesh,
 	double hard_angles_threshold = 45.0,
 	ChartParameterizer=PARAM_ABF,
-	bool verbose = false
+	bool verbose = false,
+	ChartPacker packer = PACK_TETRIS
     );
 }
 
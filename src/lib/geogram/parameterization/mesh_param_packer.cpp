@@ -47,6 +47,7 @@
 #include <geogram/mesh/mesh.h>
 #include <geogram/mesh/mesh_geometry.h>
 #include <geogram/basic/logger.h>
+#include <geogram/basic/process.h>
 #include <geogram/numerics/matrix_util.h>
 #include <algorithm>
 #include <math.h>
@@ -650,12 +651,940 @@ namespace GEO {
     };
 
 
+    /***********************************************************/
+
+    /**
+     * \brief Internal implementation of the rasterized packing algorithm.
+     * \details The footprint of each chart is rasterized in a bitmask at
+     *  half the resolution of the target texture, and dilated by the 
+     *  margin. Charts are sorted by decreasing size, then each chart is
+     *  placed at the position that minimizes its top (then its bottom, 
+     *  then its abscissa) where its dilated footprint does not overlap 
+     *  the already placed charts, among the four 90 degrees rotations. 
+     *  Overlap tests operate on 64 cells at a time, rows without a large
+     *  enough free square are skipped, and candidate rows are tested in
+     *  parallel. The result does not depend on the number of threads.
+     */
+    class RasterPacker {
+    public:
+
+	/**
+	 * \brief RasterPacker constructor.
+	 * \param[in] mesh a reference the surface mesh to be packed.
+	 *  It needs to have a vector attribute of dimension 2 attached
+	 *  to the facet corners and named "tex_coord".
+	 */
+	RasterPacker(Mesh& mesh) :
+	    image_size_in_pixels_(1024),
+	    margin_width_in_pixels_(4),
+	    cell_size_in_pixels_(2),
+	    margin_in_cells_(0),
+	    step_(0.0),
+	    width_(0),
+	    nb_words_(0),
+	    nb_blocks_(0),
+	    nb_rows_(0),
+	    height_(0),
+	    min_free_row_(0),
+	    current_(nil) {
+	    tex_coord_.bind_if_is_defined(
+		mesh.facet_corners.attributes(), "tex_coord"
+	    );
+	    geo_assert(tex_coord_.is_bound() && tex_coord_.dimension() == 2);
+	}
+
+        void set_image_size_in_pixels(index_t size) {
+            image_size_in_pixels_ = size;
+        }
+
+        void set_margin_width_in_pixels(index_t width) {
+            margin_width_in_pixels_ = width;
+        } 
+
+	/**
+	 * \brief Adds a chart to be packed.
+	 * \param[in] chart a pointer to the chart. Its texture 
+	 *  coordinates are supposed to be normalized.
+	 */
+	void add(Chart* chart) {
+	    footprints_.push_back(Footprint());
+	    footprints_.back().chart = chart;
+	}
+
+	/**
+	 * \brief Packs all the charts and updates their texture coordinates.
+	 */
+	void apply() {
+	    if(footprints_.size() == 0) {
+		return;
+	    }
+	    
+	    // The size of a pixel in the final texture is estimated from
+	    // the total area of the bounding boxes, as in TetrisPacker.
+	    // Footprints are rasterized at a coarser resolution, and the
+	    // margin is rounded up to a whole number of cells.
+	    double area = 0.0;
+	    for(index_t i=0; i<footprints_.size(); ++i) {
+		Footprint& F = footprints_[i];
+		Geom::get_chart_bbox_2d(
+		    *F.chart, tex_coord_, F.u_min, F.v_min, F.u_max, F.v_max
+		);
+		area += (F.u_max - F.u_min) * (F.v_max - F.v_min);
+	    }
+	    margin_in_cells_ = 
+		(margin_width_in_pixels_ + cell_size_in_pixels_ - 1) /
+		cell_size_in_pixels_;
+	    step_ = ::sqrt(area) * double(cell_size_in_pixels_) /
+		double(image_size_in_pixels_);
+	    if(step_ == 0.0) {
+		step_ = 1.0;
+	    }
+	    
+	    parallel_for(
+		parallel_for_member_callback(
+		    this, &RasterPacker::rasterize_footprint
+		),
+		0, footprints_.size()
+	    );
+
+	    // Largest charts first, ties broken by chart index.
+	    vector<index_t> order(footprints_.size());
+	    index_t total_cells = 0;
+	    index_t min_width = 0;
+	    for(index_t i=0; i<footprints_.size(); ++i) {
+		order[i] = i;
+		total_cells += footprints_[i].nb_cells;
+		min_width = geo_max(
+		    min_width,
+		    geo_min(footprints_[i].width[0], footprints_[i].height[0])
+		);
+	    }
+	    std::sort(order.begin(), order.end(), CompareFootprints(*this));
+
+	    // Aim at a square atlas with 80% of the cells covered.
+	    width_ = geo_max(
+		min_width, index_t(::sqrt(double(total_cells) / 0.8)) + 1
+	    );
+	    nb_words_ = width_ / 64 + 2;
+	    nb_blocks_ = (width_ + block_size() - 1) / block_size();
+	    nb_rows_ = 0;
+	    height_ = 0;
+	    min_free_row_ = 0;
+	    atlas_.clear();
+	    square_.clear();
+	    max_square_.clear();
+	    block_square_.clear();
+
+	    x_.assign(footprints_.size(), 0);
+	    y_.assign(footprints_.size(), 0);
+	    orient_.assign(footprints_.size(), 0);
+	    for(index_t k=0; k<order.size(); ++k) {
+		place(order[k]);
+	    }
+	    
+	    parallel_for(
+		parallel_for_member_callback(
+		    this, &RasterPacker::update_tex_coords
+		),
+		0, footprints_.size()
+	    );
+	}
+
+    protected:
+
+	/**
+	 * \brief A word of a bitmask, that stores 64 cells.
+	 */
+	typedef Numeric::uint64 Word;
+
+	/**
+	 * \brief A horizontal run of cells in a footprint.
+	 */
+	struct Run {
+	    index_t row;
+	    index_t begin;
+	    index_t length;
+
+	    /**
+	     * \brief Sorts the runs by decreasing length, since the longest
+	     *  runs are the most likely to reject candidate positions.
+	     */
+	    bool operator<(const Run& rhs) const {
+		if(length != rhs.length) {
+		    return length > rhs.length;
+		}
+		if(row != rhs.row) {
+		    return row < rhs.row;
+		}
+		return begin < rhs.begin;
+	    }
+	};
+	
+	/**
+	 * \brief The rasterized footprint of a chart.
+	 * \details Bitmasks are stored row by row, each row being padded
+	 *  to a whole number of words. Bit k of word i of a row corresponds
+	 *  to column 64*i+k. There is one bitmask per 90 degrees rotation.
+	 */
+	struct Footprint {
+	    Chart* chart;
+	    double u_min, v_min, u_max, v_max;
+	    index_t nb_cells;
+	    index_t width[4];
+	    index_t height[4];
+	    index_t nb_words[4];
+
+	    /** 
+	     * \brief Size and lower-left corner of the largest square 
+	     *  of cells in dilated.
+	     */
+	    index_t square[4];
+	    index_t square_x[4];
+	    index_t square_y[4];
+
+	    /** 
+	     * \brief The runs of cells of dilated, longest first.
+	     */
+	    vector<Run> runs[4];
+
+	    /** \brief The footprint dilated by the margin */
+	    vector<Word> dilated[4];
+
+	    /** \brief The footprint itself */
+	    vector<Word> core[4];
+	};
+
+	/**
+	 * \brief Sorts the charts by decreasing footprint size.
+	 */
+	class CompareFootprints {
+	public:
+	    CompareFootprints(const RasterPacker& packer) : packer_(packer) {
+	    }
+
+	    bool operator()(index_t i, index_t j) const {
+		const Footprint& Fi = packer_.footprints_[i];
+		const Footprint& Fj = packer_.footprints_[j];
+		index_t si = geo_max(Fi.width[0], Fi.height[0]);
+		index_t sj = geo_max(Fj.width[0], Fj.height[0]);
+		if(si != sj) {
+		    return si > sj;
+		}
+		if(Fi.nb_cells != Fj.nb_cells) {
+		    return Fi.nb_cells > Fj.nb_cells;
+		}
+		return i < j;
+	    }
+	private:
+	    const RasterPacker& packer_;
+	};
+
+	/**
+	 * \brief Tests whether a cell overlaps a triangle.
+	 * \param[in] p0 , p1 , p2 the vertices of the triangle, in
+	 *  cell units, in counterclockwise order.
+	 * \param[in] x , y the lower-left corner of the cell.
+	 * \retval true if the triangle and the cell overlap.
+	 * \retval false otherwise.
+	 */
+	static bool cell_overlaps_triangle(
+	    const vec2& p0, const vec2& p1, const vec2& p2,
+	    double x, double y
+	) {
+	    const vec2* p[3] = { &p0, &p1, &p2 };
+	    for(index_t e=0; e<3; ++e) {
+		const vec2& q1 = *p[e];
+		const vec2& q2 = *p[(e+1)%3];
+		vec2 N(q1.y - q2.y, q2.x - q1.x);
+		// The cell is separated by edge e if its four
+		// corners are strictly on the outer side.
+		double d = dot(N, vec2(x,y) - q1);
+		double d_max = d + geo_max(N.x, 0.0) + geo_max(N.y, 0.0);
+		if(d_max < 0.0) {
+		    return false;
+		}
+	    }
+	    return true;
+	}
+
+	/**
+	 * \brief Rasterizes the footprint of a chart in its four 
+	 *  orientations.
+	 * \param[in] i the index of the footprint.
+	 */
+	void rasterize_footprint(index_t i) {
+	    Footprint& F = footprints_[i];
+	    const Chart& chart = *F.chart;
+	    const Mesh& M = chart.mesh;
+	    index_t m = margin_in_cells_;
+	    index_t w = index_t((F.u_max - F.u_min) / step_) + 1 + 2*m;
+	    index_t h = index_t((F.v_max - F.v_min) / step_) + 1 + 2*m;
+	    
+	    vector<Numeric::uint8> core(w*h, 0);
+	    for(index_t ff=0; ff<chart.facets.size(); ++ff) {
+		index_t f = chart.facets[ff];
+		index_t c1 = M.facets.corners_begin(f);
+		for(index_t c2 = c1+1; c2+1 < M.facets.corners_end(f); ++c2) {
+		    index_t c3 = c2+1;
+		    vec2 p1 = cell_coords(F, c1);
+		    vec2 p2 = cell_coords(F, c2);
+		    vec2 p3 = cell_coords(F, c3);
+		    if(Geom::triangle_signed_area(p1,p2,p3) < 0.0) {
+			geo_swap(p2,p3);
+		    }
+		    index_t x_min = index_t(geo_min(p1.x, geo_min(p2.x, p3.x)));
+		    index_t y_min = index_t(geo_min(p1.y, geo_min(p2.y, p3.y)));
+		    index_t x_max = geo_min(
+			index_t(geo_max(p1.x, geo_max(p2.x, p3.x))), w-1
+		    );
+		    index_t y_max = geo_min(
+			index_t(geo_max(p1.y, geo_max(p2.y, p3.y))), h-1
+		    );
+		    for(index_t y=y_min; y<=y_max; ++y) {
+			for(index_t x=x_min; x<=x_max; ++x) {
+			    if(
+				core[y*w+x] == 0 &&
+				cell_overlaps_triangle(
+				    p1, p2, p3, double(x), double(y)
+				)
+			    ) {
+				core[y*w+x] = 1;
+			    }
+			}
+		    }
+		}
+	    }
+
+	    // Dilate (separable square structuring element)
+	    vector<Numeric::uint8> tmp(w*h, 0);
+	    vector<Numeric::uint8> dilated(w*h, 0);
+	    F.nb_cells = 0;
+	    for(index_t y=0; y<h; ++y) {
+		for(index_t x=0; x<w; ++x) {
+		    if(core[y*w+x] != 0) {
+			index_t x1 = (x >= m) ? x-m : 0;
+			index_t x2 = geo_min(x+m, w-1);
+			for(index_t xx=x1; xx<=x2; ++xx) {
+			    tmp[y*w+xx] = 1;
+			}
+		    }
+		}
+	    }
+	    for(index_t y=0; y<h; ++y) {
+		for(index_t x=0; x<w; ++x) {
+		    if(tmp[y*w+x] != 0) {
+			index_t y1 = (y >= m) ? y-m : 0;
+			index_t y2 = geo_min(y+m, h-1);
+			for(index_t yy=y1; yy<=y2; ++yy) {
+			    dilated[yy*w+x] = 1;
+			}
+		    }
+		}
+	    }
+	    for(index_t k=0; k<w*h; ++k) {
+		F.nb_cells += dilated[k];
+	    }
+
+	    // Largest square in the dilated footprint
+	    index_t q = 0, qx = 0, qy = 0;
+	    {
+		vector<index_t> S(w*h, 0);
+		for(index_t y=h; y-- > 0; ) {
+		    for(index_t x=w; x-- > 0; ) {
+			if(dilated[y*w+x] == 0) {
+			    continue;
+			}
+			index_t s = 1;
+			if(x+1 < w && y+1 < h) {
+			    s += geo_min(
+				S[y*w+x+1], geo_min(S[(y+1)*w+x], S[(y+1)*w+x+1])
+			    );
+			}
+			S[y*w+x] = s;
+			if(s >= q) {
+			    q = s; qx = x; qy = y;
+			}
+		    }
+		}
+	    }
+
+	    for(index_t o=0; o<4; ++o) {
+		index_t ow = (o%2 == 0) ? w : h;
+		index_t oh = (o%2 == 0) ? h : w;
+		F.width[o] = ow;
+		F.height[o] = oh;
+		F.nb_words[o] = (ow + 63) / 64;
+		F.core[o].assign(F.nb_words[o]*oh, 0);
+		F.dilated[o].assign(F.nb_words[o]*oh, 0);
+		for(index_t y=0; y<h; ++y) {
+		    for(index_t x=0; x<w; ++x) {
+			index_t X,Y;
+			rotate_cell(o, w, h, x, y, X, Y);
+			Word bit = Word(1) << (X%64);
+			index_t word = Y*F.nb_words[o] + X/64;
+			if(core[y*w+x] != 0) {
+			    F.core[o][word] |= bit;
+			}
+			if(dilated[y*w+x] != 0) {
+			    F.dilated[o][word] |= bit;
+			}
+		    }
+		}
+		F.runs[o].clear();
+		for(index_t Y=0; Y<oh; ++Y) {
+		    const Word* row = &F.dilated[o][Y*F.nb_words[o]];
+		    index_t x = next_bit(row, 0, ow, true);
+		    while(x < ow) {
+			index_t e = next_bit(row, x, ow, false);
+			Run R;
+			R.row = Y;
+			R.begin = x;
+			R.length = e - x;
+			F.runs[o].push_back(R);
+			x = next_bit(row, e, ow, true);
+		    }
+		}
+		std::sort(F.runs[o].begin(), F.runs[o].end());
+		index_t X1,Y1,X2,Y2;
+		rotate_cell(o, w, h, qx, qy, X1, Y1);
+		rotate_cell(o, w, h, qx+q-1, qy+q-1, X2, Y2);
+		F.square[o] = q;
+		F.square_x[o] = geo_min(X1,X2);
+		F.square_y[o] = geo_min(Y1,Y2);
+	    }
+	}
+
+	/**
+	 * \brief Finds the next set or cleared bit in a row.
+	 * \param[in] row a pointer to the words of the row
+	 * \param[in] x the first bit to be tested
+	 * \param[in] end one position past the last bit to be tested
+	 * \param[in] value true for set bits, false for cleared bits
+	 * \return the position of the first bit equal to \p value in 
+	 *  [x, end), or \p end if there is no such bit.
+	 */
+	static index_t next_bit(
+	    const Word* row, index_t x, index_t end, bool value
+	) {
+	    while(x < end) {
+		Word w = value ? row[x/64] : ~row[x/64];
+		w >>= (x%64);
+		if(w == 0) {
+		    // Skip the remaining bits of this word.
+		    x = (x/64 + 1)*64;
+		    continue;
+		}
+		while((w & Word(1)) == 0) {
+		    w >>= 1;
+		    ++x;
+		}
+		return geo_min(x, end);
+	    }
+	    return end;
+	}
+
+	/**
+	 * \brief Gets the texture coordinates of a corner relative to the
+	 *  dilated footprint of its chart, in cell units.
+	 * \param[in] F the footprint
+	 * \param[in] c the corner
+	 * \return the coordinates of \p c, in cell units
+	 */
+	vec2 cell_coords(const Footprint& F, index_t c) const {
+	    double m = double(margin_in_cells_);
+	    return vec2(
+		(tex_coord_[2*c]   - F.u_min) / step_ + m,
+		(tex_coord_[2*c+1] - F.v_min) / step_ + m
+	    );
+	}
+
+	/**
+	 * \brief Rotates a cell by a multiple of 90 degrees.
+	 * \param[in] o the number of counterclockwise quarter turns.
+	 * \param[in] w , h the size of the unrotated footprint.
+	 * \param[in] x , y the cell in the unrotated footprint.
+	 * \param[out] X , Y the cell in the rotated footprint.
+	 */
+	static void rotate_cell(
+	    index_t o, index_t w, index_t h, index_t x, index_t y,
+	    index_t& X, index_t& Y
+	) {
+	    switch(o) {
+	    case 0:
+		X = x; Y = y;
+		break;
+	    case 1:
+		X = h-1-y; Y = x;
+		break;
+	    case 2:
+		X = w-1-x; Y = h-1-y;
+		break;
+	    default:
+		X = y; Y = w-1-x;
+		break;
+	    }
+	}
+
+	/**
+	 * \brief Rotates a point by a multiple of 90 degrees.
+	 * \details Continuous version of rotate_cell().
+	 * \param[in] o the number of counterclockwise quarter turns.
+	 * \param[in] w , h the size of the unrotated footprint.
+	 * \param[in] p the point in the unrotated footprint.
+	 * \return the point in the rotated footprint.
+	 */
+	static vec2 rotate_point(index_t o, double w, double h, const vec2& p) {
+	    switch(o) {
+	    case 0:
+		return p;
+	    case 1:
+		return vec2(h - p.y, p.x);
+	    case 2:
+		return vec2(w - p.x, h - p.y);
+	    default:
+		return vec2(p.y, w - p.x);
+	    }
+	}
+
+	/**
+	 * \brief Makes sure that the atlas has a given number of rows.
+	 * \details The padding bits on the right of the atlas are set,
+	 *  so that no footprint can exceed its width.
+	 * \param[in] nb_rows the minimum number of rows
+	 */
+	void reserve_rows(index_t nb_rows) {
+	    if(nb_rows <= nb_rows_) {
+		return;
+	    }
+	    atlas_.resize(nb_rows * nb_words_, 0);
+	    square_.resize(nb_rows * width_);
+	    max_square_.resize(nb_rows, geo_min(width_, max_square_size()));
+	    block_square_.resize(nb_rows * nb_blocks_);
+	    for(index_t y=nb_rows_; y<nb_rows; ++y) {
+		for(index_t x=0; x<width_; ++x) {
+		    square_[y*width_+x] = Numeric::uint16(
+			geo_min(width_ - x, max_square_size())
+		    );
+		}
+		Word* row = &atlas_[y*nb_words_];
+		for(index_t x=width_; x<nb_words_*64; ++x) {
+		    row[x/64] |= (Word(1) << (x%64));
+		}
+		for(index_t b=0; b<nb_blocks_; ++b) {
+		    block_square_[y*nb_blocks_+b] = Numeric::uint16(
+			geo_min(width_ - b*block_size(), max_square_size())
+		    );
+		}
+	    }
+	    nb_rows_ = nb_rows;
+	}
+
+	/**
+	 * \brief Marks the cells covered by a bitmask as occupied.
+	 * \param[in] mask the bitmask
+	 * \param[in] nb_words the number of words per row of \p mask
+	 * \param[in] height the number of rows of \p mask
+	 * \param[in] x , y the cell of the atlas where the 
+	 *  lower left corner of \p mask is placed
+	 */
+	void fill(
+	    const Word* mask, index_t nb_words, index_t height,
+	    index_t x, index_t y
+	) {
+	    index_t s = x % 64;
+	    index_t w0 = x / 64;
+	    for(index_t r=0; r<height; ++r) {
+		const Word* m = mask + r*nb_words;
+		Word* row = &atlas_[(y+r)*nb_words_ + w0];
+		Word carry = 0;
+		for(index_t i=0; i<nb_words; ++i) {
+		    Word shifted = (m[i] << s) | carry;
+		    carry = (s == 0) ? 0 : (m[i] >> (64 - s));
+		    row[i] |= shifted;
+		}
+		row[nb_words] |= carry;
+	    }
+	}
+
+	/**
+	 * \brief Tests whether a footprint overlaps occupied cells.
+	 * \param[in] F the footprint
+	 * \param[in] o the orientation of the footprint
+	 * \param[in] x , y the cell of the atlas where the lower left
+	 *  corner of the footprint is placed
+	 * \retval true if all the cells covered by the footprint are free
+	 * \retval false otherwise
+	 */
+	bool fits(const Footprint& F, index_t o, index_t x, index_t y) const {
+	    const vector<Run>& runs = F.runs[o];
+	    for(index_t k=0; k<runs.size(); ++k) {
+		const Run& R = runs[k];
+		if(
+		    !is_free(
+			&atlas_[(y + R.row)*nb_words_], x + R.begin, R.length
+		    )
+		) {
+		    return false;
+		}
+	    }
+	    return true;
+	}
+
+	/**
+	 * \brief Tests whether a range of cells of a row is free.
+	 * \details The range is tested 64 cells at a time.
+	 * \param[in] row a row of the atlas
+	 * \param[in] begin , length the range of cells
+	 * \retval true if all the cells of the range are free
+	 * \retval false otherwise
+	 */
+	static bool is_free(const Word* row, index_t begin, index_t length) {
+	    while(length != 0) {
+		index_t w = begin / 64;
+		index_t s = begin % 64;
+		Word bits = row[w] >> s;
+		if(s != 0) {
+		    bits |= row[w+1] << (64 - s);
+		}
+		index_t n = geo_min(length, index_t(64));
+		if(n < 64) {
+		    bits &= (Word(1) << n) - 1;
+		}
+		if(bits != 0) {
+		    return false;
+		}
+		begin += n;
+		length -= n;
+	    }
+	    return true;
+	}
+
+	/**
+	 * \brief Finds the leftmost position of a footprint in a row.
+	 * \details The lower left corner of the largest square of the 
+	 *  footprint needs to be placed on a cell with a large enough
+	 *  free square. Blocks of cells where there is no such cell 
+	 *  are skipped, and the footprint is only tested at the remaining
+	 *  candidate cells.
+	 * \param[in] F the footprint
+	 * \param[in] o the orientation of the footprint
+	 * \param[in] y the row of the atlas where the bottom of the 
+	 *  footprint should be placed
+	 * \param[out] x the leftmost position where the footprint does not
+	 *  overlap occupied cells, if there is one
+	 * \retval true if the footprint can be placed in row \p y
+	 * \retval false otherwise
+	 */
+	bool find_in_row(
+	    const Footprint& F, index_t o, index_t y, index_t& x
+	) const {
+	    index_t sq = geo_min(F.square[o], max_square_size());
+	    index_t sy = y + F.square_y[o];
+	    if(max_square_[sy] < sq) {
+		return false;
+	    }
+	    // Range of the cells where the largest square of the
+	    // footprint can be placed.
+	    index_t c_begin = F.square_x[o];
+	    index_t c_end = width_ - F.width[o] + F.square_x[o] + 1;
+	    const Numeric::uint16* square = &square_[sy*width_];
+	    const Numeric::uint16* block = &block_square_[sy*nb_blocks_];
+	    for(index_t b=c_begin/block_size(); b*block_size()<c_end; ++b) {
+		if(block[b] < sq) {
+		    continue;
+		}
+		index_t c0 = geo_max(c_begin, b*block_size());
+		index_t c1 = geo_min(c_end, (b+1)*block_size());
+		for(index_t c=c0; c<c1; ++c) {
+		    if(
+			square[c] >= sq && 
+			fits(F, o, c - F.square_x[o], y)
+		    ) {
+			x = c - F.square_x[o];
+			return true;
+		    }
+		}
+	    }
+	    return false;
+	}
+	
+	/**
+	 * \brief Finds the lowest position of the current footprint
+	 *  for each orientation in a range of rows.
+	 * \details This is the task executed by the threads. Task \p t 
+	 *  handles the t-th slice of the candidate rows. An orientation 
+	 *  is no longer searched once it cannot give a lower top than 
+	 *  the best position found so far (or the same top in the same 
+	 *  row, where a lower abscissa wins).
+	 * \param[in] t the index of the task
+	 */
+	void search_task(index_t t) {
+	    const Footprint& F = *current_;
+	    index_t y_begin = min_free_row_ + t * slice_size_;
+	    index_t y_end = geo_min(y_begin + slice_size_, height_ + 1);
+	    bool active[4];
+	    for(index_t o=0; o<4; ++o) {
+		task_x_[4*t+o] = index_t(-1);
+		task_y_[4*t+o] = index_t(-1);
+		active[o] = (F.width[o] <= width_);
+	    }
+	    index_t best_top = index_t(-1);
+	    index_t best_y = index_t(-1);
+	    for(index_t y=y_begin; y<y_end; ++y) {
+		bool any_active = false;
+		for(index_t o=0; o<4; ++o) {
+		    if(!active[o]) {
+			continue;
+		    }
+		    if(
+			best_top != index_t(-1) && (
+			    y + F.height[o] > best_top ||
+			    (y + F.height[o] == best_top && y > best_y)
+			)
+		    ) {
+			active[o] = false;
+			continue;
+		    }
+		    any_active = true;
+		    index_t x;
+		    if(find_in_row(F, o, y, x)) {
+			task_x_[4*t+o] = x;
+			task_y_[4*t+o] = y;
+			active[o] = false;
+			if(y + F.height[o] < best_top) {
+			    best_top = y + F.height[o];
+			    best_y = y;
+			}
+		    }
+		}
+		if(!any_active) {
+		    break;
+		}
+	    }
+	}
+
+	/**
+	 * \brief Gets the maximum size of the free squares stored 
+	 *  in the atlas.
+	 */
+	static index_t max_square_size() {
+	    return 65535;
+	}
+
+	/**
+	 * \brief Gets the number of cells in the blocks used to skip
+	 *  the parts of the rows without large enough free squares.
+	 */
+	static index_t block_size() {
+	    return 32;
+	}
+
+	/**
+	 * \brief Updates the size of the largest free squares after some
+	 *  cells were occupied.
+	 * \details square_[y*width_+x] is the size of the largest free
+	 *  square with (x,y) as its lower-left corner. It only depends on
+	 *  the rows above, thus rows are updated from top to bottom, until
+	 *  a row below the modified ones is unchanged. The maximum of 
+	 *  each block of cells and of each row are updated as well.
+	 * \param[in] y_begin , y_end the range of modified rows
+	 */
+	void update_squares(index_t y_begin, index_t y_end) {
+	    for(index_t y=y_end; y-- > 0; ) {
+		bool changed = false;
+		index_t row_max = 0;
+		index_t block_max = 0;
+		const Word* row = &atlas_[y*nb_words_];
+		for(index_t x=width_; x-- > 0; ) {
+		    index_t s = 0;
+		    if(((row[x/64] >> (x%64)) & Word(1)) == 0) {
+			index_t right = (x+1 < width_) ? 
+			    index_t(square_[y*width_+x+1]) : 0;
+			index_t up = max_square_size();
+			index_t up_right = max_square_size();
+			if(y+1 < nb_rows_) {
+			    up = square_[(y+1)*width_+x];
+			    up_right = (x+1 < width_) ? 
+				index_t(square_[(y+1)*width_+x+1]) : 0;
+			} else {
+			    up_right = (x+1 < width_) ? up_right : 0;
+			}
+			s = geo_min(
+			    1 + geo_min(right, geo_min(up, up_right)),
+			    max_square_size()
+			);
+		    }
+		    if(square_[y*width_+x] != s) {
+			square_[y*width_+x] = Numeric::uint16(s);
+			changed = true;
+		    }
+		    row_max = geo_max(row_max, s);
+		    if(x%block_size() == 0) {
+			block_square_[y*nb_blocks_+x/block_size()] = 
+			    Numeric::uint16(geo_max(block_max, s));
+			block_max = 0;
+		    } else {
+			block_max = geo_max(block_max, s);
+		    }
+		}
+		max_square_[y] = row_max;
+		if(!changed && y < y_begin) {
+		    break;
+		}
+	    }
+	}
+
+	/**
+	 * \brief Places a chart in the atlas.
+	 * \param[in] i the index of the footprint of the chart.
+	 */
+	void place(index_t i) {
+	    const Footprint& F = footprints_[i];
+	    current_ = &F;
+	    index_t max_h = geo_max(F.height[0], F.height[1]);
+	    reserve_rows(height_ + max_h + 1);
+
+	    // Candidate rows range from the lowest non-full row to the
+	    // top of the atlas (where a footprint always fits).
+	    index_t nb_candidate_rows = height_ + 1 - min_free_row_;
+	    index_t nb_slices = 1;
+	    if(nb_candidate_rows > 64) {
+		nb_slices = geo_min(
+		    Process::maximum_concurrent_threads(),
+		    nb_candidate_rows / 16
+		);
+		nb_slices = geo_max(nb_slices, index_t(1));
+	    }
+	    slice_size_ = (nb_candidate_rows + nb_slices - 1) / nb_slices;
+	    task_x_.assign(4*nb_slices, index_t(-1));
+	    task_y_.assign(4*nb_slices, index_t(-1));
+	    if(nb_slices == 1) {
+		search_task(0);
+	    } else {
+		parallel_for(
+		    parallel_for_member_callback(
+			this, &RasterPacker::search_task
+		    ),
+		    0, nb_slices
+		);
+	    }
+
+	    // Keep the position that minimizes the top of the chart,
+	    // then its bottom, then its abscissa, then its rotation.
+	    index_t best_o = index_t(-1);
+	    index_t best_x = 0;
+	    index_t best_y = 0;
+	    for(index_t t=0; t<4*nb_slices; ++t) {
+		if(task_y_[t] == index_t(-1)) {
+		    continue;
+		}
+		index_t o = t % 4;
+		index_t x = task_x_[t];
+		index_t y = task_y_[t];
+		if(
+		    best_o == index_t(-1) ||
+		    y + F.height[o] < best_y + F.height[best_o] ||
+		    (
+			y + F.height[o] == best_y + F.height[best_o] &&
+			(
+			    y < best_y ||
+			    (y == best_y && (x < best_x || 
+					     (x == best_x && o < best_o)))
+			)
+		    )
+		) {
+		    best_o = o;
+		    best_x = x;
+		    best_y = y;
+		}
+	    }
+	    geo_assert(best_o != index_t(-1));
+
+	    fill(
+		&F.core[best_o][0], F.nb_words[best_o], F.height[best_o],
+		best_x, best_y
+	    );
+	    orient_[i] = best_o;
+	    x_[i] = best_x;
+	    y_[i] = best_y;
+	    height_ = geo_max(height_, best_y + F.height[best_o]);
+	    update_squares(best_y, best_y + F.height[best_o]);
+	    
+	    // Skip the rows where no footprint can fit (all dilated
+	    // footprints contain a square of size 2*margin+1).
+	    while(
+		min_free_row_ < height_ &&
+		max_square_[min_free_row_] < 2*margin_in_cells_+1
+	    ) {
+		++min_free_row_;
+	    }
+	}
+
+	/**
+	 * \brief Applies the rotation and translation computed by
+	 *  the packing to the texture coordinates of a chart.
+	 * \param[in] i the index of the footprint of the chart.
+	 */
+	void update_tex_coords(index_t i) {
+	    const Footprint& F = footprints_[i];
+	    const Chart& chart = *F.chart;
+	    const Mesh& M = chart.mesh;
+	    double w = double(F.width[0]);
+	    double h = double(F.height[0]);
+	    vec2 t(double(x_[i]), double(y_[i]));
+	    for(index_t ff=0; ff<chart.facets.size(); ++ff) {
+		index_t f = chart.facets[ff];
+		for(
+		    index_t c = M.facets.corners_begin(f);
+		    c < M.facets.corners_end(f); ++c
+		) {
+		    vec2 p = rotate_point(orient_[i], w, h, cell_coords(F, c));
+		    p = step_ * (p + t);
+		    tex_coord_[2*c] = p.x;
+		    tex_coord_[2*c+1] = p.y;
+		}
+	    }
+	}
+	
+    private:
+        index_t image_size_in_pixels_;
+        index_t margin_width_in_pixels_;
+	index_t cell_size_in_pixels_;
+	index_t margin_in_cells_;
+	double step_;
+	
+	vector<Footprint> footprints_;
+	
+	index_t width_;
+	index_t nb_words_;
+	index_t nb_blocks_;
+	index_t nb_rows_;
+	index_t height_;
+	index_t min_free_row_;
+	vector<Word> atlas_;
+	vector<Numeric::uint16> square_;
+	vector<index_t> max_square_;
+	vector<Numeric::uint16> block_square_;
+
+	vector<index_t> x_;
+	vector<index_t> y_;
+	vector<index_t> orient_;
+
+	const Footprint* current_;
+	index_t slice_size_;
+	vector<index_t> task_x_;
+	vector<index_t> task_y_;
+	
+	Attribute<double> tex_coord_;
+    };
+
 /***********************************************************************/
 
 
     Packer::Packer() {
         image_size_in_pixels_ = 1024;
         margin_width_in_pixels_ = 4;
+	chart_packer_ = PACK_TETRIS;
     }
   
 
@@ -765,6 +1694,18 @@ namespace GEO {
             geo_assert(chart_is_ok(charts[i], tex_coord_));
         }
 
+	if(chart_packer_ == PACK_RASTER) {
+	    RasterPacker pack(mesh);
+	    pack.set_image_size_in_pixels(image_size_in_pixels());
+	    pack.set_margin_width_in_pixels(margin_width_in_pixels());
+	    for(index_t i=0; i<charts.size(); ++i) {
+		pack.add(&charts[i]);
+	    }
+	    pack.apply();
+	    show_filling_ratio(mesh);
+	    return;
+	}
+	
         // use the tetris packer (more efficient for large dataset)
         // set some application dependant const
         TetrisPacker pack(mesh);  
@@ -795,17 +1736,18 @@ namespace GEO {
         
         
         pack.recursive_apply();
+	show_filling_ratio(mesh);
+    }
 
-	{
-	    double total_area = Geom::mesh_area_2d(mesh, tex_coord_);
-	    double u_min, v_min, u_max, v_max;
-	    Geom::get_mesh_bbox_2d(mesh, tex_coord_, u_min, v_min, u_max, v_max);
-            double bbox_area = (u_max - u_min)*(v_max-v_min);
-            double filling_ratio = total_area / bbox_area;
-            Logger::out("Packer") << "BBox area:"  << bbox_area << std::endl;
-            Logger::out("Packer") << "Filling ratio:" 
-                                  << filling_ratio << std::endl;
-        }
+    void Packer::show_filling_ratio(Mesh& mesh) {
+	double total_area = Geom::mesh_area_2d(mesh, tex_coord_);
+	double u_min, v_min, u_max, v_max;
+	Geom::get_mesh_bbox_2d(mesh, tex_coord_, u_min, v_min, u_max, v_max);
+	double bbox_area = (u_max - u_min)*(v_max-v_min);
+	double filling_ratio = total_area / bbox_area;
+	Logger::out("Packer") << "BBox area:"  << bbox_area << std::endl;
+	Logger::out("Packer") << "Filling ratio:" 
+			      << filling_ratio << std::endl;
     }
 
     void Packer::normalize_chart(Chart& chart) {
@@ -57,6 +57,18 @@
 
 namespace GEO {
 
+    /**
+     * \brief Algorithm used to pack the charts in texture space.
+     * \details 
+     *  - PACK_TETRIS places the bounding boxes of the charts from bottom
+     *    to top using their lower and upper horizons.
+     *  - PACK_RASTER rasterizes the charts in bitmasks and searches the
+     *    lowest free position (and the best of the four 90 degrees 
+     *    rotations) for each chart in parallel.
+     */
+    enum ChartPacker {
+	PACK_TETRIS, PACK_RASTER
+    };
 
     /****************************************************************/
 
@@ -124,6 +136,22 @@ namespace GEO {
             margin_width_in_pixels_ = width;
         } 
 
+	/**
+	 * \brief Gets the algorithm used to pack the charts.
+	 * \return one of PACK_TETRIS, PACK_RASTER.
+	 */
+	ChartPacker chart_packer() const {
+	    return chart_packer_;
+	}
+
+	/**
+	 * \brief Sets the algorithm used to pack the charts.
+	 * \param[in] packer one of PACK_TETRIS (default), PACK_RASTER.
+	 */
+	void set_chart_packer(ChartPacker packer) {
+	    chart_packer_ = packer;
+	}
+
       protected:
 	/**
 	 * \brief Packs a set of charts.
@@ -145,10 +173,18 @@ namespace GEO {
 	 */
         void normalize_chart(Chart& chart);
 
+	/**
+	 * \brief Displays the ratio between the area covered by the charts
+	 *  and the area of their bounding box in parameter space.
+	 * \param[in] mesh the surface mesh.
+	 */
+	void show_filling_ratio(Mesh& mesh);
+
       private:
         double total_area_3d_ ;
         index_t image_size_in_pixels_ ;
         index_t margin_width_in_pixels_ ;
+	ChartPacker chart_packer_;
 	Attribute<double> tex_coord_;
 	Attribute<index_t> chart_attr_;
 	
@@ -46,15 +46,35 @@
 #include <geogram/parameterization/mesh_param_validator.h>
 #include <geogram/mesh/mesh.h>
 #include <geogram/mesh/mesh_geometry.h>
+#include <geogram/basic/process.h>
 #include <algorithm>
 
+namespace {
+
+    using namespace GEO;
+
+    /**
+     * \brief Minimum number of facets rasterized by each slice.
+     * \details Below this size, the cost of clearing and merging the
+     *  per-slice coverage buffers exceeds the gain.
+     */
+    const index_t min_facets_per_slice = 20000;
+}
+
 namespace GEO {
 
     ParamValidator::ParamValidator() {
         graph_size_ = 1024;
         graph_mem_ = new Numeric::uint8[graph_size_ * graph_size_];
-        x_left_  = new int[graph_size_];
-        x_right_ = new int[graph_size_];
+	nb_slices_ = 1;
+	chart_ = nil;
+	tex_coord_ = nil;
+	nb_bands_ = 1;
+	chart_width_ = 0;
+	chart_height_ = 0;
+	fill_ratio_ = 0.0;
+	overlap_ratio_ = 0.0;
+	nb_flipped_ = 0;
         max_overlap_ratio_ = 0.005;
         max_scaling_ = 20.0;
         min_fill_ratio_ = 0.25;
@@ -64,10 +84,6 @@ namespace GEO {
     ParamValidator::~ParamValidator() {
         delete[] graph_mem_;
 	graph_mem_ = nil;
-        delete[] x_left_;
-	x_left_ = nil;
-        delete[] x_right_;
-	x_right_ = nil;
     }
 
     bool ParamValidator::chart_is_valid(Chart& chart) {
@@ -101,6 +117,8 @@ namespace GEO {
 		<< "Fill ratio = " << fill_ratio() << std::endl;
 	    Logger::out("ParamValidator") 
 		<< "Overlap ratio = " << overlap_ratio() << std::endl;
+	    Logger::out("ParamValidator") 
+		<< "Flipped triangles = " << nb_flipped() << std::endl;
 	}
 
         double comp_scaling = chart_scaling(chart);
@@ -135,6 +153,17 @@ namespace GEO {
             return false;
         }
 
+        // Flipped triangles fold the parameterization onto itself, even
+	// when the overlapping area is too small to be detected, reject chart.
+        if(nb_flipped() != 0) {
+	    if(verbose_) {
+		Logger::out("ParamValidator")
+		    << "----> REJECT: flipped triangles"
+		    << std::endl;
+	    }
+            return false;
+        }
+
         if(Numeric::is_nan(comp_scaling) || comp_scaling > max_scaling_) {
 	    if(verbose_) {
 		Logger::out("ParamValidator")
@@ -194,7 +223,75 @@ namespace GEO {
 	tex_coord.bind_if_is_defined(chart.mesh.facet_corners.attributes(), "tex_coord");
 	geo_assert(tex_coord.is_bound() && tex_coord.dimension() == 2);
         begin_rasterizer(chart,tex_coord);
-	for(index_t ff=0; ff<chart.facets.size(); ++ff) {
+	parallel_for(
+	    parallel_for_member_callback(this, &ParamValidator::rasterize_slice),
+	    0, nb_slices_
+	);
+        end_rasterizer();
+    }
+
+    void ParamValidator::begin_rasterizer(Chart& chart, Attribute<double>& tex_coord) {
+	Memory::clear(graph_mem_, size_t(graph_size_ * graph_size_));
+	double xmin, ymin, xmax, ymax;
+	Geom::get_chart_bbox_2d(chart, tex_coord, xmin, ymin, xmax, ymax);
+        user_x_min_  = xmin;
+        user_y_min_  = ymin;
+        user_width_  = xmax - xmin;
+        user_height_ = ymax - ymin;
+        user_size_ = geo_max(user_width_, user_height_);
+        if(user_width_ > user_height_) {
+            chart_width_  = graph_size_;
+            chart_height_ = int(
+		(user_height_ * double(graph_size_)) / user_width_
+	    );
+        } else {
+            chart_height_ = graph_size_;
+            chart_width_  = int(
+		(user_width_ * double(graph_size_)) / user_height_
+	    );
+        }
+
+	// Small charts, and charts validated from concurrent threads
+	// (where parallel_for() is sequential), use a single slice.
+	nb_slices_ = 1;
+	if(
+	    !Process::is_running_threads() &&
+	    chart.facets.size() > min_facets_per_slice
+	) {
+	    nb_slices_ = geo_min(
+		Process::maximum_concurrent_threads(),
+		index_t(chart.facets.size() / min_facets_per_slice)
+	    );
+	}
+	nb_bands_ = (nb_slices_ == 1) ? 1 : 4 * nb_slices_;
+	slice_mem_.assign(
+	    size_t(nb_slices_ - 1) * size_t(graph_size_ * graph_size_), 0
+	);
+	slice_nb_ccw_.assign(nb_slices_, 0);
+	slice_nb_cw_.assign(nb_slices_, 0);
+	slice_signed_area_.assign(nb_slices_, 0.0);
+	band_filled_.assign(nb_bands_, 0);
+	band_overlapped_.assign(nb_bands_, 0);
+	chart_ = &chart;
+	tex_coord_ = &tex_coord;
+    }
+
+    void ParamValidator::rasterize_slice(index_t slice) {
+	const Chart& chart = *chart_;
+	const Attribute<double>& tex_coord = *tex_coord_;
+	size_t slice_size = size_t(graph_size_ * graph_size_);
+	Numeric::uint8* graph_mem = (slice == 0) ? graph_mem_ :
+	    slice_mem_.data() + size_t(slice-1) * slice_size;
+	vector<int> x_left(index_t(graph_size_), 0);
+	vector<int> x_right(index_t(graph_size_), 0);
+	index_t nb_facets = index_t(chart.facets.size());
+	index_t ff_begin = index_t(
+	    (Numeric::uint64(slice) * nb_facets) / nb_slices_
+	);
+	index_t ff_end = index_t(
+	    (Numeric::uint64(slice+1) * nb_facets) / nb_slices_
+	);
+	for(index_t ff=ff_begin; ff<ff_end; ++ff) {
 	    index_t f = chart.facets[ff];
 	    index_t c1 = chart.mesh.facets.corners_begin(f);
 	    vec2 p1(tex_coord[2*c1], tex_coord[2*c1+1]);
@@ -204,21 +301,50 @@ namespace GEO {
 		index_t c3=c2+1;
 		vec2 p2(tex_coord[2*c2], tex_coord[2*c2+1]);
 		vec2 p3(tex_coord[2*c3], tex_coord[2*c3+1]);
-		rasterize_triangle(p1,p2,p3);
+		double A = Geom::triangle_signed_area(p1,p2,p3);
+		slice_signed_area_[slice] += A;
+		if(A > 0.0) {
+		    ++slice_nb_ccw_[slice];
+		} else if(A < 0.0) {
+		    ++slice_nb_cw_[slice];
+		}
+		rasterize_triangle(
+		    p1, p2, p3, graph_mem, x_left.data(), x_right.data()
+		);
 	    }
 	}
-        end_rasterizer();
     }
 
-    void ParamValidator::begin_rasterizer(Chart& chart, Attribute<double>& tex_coord) {
-	Memory::clear(graph_mem_, size_t(graph_size_ * graph_size_));
-	double xmin, ymin, xmax, ymax;
-	Geom::get_chart_bbox_2d(chart, tex_coord, xmin, ymin, xmax, ymax);
-        user_x_min_  = xmin;
-        user_y_min_  = ymin;
-        user_width_  = xmax - xmin;
-        user_height_ = ymax - ymin;
-        user_size_ = geo_max(user_width_, user_height_);
+    void ParamValidator::merge_band(index_t band) {
+	int y_begin = int(
+	    (Numeric::uint64(band) * Numeric::uint64(chart_height_)) /
+	    nb_bands_
+	);
+	int y_end = int(
+	    (Numeric::uint64(band+1) * Numeric::uint64(chart_height_)) /
+	    nb_bands_
+	);
+	size_t slice_size = size_t(graph_size_ * graph_size_);
+	index_t nb_filled = 0;
+	index_t nb_overlapped = 0;
+	for(int y=y_begin; y<y_end; ++y) {
+	    for(int x=0; x<chart_width_; ++x) {
+		size_t offset = size_t(y * graph_size_ + x);
+		index_t pixel = graph_mem_[offset];
+		for(index_t s=1; s<nb_slices_; ++s) {
+		    pixel += slice_mem_.data()[size_t(s-1)*slice_size + offset];
+		}
+		if(pixel > 0) {
+		    nb_filled++;
+		    if(pixel > 1) {
+			nb_overlapped++;
+		    }
+		}
+		graph_mem_[offset] = Numeric::uint8(geo_min(pixel, index_t(255)));
+	    }
+	}
+	band_filled_[band] = nb_filled;
+	band_overlapped_[band] = nb_overlapped;
     }
 
     
@@ -230,7 +356,8 @@ namespace GEO {
     }
     
     void ParamValidator::rasterize_triangle(
-        const vec2& p1, const vec2& p2, const vec2& p3
+        const vec2& p1, const vec2& p2, const vec2& p3,
+	Numeric::uint8* graph_mem, int* x_left, int* x_right
     ) {
         int x[3];
         int y[3];
@@ -300,7 +427,7 @@ namespace GEO {
             int X = x1;
             int Y = y1;
             
-            int* line_x = is_left ? x_left_ : x_right_;
+            int* line_x = is_left ? x_left : x_right;
             line_x[Y] = X;
             
             int e = dy - 2 * dx;
@@ -320,41 +447,45 @@ namespace GEO {
             line_x[y2] = x2;
         }
         
+        // Counters saturate instead of wrapping around.
         for(int Y = ymin; Y < ymax; ++Y) {
-            for(int X = x_left_[Y]; X < x_right_[Y]; ++X) {
-                graph_mem_[Y * graph_size_ + X]++;
+            for(int X = x_left[Y]; X < x_right[Y]; ++X) {
+                Numeric::uint8& pixel = graph_mem[Y * graph_size_ + X];
+                if(pixel != 255) {
+                    ++pixel;
+                }
             }
         }
     }
     
     void ParamValidator::end_rasterizer() {
-        int nb_filled = 0;
-        int nb_overlapped = 0;
-        int width = 0;
-        int height = 0;
-        if(user_width_ > user_height_) {
-            width  = graph_size_;
-            height = int((user_height_ * double(graph_size_)) / user_width_);
-        } else {
-            height = graph_size_;
-            width  = int((user_width_ * double(graph_size_)) / user_height_);
-        }
-
-        for(int x=0; x<width; x++) {
-            for(int y=0; y<height; y++) {
-                Numeric::uint8 pixel = graph_mem_[y * graph_size_ + x];
-                if(pixel > 0) {
-                    nb_filled++;
-                    if(pixel > 1) {
-                        nb_overlapped++;
-                    }
-                }
-            }
-        }
-
-        fill_ratio_ = double(nb_filled) / double(width * height);
-        overlap_ratio_ = double(nb_overlapped) / double(width * height);
+	parallel_for(
+	    parallel_for_member_callback(this, &ParamValidator::merge_band),
+	    0, nb_bands_
+	);
+	chart_ = nil;
+	tex_coord_ = nil;
+	
+        index_t nb_filled = 0;
+        index_t nb_overlapped = 0;
+	for(index_t band=0; band<nb_bands_; ++band) {
+	    nb_filled += band_filled_[band];
+	    nb_overlapped += band_overlapped_[band];
+	}
+	double nb_pixels = double(chart_width_) * double(chart_height_);
+        fill_ratio_ = double(nb_filled) / nb_pixels;
+        overlap_ratio_ = double(nb_overlapped) / nb_pixels;
+
+	// The orientation of the chart is the one of the largest part of
+	// its area, triangles with the other orientation are flipped.
+	double signed_area = 0.0;
+	index_t nb_ccw = 0;
+	index_t nb_cw = 0;
+	for(index_t slice=0; slice<nb_slices_; ++slice) {
+	    signed_area += slice_signed_area_[slice];
+	    nb_ccw += slice_nb_ccw_[slice];
+	    nb_cw += slice_nb_cw_[slice];
+	}
+	nb_flipped_ = (signed_area >= 0.0) ? nb_cw : nb_ccw;
     }
 }
-
-
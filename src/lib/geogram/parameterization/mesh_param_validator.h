@@ -83,6 +83,8 @@ namespace GEO {
 	 * \details The mesh this chart belongs to is supposed to have a
 	 *  2d vector attribute "tex_coord" attached to the 
 	 *  vertices of the mesh with the texture coordinates.
+	 *  Charts with flipped triangles are rejected, as well as charts
+	 *  that do not satisfy the thresholds on overlap, scaling and filling.
 	 * \retval true if texture coordinates define a valid parameterization.
 	 * \retval false otherwise.
 	 */
@@ -101,13 +103,16 @@ namespace GEO {
 	 *  parameterized chart.
 	 * \details The filling and overlapping ratio are stored in this 
 	 *  ParamValidator and can be subsequently queried with fill_ratio() 
-	 *  and overlap_ratio() respectively.
+	 *  and overlap_ratio() respectively. The number of flipped triangles
+	 *  is computed in the same pass and can be queried with nb_flipped().
+	 *  The facets are split into slices rasterized in parallel, each
+	 *  one in its own pixel buffer, and the buffers are then merged.
 	 */
         void compute_fill_and_overlap_ratio(Chart& chart);
 
 	/**
 	 * \brief Gets the computed filling ratio.
-	 * \details chart_is_valid() or compute_fill_and_overlap_ration() 
+	 * \details chart_is_valid() or compute_fill_and_overlap_ratio() 
 	 *  need to be called before.
 	 * \return The ratio between the area used by the triangles in 
 	 *  parameter space and the total area of the bounding rectangle.
@@ -118,7 +123,7 @@ namespace GEO {
 
 	/**
 	 * \brief Gets the computed overlap ratio.
-	 * \details chart_is_valid() or compute_fill_and_overlap_ration() 
+	 * \details chart_is_valid() or compute_fill_and_overlap_ratio() 
 	 *  need to be called before.
 	 * \return The ratio between the area that correspond to overlapping 
 	 *  triangles in parameter space and the total area of the bounding 
@@ -128,6 +133,18 @@ namespace GEO {
 	    return overlap_ratio_;
 	}
 
+	/**
+	 * \brief Gets the computed number of flipped triangles.
+	 * \details chart_is_valid() or compute_fill_and_overlap_ratio() 
+	 *  need to be called before.
+	 * \return The number of triangles (facets are triangulated) that 
+	 *  have in parameter space the orientation opposite to the one of
+	 *  the chart.
+	 */
+	index_t nb_flipped() const {
+	    return nb_flipped_;
+	}
+
 	/**
 	 * \brief Gets the maximum overlapping ratio.
 	 * \details If the overlapping ratio is greater than this threshold 
@@ -220,10 +237,26 @@ namespace GEO {
 	 */
         void begin_rasterizer(Chart& chart, Attribute<double>& tex_coord);
 
+	/**
+	 * \brief Rasterizes a slice of the facets of the current chart.
+	 * \details Slice 0 is rasterized in graph_mem_ and the other ones
+	 *  in slice_mem_. This also counts the triangles of each orientation.
+	 * \param[in] slice the index of the slice
+	 */
+	void rasterize_slice(index_t slice);
+
+	/**
+	 * \brief Merges the pixel buffers of all the slices in a band of
+	 *  scanlines, and counts the filled and overlapped pixels of the 
+	 *  band.
+	 * \param[in] band the index of the band
+	 */
+	void merge_band(index_t band);
+	
 	/**
 	 * \brief Terminates the software rasterizer.
-	 * \details This counts the pixels to evaluate the filling and 
-	 *  overlapping ratio.
+	 * \details This merges and counts the pixels to evaluate the 
+	 *  filling and overlapping ratio.
 	 */
         void end_rasterizer();
 
@@ -233,9 +266,14 @@ namespace GEO {
 	 *  and overlapping ratio.
 	 * \param[in] p1 , p2 , p3 the 2d coordinates of the vertices of the
 	 *  triangle.
+	 * \param[in,out] graph_mem the pixel buffer
+	 * \param[out] x_left , x_right two arrays of dimension graph_size_
+	 *  used to store the left and right X pixel coordinates of the
+	 *  scanlines
 	 */
         void rasterize_triangle(
-            const vec2& p1, const vec2& p2, const vec2& p3
+            const vec2& p1, const vec2& p2, const vec2& p3,
+	    Numeric::uint8* graph_mem, int* x_left, int* x_right
         );
 
 	/**
@@ -259,16 +297,49 @@ namespace GEO {
         Numeric::uint8* graph_mem_;
 
 	/**
-	 * \brief A pointer to an array of dimension graph_size_ with 
-	 *  the left X pixel coordinate of the scanline,
-	 */  
-        int* x_left_;
+	 * \brief The number of slices of facets rasterized in parallel.
+	 */
+	index_t nb_slices_;
 
 	/**
-	 * \brief A pointer to an array of dimension graph_size_ with 
-	 *  the right X pixel coordinate of the scanline,
-	 */  
-        int* x_right_;
+	 * \brief The pixel buffers of slices 1 to nb_slices_-1, 
+	 *  one after the other.
+	 */
+	vector<Numeric::uint8> slice_mem_;
+
+	/**
+	 * \brief The current chart.
+	 */
+	Chart* chart_;
+
+	/**
+	 * \brief The texture coordinates of the current chart.
+	 */
+	Attribute<double>* tex_coord_;
+	
+	/**
+	 * \brief For each slice, the number of triangles with a positive
+	 *  and negative signed area in parameter space.
+	 */
+	vector<index_t> slice_nb_ccw_;
+	vector<index_t> slice_nb_cw_;
+
+	/**
+	 * \brief For each slice, the sum of the signed areas of the 
+	 *  triangles in parameter space.
+	 */
+	vector<double> slice_signed_area_;
+
+	/**
+	 * \brief The number of bands of scanlines merged in parallel.
+	 */
+	index_t nb_bands_;
+	
+	/**
+	 * \brief For each band, the number of filled and overlapped pixels.
+	 */
+	vector<index_t> band_filled_;
+	vector<index_t> band_overlapped_;
 
 	/**
 	 * \brief Viewport lower-left corner x coordinate.
@@ -295,6 +366,13 @@ namespace GEO {
 	 */
         double user_size_;
 
+	/**
+	 * \brief Width and height of the part of the rasterizer covered
+	 *  by the bounding box of the chart, in pixels.
+	 */
+	int chart_width_;
+	int chart_height_;
+
 	/**
 	 * \brief The computed filling ratio.
 	 */
@@ -305,6 +383,11 @@ namespace GEO {
 	 */
         double overlap_ratio_;
 
+	/**
+	 * \brief The computed number of flipped triangles.
+	 */
+	index_t nb_flipped_;
+
 	/**
 	 * \brief Maximum tolerated overlapping ratio.
 	 */
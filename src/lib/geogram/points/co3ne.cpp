@@ -59,6 +59,7 @@
 #include <geogram/basic/command_line.h>
 #include <geogram/basic/algorithm.h>
 #include <geogram/basic/stopwatch.h>
+#include <geogram/basic/profiler.h>
 #include <stack>
 #include <queue>
 
@@ -2779,6 +2780,7 @@ namespace GEO {
     }
 
     void Co3Ne_reconstruct(Mesh& M, double radius) {
+        geo_profile_scope("Co3Ne_reconstruct");
         Co3Ne co3ne(M);
 	co3ne.reconstruct(radius);
     }
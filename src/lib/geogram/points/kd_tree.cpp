@@ -132,6 +132,7 @@ namespace GEO {
     void KdTree::set_points(
         index_t nb_points, const double* points, index_t stride
     ) {
+        geo_memory_tag("kd-tree");
         nb_points_ = nb_points;
         points_ = points;
         stride_ = stride;
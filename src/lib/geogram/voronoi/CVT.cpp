@@ -50,6 +50,7 @@
 #include <geogram/numerics/optimizer.h>
 #include <geogram/basic/progress.h>
 #include <geogram/basic/argused.h>
+#include <geogram/basic/profiler.h>
 #include <geogram/bibliography/bibliography.h>
 
 /****************************************************************************/
@@ -137,6 +138,7 @@ namespace GEO {
     }
 
     void CentroidalVoronoiTesselation::Lloyd_iterations(index_t nb_iter) {
+        geo_profile_scope("CVT Lloyd");
         index_t nb_points = index_t(points_.size() / dimension_);
 
         vector<double> mg;
@@ -278,6 +280,7 @@ namespace GEO {
     void CentroidalVoronoiTesselation::Newton_iterations(
         index_t nb_iter, index_t m
     ) {
+        geo_profile_scope("CVT Newton");
         Optimizer_var optimizer = Optimizer::create("HLBFGS");
 	if(optimizer.is_nil()) {
 	    Logger::warn("CVT") << "This geogram was not compiled with HLBFGS"
@@ -341,6 +344,7 @@ namespace GEO {
             RVD_->compute_CVT_func_grad(f, g);
         }
         constrain_points(g);
+        geo_profile_counter("CVT energy", f);
     }
 
     void CentroidalVoronoiTesselation::newiteration() {
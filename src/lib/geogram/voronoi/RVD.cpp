@@ -375,6 +375,7 @@ namespace {
         };
 
         virtual void compute_centroids_on_surface(double* mg, double* m) {
+            geo_memory_tag("RVD");
             create_threads();
             if(nb_parts() == 0) {
                 if(master_ != nil) {
@@ -504,6 +505,7 @@ namespace {
         };
 
         virtual void compute_centroids_in_volume(double* mg, double* m) {
+            geo_memory_tag("RVD");
             create_threads();
             if(nb_parts() == 0) {
                 if(master_ != nil) {
@@ -730,6 +732,7 @@ namespace {
         };
 
         virtual void compute_CVT_func_grad_on_surface(double& f, double* g) {
+            geo_memory_tag("RVD");
             create_threads();
             if(nb_parts() == 0) {
                 if(master_ != nil) {
@@ -882,6 +885,7 @@ namespace {
         };
 
         virtual void compute_CVT_func_grad_in_volume(double& f, double* g) {
+            geo_memory_tag("RVD");
             create_threads();
             if(nb_parts() == 0) {
                 if(master_ != nil) {
@@ -1005,6 +1009,7 @@ namespace {
         virtual void compute_integration_simplex_func_grad(
             double& f, double* g, IntegrationSimplex* F
         ) {
+            geo_memory_tag("RVD");
             create_threads();
             if(nb_parts() == 0) {
                 if(master_ == nil) {
@@ -1110,6 +1115,7 @@ namespace {
         virtual void compute_with_polygon_callback(
 	    GEO::RVDPolygonCallback& polygon_callback
         ) {
+            geo_memory_tag("RVD");
             create_threads();
             if(nb_parts() == 0) {
 		PolygonCallbackAction action(RVD_,polygon_callback);
@@ -1137,6 +1143,7 @@ namespace {
         virtual void compute_with_polyhedron_callback(
 	    GEO::RVDPolyhedronCallback& polyhedron_callback
         ) {
+            geo_memory_tag("RVD");
             create_threads();
             if(nb_parts() == 0) {
 		RVD_.for_each_polyhedron(polyhedron_callback);
@@ -1451,6 +1458,7 @@ namespace {
             Mesh& M, coord_index_t dim, bool cell_borders_only,
             bool integration_simplices
         ) {
+            geo_memory_tag("RVD");
             bool sym = RVD_.symbolic();
             RVD_.set_symbolic(true);
             if(volumetric_) {
@@ -1740,8 +1748,9 @@ namespace {
 
             //   Step 2.2: get two-ring neighborhood
             stars_.resize(mesh_->vertices.nb());
+            Memory::ArenaScope arena_scope;
             for(index_t i = 0; i < stars2.size(); i++) {
-                vector<index_t> Ni;
+                std::vector<index_t, Memory::arena_allocator<index_t> > Ni;
                 for(index_t j = 0; j < stars2[i].size(); j++) {
                     index_t t = stars2[i][j];
                     for(index_t iv = 0; iv < 3; iv++) {
@@ -2312,6 +2321,7 @@ namespace {
             const vector<bool>& seed_is_locked,
             MeshFacetsAABB* AABB
         ) {
+            geo_memory_tag("RVD");
             if(volumetric_) {
                 // For the moment, only simple mode is supported
                 simplices.clear();
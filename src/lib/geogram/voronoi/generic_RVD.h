@@ -126,6 +126,7 @@ namespace GEOGen {
             GEO::Mesh* mesh
         ) :
             mesh_(mesh),
+            vertex_weight_key_("weight"),
             delaunay_(delaunay),
             intersections_(DIM),
             symbolic_(false),
@@ -1362,9 +1363,8 @@ namespace GEOGen {
             FacetSeedStack adjacent_facets;
             SeedStack adjacent_seeds;
             Polygon F;
-            GEO::Attribute<double> vertex_weight;
-            vertex_weight.bind_if_is_defined(
-		mesh_->vertices.attributes(), "weight"
+            GEO::ReadOnlyAttributeView<double> vertex_weight(
+		mesh_->vertices.attributes(), vertex_weight_key_
 	    );
 
             // The algorithm propagates along both the facet-graph of
@@ -1515,9 +1515,8 @@ namespace GEOGen {
             TetSeedStack adjacent_tets;
             SeedStack adjacent_seeds;
             Polyhedron C(dimension());
-            GEO::Attribute<double> vertex_weight;
-            vertex_weight.bind_if_is_defined(
-		mesh_->vertices.attributes(), "weight"
+            GEO::ReadOnlyAttributeView<double> vertex_weight(
+		mesh_->vertices.attributes(), vertex_weight_key_
 	    );
             
             current_polyhedron_ = &C;
@@ -1667,8 +1666,15 @@ namespace GEOGen {
             current_polyhedron_ = nil;
             init_get_neighbors();
 
-            std::deque<TetSeed> adjacent_seeds;
-            std::stack<index_t> adjacent_tets;
+            // The queues grow and shrink continuously during the
+            // traversal, they are allocated in the arena of the thread.
+            GEO::Memory::ArenaScope arena_scope;
+            std::deque<TetSeed, GEO::Memory::arena_allocator<TetSeed> >
+                adjacent_seeds;
+            std::stack<
+                index_t,
+                std::deque<index_t, GEO::Memory::arena_allocator<index_t> >
+            > adjacent_tets;
 
             static const index_t NO_STAMP = index_t(-1);
             GEO::vector<index_t> tet_stamp(
@@ -1689,9 +1695,8 @@ namespace GEOGen {
             current_connected_component_ = 0;
             // index_t C_index = tets_end_ + 1; // Unused (see comment later)
 
-            GEO::Attribute<double> vertex_weight;
-            vertex_weight.bind_if_is_defined(
-		mesh_->vertices.attributes(),"weight"
+            GEO::ReadOnlyAttributeView<double> vertex_weight(
+		mesh_->vertices.attributes(), vertex_weight_key_
 	    );
             
             // The algorithm propagates along both the facet-graph of
@@ -1897,8 +1902,15 @@ namespace GEOGen {
             current_polygon_ = nil;
             init_get_neighbors();
 
-            std::deque<FacetSeed> adjacent_seeds;
-            std::stack<index_t> adjacent_facets;
+            // The queues grow and shrink continuously during the
+            // traversal, they are allocated in the arena of the thread.
+            GEO::Memory::ArenaScope arena_scope;
+            std::deque<FacetSeed, GEO::Memory::arena_allocator<FacetSeed> >
+                adjacent_seeds;
+            std::stack<
+                index_t,
+                std::deque<index_t, GEO::Memory::arena_allocator<index_t> >
+            > adjacent_facets;
 
             static const index_t NO_STAMP = index_t(-1);
             GEO::vector<index_t> facet_stamp(
@@ -1914,9 +1926,8 @@ namespace GEOGen {
             current_connected_component_ = 0;
             index_t F_index = facets_end_ + 1;
 
-            GEO::Attribute<double> vertex_weight;
-            vertex_weight.bind_if_is_defined(
-		mesh_->vertices.attributes(),"weight"
+            GEO::ReadOnlyAttributeView<double> vertex_weight(
+		mesh_->vertices.attributes(), vertex_weight_key_
 	    );
             
             // The algorithm propagates along both the facet-graph of
@@ -2470,6 +2481,8 @@ namespace GEOGen {
 
     protected:
         GEO::Mesh* mesh_;
+        /** \brief Key of the vertex attribute that stores the weights */
+        GEO::AttributeKey vertex_weight_key_;
         Delaunay* delaunay_;
         GEO::Delaunay_NearestNeighbors* delaunay_nn_;
 
@@ -213,7 +213,7 @@ namespace GEOGen {
 
     void ConvexCell::initialize_from_mesh_tetrahedron(
         const Mesh* mesh, index_t t, bool symbolic,
-        const GEO::Attribute<double>& vertex_weight
+        const GEO::ReadOnlyAttributeView<double>& vertex_weight
     ) {
         clear();
 
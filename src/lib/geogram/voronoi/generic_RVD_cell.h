@@ -53,6 +53,7 @@
 #include <geogram/basic/attributes.h>
 #include <iosfwd>
 #include <stack>
+#include <deque>
 
 /**
  * \file geogram/voronoi/generic_RVD_cell.h
@@ -236,7 +237,7 @@ namespace GEOGen {
          */
         void initialize_from_mesh_tetrahedron(
             const Mesh* mesh, index_t t, bool symbolic,
-            const GEO::Attribute<double>& vertex_weight
+            const GEO::ReadOnlyAttributeView<double>& vertex_weight
         );
 
 
@@ -1122,7 +1123,13 @@ namespace GEOGen {
                 return;
             }
 
-            std::stack<index_t> S;
+            // This function is called for each clipping plane, the stack
+            // is allocated in the arena of the thread.
+            GEO::Memory::ArenaScope arena_scope;
+            std::stack<
+                index_t,
+                std::deque<index_t, GEO::Memory::arena_allocator<index_t> >
+            > S;
             S.push(first_t);
             append_triangle_to_conflict_list(
                 first_t, conflict_begin, conflict_end
@@ -1351,6 +1351,23 @@ namespace GEO {
 		long_vector_attribute_ = true;
             }
         }
+
+        // Quantized attributes (and float16 attributes if GL does not
+        // support half floats) cannot be sent as is to GL, they are
+        // decoded on the CPU in immediate mode.
+        if(
+            scalar_attribute_.is_bound() && (
+                scalar_attribute_.element_type() ==
+                ReadOnlyScalarAttributeAdapter::ET_QUANTIZED16
+#ifndef GL_HALF_FLOAT
+                || scalar_attribute_.element_type() ==
+                ReadOnlyScalarAttributeAdapter::ET_FLOAT16
+#endif
+            )
+        ) {
+            scalar_attribute_.unbind();
+            long_vector_attribute_ = true;
+        }
         
         if(scalar_attribute_.is_bound()) {
             size_t element_size = scalar_attribute_.attribute_store()->element_size();
@@ -1435,6 +1452,13 @@ namespace GEO {
                 2, dimension, GL_FLOAT, GL_FALSE, stride, offset
             );
             break;
+        case ReadOnlyScalarAttributeAdapter::ET_FLOAT16:
+#ifdef GL_HALF_FLOAT
+            glVertexAttribPointer(
+                2, dimension, GL_HALF_FLOAT, GL_FALSE, stride, offset
+            );
+#endif
+            break;
         case ReadOnlyScalarAttributeAdapter::ET_FLOAT64:
         case ReadOnlyScalarAttributeAdapter::ET_VEC2:
         case ReadOnlyScalarAttributeAdapter::ET_VEC3:                        
@@ -1448,6 +1472,7 @@ namespace GEO {
             );
 #endif            
             break;
+        case ReadOnlyScalarAttributeAdapter::ET_QUANTIZED16:
         case ReadOnlyScalarAttributeAdapter::ET_NONE:
             geo_assert_not_reached;
         }
@@ -0,0 +1,199 @@
+/*
+ *  Copyright (c) 2012-2014, Bruno Levy
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *  this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *  this list of conditions and the following disclaimer in the documentation
+ *  and/or other materials provided with the distribution.
+ *  * Neither the name of the ALICE Project-Team nor the names of its
+ *  contributors may be used to endorse or promote products derived from this
+ *  software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     Bruno.Levy@inria.fr
+ *     http://www.loria.fr/~levy
+ *
+ *     ALICE Project
+ *     LORIA, INRIA Lorraine, 
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX 
+ *     FRANCE
+ *
+ */
+
+
+
+#include <geogram/basic/common.h>
+#include <geogram/basic/logger.h>
+#include <geogram/basic/command_line.h>
+#include <geogram/basic/command_line_args.h>
+#include <geogram/basic/stopwatch.h>
+#include <geogram/basic/geometry_nd.h>
+#include <geogram/mesh/mesh.h>
+#include <exploragram/optimal_transport/optimal_transport_3d.h>
+#include <exploragram/optimal_transport/optimal_transport_discrete.h>
+
+#include <cstdlib>
+
+namespace {
+
+    using namespace GEO;
+
+    /**
+     * \brief Creates a tetrahedral mesh of the unit cube.
+     * \param[out] M the mesh
+     * \param[in] K number of cubes along each axis, each
+     *  cube is decomposed into 6 tetrahedra
+     */
+    void create_cube(Mesh& M, index_t K) {
+        static const index_t tets[6][4] = {
+            {0,1,3,7}, {0,1,5,7}, {0,2,3,7},
+            {0,2,6,7}, {0,4,5,7}, {0,4,6,7}
+        };
+        M.clear();
+        M.vertices.set_dimension(3);
+        for(index_t k=0; k<=K; ++k) {
+            for(index_t j=0; j<=K; ++j) {
+                for(index_t i=0; i<=K; ++i) {
+                    index_t v = M.vertices.create_vertex();
+                    double* p = M.vertices.point_ptr(v);
+                    p[0] = double(i) / double(K);
+                    p[1] = double(j) / double(K);
+                    p[2] = double(k) / double(K);
+                }
+            }
+        }
+        for(index_t k=0; k<K; ++k) {
+            for(index_t j=0; j<K; ++j) {
+                for(index_t i=0; i<K; ++i) {
+                    index_t c[8];
+                    for(index_t b=0; b<8; ++b) {
+                        c[b] = ((k + ((b>>2)&1)) * (K+1) + j + ((b>>1)&1)) *
+                            (K+1) + i + (b&1);
+                    }
+                    for(index_t t=0; t<6; ++t) {
+                        M.cells.create_tet(
+                            c[tets[t][0]], c[tets[t][1]],
+                            c[tets[t][2]], c[tets[t][3]]
+                        );
+                    }
+                }
+            }
+        }
+        M.cells.connect();
+    }
+
+    /**
+     * \brief Generates random points in the unit cube.
+     * \param[in] nb number of points
+     * \param[out] points the 3*nb coordinates of the points
+     * \param[in] skew if true, the first coordinate is squared, so that
+     *  the transport from the uniform measure is not trivial
+     */
+    void random_points(index_t nb, vector<double>& points, bool skew) {
+        points.resize(3*nb);
+        for(index_t i=0; i<3*nb; ++i) {
+            double x = Numeric::random_float64();
+            points[i] = (skew && (i%3 == 0)) ? x*x : x;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    using namespace GEO;
+
+    GEO::initialize();
+
+    try {
+        CmdLine::import_arg_group("standard");
+        CmdLine::import_arg_group("algo");
+        CmdLine::declare_arg("nb_points", 5000, "number of target points");
+        CmdLine::declare_arg(
+            "nb_samples", 20000, "number of samples of the source measure"
+        );
+        CmdLine::declare_arg("grid_size", 10, "cubes along each axis");
+        CmdLine::declare_arg("epsilon", 1e-3, "entropic regularization");
+        CmdLine::declare_arg("nb_neighbors", 30, "kernel truncation");
+        if(!CmdLine::parse(argc, argv)) {
+            return 1;
+        }
+
+        index_t N = CmdLine::get_arg_uint("nb_points");
+        index_t M = CmdLine::get_arg_uint("nb_samples");
+
+        Numeric::random_reset();
+        vector<double> points;
+        random_points(N, points, true);
+
+        // Semi-discrete: uniform measure in the cube -> points.
+        Mesh omega;
+        create_cube(omega, CmdLine::get_arg_uint("grid_size"));
+        vector<double> Laguerre_centroids(3*N);
+        double t0 = SystemStopwatch::now();
+        compute_Laguerre_centroids_3d(
+            &omega, N, points.data(), Laguerre_centroids.data()
+        );
+        double t_semi_discrete = SystemStopwatch::now() - t0;
+
+        // Discrete: uniform samples in the cube -> points.
+        vector<double> samples;
+        random_points(M, samples, false);
+        DiscreteOptimalTransport OT(3);
+        OT.set_source(M, samples.data());
+        OT.set_target(N, points.data());
+        OT.set_epsilon(CmdLine::get_arg_double("epsilon"));
+        OT.set_nb_neighbors(CmdLine::get_arg_uint("nb_neighbors"));
+        OT.set_verbose(true);
+        t0 = SystemStopwatch::now();
+        bool converged = OT.optimize();
+        double t_discrete = SystemStopwatch::now() - t0;
+        vector<double> barycenters(3*N);
+        OT.compute_target_barycenters(barycenters.data());
+
+        // The barycenters of the samples transported to each point
+        // approximate the centroids of the Laguerre cells.
+        double avg_dist = 0.0;
+        for(index_t j=0; j<N; ++j) {
+            avg_dist += Geom::distance(
+                &barycenters[3*j], &Laguerre_centroids[3*j], 3
+            ) / double(N);
+        }
+
+        Logger::out("OT") << "semi-discrete: " << t_semi_discrete << " s"
+                          << std::endl;
+        Logger::out("OT") << "Sinkhorn: " << t_discrete << " s, "
+                          << (converged ? "converged" : "not converged")
+                          << ", cost=" << OT.transport_cost()
+                          << std::endl;
+        Logger::out("OT") << "average distance between centroids: "
+                          << avg_dist << std::endl;
+    }
+    catch(const std::exception& e) {
+        std::cerr << "Received an exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
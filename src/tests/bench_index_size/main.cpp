@@ -0,0 +1,180 @@
+/*
+ *  Copyright (c) 2012-2014, Bruno Levy
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *  this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *  this list of conditions and the following disclaimer in the documentation
+ *  and/or other materials provided with the distribution.
+ *  * Neither the name of the ALICE Project-Team nor the names of its
+ *  contributors may be used to endorse or promote products derived from this
+ *  software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     Bruno.Levy@inria.fr
+ *     http://www.loria.fr/~levy
+ *
+ *     ALICE Project
+ *     LORIA, INRIA Lorraine, 
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX 
+ *     FRANCE
+ *
+ */
+
+#include <geogram/basic/common.h>
+#include <geogram/basic/logger.h>
+#include <geogram/basic/command_line.h>
+#include <geogram/basic/command_line_args.h>
+#include <geogram/basic/stopwatch.h>
+#include <geogram/basic/process.h>
+#include <geogram/basic/file_system.h>
+#include <geogram/delaunay/delaunay.h>
+#include <geogram/mesh/mesh.h>
+#include <geogram/mesh/mesh_io.h>
+#include <geogram/mesh/mesh_AABB.h>
+
+/*
+ * Measures the time and memory used by Delaunay triangulation,
+ * mesh construction, AABB tree construction and queries and
+ * .geogram save/load. Comparing the results of a standard build with
+ * a build configured with -DGEOGRAM_WITH_64BIT_INDICES=ON gives the
+ * cost of 64 bits indices.
+ */
+
+namespace {
+
+    using namespace GEO;
+
+    /**
+     * \brief Displays the memory used by the process.
+     * \param[in] what name of the step
+     */
+    void show_memory(const std::string& what) {
+        Logger::out("Memory") << what << ": "
+                              << Process::used_memory() / (1024*1024)
+                              << " MB" << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    using namespace GEO;
+
+    GEO::initialize();
+
+    try {
+        CmdLine::import_arg_group("standard");
+        CmdLine::import_arg_group("algo");
+        CmdLine::declare_arg("nb_points", 1000000, "number of points");
+        CmdLine::declare_arg("nb_queries", 1000000, "number of AABB queries");
+        CmdLine::declare_arg(
+            "filename", "bench_index_size.geogram", "temporary mesh file"
+        );
+        if(!CmdLine::parse(argc, argv)) {
+            return 1;
+        }
+
+        index_t nb_points = CmdLine::get_arg_uint("nb_points");
+        index_t nb_queries = CmdLine::get_arg_uint("nb_queries");
+        std::string filename = CmdLine::get_arg("filename");
+
+        Logger::out("Index") << "sizeof(index_t) = " << sizeof(index_t)
+                             << std::endl;
+        show_memory("initial");
+
+        vector<double> points(3*nb_points);
+        for(index_t i=0; i<points.size(); ++i) {
+            points[i] = Numeric::random_float64();
+        }
+
+        Mesh M;
+        {
+            Stopwatch W("Delaunay");
+            Delaunay_var delaunay = Delaunay::create(3, "PDEL");
+            delaunay->set_vertices(nb_points, points.data());
+            show_memory("Delaunay");
+            vector<index_t> tets(delaunay->nb_cells()*4);
+            for(index_t i=0; i<tets.size(); ++i) {
+                tets[i] = index_t(delaunay->cell_to_v()[i]);
+            }
+            vector<double> vertices(points);
+            M.cells.assign_tet_mesh(3, vertices, tets, true);
+        }
+        {
+            Stopwatch W("Connect");
+            M.cells.connect();
+        }
+        Logger::out("Mesh") << M.cells.nb() << " tets" << std::endl;
+        show_memory("Mesh");
+
+        {
+            Stopwatch W("AABB");
+            MeshCellsAABB AABB(M);
+            show_memory("AABB");
+            index_t nb_found = 0;
+            for(index_t i=0; i<nb_queries; ++i) {
+                vec3 p(
+                    Numeric::random_float64(),
+                    Numeric::random_float64(),
+                    Numeric::random_float64()
+                );
+                if(AABB.containing_tet(p) != MeshCellsAABB::NO_TET) {
+                    ++nb_found;
+                }
+            }
+            Logger::out("AABB") << nb_found << "/" << nb_queries
+                                << " points located" << std::endl;
+        }
+
+        {
+            Stopwatch W("Save");
+            if(!mesh_save(M, filename)) {
+                return 1;
+            }
+        }
+        {
+            Stopwatch W("Load");
+            Mesh M2;
+            if(!mesh_load(filename, M2)) {
+                return 1;
+            }
+            geo_assert(M2.cells.nb() == M.cells.nb());
+            for(index_t c=0; c<M.cells.nb(); ++c) {
+                for(index_t lv=0; lv<4; ++lv) {
+                    geo_assert(M2.cells.vertex(c,lv) == M.cells.vertex(c,lv));
+                }
+            }
+        }
+        FileSystem::delete_file(filename);
+    }
+    catch(const std::exception& e) {
+        std::cerr << "Received an exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    Logger::out("Memory") << "max used: "
+                          << Process::max_used_memory() / (1024*1024)
+                          << " MB" << std::endl;
+    return 0;
+}
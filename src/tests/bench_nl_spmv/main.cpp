@@ -0,0 +1,453 @@
+/*
+ *  Copyright (c) 2012-2014, Bruno Levy
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *  this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *  this list of conditions and the following disclaimer in the documentation
+ *  and/or other materials provided with the distribution.
+ *  * Neither the name of the ALICE Project-Team nor the names of its
+ *  contributors may be used to endorse or promote products derived from this
+ *  software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     Bruno.Levy@inria.fr
+ *     http://www.loria.fr/~levy
+ *
+ *     ALICE Project
+ *     LORIA, INRIA Lorraine, 
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX 
+ *     FRANCE
+ *
+ */
+
+
+#include <geogram/basic/common.h>
+#include <geogram/basic/logger.h>
+#include <geogram/basic/command_line.h>
+#include <geogram/basic/command_line_args.h>
+#include <geogram/basic/stopwatch.h>
+#include <geogram/basic/process.h>
+#include <geogram/NL/nl.h>
+#include <geogram/NL/nl_matrix.h>
+
+namespace {
+
+    using namespace GEO;
+
+    /**
+     * \brief Creates the matrix of the 7-points Laplacian on a regular grid.
+     * \details A small shift is added to the diagonal to make it
+     *  positive definite.
+     * \param[in] N number of grid nodes along each axis
+     * \return a pointer to an NLCRSMatrix of size N^3 x N^3
+     */
+    NLMatrix create_grid_laplacian(index_t N) {
+        index_t n = N*N*N;
+        NLSparseMatrix* M = (NLSparseMatrix*)(
+            nlSparseMatrixNew(n, n, NL_MATRIX_STORE_ROWS)
+        );
+        for(index_t i=0; i<N; ++i) {
+            for(index_t j=0; j<N; ++j) {
+                for(index_t k=0; k<N; ++k) {
+                    index_t v = (i*N+j)*N+k;
+                    nlSparseMatrixAdd(M, v, v, 6.1);
+                    if(i > 0)   { nlSparseMatrixAdd(M, v, v-N*N, -1.0); }
+                    if(i < N-1) { nlSparseMatrixAdd(M, v, v+N*N, -1.0); }
+                    if(j > 0)   { nlSparseMatrixAdd(M, v, v-N, -1.0); }
+                    if(j < N-1) { nlSparseMatrixAdd(M, v, v+N, -1.0); }
+                    if(k > 0)   { nlSparseMatrixAdd(M, v, v-1, -1.0); }
+                    if(k < N-1) { nlSparseMatrixAdd(M, v, v+1, -1.0); }
+                }
+            }
+        }
+        NLMatrix result = (NLMatrix)M;
+        nlMatrixCompress(&result);
+        return result;
+    }
+
+    /**
+     * \brief Measures the throughput of matrix-vector products.
+     * \param[in] name the name of the storage, used in messages
+     * \param[in] M the matrix
+     * \param[in] nb_times number of matrix-vector products
+     * \param[out] y the result of the last product
+     */
+    void bench_spmv(
+        const std::string& name, NLMatrix M, index_t nb_times,
+        std::vector<double>& y
+    ) {
+        std::vector<double> x(M->n);
+        for(index_t i=0; i<M->n; ++i) {
+            x[i] = double(i % 17) / 17.0;
+        }
+        y.assign(M->m, 0.0);
+        double t0 = SystemStopwatch::now();
+        for(index_t k=0; k<nb_times; ++k) {
+            nlMultMatrixVector(M, x.data(), y.data());
+        }
+        double t = SystemStopwatch::now() - t0;
+        double flops = 2.0 * double(nlMatrixNNZ(M)) * double(nb_times);
+        Logger::out("SpMV") << name << ": "
+                            << t << " s, "
+                            << (t == 0.0 ? 0.0 : flops / (t * 1e9))
+                            << " GFlops" << std::endl;
+    }
+
+    /**
+     * \brief Adds the coefficients of the rows of a slab of the
+     *  Laplacian on a regular grid to the current OpenNL matrix.
+     * \param[in] N number of grid nodes along each axis
+     * \param[in] i index of the slab
+     * \param[in] thread if different from index_t(-1), the coefficients are
+     *  added with nlThreadAddIJCoefficient() using this thread index
+     */
+    void add_slab(index_t N, index_t i, index_t thread) {
+        for(index_t j=0; j<N; ++j) {
+            for(index_t k=0; k<N; ++k) {
+                index_t v = (i*N+j)*N+k;
+                index_t nb = 0;
+                index_t J[7];
+                double  a[7];
+                J[nb] = v; a[nb] = 6.1; ++nb;
+                if(i > 0)   { J[nb] = v-N*N; a[nb] = -1.0; ++nb; }
+                if(i < N-1) { J[nb] = v+N*N; a[nb] = -1.0; ++nb; }
+                if(j > 0)   { J[nb] = v-N;   a[nb] = -1.0; ++nb; }
+                if(j < N-1) { J[nb] = v+N;   a[nb] = -1.0; ++nb; }
+                if(k > 0)   { J[nb] = v-1;   a[nb] = -1.0; ++nb; }
+                if(k < N-1) { J[nb] = v+1;   a[nb] = -1.0; ++nb; }
+                for(index_t c=0; c<nb; ++c) {
+                    if(thread == index_t(-1)) {
+                        nlAddIJCoefficient(v, J[c], a[c]);
+                    } else {
+                        nlThreadAddIJCoefficient(thread, v, J[c], a[c]);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * \brief Functional object used to assemble the slabs of the 
+     *  Laplacian in parallel, one thread buffer per slab.
+     */
+    class AddSlab {
+    public:
+        /**
+         * \brief AddSlab constructor.
+         * \param[in] N number of grid nodes along each axis
+         * \param[in] context the OpenNL context being assembled
+         */
+        AddSlab(index_t N, NLContext context) : N_(N), context_(context) {
+        }
+
+        /**
+         * \brief Adds the coefficients of a slab.
+         * \details The current OpenNL context is thread-local, thus
+         *  the context is bound in the calling thread first.
+         * \param[in] i index of the slab, also used as the thread index
+         */
+        void operator()(index_t i) const {
+            nlMakeCurrent(context_);
+            add_slab(N_, i, i);
+        }
+
+    private:
+        index_t N_;
+        NLContext context_;
+    };
+
+    /**
+     * \brief Solves a linear system with the Laplacian on a regular
+     *  grid using OpenNL, and displays time and NL_GFLOPS.
+     * \param[in] N number of grid nodes along each axis
+     * \param[in] sell if true, SELL-C-sigma storage is used
+     * \param[in] parallel_assembly if true, the matrix is assembled
+     *  concurrently, one slab of the grid per thread buffer
+     * \param[in] mixed if true, single-precision iterations with 
+     *  double-precision refinement are used
+     */
+    void bench_solve(
+        index_t N, bool sell, bool parallel_assembly, bool mixed = false
+    ) {
+        index_t n = N*N*N;
+        nlNewContext();
+        nlSolverParameteri(NL_NB_VARIABLES, NLint(n));
+        nlSolverParameteri(NL_SOLVER, NL_CG);
+        nlSolverParameteri(NL_PRECONDITIONER, NL_PRECOND_JACOBI);
+        nlSolverParameteri(NL_MAX_ITERATIONS, 1000);
+        nlSolverParameterd(NL_THRESHOLD, 1e-10);
+        if(parallel_assembly) {
+            nlSolverParameteri(NL_ASSEMBLY_THREADS, NLint(N));
+        }
+        if(sell) {
+            nlEnable(NL_SELL_STORAGE);
+        }
+        if(mixed) {
+            nlEnable(NL_MIXED_PRECISION);
+        }
+        double t0 = SystemStopwatch::now();
+        nlBegin(NL_SYSTEM);
+        nlBegin(NL_MATRIX);
+        if(parallel_assembly) {
+            parallel_for(AddSlab(N, nlGetCurrent()), 0, N);
+        } else {
+            for(index_t i=0; i<N; ++i) {
+                add_slab(N, i, index_t(-1));
+            }
+        }
+        for(index_t v=0; v<n; ++v) {
+            nlAddIRightHandSide(v, 1.0);
+        }
+        nlEnd(NL_MATRIX);
+        nlEnd(NL_SYSTEM);
+        double t_assembly = SystemStopwatch::now() - t0;
+        nlSolve();
+        NLint used_iter;
+        NLdouble elapsed, gflops, error;
+        nlGetIntegerv(NL_USED_ITERATIONS, &used_iter);
+        nlGetDoublev(NL_ERROR, &error);
+        nlGetDoublev(NL_ELAPSED_TIME, &elapsed);
+        nlGetDoublev(NL_GFLOPS, &gflops);
+        Logger::out("Solve") << (sell ? "SELL" : "CRS ") 
+                             << (parallel_assembly ? " (par. assembly)" : "")
+                             << (mixed ? " (mixed precision)" : "")
+                             << ": "
+                             << "assembly " << t_assembly << " s, "
+                             << used_iter << " iterations, "
+                             << "error " << error << ", "
+                             << elapsed << " s, "
+                             << gflops << " NL_GFLOPS" << std::endl;
+        if(sell) {
+            // The matrix stays in CRS format, so that the system can be
+            // solved again (the Jacobi preconditioner requires CRS).
+            std::vector<double> x0(n, 0.0);
+            nlUpdateRightHandSide(x0.data());
+            nlSolve();
+            NLint used_iter_again;
+            nlGetIntegerv(NL_USED_ITERATIONS, &used_iter_again);
+            geo_assert(used_iter_again == used_iter);
+        }
+        nlDeleteContext(nlGetCurrent());
+    }
+
+    /**
+     * \brief Solves a linear system with the Laplacian on a regular
+     *  grid with the SSOR preconditioner, that needs a dynamic sparse
+     *  matrix.
+     * \param[in] N number of grid nodes along each axis
+     * \param[in] parallel_assembly if true, the matrix is assembled
+     *  concurrently, one slab of the grid per thread buffer
+     * \param[out] x the solution
+     * \return the number of used iterations
+     */
+    NLint solve_SSOR(
+        index_t N, bool parallel_assembly, std::vector<double>& x
+    ) {
+        index_t n = N*N*N;
+        nlNewContext();
+        nlSolverParameteri(NL_NB_VARIABLES, NLint(n));
+        nlSolverParameteri(NL_SOLVER, NL_CG);
+        nlSolverParameteri(NL_PRECONDITIONER, NL_PRECOND_SSOR);
+        nlSolverParameteri(NL_MAX_ITERATIONS, 1000);
+        nlSolverParameterd(NL_THRESHOLD, 1e-10);
+        nlSolverParameteri(NL_SYMMETRIC, NL_TRUE);
+        if(parallel_assembly) {
+            nlSolverParameteri(NL_ASSEMBLY_THREADS, NLint(N));
+        }
+        nlBegin(NL_SYSTEM);
+        nlBegin(NL_MATRIX);
+        if(parallel_assembly) {
+            parallel_for(AddSlab(N, nlGetCurrent()), 0, N);
+        } else {
+            for(index_t i=0; i<N; ++i) {
+                add_slab(N, i, index_t(-1));
+            }
+        }
+        for(index_t v=0; v<n; ++v) {
+            nlAddIRightHandSide(v, 1.0);
+        }
+        nlEnd(NL_MATRIX);
+        nlEnd(NL_SYSTEM);
+        nlSolve();
+        NLint used_iter;
+        nlGetIntegerv(NL_USED_ITERATIONS, &used_iter);
+        x.resize(n);
+        for(index_t v=0; v<n; ++v) {
+            x[v] = nlGetVariable(v);
+        }
+        nlDeleteContext(nlGetCurrent());
+        return used_iter;
+    }
+
+    /**
+     * \brief Checks that parallel assembly gives the same result as 
+     *  sequential assembly with the SSOR preconditioner.
+     * \param[in] N number of grid nodes along each axis
+     */
+    void check_SSOR_parallel_assembly(index_t N) {
+        std::vector<double> x_seq, x_par;
+        NLint iter_seq = solve_SSOR(N, false, x_seq);
+        NLint iter_par = solve_SSOR(N, true, x_par);
+        geo_assert(iter_seq == iter_par);
+        geo_assert(x_seq == x_par);
+        Logger::out("Solve") << "SSOR (par. assembly): "
+                             << iter_par << " iterations, "
+                             << "same as sequential assembly" << std::endl;
+    }
+
+    /**
+     * \brief Functional object that solves independent systems in
+     *  parallel, each one in its own OpenNL context.
+     */
+    class SolveInOwnContext {
+    public:
+        /**
+         * \brief SolveInOwnContext constructor.
+         * \param[in] N number of grid nodes along each axis
+         * \param[out] result the first component of the solution of
+         *  each system
+         */
+        SolveInOwnContext(index_t N, std::vector<double>& result) : 
+            N_(N), result_(result) {
+        }
+
+        /**
+         * \brief Solves the system with the Laplacian on a grid, and
+         *  a right-hand side that depends on \p s.
+         * \param[in] s index of the system
+         */
+        void operator()(index_t s) const {
+            index_t n = N_*N_*N_;
+            NLContext context = nlNewContext();
+            nlSolverParameteri(NL_NB_VARIABLES, NLint(n));
+            nlSolverParameteri(NL_SOLVER, NL_CG);
+            nlSolverParameteri(NL_PRECONDITIONER, NL_PRECOND_JACOBI);
+            nlSolverParameteri(NL_MAX_ITERATIONS, 1000);
+            nlSolverParameterd(NL_THRESHOLD, 1e-10);
+            nlBegin(NL_SYSTEM);
+            nlBegin(NL_MATRIX);
+            for(index_t i=0; i<N_; ++i) {
+                add_slab(N_, i, index_t(-1));
+            }
+            for(index_t v=0; v<n; ++v) {
+                nlAddIRightHandSide(v, double(s+1));
+            }
+            nlEnd(NL_MATRIX);
+            nlEnd(NL_SYSTEM);
+            nlSolve();
+            geo_assert(nlGetCurrent() == context);
+            result_[s] = nlGetVariable(0);
+            nlDeleteContext(context);
+        }
+
+    private:
+        index_t N_;
+        std::vector<double>& result_;
+    };
+
+    /**
+     * \brief Solves independent systems sequentially and concurrently,
+     *  and checks that the results are the same.
+     * \param[in] N number of grid nodes along each axis
+     * \param[in] nb_systems number of systems
+     */
+    void bench_concurrent_solves(index_t N, index_t nb_systems) {
+        std::vector<double> sequential(nb_systems);
+        std::vector<double> concurrent(nb_systems);
+        SolveInOwnContext sequential_solve(N, sequential);
+        SolveInOwnContext concurrent_solve(N, concurrent);
+        double t0 = SystemStopwatch::now();
+        for(index_t s=0; s<nb_systems; ++s) {
+            sequential_solve(s);
+        }
+        double t_sequential = SystemStopwatch::now() - t0;
+        t0 = SystemStopwatch::now();
+        parallel_for(concurrent_solve, 0, nb_systems);
+        double t_concurrent = SystemStopwatch::now() - t0;
+        for(index_t s=0; s<nb_systems; ++s) {
+            geo_assert(sequential[s] == concurrent[s]);
+        }
+        Logger::out("Contexts") << nb_systems << " systems, "
+                                << "sequential: " << t_sequential << " s, "
+                                << "concurrent: " << t_concurrent << " s"
+                                << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    using namespace GEO;
+
+    GEO::initialize();
+
+    try {
+        Stopwatch W("Total time");
+        CmdLine::import_arg_group("standard");
+        CmdLine::declare_arg("grid_size", 64, "number of nodes along each axis");
+        CmdLine::declare_arg("nb_times", 100, "number of matrix-vector products");
+        CmdLine::declare_arg("chunk", 8, "chunk height of SELL storage");
+        CmdLine::declare_arg("sigma", 256, "sorting window of SELL storage");
+        if(!CmdLine::parse(argc, argv)) {
+            return 1;
+        }
+
+        index_t N = CmdLine::get_arg_uint("grid_size");
+        index_t nb_times = CmdLine::get_arg_uint("nb_times");
+
+        NLMatrix CRS = create_grid_laplacian(N);
+        NLMatrix SELL = nlSELLMatrixNewFromCRSMatrix(
+            (NLCRSMatrix*)CRS,
+            CmdLine::get_arg_uint("chunk"),
+            CmdLine::get_arg_uint("sigma")
+        );
+        Logger::out("SpMV")
+            << "n=" << CRS->n << " nnz=" << nlMatrixNNZ(CRS)
+            << " SELL fill ratio=" 
+            << nlSELLMatrixFillRatio((NLSELLMatrix*)SELL)
+            << std::endl;
+
+        std::vector<double> y_CRS, y_SELL;
+        bench_spmv("CRS ", CRS, nb_times, y_CRS);
+        bench_spmv("SELL", SELL, nb_times, y_SELL);
+        for(index_t i=0; i<index_t(y_CRS.size()); ++i) {
+            geo_assert(::fabs(y_CRS[i] - y_SELL[i]) < 1e-10);
+        }
+        nlDeleteMatrix(CRS);
+        nlDeleteMatrix(SELL);
+
+        bench_solve(N, false, false);
+        bench_solve(N, false, true);
+        bench_solve(N, true, true);
+        bench_solve(N, false, false, true);
+        check_SSOR_parallel_assembly(16);
+        bench_concurrent_solves(16, 64);
+    }
+    catch(const std::exception& e) {
+        std::cerr << "Received an exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,247 @@
+/*
+ *  Copyright (c) 2012-2014, Bruno Levy
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *  this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *  this list of conditions and the following disclaimer in the documentation
+ *  and/or other materials provided with the distribution.
+ *  * Neither the name of the ALICE Project-Team nor the names of its
+ *  contributors may be used to endorse or promote products derived from this
+ *  software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     Bruno.Levy@inria.fr
+ *     http://www.loria.fr/~levy
+ *
+ *     ALICE Project
+ *     LORIA, INRIA Lorraine, 
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX 
+ *     FRANCE
+ *
+ */
+
+#include <geogram/basic/common.h>
+#include <geogram/basic/logger.h>
+#include <geogram/basic/command_line.h>
+#include <geogram/basic/command_line_args.h>
+#include <geogram/basic/stopwatch.h>
+#include <geogram/basic/numeric.h>
+#include <geogram/numerics/predicates.h>
+#include <vector>
+#include <algorithm>
+
+namespace {
+
+    using namespace GEO;
+
+    /**
+     * \brief Generates random points.
+     * \param[in] nb_points number of points
+     * \param[out] points the coordinates of the points
+     */
+    void generate_random_points(
+        index_t nb_points, std::vector<double>& points
+    ) {
+        points.resize(3*nb_points);
+        for(index_t i=0; i<3*nb_points; ++i) {
+            points[i] = Numeric::random_float64();
+        }
+    }
+
+    /**
+     * \brief Generates the nodes of a regular grid.
+     * \details Many configurations are degenerate (coplanar or cospherical
+     *  points), and need exact arithmetic.
+     * \param[in] N number of nodes along each axis
+     * \param[out] points the coordinates of the points
+     */
+    void generate_grid_points(
+        index_t N, std::vector<double>& points
+    ) {
+        points.clear();
+        for(index_t i=0; i<N; ++i) {
+            for(index_t j=0; j<N; ++j) {
+                for(index_t k=0; k<N; ++k) {
+                    points.push_back(double(i));
+                    points.push_back(double(j));
+                    points.push_back(double(k));
+                }
+            }
+        }
+    }
+
+    /**
+     * \brief Randomly moves points by a small amount.
+     * \details Applied to the nodes of a grid, this generates nearly
+     *  degenerate configurations, that the semi-static filters cannot
+     *  decide, but that interval arithmetics can often decide.
+     * \param[in] amount maximum displacement along each axis
+     * \param[in,out] points the coordinates of the points
+     */
+    void perturb_points(double amount, std::vector<double>& points) {
+        for(index_t i=0; i<points.size(); ++i) {
+            points[i] += amount * (2.0 * Numeric::random_float64() - 1.0);
+        }
+    }
+
+    /**
+     * \brief Picks a random point different from previously picked ones.
+     * \param[in] points coordinates of the points
+     * \param[in] picked the indices of the previously picked points
+     * \return a pointer to the coordinates of the picked point
+     */
+    const double* pick_point(
+        const std::vector<double>& points, std::vector<index_t>& picked
+    ) {
+        index_t nb_points = index_t(points.size() / 3);
+        for(;;) {
+            index_t v = index_t(Numeric::random_int32()) % nb_points;
+            if(std::find(picked.begin(), picked.end(), v) == picked.end()) {
+                picked.push_back(v);
+                return &points[3*v];
+            }
+        }
+    }
+
+    /**
+     * \brief Measures the throughput of the scalar and batched versions
+     *  of orient_3d() and in_sphere_3d_SOS(), and checks that they
+     *  return the same results.
+     * \param[in] name name of the dataset, used in messages
+     * \param[in] points coordinates of the points
+     * \param[in] nb_tests number of predicate evaluations
+     */
+    void bench(
+        const std::string& name, const std::vector<double>& points,
+        index_t nb_tests
+    ) {
+        std::vector<const double*> p0(nb_tests), p1(nb_tests),
+            p2(nb_tests), p3(nb_tests), p4(nb_tests);
+        std::vector<index_t> picked;
+        for(index_t i=0; i<nb_tests; ++i) {
+            picked.clear();
+            p0[i] = pick_point(points, picked);
+            p1[i] = pick_point(points, picked);
+            p2[i] = pick_point(points, picked);
+            p3[i] = pick_point(points, picked);
+            p4[i] = pick_point(points, picked);
+        }
+
+        std::vector<Sign> scalar(nb_tests), batch(nb_tests);
+
+        double t0 = SystemStopwatch::now();
+        for(index_t i=0; i<nb_tests; ++i) {
+            scalar[i] = PCK::orient_3d(p0[i], p1[i], p2[i], p3[i]);
+        }
+        double t_scalar = SystemStopwatch::now() - t0;
+        t0 = SystemStopwatch::now();
+        PCK::orient_3d_batch(
+            nb_tests, &p0[0], &p1[0], &p2[0], &p3[0], &batch[0]
+        );
+        double t_batch = SystemStopwatch::now() - t0;
+        for(index_t i=0; i<nb_tests; ++i) {
+            geo_assert(scalar[i] == batch[i]);
+        }
+        Logger::out("orient_3d") << name 
+                                 << " scalar: " << t_scalar << " s, "
+                                 << "batch: " << t_batch << " s" 
+                                 << std::endl;
+
+        // in_sphere_3d_SOS() expects positively oriented tetrahedra
+        index_t nb_tets = 0;
+        for(index_t i=0; i<nb_tests; ++i) {
+            if(batch[i] == ZERO) {
+                continue;
+            }
+            const double* q2 = p2[i];
+            const double* q3 = p3[i];
+            if(batch[i] == NEGATIVE) {
+                std::swap(q2,q3);
+            }
+            p0[nb_tets] = p0[i];
+            p1[nb_tets] = p1[i];
+            p2[nb_tets] = q2;
+            p3[nb_tets] = q3;
+            p4[nb_tets] = p4[i];
+            ++nb_tets;
+        }
+
+        t0 = SystemStopwatch::now();
+        for(index_t i=0; i<nb_tets; ++i) {
+            scalar[i] = PCK::in_sphere_3d_SOS(
+                p0[i], p1[i], p2[i], p3[i], p4[i]
+            );
+        }
+        t_scalar = SystemStopwatch::now() - t0;
+        t0 = SystemStopwatch::now();
+        PCK::in_sphere_3d_SOS_batch(
+            nb_tets, &p0[0], &p1[0], &p2[0], &p3[0], &p4[0], &batch[0]
+        );
+        t_batch = SystemStopwatch::now() - t0;
+        for(index_t i=0; i<nb_tets; ++i) {
+            geo_assert(scalar[i] == batch[i]);
+        }
+        Logger::out("in_sphere_3d") << name 
+                                    << " scalar: " << t_scalar << " s, "
+                                    << "batch: " << t_batch << " s" 
+                                    << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    using namespace GEO;
+
+    GEO::initialize();
+
+    try {
+        Stopwatch W("Total time");
+        CmdLine::import_arg_group("standard");
+        CmdLine::declare_arg("nb_points", 100000, "number of points");
+        CmdLine::declare_arg("nb_tests", 2000000, "number of predicates");
+        if(!CmdLine::parse(argc, argv)) {
+            return 1;
+        }
+
+        index_t nb_points = CmdLine::get_arg_uint("nb_points");
+        index_t nb_tests = CmdLine::get_arg_uint("nb_tests");
+
+        std::vector<double> points;
+        generate_random_points(nb_points, points);
+        bench("random    ", points, nb_tests);
+        generate_grid_points(8, points);
+        bench("degenerate", points, nb_tests);
+        perturb_points(1e-13, points);
+        bench("perturbed ", points, nb_tests);
+
+        PCK::show_stats();
+    }
+    catch(const std::exception& e) {
+        std::cerr << "Received an exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,327 @@
+/*
+ *  Copyright (c) 2012-2014, Bruno Levy
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *  this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *  this list of conditions and the following disclaimer in the documentation
+ *  and/or other materials provided with the distribution.
+ *  * Neither the name of the ALICE Project-Team nor the names of its
+ *  contributors may be used to endorse or promote products derived from this
+ *  software without specific prior written permission.
+ * 
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  If you modify this software, you should include a notice giving the
+ *  name of the person performing the modification, the date of modification,
+ *  and the reason for such modification.
+ *
+ *  Contact: Bruno Levy
+ *
+ *     Bruno.Levy@inria.fr
+ *     http://www.loria.fr/~levy
+ *
+ *     ALICE Project
+ *     LORIA, INRIA Lorraine, 
+ *     Campus Scientifique, BP 239
+ *     54506 VANDOEUVRE LES NANCY CEDEX 
+ *     FRANCE
+ *
+ */
+
+#include <geogram/basic/common.h>
+#include <geogram/basic/logger.h>
+#include <geogram/basic/command_line.h>
+#include <geogram/basic/command_line_args.h>
+#include <geogram/basic/file_system.h>
+#include <geogram/mesh/mesh.h>
+#include <geogram/mesh/mesh_io.h>
+
+/*
+ * Checks that modifying a copy of a mesh leaves the original unchanged
+ * and conversely, and that saving a copy does not duplicate the
+ * attributes shared with the original mesh (copy-on-write).
+ */
+
+namespace {
+
+    using namespace GEO;
+
+    /**
+     * \brief Tests whether all the attributes of two AttributesManager%s
+     *  still share their memory.
+     * \param[in] A , B the two AttributesManager%s
+     * \param[in] what name of the mesh element, displayed in the error
+     *  message
+     * \retval true if all the attributes are shared
+     * \retval false otherwise
+     */
+    bool check_shared(
+        const AttributesManager& A, const AttributesManager& B,
+        const std::string& what
+    ) {
+        vector<std::string> names;
+        A.list_attribute_names(names);
+        bool result = true;
+        for(index_t i=0; i<names.size(); ++i) {
+            const AttributeStore* SA = A.find_attribute_store(names[i]);
+            const AttributeStore* SB = B.find_attribute_store(names[i]);
+            if(
+                SB == nil || !SA->is_shared() || !SB->is_shared() ||
+                SA->data() != SB->data()
+            ) {
+                Logger::err("COW") << what << "." << names[i]
+                                   << " was duplicated" << std::endl;
+                result = false;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * \brief Creates a regular grid of triangles with a facet attribute
+     *  and a facet corner attribute.
+     * \param[out] M the mesh
+     * \param[in] N number of vertices along each axis
+     */
+    void create_grid(Mesh& M, index_t N) {
+        M.vertices.create_vertices(N*N);
+        for(index_t i=0; i<N; ++i) {
+            for(index_t j=0; j<N; ++j) {
+                double* p = M.vertices.point_ptr(i*N+j);
+                p[0] = double(i);
+                p[1] = double(j);
+                p[2] = 0.0;
+            }
+        }
+        for(index_t i=0; i+1<N; ++i) {
+            for(index_t j=0; j+1<N; ++j) {
+                index_t v00 = i*N+j;
+                index_t v10 = v00+N;
+                M.facets.create_triangle(v00, v10, v10+1);
+                M.facets.create_triangle(v00, v10+1, v00+1);
+            }
+        }
+        Attribute<index_t> region(M.facets.attributes(), "region");
+        Attribute<double> tex_coord;
+        tex_coord.create_vector_attribute(
+            M.facet_corners.attributes(), "tex_coord", 2
+        );
+        for(index_t f=0; f<M.facets.nb(); ++f) {
+            region[f] = f%7;
+        }
+        for(index_t c=0; c<M.facet_corners.nb(); ++c) {
+            tex_coord[2*c] = double(c%5);
+            tex_coord[2*c+1] = double(c%3);
+        }
+    }
+
+    /**
+     * \brief Appends the raw content of all the attributes of an
+     *  AttributesManager to a vector.
+     * \details Only const accessors are used, that do not unshare
+     *  the attributes.
+     * \param[in] A the AttributesManager
+     * \param[in,out] contents the bytes of the attributes are appended
+     *  to it
+     */
+    void append_attributes(
+        const AttributesManager& A, std::vector<Numeric::uint8>& contents
+    ) {
+        vector<std::string> names;
+        A.list_attribute_names(names);
+        for(index_t i=0; i<names.size(); ++i) {
+            const AttributeStore* store = A.find_attribute_store(names[i]);
+            const Numeric::uint8* data = 
+                static_cast<const Numeric::uint8*>(store->data());
+            size_t nb_bytes = 
+                size_t(store->size()) * store->dimension() * 
+                store->element_size();
+            contents.insert(contents.end(), data, data + nb_bytes);
+        }
+    }
+
+    /**
+     * \brief Gets the coordinates, facets and attributes of a mesh.
+     * \param[in] M the mesh
+     * \param[out] contents the bytes of the vertices, facet corners
+     *  and attributes of \p M
+     */
+    void get_contents(const Mesh& M, std::vector<Numeric::uint8>& contents) {
+        contents.clear();
+        for(index_t v=0; v<M.vertices.nb(); ++v) {
+            const Numeric::uint8* p = 
+                reinterpret_cast<const Numeric::uint8*>(
+                    M.vertices.point_ptr(v)
+                );
+            contents.insert(
+                contents.end(), p, p + M.vertices.dimension()*sizeof(double)
+            );
+        }
+        for(index_t f=0; f<M.facets.nb(); ++f) {
+            for(index_t lv=0; lv<M.facets.nb_vertices(f); ++lv) {
+                index_t v = M.facets.vertex(f,lv);
+                const Numeric::uint8* p = 
+                    reinterpret_cast<const Numeric::uint8*>(&v);
+                contents.insert(contents.end(), p, p + sizeof(index_t));
+            }
+        }
+        append_attributes(M.vertices.attributes(), contents);
+        append_attributes(M.facets.attributes(), contents);
+        append_attributes(M.facet_corners.attributes(), contents);
+    }
+
+    /**
+     * \brief A modification of a mesh.
+     */
+    typedef void (*Modification)(Mesh& M);
+
+    void write_point(Mesh& M) {
+        M.vertices.point_ptr(3)[0] = 100.0;
+    }
+
+    void write_attribute(Mesh& M) {
+        Attribute<index_t> region(M.facets.attributes(), "region");
+        region[5] = 42;
+    }
+
+    void write_facet_vertex(Mesh& M) {
+        M.facets.set_vertex(0, 0, 17);
+    }
+
+    void permute_facets(Mesh& M) {
+        vector<index_t> permutation(M.facets.nb());
+        for(index_t f=0; f<M.facets.nb(); ++f) {
+            permutation[f] = M.facets.nb() - 1 - f;
+        }
+        M.facets.permute_elements(permutation);
+    }
+
+    void delete_facets(Mesh& M) {
+        vector<index_t> to_delete(M.facets.nb(), 0);
+        for(index_t f=0; f<M.facets.nb(); f+=3) {
+            to_delete[f] = 1;
+        }
+        M.facets.delete_elements(to_delete);
+    }
+
+    /**
+     * \brief Checks that modifying a copy of a mesh does not change the
+     *  original mesh, and conversely.
+     * \param[in] name name of the modification, displayed in the error
+     *  messages
+     * \param[in] modify the modification
+     * \retval true if the modified mesh changed and the other one did not
+     * \retval false otherwise
+     */
+    bool check_independent(const std::string& name, Modification modify) {
+        bool result = true;
+        for(index_t modify_copy=0; modify_copy<2; ++modify_copy) {
+            Mesh original;
+            create_grid(original, 20);
+            Mesh copy;
+            copy.copy(original);
+            Mesh& modified = (modify_copy != 0) ? copy : original;
+            Mesh& other = (modify_copy != 0) ? original : copy;
+            std::vector<Numeric::uint8> before, after, modified_after;
+            get_contents(other, before);
+            modify(modified);
+            get_contents(other, after);
+            get_contents(modified, modified_after);
+            const char* what = (modify_copy != 0) ? "copy" : "original";
+            if(after != before) {
+                Logger::err("COW") << name << " on the " << what
+                                   << " changed the other mesh" << std::endl;
+                result = false;
+            }
+            if(modified_after == before) {
+                Logger::err("COW") << name << " on the " << what
+                                   << " did not change it" << std::endl;
+                result = false;
+            }
+        }
+        return result;
+    }
+}
+
+int main(int argc, char** argv) {
+    using namespace GEO;
+
+    GEO::initialize();
+
+    try {
+        CmdLine::import_arg_group("standard");
+        CmdLine::declare_arg(
+            "filename", "test_mesh_cow", "basename of the temporary files"
+        );
+        if(!CmdLine::parse(argc, argv)) {
+            return 1;
+        }
+        std::string basename = CmdLine::get_arg("filename");
+
+        bool ok = true;
+        ok = check_independent("point_ptr()", write_point) && ok;
+        ok = check_independent("Attribute::operator[]", write_attribute) && ok;
+        ok = check_independent("facets.set_vertex()", write_facet_vertex) && ok;
+        ok = check_independent("facets.permute_elements()", permute_facets) && ok;
+        ok = check_independent("facets.delete_elements()", delete_facets) && ok;
+        if(!ok) {
+            return 1;
+        }
+        Logger::out("COW") << "Modified meshes are independent" << std::endl;
+
+        Mesh M;
+        create_grid(M, 100);
+
+        Mesh M2;
+        M2.copy(M);
+
+        MeshIOFlags flags;
+        flags.set_attribute(MESH_FACET_REGION);
+
+        const char* extensions[] = { "geogram", "obj", "mesh", "stl" };
+        for(index_t i=0; i<sizeof(extensions)/sizeof(extensions[0]); ++i) {
+            std::string filename = basename + "." + extensions[i];
+            if(!mesh_save(M2, filename, flags)) {
+                return 1;
+            }
+            FileSystem::delete_file(filename);
+            ok = check_shared(
+                M.vertices.attributes(), M2.vertices.attributes(),
+                std::string(extensions[i]) + ": vertices"
+            ) && ok;
+            ok = check_shared(
+                M.facets.attributes(), M2.facets.attributes(),
+                std::string(extensions[i]) + ": facets"
+            ) && ok;
+            ok = check_shared(
+                M.facet_corners.attributes(), M2.facet_corners.attributes(),
+                std::string(extensions[i]) + ": facet_corners"
+            ) && ok;
+        }
+        if(!ok) {
+            return 1;
+        }
+        Logger::out("COW") << "All attributes are still shared" << std::endl;
+    }
+    catch(const std::exception& e) {
+        std::cerr << "Received an exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}